@@ -361,6 +361,13 @@ struct fdb_tsdb {
 };
 typedef struct fdb_tsdb *fdb_tsdb_t;
 
+/* KV batch write item */
+struct fdb_kv_batch {
+    const char *key;                             /**< KV name */
+    const void *value;                           /**< KV value, the KV will be deleted when it's NULL */
+    size_t len;                                  /**< KV value length */
+};
+
 /* blob structure */
 struct fdb_blob {
     void *buf;                                   /**< blob data buffer */
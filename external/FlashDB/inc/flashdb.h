@@ -47,6 +47,7 @@ char             *fdb_kv_get          (fdb_kvdb_t db, const char *key);
 fdb_err_t         fdb_kv_set_blob     (fdb_kvdb_t db, const char *key, fdb_blob_t blob);
 size_t            fdb_kv_get_blob     (fdb_kvdb_t db, const char *key, fdb_blob_t blob);
 fdb_err_t         fdb_kv_del          (fdb_kvdb_t db, const char *key);
+fdb_err_t         fdb_kv_set_batch    (fdb_kvdb_t db, const struct fdb_kv_batch *batch, size_t num);
 fdb_kv_t          fdb_kv_get_obj      (fdb_kvdb_t db, const char *key, fdb_kv_t kv);
 fdb_blob_t        fdb_kv_to_blob      (fdb_kv_t   kv, fdb_blob_t blob);
 fdb_err_t         fdb_kv_set_default  (fdb_kvdb_t db);
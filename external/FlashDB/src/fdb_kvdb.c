@@ -137,6 +137,12 @@ struct gc_cb_args {
     uint32_t traversed_len;
 };
 
+struct batch_space_cb_args {
+    size_t max_kv_size;
+    size_t free_size;
+    size_t empty_sec;
+};
+
 uint8_t kvdb_log = 0;
 uint8_t kvdb_assert = 0;
 
@@ -1458,7 +1464,7 @@ fdb_err_t fdb_kv_del(fdb_kvdb_t db, const char *key)
     return result;
 }
 
-static fdb_err_t set_kv(fdb_kvdb_t db, const char *key, const void *value_buf, size_t buf_len)
+static fdb_err_t set_kv_ex(fdb_kvdb_t db, const char *key, const void *value_buf, size_t buf_len, bool do_gc)
 {
     fdb_err_t result = FDB_NO_ERR;
     bool kv_is_found = false;
@@ -1484,7 +1490,7 @@ static fdb_err_t set_kv(fdb_kvdb_t db, const char *key, const void *value_buf, s
             result = del_kv(db, key, &db->cur_kv, true);
         }
         /* process the GC after set KV */
-        if (db->gc_request) {
+        if (do_gc && db->gc_request) {
             gc_collect_by_free_size(db, KV_HDR_DATA_SIZE + FDB_WG_ALIGN(strlen(key)) + FDB_WG_ALIGN(buf_len));
         }
     }
@@ -1492,6 +1498,11 @@ static fdb_err_t set_kv(fdb_kvdb_t db, const char *key, const void *value_buf, s
     return result;
 }
 
+static fdb_err_t set_kv(fdb_kvdb_t db, const char *key, const void *value_buf, size_t buf_len)
+{
+    return set_kv_ex(db, key, value_buf, buf_len, true);
+}
+
 /**
  * Set a blob KV. If it blob value is NULL, delete it.
  * If not find it in flash, then create it.
@@ -1529,6 +1540,108 @@ fdb_err_t fdb_kv_set_blob(fdb_kvdb_t db, const char *key, fdb_blob_t blob)
     return result;
 }
 
+static bool batch_space_cb(kv_sec_info_t sector, void *arg1, void *arg2)
+{
+    struct batch_space_cb_args *arg = arg1;
+
+    if (!sector->check_ok || sector->status.dirty != FDB_SECTOR_DIRTY_FALSE) {
+        return false;
+    }
+    if (sector->status.store == FDB_SECTOR_STORE_EMPTY) {
+        arg->empty_sec++;
+    } else if (sector->status.store == FDB_SECTOR_STORE_USING && sector->remain > arg->max_kv_size) {
+        arg->free_size += sector->remain - arg->max_kv_size;
+    }
+
+    return false;
+}
+
+/*
+ * The free space which is sure to hold KVs up to max_kv_size each. Every sector
+ * may leave less than max_kv_size unused at its end, and the empty sectors
+ * reserved for GC are not counted.
+ */
+static size_t batch_free_size(fdb_kvdb_t db, size_t max_kv_size)
+{
+    struct kvdb_sec_info sector;
+    struct batch_space_cb_args arg = { max_kv_size, 0, 0 };
+    size_t empty_free = db_sec_size(db) - SECTOR_HDR_DATA_SIZE;
+
+    sector_iterator(db, &sector, FDB_SECTOR_STORE_UNUSED, &arg, NULL, batch_space_cb, true);
+    if (arg.empty_sec > FDB_GC_EMPTY_SEC_THRESHOLD && empty_free > max_kv_size) {
+        arg.free_size += (arg.empty_sec - FDB_GC_EMPTY_SEC_THRESHOLD) * (empty_free - max_kv_size);
+    }
+
+    return arg.free_size;
+}
+
+/**
+ * Set several KVs at once. The item which value is NULL will be deleted.
+ *
+ * The free space for the whole batch is checked before anything is written,
+ * GC runs first when it is not enough. If it is still not enough, nothing is
+ * written and FDB_SAVED_FULL is returned. If a write fails later on, the items
+ * before it already hold their new values, and setting the same batch again is
+ * safe, so the caller should keep the batch and retry it.
+ *
+ * @param db database object
+ * @param batch KV items
+ * @param num item number
+ *
+ * @return result
+ */
+fdb_err_t fdb_kv_set_batch(fdb_kvdb_t db, const struct fdb_kv_batch *batch, size_t num)
+{
+    fdb_err_t result = FDB_NO_ERR;
+    size_t total_len = 0, max_len = 0, kv_len;
+    size_t i;
+
+    if (!db_init_ok(db)) {
+        FDB_INFO("Error: KV (%s) isn't initialize OK.\n", db_name(db));
+        return FDB_INIT_FAILED;
+    }
+
+    for (i = 0; i < num; i++) {
+        if (batch[i].value) {
+            kv_len = KV_HDR_DATA_SIZE + FDB_WG_ALIGN(strlen(batch[i].key)) + FDB_WG_ALIGN(batch[i].len);
+            total_len += kv_len;
+            if (kv_len > max_len) {
+                max_len = kv_len;
+            }
+        }
+    }
+
+    /* lock the KV cache */
+    db_lock(db);
+
+    /* reserve the space for the whole batch, GC now if not enough */
+    if (total_len > 0 && batch_free_size(db, max_len) < total_len) {
+        gc_collect_by_free_size(db, total_len);
+        if (batch_free_size(db, max_len) < total_len) {
+            FDB_INFO("Error: No space for the KV batch (size %" PRIu32 ").\n", (uint32_t)total_len);
+            result = FDB_SAVED_FULL;
+        }
+    }
+
+    for (i = 0; i < num && result == FDB_NO_ERR; i++) {
+        result = set_kv_ex(db, batch[i].key, batch[i].value, batch[i].len, false);
+        if (result == FDB_KV_NAME_ERR && batch[i].value == NULL) {
+            /* deleting a KV which doesn't exist */
+            result = FDB_NO_ERR;
+        }
+    }
+
+    /* process the GC after the whole batch */
+    if (db->gc_request) {
+        gc_collect_by_free_size(db, total_len);
+    }
+
+    /* unlock the KV cache */
+    db_unlock(db);
+
+    return result;
+}
+
 /**
  * Set a string KV. If it value is NULL, delete it.
  * If not find it in flash, then create it.
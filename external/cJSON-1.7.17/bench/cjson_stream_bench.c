@@ -0,0 +1,531 @@
+/**
+  ******************************************************************************
+  * @file   cjson_stream_bench.c
+  * @author Sifli software development team
+  * @brief Host benchmark of cJSON DOM against arena, reader and writer
+ *
+  * Build and run on host, rtthread.h here stands in for the kernel one:
+  *   gcc -O2 -I. -I.. -DPKG_CJSON_USING_STREAM cjson_stream_bench.c ../cJSON.c -lm -o cjson_stream_bench
+  *   ./cjson_stream_bench [rounds]
+  *
+  * The payloads are what a watch exchanges with the phone: contact sync,
+  * weather forecast and notifications. Every path is checked against the DOM
+  * before it's timed.
+  ******************************************************************************
+*/
+/**
+ * @attention
+ * Copyright (c) 2019 - 2022,  Sifli Technology
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Sifli integrated circuit
+ *    in a product or a software update for such product, must reproduce the above
+ *    copyright notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Sifli nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Sifli integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY SIFLI TECHNOLOGY "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL SIFLI TECHNOLOGY OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "cJSON.h"
+
+#define BENCH_DEFAULT_ROUNDS (2000)
+/* what a BLE or uart sender would take at a time */
+#define BENCH_WRITER_BUF     (256)
+#define BENCH_ARENA_BUF      (4096)
+#define BENCH_ARENA_BLOCK    (4096)
+#define BENCH_SCRATCH_BUF    (512)
+#define BENCH_TEXT_MAX       (64 * 1024)
+
+typedef enum
+{
+    BENCH_CONTACTS,
+    BENCH_WEATHER,
+    BENCH_NOTIFY,
+    BENCH_PAYLOAD_NUM
+} bench_payload_t;
+
+static const char *payload_name[BENCH_PAYLOAD_NUM] = {"contacts", "weather", "notify"};
+
+static uint32_t malloc_count;
+static uint32_t malloc_bytes;
+
+static double bench_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void *bench_malloc(size_t size)
+{
+    malloc_count++;
+    malloc_bytes += size;
+    return malloc(size);
+}
+
+static void bench_free(void *pointer)
+{
+    free(pointer);
+}
+
+/************************ payload, built both ways ****************************/
+
+static const char *first_name[] = {"Alice", "Bob", "Chen Wei", "Dmitri", "Elena", "Fatima", "George", "Hiro"};
+static const char *last_name[] = {"Smith", "Zhang", "Ivanov", "Garcia", "Tanaka", "Okafor"};
+static const char *weather_text[] = {"Sunny", "Cloudy", "Light rain", "Thunderstorm", "Snow"};
+static const char *notify_app[] = {"com.tencent.mm", "com.android.mms", "com.whatsapp", "com.google.android.gm"};
+static const char *notify_body[] = {"See you at 7?", "Your parcel \"12345\" is out for delivery",
+                                    "Meeting moved to 3pm\nRoom 402", "Verification code: 482913"
+                                   };
+
+static cJSON *build_dom(bench_payload_t payload)
+{
+    cJSON *root;
+    cJSON *list;
+    cJSON *item;
+    char text[64];
+    int i;
+
+    root = cJSON_CreateObject();
+    switch (payload)
+    {
+    case BENCH_CONTACTS:
+        cJSON_AddNumberToObject(root, "version", 3);
+        list = cJSON_AddArrayToObject(root, "contacts");
+        for (i = 0; i < 50; i++)
+        {
+            item = cJSON_CreateObject();
+            snprintf(text, sizeof(text), "%s %s", first_name[i % 8], last_name[i % 6]);
+            cJSON_AddNumberToObject(item, "id", 1000 + i);
+            cJSON_AddStringToObject(item, "name", text);
+            snprintf(text, sizeof(text), "+86 138%08d", i * 7919);
+            cJSON_AddStringToObject(item, "phone", text);
+            cJSON_AddBoolToObject(item, "favorite", (i % 5) == 0);
+            cJSON_AddItemToArray(list, item);
+        }
+        break;
+    case BENCH_WEATHER:
+        cJSON_AddStringToObject(root, "city", "Shanghai");
+        cJSON_AddNumberToObject(root, "update", 1760860800);
+        item = cJSON_AddObjectToObject(root, "now");
+        cJSON_AddNumberToObject(item, "temp", 21.5);
+        cJSON_AddNumberToObject(item, "humidity", 68);
+        cJSON_AddStringToObject(item, "text", weather_text[1]);
+        list = cJSON_AddArrayToObject(root, "daily");
+        for (i = 0; i < 7; i++)
+        {
+            item = cJSON_CreateObject();
+            cJSON_AddNumberToObject(item, "day", i);
+            cJSON_AddNumberToObject(item, "high", 24 - i);
+            cJSON_AddNumberToObject(item, "low", 15.5 - i);
+            cJSON_AddStringToObject(item, "text", weather_text[i % 5]);
+            cJSON_AddNumberToObject(item, "pop", i * 10);
+            cJSON_AddNullToObject(item, "alert");
+            cJSON_AddItemToArray(list, item);
+        }
+        break;
+    default:
+        list = cJSON_AddArrayToObject(root, "notify");
+        for (i = 0; i < 20; i++)
+        {
+            item = cJSON_CreateObject();
+            cJSON_AddNumberToObject(item, "id", 70000 + i);
+            cJSON_AddStringToObject(item, "app", notify_app[i % 4]);
+            cJSON_AddStringToObject(item, "title", first_name[i % 8]);
+            cJSON_AddStringToObject(item, "body", notify_body[i % 4]);
+            cJSON_AddNumberToObject(item, "time", 1760860800 + i * 61);
+            cJSON_AddBoolToObject(item, "silent", i & 1);
+            cJSON_AddItemToArray(list, item);
+        }
+        break;
+    }
+
+    return root;
+}
+
+static void write_payload(cJSON_Writer *w, bench_payload_t payload)
+{
+    char text[64];
+    int i;
+
+    cJSON_WriteObjectStart(w, NULL);
+    switch (payload)
+    {
+    case BENCH_CONTACTS:
+        cJSON_WriteNumber(w, "version", 3);
+        cJSON_WriteArrayStart(w, "contacts");
+        for (i = 0; i < 50; i++)
+        {
+            cJSON_WriteObjectStart(w, NULL);
+            snprintf(text, sizeof(text), "%s %s", first_name[i % 8], last_name[i % 6]);
+            cJSON_WriteNumber(w, "id", 1000 + i);
+            cJSON_WriteString(w, "name", text);
+            snprintf(text, sizeof(text), "+86 138%08d", i * 7919);
+            cJSON_WriteString(w, "phone", text);
+            cJSON_WriteBool(w, "favorite", (i % 5) == 0);
+            cJSON_WriteObjectEnd(w);
+        }
+        cJSON_WriteArrayEnd(w);
+        break;
+    case BENCH_WEATHER:
+        cJSON_WriteString(w, "city", "Shanghai");
+        cJSON_WriteNumber(w, "update", 1760860800);
+        cJSON_WriteObjectStart(w, "now");
+        cJSON_WriteNumber(w, "temp", 21.5);
+        cJSON_WriteNumber(w, "humidity", 68);
+        cJSON_WriteString(w, "text", weather_text[1]);
+        cJSON_WriteObjectEnd(w);
+        cJSON_WriteArrayStart(w, "daily");
+        for (i = 0; i < 7; i++)
+        {
+            cJSON_WriteObjectStart(w, NULL);
+            cJSON_WriteNumber(w, "day", i);
+            cJSON_WriteNumber(w, "high", 24 - i);
+            cJSON_WriteNumber(w, "low", 15.5 - i);
+            cJSON_WriteString(w, "text", weather_text[i % 5]);
+            cJSON_WriteNumber(w, "pop", i * 10);
+            cJSON_WriteNull(w, "alert");
+            cJSON_WriteObjectEnd(w);
+        }
+        cJSON_WriteArrayEnd(w);
+        break;
+    default:
+        cJSON_WriteArrayStart(w, "notify");
+        for (i = 0; i < 20; i++)
+        {
+            cJSON_WriteObjectStart(w, NULL);
+            cJSON_WriteNumber(w, "id", 70000 + i);
+            cJSON_WriteString(w, "app", notify_app[i % 4]);
+            cJSON_WriteString(w, "title", first_name[i % 8]);
+            cJSON_WriteString(w, "body", notify_body[i % 4]);
+            cJSON_WriteNumber(w, "time", 1760860800 + i * 61);
+            cJSON_WriteBool(w, "silent", i & 1);
+            cJSON_WriteObjectEnd(w);
+        }
+        cJSON_WriteArrayEnd(w);
+        break;
+    }
+    cJSON_WriteObjectEnd(w);
+}
+
+/* the sink of the writer, a transport would send the data here */
+typedef struct
+{
+    char *text;
+    size_t len;
+    uint32_t flushes;
+} bench_sink_t;
+
+static cJSON_bool bench_flush(void *user, const char *data, size_t length)
+{
+    bench_sink_t *sink = (bench_sink_t *)user;
+
+    if (sink->len + length >= BENCH_TEXT_MAX)
+    {
+        return 0;
+    }
+    memcpy(sink->text + sink->len, data, length);
+    sink->len += length;
+    sink->flushes++;
+
+    return 1;
+}
+
+/************************ the same digest from every path *********************/
+
+typedef struct
+{
+    double numbers;
+    uint32_t strings;
+    uint32_t keys;
+    uint32_t values;
+} bench_digest_t;
+
+static void digest_string(uint32_t *sum, const char *s)
+{
+    while (*s)
+    {
+        *sum = *sum * 31 + (uint8_t)*s++;
+    }
+}
+
+static void digest_dom(const cJSON *item, bench_digest_t *d)
+{
+    for (; item != NULL; item = item->next)
+    {
+        d->values++;
+        if (item->string != NULL)
+        {
+            digest_string(&d->keys, item->string);
+        }
+        if (cJSON_IsNumber(item))
+        {
+            d->numbers += item->valuedouble;
+        }
+        else if (cJSON_IsString(item))
+        {
+            digest_string(&d->strings, item->valuestring);
+        }
+        else if (cJSON_IsBool(item))
+        {
+            d->numbers += cJSON_IsTrue(item) ? 1 : 0;
+        }
+        digest_dom(item->child, d);
+    }
+}
+
+static int digest_reader(const char *json, size_t len, bench_digest_t *d)
+{
+    static char scratch[BENCH_SCRATCH_BUF];
+    cJSON_Reader r;
+    cJSON_ReadToken token;
+
+    cJSON_ReaderInit(&r, json, len, scratch, sizeof(scratch));
+    while (1)
+    {
+        token = cJSON_ReaderNext(&r);
+        if ((token == cJSON_ReadError) || (token == cJSON_ReadEnd))
+        {
+            return (token == cJSON_ReadEnd) ? 0 : -1;
+        }
+        if ((token == cJSON_ReadObjectEnd) || (token == cJSON_ReadArrayEnd))
+        {
+            continue;
+        }
+        d->values++;
+        if (r.key != NULL)
+        {
+            digest_string(&d->keys, r.key);
+        }
+        if (token == cJSON_ReadNumber)
+        {
+            d->numbers += r.valuedouble;
+        }
+        else if (token == cJSON_ReadString)
+        {
+            digest_string(&d->strings, r.string);
+        }
+        else if (token == cJSON_ReadTrue)
+        {
+            d->numbers += 1;
+        }
+    }
+}
+
+static int digest_equal(const bench_digest_t *a, const bench_digest_t *b)
+{
+    return (a->numbers == b->numbers) && (a->strings == b->strings) &&
+           (a->keys == b->keys) && (a->values == b->values);
+}
+
+/* a reader which only wants the first contact name skips the rest */
+static int reader_skip_check(const char *json, size_t len)
+{
+    static char scratch[BENCH_SCRATCH_BUF];
+    cJSON_Reader r;
+    cJSON_ReadToken token;
+    int count = 0;
+
+    cJSON_ReaderInit(&r, json, len, scratch, sizeof(scratch));
+    while ((token = cJSON_ReaderNext(&r)) != cJSON_ReadEnd)
+    {
+        if (token == cJSON_ReadError)
+        {
+            return -1;
+        }
+        if (((token == cJSON_ReadObjectStart) || (token == cJSON_ReadArrayStart)) && (r.depth > 1))
+        {
+            if (!cJSON_ReaderSkip(&r))
+            {
+                return -1;
+            }
+        }
+        count++;
+    }
+
+    return count;
+}
+
+/************************ main ************************************************/
+
+static void report(const char *name, double t, uint32_t rounds, size_t bytes, uint32_t allocs, uint32_t alloc_bytes)
+{
+    printf("  %-14s %8.2f us %7.1f MB/s %6u mallocs %7u bytes\n", name, t * 1e6 / rounds,
+           (double)bytes * rounds / t / 1e6, allocs, alloc_bytes);
+}
+
+int main(int argc, char **argv)
+{
+    static char arena_buf[BENCH_ARENA_BUF];
+    static char writer_buf[BENCH_WRITER_BUF];
+    static char sink_text[BENCH_TEXT_MAX];
+    cJSON_Hooks hooks = {bench_malloc, bench_free};
+    bench_digest_t d_dom;
+    bench_digest_t d_other;
+    bench_sink_t sink;
+    cJSON_Writer w;
+    cJSON_Arena arena;
+    cJSON *root;
+    char *json;
+    char *text;
+    size_t len;
+    uint32_t rounds;
+    uint32_t allocs;
+    uint32_t alloc_bytes;
+    uint32_t r;
+    int p;
+    double t0;
+
+    rounds = (argc > 1) ? atoi(argv[1]) : BENCH_DEFAULT_ROUNDS;
+    if (0 == rounds)
+    {
+        rounds = 1;
+    }
+    cJSON_InitHooks(&hooks);
+    cJSON_ArenaInit(&arena, arena_buf, sizeof(arena_buf), BENCH_ARENA_BLOCK);
+
+    printf("rounds %u, writer buffer %u, arena buffer %u, reader scratch %u\n", rounds,
+           BENCH_WRITER_BUF, BENCH_ARENA_BUF, BENCH_SCRATCH_BUF);
+    for (p = 0; p < BENCH_PAYLOAD_NUM; p++)
+    {
+        root = build_dom((bench_payload_t)p);
+        json = cJSON_PrintUnformatted(root);
+        cJSON_Delete(root);
+        len = strlen(json);
+        printf("%s: %u bytes\n", payload_name[p], (unsigned)len);
+
+        /* check every path against the DOM first */
+        root = cJSON_Parse(json);
+        memset(&d_dom, 0, sizeof(d_dom));
+        digest_dom(root, &d_dom);
+        cJSON_Delete(root);
+
+        root = cJSON_ParseArena(&arena, json, len);
+        text = root ? cJSON_PrintUnformatted(root) : NULL;
+        if (!text || strcmp(text, json))
+        {
+            printf("  arena parse mismatch\n");
+            return 1;
+        }
+        cJSON_free(text);
+        cJSON_ArenaReset(&arena);
+
+        memset(&d_other, 0, sizeof(d_other));
+        if (digest_reader(json, len, &d_other) || !digest_equal(&d_dom, &d_other))
+        {
+            printf("  reader mismatch\n");
+            return 1;
+        }
+        if (reader_skip_check(json, len) < 0)
+        {
+            printf("  reader skip failed\n");
+            return 1;
+        }
+
+        memset(&sink, 0, sizeof(sink));
+        sink.text = sink_text;
+        cJSON_WriterInit(&w, writer_buf, sizeof(writer_buf), bench_flush, &sink);
+        write_payload(&w, (bench_payload_t)p);
+        if ((cJSON_WriterFinish(&w) != len) || (sink.len != len) || memcmp(sink.text, json, len))
+        {
+            printf("  writer mismatch\n");
+            return 1;
+        }
+
+        /* parse */
+        malloc_count = malloc_bytes = 0;
+        t0 = bench_now();
+        for (r = 0; r < rounds; r++)
+        {
+            root = cJSON_ParseWithLength(json, len);
+            cJSON_Delete(root);
+        }
+        report("dom parse", bench_now() - t0, rounds, len, malloc_count / rounds, malloc_bytes / rounds);
+
+        malloc_count = malloc_bytes = 0;
+        t0 = bench_now();
+        for (r = 0; r < rounds; r++)
+        {
+            root = cJSON_ParseArena(&arena, json, len);
+            if (r == 0)
+            {
+                alloc_bytes = arena.used;
+            }
+            cJSON_ArenaReset(&arena);
+        }
+        allocs = malloc_count / rounds;
+        report("arena parse", bench_now() - t0, rounds, len, allocs, malloc_bytes / rounds);
+        printf("  %-14s %u bytes of arena\n", "", alloc_bytes);
+
+        malloc_count = malloc_bytes = 0;
+        t0 = bench_now();
+        for (r = 0; r < rounds; r++)
+        {
+            memset(&d_other, 0, sizeof(d_other));
+            digest_reader(json, len, &d_other);
+        }
+        report("reader", bench_now() - t0, rounds, len, malloc_count / rounds, malloc_bytes / rounds);
+
+        /* print */
+        malloc_count = malloc_bytes = 0;
+        t0 = bench_now();
+        for (r = 0; r < rounds; r++)
+        {
+            root = build_dom((bench_payload_t)p);
+            text = cJSON_PrintUnformatted(root);
+            cJSON_Delete(root);
+            cJSON_free(text);
+        }
+        report("dom print", bench_now() - t0, rounds, len, malloc_count / rounds, malloc_bytes / rounds);
+
+        malloc_count = malloc_bytes = 0;
+        t0 = bench_now();
+        for (r = 0; r < rounds; r++)
+        {
+            sink.len = 0;
+            sink.flushes = 0;
+            cJSON_WriterInit(&w, writer_buf, sizeof(writer_buf), bench_flush, &sink);
+            write_payload(&w, (bench_payload_t)p);
+            cJSON_WriterFinish(&w);
+        }
+        report("writer", bench_now() - t0, rounds, len, malloc_count / rounds, malloc_bytes / rounds);
+        printf("  %-14s %u flushes of %u bytes\n", "", sink.flushes, BENCH_WRITER_BUF);
+
+        cJSON_free(json);
+    }
+
+    return 0;
+}
+
+/************************ (C) COPYRIGHT Sifli Technology *******END OF FILE****/
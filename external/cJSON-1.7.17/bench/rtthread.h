@@ -0,0 +1,10 @@
+/* Host stand-in of rtthread.h for the cJSON benchmark only */
+#ifndef CJSON_BENCH_RTTHREAD_H
+#define CJSON_BENCH_RTTHREAD_H
+
+#include <string.h>
+
+#define rt_memcpy memcpy
+#define rt_memset memset
+
+#endif
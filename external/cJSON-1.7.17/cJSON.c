@@ -159,8 +159,18 @@ typedef struct internal_hooks
     void *(CJSON_CDECL *allocate)(size_t size);
     void (CJSON_CDECL *deallocate)(void *pointer);
     void *(CJSON_CDECL *reallocate)(void *pointer, size_t size);
+#ifdef PKG_CJSON_USING_STREAM
+    /* items and strings of the parser are taken from here if not NULL */
+    cJSON_Arena *arena;
+#endif
 } internal_hooks;
 
+#ifdef PKG_CJSON_USING_STREAM
+#define INTERNAL_HOOKS_INIT(allocate, deallocate, reallocate) { allocate, deallocate, reallocate, NULL }
+#else
+#define INTERNAL_HOOKS_INIT(allocate, deallocate, reallocate) { allocate, deallocate, reallocate }
+#endif
+
 #if defined(_MSC_VER)
 /* work around MSVC error C2322: '...' address of dllimport '...' is not static */
 static void * CJSON_CDECL internal_malloc(size_t size)
@@ -188,7 +198,23 @@ static void * CJSON_CDECL internal_realloc(void *pointer, size_t size)
 /* strlen of character literals resolved at compile time */
 #define static_strlen(string_literal) (sizeof(string_literal) - sizeof(""))
 
-static internal_hooks global_hooks = { internal_malloc, internal_free, internal_realloc };
+static internal_hooks global_hooks = INTERNAL_HOOKS_INIT(internal_malloc, internal_free, internal_realloc);
+
+#ifdef PKG_CJSON_USING_STREAM
+#define hooks_in_arena(hooks) ((hooks)->arena != NULL)
+static void *hooks_allocate(const internal_hooks * const hooks, size_t size)
+{
+    if (hooks->arena != NULL)
+    {
+        return cJSON_ArenaAlloc(hooks->arena, size);
+    }
+
+    return hooks->allocate(size);
+}
+#else
+#define hooks_in_arena(hooks) false
+#define hooks_allocate(hooks, size) ((hooks)->allocate(size))
+#endif
 
 static unsigned char* cJSON_strdup(const unsigned char* string, const internal_hooks * const hooks)
 {
@@ -245,7 +271,7 @@ CJSON_PUBLIC(void) cJSON_InitHooks(cJSON_Hooks* hooks)
 /* Internal constructor. */
 static cJSON *cJSON_New_Item(const internal_hooks * const hooks)
 {
-    cJSON* node = (cJSON*)hooks->allocate(sizeof(cJSON));
+    cJSON* node = (cJSON*)hooks_allocate(hooks, sizeof(cJSON));
     if (node)
     {
         rt_memset(node, '\0', sizeof(cJSON));
@@ -819,7 +845,7 @@ static cJSON_bool parse_string(cJSON * const item, parse_buffer * const input_bu
 
         /* This is at most how much we need for the output */
         allocation_length = (size_t) (input_end - buffer_at_offset(input_buffer)) - skipped_bytes;
-        output = (unsigned char*)input_buffer->hooks.allocate(allocation_length + sizeof(""));
+        output = (unsigned char*)hooks_allocate(&input_buffer->hooks, allocation_length + sizeof(""));
         if (output == NULL)
         {
             goto fail; /* allocation failure */
@@ -895,7 +921,7 @@ static cJSON_bool parse_string(cJSON * const item, parse_buffer * const input_bu
     return true;
 
 fail:
-    if (output != NULL)
+    if ((output != NULL) && !hooks_in_arena(&input_buffer->hooks))
     {
         input_buffer->hooks.deallocate(output);
     }
@@ -1101,10 +1127,17 @@ CJSON_PUBLIC(cJSON *) cJSON_ParseWithOpts(const char *value, const char **return
     return cJSON_ParseWithLengthOpts(value, buffer_length, return_parse_end, require_null_terminated);
 }
 
+static cJSON *parse_with_hooks(const char *value, size_t buffer_length, const char **return_parse_end, cJSON_bool require_null_terminated, const internal_hooks * const hooks);
+
 /* Parse an object - create a new root, and populate. */
 CJSON_PUBLIC(cJSON *) cJSON_ParseWithLengthOpts(const char *value, size_t buffer_length, const char **return_parse_end, cJSON_bool require_null_terminated)
 {
-    parse_buffer buffer = { 0, 0, 0, 0, { 0, 0, 0 } };
+    return parse_with_hooks(value, buffer_length, return_parse_end, require_null_terminated, &global_hooks);
+}
+
+static cJSON *parse_with_hooks(const char *value, size_t buffer_length, const char **return_parse_end, cJSON_bool require_null_terminated, const internal_hooks * const hooks)
+{
+    parse_buffer buffer = { 0, 0, 0, 0, INTERNAL_HOOKS_INIT(NULL, NULL, NULL) };
     cJSON *item = NULL;
 
     /* reset error position */
@@ -1119,9 +1152,9 @@ CJSON_PUBLIC(cJSON *) cJSON_ParseWithLengthOpts(const char *value, size_t buffer
     buffer.content = (const unsigned char*)value;
     buffer.length = buffer_length;
     buffer.offset = 0;
-    buffer.hooks = global_hooks;
+    buffer.hooks = *hooks;
 
-    item = cJSON_New_Item(&global_hooks);
+    item = cJSON_New_Item(&buffer.hooks);
     if (item == NULL) /* memory fail */
     {
         goto fail;
@@ -1150,7 +1183,7 @@ CJSON_PUBLIC(cJSON *) cJSON_ParseWithLengthOpts(const char *value, size_t buffer
     return item;
 
 fail:
-    if (item != NULL)
+    if ((item != NULL) && !hooks_in_arena(hooks))
     {
         cJSON_Delete(item);
     }
@@ -1271,7 +1304,7 @@ CJSON_PUBLIC(char *) cJSON_PrintUnformatted(const cJSON *item)
 
 CJSON_PUBLIC(char *) cJSON_PrintBuffered(const cJSON *item, int prebuffer, cJSON_bool fmt)
 {
-    printbuffer p = { 0, 0, 0, 0, 0, 0, { 0, 0, 0 } };
+    printbuffer p = { 0, 0, 0, 0, 0, 0, INTERNAL_HOOKS_INIT(NULL, NULL, NULL) };
 
     if (prebuffer < 0)
     {
@@ -1301,7 +1334,7 @@ CJSON_PUBLIC(char *) cJSON_PrintBuffered(const cJSON *item, int prebuffer, cJSON
 
 CJSON_PUBLIC(cJSON_bool) cJSON_PrintPreallocated(cJSON *item, char *buffer, const int length, const cJSON_bool format)
 {
-    printbuffer p = { 0, 0, 0, 0, 0, 0, { 0, 0, 0 } };
+    printbuffer p = { 0, 0, 0, 0, 0, 0, INTERNAL_HOOKS_INIT(NULL, NULL, NULL) };
 
     if ((length < 0) || (buffer == NULL))
     {
@@ -1537,7 +1570,7 @@ success:
     return true;
 
 fail:
-    if (head != NULL)
+    if ((head != NULL) && !hooks_in_arena(&input_buffer->hooks))
     {
         cJSON_Delete(head);
     }
@@ -1712,7 +1745,7 @@ success:
     return true;
 
 fail:
-    if (head != NULL)
+    if ((head != NULL) && !hooks_in_arena(&input_buffer->hooks))
     {
         cJSON_Delete(head);
     }
@@ -3132,3 +3165,605 @@ CJSON_PUBLIC(void) cJSON_free(void *object)
 {
     global_hooks.deallocate(object);
 }
+
+#ifdef PKG_CJSON_USING_STREAM
+/* items hold doubles */
+#define arena_align(size) (((size) + 7) & ~(size_t)7)
+
+CJSON_PUBLIC(void) cJSON_ArenaInit(cJSON_Arena *arena, void *buffer, size_t size, size_t block_size)
+{
+    if (arena == NULL)
+    {
+        return;
+    }
+
+    rt_memset(arena, 0, sizeof(*arena));
+    if (buffer != NULL)
+    {
+        arena->buffer = (unsigned char*)buffer;
+        arena->size = size;
+    }
+    arena->block_size = block_size;
+    cJSON_ArenaReset(arena);
+}
+
+CJSON_PUBLIC(void *) cJSON_ArenaAlloc(cJSON_Arena *arena, size_t size)
+{
+    cJSON_ArenaBlock *block = NULL;
+    size_t block_size = 0;
+    unsigned char *pointer = NULL;
+
+    if (arena == NULL)
+    {
+        return NULL;
+    }
+
+    size = arena_align(size);
+    if ((size_t)(arena->end - arena->pos) < size)
+    {
+        if (arena->block_size == 0)
+        {
+            return NULL;
+        }
+
+        block_size = arena_align(sizeof(cJSON_ArenaBlock)) + size;
+        if (block_size < arena->block_size)
+        {
+            block_size = arena->block_size;
+        }
+        block = (cJSON_ArenaBlock*)global_hooks.allocate(block_size);
+        if (block == NULL)
+        {
+            return NULL;
+        }
+        block->next = arena->blocks;
+        block->size = block_size;
+        arena->blocks = block;
+        arena->pos = (unsigned char*)block + arena_align(sizeof(cJSON_ArenaBlock));
+        arena->end = (unsigned char*)block + block_size;
+    }
+
+    pointer = arena->pos;
+    arena->pos += size;
+    arena->used += size;
+
+    return pointer;
+}
+
+CJSON_PUBLIC(void) cJSON_ArenaReset(cJSON_Arena *arena)
+{
+    cJSON_ArenaBlock *block = NULL;
+    size_t skip = 0;
+
+    if (arena == NULL)
+    {
+        return;
+    }
+
+    while (arena->blocks != NULL)
+    {
+        block = arena->blocks;
+        arena->blocks = block->next;
+        global_hooks.deallocate(block);
+    }
+
+    arena->pos = arena->buffer;
+    arena->end = arena->buffer;
+    if (arena->buffer != NULL)
+    {
+        skip = arena_align((size_t)arena->buffer) - (size_t)arena->buffer;
+        if (skip < arena->size)
+        {
+            arena->pos = arena->buffer + skip;
+            arena->end = arena->buffer + arena->size;
+        }
+    }
+    arena->used = 0;
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ParseArena(cJSON_Arena *arena, const char *value, size_t buffer_length)
+{
+    internal_hooks hooks = global_hooks;
+
+    if (arena == NULL)
+    {
+        return NULL;
+    }
+    /* nothing is freed on failure, the arena is reset by the caller */
+    hooks.arena = arena;
+
+    return parse_with_hooks(value, buffer_length, NULL, false, &hooks);
+}
+
+CJSON_PUBLIC(void) cJSON_ReaderInit(cJSON_Reader *reader, const char *json, size_t length, void *scratch, size_t scratch_size)
+{
+    if (reader == NULL)
+    {
+        return;
+    }
+
+    rt_memset(reader, 0, sizeof(*reader));
+    reader->json = (const unsigned char*)json;
+    reader->length = length;
+    if ((json != NULL) && (length >= 3) && (strncmp(json, "\xEF\xBB\xBF", 3) == 0))
+    {
+        reader->offset = 3;
+    }
+    cJSON_ArenaInit(&reader->scratch, scratch, scratch_size, 0);
+}
+
+CJSON_PUBLIC(cJSON_ReadToken) cJSON_ReaderNext(cJSON_Reader *reader)
+{
+    parse_buffer buffer = { 0, 0, 0, 0, INTERNAL_HOOKS_INIT(NULL, NULL, NULL) };
+    cJSON item;
+    cJSON_bool in_object = false;
+    cJSON_ReadToken token = cJSON_ReadError;
+    unsigned char c = 0;
+
+    if ((reader == NULL) || (reader->json == NULL))
+    {
+        return cJSON_ReadError;
+    }
+
+    buffer.content = reader->json;
+    buffer.length = reader->length;
+    buffer.offset = reader->offset;
+    buffer.hooks = global_hooks;
+    /* strings of the last token are dropped */
+    buffer.hooks.arena = &reader->scratch;
+    cJSON_ArenaReset(&reader->scratch);
+    rt_memset(&item, 0, sizeof(item));
+    reader->key = NULL;
+    reader->string = NULL;
+
+    buffer_skip_whitespace(&buffer);
+    if (reader->done)
+    {
+        /* only whitespace or '\0' may follow */
+        if (cannot_access_at_index(&buffer, 0) || (buffer_at_offset(&buffer)[0] <= 32))
+        {
+            token = cJSON_ReadEnd;
+        }
+        goto end;
+    }
+    if (cannot_access_at_index(&buffer, 0))
+    {
+        goto end;
+    }
+
+    if (reader->depth > 0)
+    {
+        in_object = (reader->objects >> (reader->depth - 1)) & 1;
+        c = buffer_at_offset(&buffer)[0];
+        if (c == (in_object ? '}' : ']'))
+        {
+            buffer.offset++;
+            reader->depth--;
+            reader->need_comma = true;
+            reader->done = (reader->depth == 0);
+            token = in_object ? cJSON_ReadObjectEnd : cJSON_ReadArrayEnd;
+            goto end;
+        }
+
+        if (reader->need_comma)
+        {
+            if (c != ',')
+            {
+                goto end;
+            }
+            buffer.offset++;
+            buffer_skip_whitespace(&buffer);
+            if (cannot_access_at_index(&buffer, 0))
+            {
+                goto end;
+            }
+        }
+
+        if (in_object)
+        {
+            if (!parse_string(&item, &buffer))
+            {
+                goto end;
+            }
+            reader->key = item.valuestring;
+            buffer_skip_whitespace(&buffer);
+            if (cannot_access_at_index(&buffer, 0) || (buffer_at_offset(&buffer)[0] != ':'))
+            {
+                goto end;
+            }
+            buffer.offset++;
+            buffer_skip_whitespace(&buffer);
+            if (cannot_access_at_index(&buffer, 0))
+            {
+                goto end;
+            }
+        }
+    }
+
+    c = buffer_at_offset(&buffer)[0];
+    if ((c == '{') || (c == '['))
+    {
+        if ((reader->depth >= CJSON_STREAM_DEPTH) || (reader->depth >= CJSON_NESTING_LIMIT))
+        {
+            goto end;
+        }
+        if (c == '{')
+        {
+            reader->objects |= 1U << reader->depth;
+        }
+        else
+        {
+            reader->objects &= ~(1U << reader->depth);
+        }
+        reader->depth++;
+        reader->need_comma = false;
+        buffer.offset++;
+        token = (c == '{') ? cJSON_ReadObjectStart : cJSON_ReadArrayStart;
+        goto end;
+    }
+
+    if (c == '\"')
+    {
+        if (!parse_string(&item, &buffer))
+        {
+            goto end;
+        }
+        reader->string = item.valuestring;
+        token = cJSON_ReadString;
+    }
+    else if ((c == '-') || ((c >= '0') && (c <= '9')))
+    {
+        if (!parse_number(&item, &buffer))
+        {
+            goto end;
+        }
+        reader->valuedouble = item.valuedouble;
+        reader->valueint = item.valueint;
+        token = cJSON_ReadNumber;
+    }
+    else if (can_read(&buffer, 4) && (strncmp((const char*)buffer_at_offset(&buffer), "null", 4) == 0))
+    {
+        buffer.offset += 4;
+        token = cJSON_ReadNull;
+    }
+    else if (can_read(&buffer, 4) && (strncmp((const char*)buffer_at_offset(&buffer), "true", 4) == 0))
+    {
+        buffer.offset += 4;
+        token = cJSON_ReadTrue;
+    }
+    else if (can_read(&buffer, 5) && (strncmp((const char*)buffer_at_offset(&buffer), "false", 5) == 0))
+    {
+        buffer.offset += 5;
+        token = cJSON_ReadFalse;
+    }
+    else
+    {
+        goto end;
+    }
+    reader->need_comma = true;
+    reader->done = (reader->depth == 0);
+
+end:
+    reader->offset = buffer.offset;
+    if (token == cJSON_ReadError)
+    {
+        /* keep failing */
+        reader->json = NULL;
+    }
+
+    return token;
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_ReaderSkip(cJSON_Reader *reader)
+{
+    size_t depth = 0;
+    cJSON_ReadToken token = cJSON_ReadError;
+
+    if ((reader == NULL) || (reader->depth == 0))
+    {
+        return false;
+    }
+
+    depth = reader->depth;
+    while (reader->depth >= depth)
+    {
+        token = cJSON_ReaderNext(reader);
+        if ((token == cJSON_ReadError) || (token == cJSON_ReadEnd))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+CJSON_PUBLIC(void) cJSON_WriterInit(cJSON_Writer *writer, char *buffer, size_t size, cJSON_WriterFlush flush, void *user)
+{
+    if (writer == NULL)
+    {
+        return;
+    }
+
+    rt_memset(writer, 0, sizeof(*writer));
+    writer->buffer = (unsigned char*)buffer;
+    writer->size = size;
+    writer->flush = flush;
+    writer->user = user;
+    if ((buffer == NULL) || (size < 2))
+    {
+        writer->error = true;
+    }
+}
+
+static cJSON_bool writer_flush(cJSON_Writer * const writer)
+{
+    if ((writer->flush == NULL) || (writer->offset == 0))
+    {
+        return false;
+    }
+
+    if (!writer->flush(writer->user, (const char*)writer->buffer, writer->offset))
+    {
+        return false;
+    }
+    writer->flushed += writer->offset;
+    writer->offset = 0;
+
+    return true;
+}
+
+/* write the comma, the key and then the value or the opening bracket, all or nothing */
+static cJSON_bool writer_put(cJSON_Writer * const writer, const char * const key, const cJSON * const value, unsigned char open)
+{
+    printbuffer p = { 0, 0, 0, 0, 0, 0, INTERNAL_HOOKS_INIT(NULL, NULL, NULL) };
+    cJSON_bool comma = false;
+    cJSON_bool in_object = false;
+    unsigned char *output = NULL;
+    int retry = 0;
+
+    if ((writer == NULL) || writer->error)
+    {
+        return false;
+    }
+
+    comma = (writer->need_comma >> writer->depth) & 1;
+    in_object = (writer->depth > 0) && ((writer->objects >> (writer->depth - 1)) & 1);
+    if ((in_object != (key != NULL)) || ((writer->depth == 0) && comma))
+    {
+        /* a key is needed in an object only, one value at top level */
+        goto fail;
+    }
+
+    for (retry = 0; retry < 2; retry++)
+    {
+        p.buffer = writer->buffer;
+        p.length = writer->size;
+        p.offset = writer->offset;
+        p.noalloc = true;
+        p.hooks = global_hooks;
+
+        if (comma)
+        {
+            output = ensure(&p, 1);
+            if (output == NULL)
+            {
+                goto full;
+            }
+            *output = ',';
+            p.offset++;
+        }
+        if (key != NULL)
+        {
+            if (!print_string_ptr((const unsigned char*)key, &p))
+            {
+                goto full;
+            }
+            update_offset(&p);
+            output = ensure(&p, 1);
+            if (output == NULL)
+            {
+                goto full;
+            }
+            *output = ':';
+            p.offset++;
+        }
+        if (value != NULL)
+        {
+            if (!print_value(value, &p))
+            {
+                goto full;
+            }
+            update_offset(&p);
+        }
+        else
+        {
+            output = ensure(&p, 1);
+            if (output == NULL)
+            {
+                goto full;
+            }
+            *output = open;
+            p.offset++;
+        }
+
+        writer->offset = p.offset;
+        writer->need_comma |= 1U << writer->depth;
+        return true;
+
+full:
+        if (!writer_flush(writer))
+        {
+            break;
+        }
+    }
+
+fail:
+    writer->error = true;
+
+    return false;
+}
+
+static cJSON_bool writer_start(cJSON_Writer * const writer, const char * const key, unsigned char open)
+{
+    if ((writer == NULL) || ((writer->depth + 1) >= CJSON_STREAM_DEPTH))
+    {
+        if (writer != NULL)
+        {
+            writer->error = true;
+        }
+        return false;
+    }
+
+    if (!writer_put(writer, key, NULL, open))
+    {
+        return false;
+    }
+
+    if (open == '{')
+    {
+        writer->objects |= 1U << writer->depth;
+    }
+    else
+    {
+        writer->objects &= ~(1U << writer->depth);
+    }
+    writer->depth++;
+    writer->need_comma &= ~(1U << writer->depth);
+
+    return true;
+}
+
+static cJSON_bool writer_end(cJSON_Writer * const writer, cJSON_bool object)
+{
+    if ((writer == NULL) || writer->error)
+    {
+        return false;
+    }
+
+    if ((writer->depth == 0) || (((writer->objects >> (writer->depth - 1)) & 1) != (unsigned int)object))
+    {
+        writer->error = true;
+        return false;
+    }
+
+    /* keep one byte for '\0' */
+    if (((writer->offset + 2) > writer->size) && !writer_flush(writer))
+    {
+        writer->error = true;
+        return false;
+    }
+    writer->buffer[writer->offset++] = object ? '}' : ']';
+    writer->depth--;
+
+    return true;
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_WriteObjectStart(cJSON_Writer *writer, const char *key)
+{
+    return writer_start(writer, key, '{');
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_WriteObjectEnd(cJSON_Writer *writer)
+{
+    return writer_end(writer, true);
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_WriteArrayStart(cJSON_Writer *writer, const char *key)
+{
+    return writer_start(writer, key, '[');
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_WriteArrayEnd(cJSON_Writer *writer)
+{
+    return writer_end(writer, false);
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_WriteString(cJSON_Writer *writer, const char *key, const char *string)
+{
+    cJSON item;
+
+    rt_memset(&item, 0, sizeof(item));
+    item.type = cJSON_String;
+    item.valuestring = (char*)cast_away_const(string);
+
+    return writer_put(writer, key, &item, 0);
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_WriteNumber(cJSON_Writer *writer, const char *key, double number)
+{
+    cJSON item;
+
+    rt_memset(&item, 0, sizeof(item));
+    item.type = cJSON_Number;
+    cJSON_SetNumberHelper(&item, number);
+
+    return writer_put(writer, key, &item, 0);
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_WriteBool(cJSON_Writer *writer, const char *key, cJSON_bool boolean)
+{
+    cJSON item;
+
+    rt_memset(&item, 0, sizeof(item));
+    item.type = boolean ? cJSON_True : cJSON_False;
+
+    return writer_put(writer, key, &item, 0);
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_WriteNull(cJSON_Writer *writer, const char *key)
+{
+    cJSON item;
+
+    rt_memset(&item, 0, sizeof(item));
+    item.type = cJSON_NULL;
+
+    return writer_put(writer, key, &item, 0);
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_WriteRaw(cJSON_Writer *writer, const char *key, const char *raw)
+{
+    cJSON item;
+
+    rt_memset(&item, 0, sizeof(item));
+    item.type = cJSON_Raw;
+    item.valuestring = (char*)cast_away_const(raw);
+
+    return writer_put(writer, key, &item, 0);
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_WriteItem(cJSON_Writer *writer, const char *key, const cJSON *item)
+{
+    if (item == NULL)
+    {
+        if (writer != NULL)
+        {
+            writer->error = true;
+        }
+        return false;
+    }
+
+    return writer_put(writer, key, item, 0);
+}
+
+CJSON_PUBLIC(size_t) cJSON_WriterFinish(cJSON_Writer *writer)
+{
+    if ((writer == NULL) || writer->error || (writer->depth != 0) || (writer->need_comma == 0))
+    {
+        return 0;
+    }
+
+    if (writer->flush != NULL)
+    {
+        if ((writer->offset > 0) && !writer_flush(writer))
+        {
+            writer->error = true;
+            return 0;
+        }
+        return writer->flushed;
+    }
+
+    writer->buffer[writer->offset] = '\0';
+
+    return writer->offset;
+}
+#endif /* PKG_CJSON_USING_STREAM */
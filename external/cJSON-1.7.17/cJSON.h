@@ -293,6 +293,129 @@ CJSON_PUBLIC(char*) cJSON_SetValuestring(cJSON *object, const char *valuestring)
 CJSON_PUBLIC(void *) cJSON_malloc(size_t size);
 CJSON_PUBLIC(void) cJSON_free(void *object);
 
+/* Streaming and arena API, PKG_CJSON_USING_STREAM.
+ *
+ * cJSON_Arena: items and strings are taken from blocks and freed all at once
+ * by cJSON_ArenaReset. An arena DOM is read only: don't cJSON_Delete it, don't
+ * detach, replace or delete items of it.
+ *
+ * cJSON_Reader: pull parser, returns one token per call without building a
+ * tree. Keys and strings are decoded into the scratch buffer and are valid
+ * until the next call.
+ *
+ * cJSON_Writer: append-only writer into a buffer. When the buffer is full it
+ * is passed to flush, so a key with its value must fit in the buffer. Without
+ * flush the whole text must fit and is '\0' terminated by cJSON_WriterFinish.
+ */
+#ifndef CJSON_STREAM_DEPTH
+#define CJSON_STREAM_DEPTH 32 /* bits of an unsigned int */
+#endif
+
+typedef struct cJSON_ArenaBlock
+{
+    struct cJSON_ArenaBlock *next;
+    size_t size;
+} cJSON_ArenaBlock;
+
+typedef struct cJSON_Arena
+{
+    /* first buffer given by the user, never freed */
+    unsigned char *buffer;
+    size_t size;
+    /* blocks allocated when the first buffer is full, the newest one first */
+    cJSON_ArenaBlock *blocks;
+    size_t block_size;
+    /* free space of the current block */
+    unsigned char *pos;
+    unsigned char *end;
+    /* bytes taken since the last reset */
+    size_t used;
+} cJSON_Arena;
+
+typedef enum
+{
+    cJSON_ReadError,
+    cJSON_ReadEnd,
+    cJSON_ReadObjectStart,
+    cJSON_ReadObjectEnd,
+    cJSON_ReadArrayStart,
+    cJSON_ReadArrayEnd,
+    cJSON_ReadString,
+    cJSON_ReadNumber,
+    cJSON_ReadTrue,
+    cJSON_ReadFalse,
+    cJSON_ReadNull
+} cJSON_ReadToken;
+
+typedef struct cJSON_Reader
+{
+    const unsigned char *json;
+    size_t length;
+    size_t offset;
+    /* key of the value in an object, NULL in an array */
+    const char *key;
+    /* cJSON_ReadString */
+    const char *string;
+    /* cJSON_ReadNumber */
+    double valuedouble;
+    int valueint;
+    size_t depth;
+    /* bit n: level n + 1 is an object */
+    unsigned int objects;
+    cJSON_bool need_comma;
+    cJSON_bool done;
+    cJSON_Arena scratch;
+} cJSON_Reader;
+
+/* return false to stop writing */
+typedef cJSON_bool (*cJSON_WriterFlush)(void *user, const char *data, size_t length);
+
+typedef struct cJSON_Writer
+{
+    unsigned char *buffer;
+    size_t size;
+    size_t offset;
+    cJSON_WriterFlush flush;
+    void *user;
+    /* bytes flushed */
+    size_t flushed;
+    size_t depth;
+    /* bit n: level n + 1 is an object */
+    unsigned int objects;
+    /* bit n: level n has a value already */
+    unsigned int need_comma;
+    cJSON_bool error;
+} cJSON_Writer;
+
+/* block_size 0: buffer only, buffer NULL: blocks only */
+CJSON_PUBLIC(void) cJSON_ArenaInit(cJSON_Arena *arena, void *buffer, size_t size, size_t block_size);
+CJSON_PUBLIC(void *) cJSON_ArenaAlloc(cJSON_Arena *arena, size_t size);
+/* free everything taken from the arena, the blocks are given back to the heap */
+CJSON_PUBLIC(void) cJSON_ArenaReset(cJSON_Arena *arena);
+/* same as cJSON_ParseWithLength, the tree lives in the arena */
+CJSON_PUBLIC(cJSON *) cJSON_ParseArena(cJSON_Arena *arena, const char *value, size_t buffer_length);
+
+CJSON_PUBLIC(void) cJSON_ReaderInit(cJSON_Reader *reader, const char *json, size_t length, void *scratch, size_t scratch_size);
+CJSON_PUBLIC(cJSON_ReadToken) cJSON_ReaderNext(cJSON_Reader *reader);
+/* skip the rest of the object or array just started, false if the input is broken */
+CJSON_PUBLIC(cJSON_bool) cJSON_ReaderSkip(cJSON_Reader *reader);
+
+CJSON_PUBLIC(void) cJSON_WriterInit(cJSON_Writer *writer, char *buffer, size_t size, cJSON_WriterFlush flush, void *user);
+/* key is NULL in an array and at top level */
+CJSON_PUBLIC(cJSON_bool) cJSON_WriteObjectStart(cJSON_Writer *writer, const char *key);
+CJSON_PUBLIC(cJSON_bool) cJSON_WriteObjectEnd(cJSON_Writer *writer);
+CJSON_PUBLIC(cJSON_bool) cJSON_WriteArrayStart(cJSON_Writer *writer, const char *key);
+CJSON_PUBLIC(cJSON_bool) cJSON_WriteArrayEnd(cJSON_Writer *writer);
+CJSON_PUBLIC(cJSON_bool) cJSON_WriteString(cJSON_Writer *writer, const char *key, const char *string);
+CJSON_PUBLIC(cJSON_bool) cJSON_WriteNumber(cJSON_Writer *writer, const char *key, double number);
+CJSON_PUBLIC(cJSON_bool) cJSON_WriteBool(cJSON_Writer *writer, const char *key, cJSON_bool boolean);
+CJSON_PUBLIC(cJSON_bool) cJSON_WriteNull(cJSON_Writer *writer, const char *key);
+CJSON_PUBLIC(cJSON_bool) cJSON_WriteRaw(cJSON_Writer *writer, const char *key, const char *raw);
+/* write a tree unformatted, it must fit in the buffer */
+CJSON_PUBLIC(cJSON_bool) cJSON_WriteItem(cJSON_Writer *writer, const char *key, const cJSON *item);
+/* flush the rest, returns the total length or 0 on any error */
+CJSON_PUBLIC(size_t) cJSON_WriterFinish(cJSON_Writer *writer);
+
 #ifdef __cplusplus
 }
 #endif
@@ -311,14 +311,15 @@ uint32_t lv_draw_get_unit_count(void)
 lv_draw_task_t * lv_draw_get_next_available_task(lv_layer_t * layer, lv_draw_task_t * t_prev, uint8_t draw_unit_id)
 {
     LV_PROFILER_BEGIN;
-    /*If the first task is screen sized, there cannot be independent areas*/
+    /*If the first task is screen sized, there cannot be independent areas.
+     *Check the real area as tiles of a split task keep the original `area`*/
     if(layer->draw_task_head) {
         int32_t hor_res = lv_display_get_horizontal_resolution(lv_refr_get_disp_refreshing());
         int32_t ver_res = lv_display_get_vertical_resolution(lv_refr_get_disp_refreshing());
         lv_draw_task_t * t = layer->draw_task_head;
         if(t->state != LV_DRAW_TASK_STATE_QUEUED &&
-           t->area.x1 <= 0 && t->area.x2 >= hor_res - 1 &&
-           t->area.y1 <= 0 && t->area.y2 >= ver_res - 1) {
+           t->_real_area.x1 <= 0 && t->_real_area.x2 >= hor_res - 1 &&
+           t->_real_area.y1 <= 0 && t->_real_area.y2 >= ver_res - 1) {
             LV_PROFILER_END;
             return NULL;
         }
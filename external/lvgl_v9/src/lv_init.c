@@ -58,6 +58,9 @@
 #if LV_USE_DRAW_EPIC
     #include "lv_draw_epic.h"
 #endif
+#if LV_USE_DRAW_SW_TILE
+    #include "lvsf_draw_sched.h"
+#endif
 #if LV_USE_WINDOWS
     #include "drivers/windows/lv_windows_context.h"
 #endif
@@ -197,6 +200,11 @@ void lv_init(void)
     lv_draw_sw_init();
 #endif
 
+#if LV_USE_DRAW_SW_TILE
+    /*Before the GPU units, so they evaluate the tasks first*/
+    lvsf_draw_sched_init();
+#endif
+
 #if LV_USE_DRAW_VGLITE
     lv_draw_vglite_init();
 #endif
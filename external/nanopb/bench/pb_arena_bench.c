@@ -0,0 +1,485 @@
+/**
+  ******************************************************************************
+  * @file   pb_arena_bench.c
+  * @author Sifli software development team
+  * @brief Host benchmark of nanopb static, heap, arena and view decoding
+ *
+  * Build and run on host, rtthread.h here stands in for the kernel one:
+  *   gcc -O2 -I. -I.. -DPB_ENABLE_ARENA -Dpb_realloc=bench_realloc -Dpb_free=bench_free \
+  *       pb_arena_bench.c ../pb_common.c ../pb_decode.c ../pb_encode.c -o pb_arena_bench
+  *   ./pb_arena_bench [rounds]
+  *
+  * The same notification list is decoded into four layouts of one message:
+  * static arrays, pointer fields from the heap, pointer fields from an arena
+  * and pb_view_t fields into the input. The messages below are what the
+  * generator makes of
+  *
+  *   message Notify {
+  *       uint32 id = 1; string app = 2; string title = 3; bytes body = 4;
+  *       uint32 time = 5; repeated uint32 tags = 6; repeated string actions = 7;
+  *   }
+  *   message NotifyList { repeated Notify items = 1; }
+  *
+  * with FT_STATIC, FT_POINTER, and callback_datatype pb_view_t /
+  * pb_view_array_t with callback_function pb_view_field_callback.
+  ******************************************************************************
+*/
+/**
+ * @attention
+ * Copyright (c) 2019 - 2022,  Sifli Technology
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Sifli integrated circuit
+ *    in a product or a software update for such product, must reproduce the above
+ *    copyright notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Sifli nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Sifli integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY SIFLI TECHNOLOGY "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL SIFLI TECHNOLOGY OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "pb_encode.h"
+#include "pb_decode.h"
+
+#define BENCH_DEFAULT_ROUNDS (5000)
+#define BENCH_ITEMS          (20)
+#define BENCH_ARENA_SIZE     (16 * 1024)
+#define BENCH_WIRE_MAX       (8 * 1024)
+
+/************************ messages, as generated ******************************/
+
+typedef PB_BYTES_ARRAY_T(160) NotifyStatic_body_t;
+typedef struct _NotifyStatic
+{
+    uint32_t id;
+    char app[32];
+    char title[32];
+    NotifyStatic_body_t body;
+    uint32_t time;
+    pb_size_t tags_count;
+    uint32_t tags[8];
+    pb_size_t actions_count;
+    char actions[3][16];
+} NotifyStatic;
+
+typedef struct _NotifyListStatic
+{
+    pb_size_t items_count;
+    NotifyStatic items[BENCH_ITEMS];
+} NotifyListStatic;
+
+typedef struct _NotifyPtr
+{
+    uint32_t id;
+    char *app;
+    char *title;
+    pb_bytes_array_t *body;
+    uint32_t time;
+    pb_size_t tags_count;
+    uint32_t *tags;
+    pb_size_t actions_count;
+    char **actions;
+} NotifyPtr;
+
+typedef struct _NotifyListPtr
+{
+    pb_size_t items_count;
+    NotifyPtr *items;
+} NotifyListPtr;
+
+typedef struct _NotifyView
+{
+    uint32_t id;
+    pb_view_t app;
+    pb_view_t title;
+    pb_view_t body;
+    uint32_t time;
+    pb_size_t tags_count;
+    uint32_t *tags;
+    pb_view_array_t actions;
+} NotifyView;
+
+typedef struct _NotifyListView
+{
+    pb_size_t items_count;
+    NotifyView *items;
+} NotifyListView;
+
+#define NotifyStatic_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   id,                1) \
+X(a, STATIC,   SINGULAR, STRING,   app,               2) \
+X(a, STATIC,   SINGULAR, STRING,   title,             3) \
+X(a, STATIC,   SINGULAR, BYTES,    body,              4) \
+X(a, STATIC,   SINGULAR, UINT32,   time,              5) \
+X(a, STATIC,   REPEATED, UINT32,   tags,              6) \
+X(a, STATIC,   REPEATED, STRING,   actions,           7)
+#define NotifyStatic_CALLBACK NULL
+#define NotifyStatic_DEFAULT NULL
+
+#define NotifyListStatic_FIELDLIST(X, a) \
+X(a, STATIC,   REPEATED, MESSAGE,  items,             1)
+#define NotifyListStatic_CALLBACK NULL
+#define NotifyListStatic_DEFAULT NULL
+#define NotifyListStatic_items_MSGTYPE NotifyStatic
+
+#define NotifyPtr_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   id,                1) \
+X(a, POINTER,  SINGULAR, STRING,   app,               2) \
+X(a, POINTER,  SINGULAR, STRING,   title,             3) \
+X(a, POINTER,  SINGULAR, BYTES,    body,              4) \
+X(a, STATIC,   SINGULAR, UINT32,   time,              5) \
+X(a, POINTER,  REPEATED, UINT32,   tags,              6) \
+X(a, POINTER,  REPEATED, STRING,   actions,           7)
+#define NotifyPtr_CALLBACK NULL
+#define NotifyPtr_DEFAULT NULL
+
+#define NotifyListPtr_FIELDLIST(X, a) \
+X(a, POINTER,  REPEATED, MESSAGE,  items,             1)
+#define NotifyListPtr_CALLBACK NULL
+#define NotifyListPtr_DEFAULT NULL
+#define NotifyListPtr_items_MSGTYPE NotifyPtr
+
+#define NotifyView_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   id,                1) \
+X(a, CALLBACK, SINGULAR, STRING,   app,               2) \
+X(a, CALLBACK, SINGULAR, STRING,   title,             3) \
+X(a, CALLBACK, SINGULAR, BYTES,    body,              4) \
+X(a, STATIC,   SINGULAR, UINT32,   time,              5) \
+X(a, POINTER,  REPEATED, UINT32,   tags,              6) \
+X(a, CALLBACK, REPEATED, STRING,   actions,           7)
+#define NotifyView_CALLBACK pb_view_field_callback
+#define NotifyView_DEFAULT NULL
+
+#define NotifyListView_FIELDLIST(X, a) \
+X(a, POINTER,  REPEATED, MESSAGE,  items,             1)
+#define NotifyListView_CALLBACK NULL
+#define NotifyListView_DEFAULT NULL
+#define NotifyListView_items_MSGTYPE NotifyView
+
+#define NotifyStatic_fields &NotifyStatic_msg
+#define NotifyListStatic_fields &NotifyListStatic_msg
+#define NotifyPtr_fields &NotifyPtr_msg
+#define NotifyListPtr_fields &NotifyListPtr_msg
+#define NotifyView_fields &NotifyView_msg
+#define NotifyListView_fields &NotifyListView_msg
+
+PB_BIND(NotifyStatic, NotifyStatic, AUTO)
+PB_BIND(NotifyListStatic, NotifyListStatic, AUTO)
+PB_BIND(NotifyPtr, NotifyPtr, AUTO)
+PB_BIND(NotifyListPtr, NotifyListPtr, AUTO)
+PB_BIND(NotifyView, NotifyView, AUTO)
+PB_BIND(NotifyListView, NotifyListView, AUTO)
+
+/************************ heap accounting *************************************/
+
+static uint32_t heap_calls;
+static uint32_t heap_bytes;
+
+void *bench_realloc(void *ptr, size_t size)
+{
+    heap_calls++;
+    heap_bytes += size;
+    return realloc(ptr, size);
+}
+
+void bench_free(void *ptr)
+{
+    free(ptr);
+}
+
+static double bench_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/************************ payload *********************************************/
+
+static const char *app_list[] = {"com.tencent.mm", "com.android.mms", "com.whatsapp", "com.google.android.gm"};
+static const char *title_list[] = {"Alice", "Bob", "Chen Wei", "Dmitri", "Elena"};
+static const char *body_list[] = {"See you at 7?", "Your parcel 12345 is out for delivery, expected before 18:00",
+                                  "Meeting moved to 3pm, room 402", "Verification code: 482913"
+                                 };
+static const char *action_list[] = {"reply", "mark read", "mute"};
+
+static void bench_fill(NotifyListStatic *list)
+{
+    NotifyStatic *n;
+    uint32_t i;
+    uint32_t j;
+
+    memset(list, 0, sizeof(*list));
+    list->items_count = BENCH_ITEMS;
+    for (i = 0; i < BENCH_ITEMS; i++)
+    {
+        n = &list->items[i];
+        n->id = 70000 + i;
+        strcpy(n->app, app_list[i % 4]);
+        strcpy(n->title, title_list[i % 5]);
+        n->body.size = (pb_size_t)strlen(body_list[i % 4]);
+        memcpy(n->body.bytes, body_list[i % 4], n->body.size);
+        n->time = 1760860800 + i * 61;
+        n->tags_count = 1 + i % 8;
+        for (j = 0; j < n->tags_count; j++)
+        {
+            n->tags[j] = i * 1000 + j;
+        }
+        n->actions_count = i % 4;
+        for (j = 0; j < n->actions_count; j++)
+        {
+            strcpy(n->actions[j], action_list[j]);
+        }
+    }
+}
+
+/************************ checks against the static decode *******************/
+
+static int view_equal(const pb_view_t *view, const void *data, size_t size)
+{
+    return (view->size == size) && !memcmp(view->bytes, data, size);
+}
+
+static int check_ptr(const NotifyListStatic *ref, const NotifyListPtr *list)
+{
+    const NotifyStatic *a;
+    const NotifyPtr *b;
+    uint32_t i;
+    uint32_t j;
+
+    if (list->items_count != ref->items_count)
+    {
+        return -1;
+    }
+    for (i = 0; i < ref->items_count; i++)
+    {
+        a = &ref->items[i];
+        b = &list->items[i];
+        if (a->id != b->id || a->time != b->time || strcmp(a->app, b->app) || strcmp(a->title, b->title) ||
+                a->body.size != b->body->size || memcmp(a->body.bytes, b->body->bytes, a->body.size) ||
+                a->tags_count != b->tags_count || memcmp(a->tags, b->tags, a->tags_count * sizeof(uint32_t)) ||
+                a->actions_count != b->actions_count)
+        {
+            return -1;
+        }
+        for (j = 0; j < a->actions_count; j++)
+        {
+            if (strcmp(a->actions[j], b->actions[j]))
+            {
+                return -1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+static int check_view(const NotifyListStatic *ref, const NotifyListView *list)
+{
+    const NotifyStatic *a;
+    const NotifyView *b;
+    uint32_t i;
+    uint32_t j;
+
+    if (list->items_count != ref->items_count)
+    {
+        return -1;
+    }
+    for (i = 0; i < ref->items_count; i++)
+    {
+        a = &ref->items[i];
+        b = &list->items[i];
+        if (a->id != b->id || a->time != b->time || !view_equal(&b->app, a->app, strlen(a->app)) ||
+                !view_equal(&b->title, a->title, strlen(a->title)) ||
+                !view_equal(&b->body, a->body.bytes, a->body.size) ||
+                a->tags_count != b->tags_count || memcmp(a->tags, b->tags, a->tags_count * sizeof(uint32_t)) ||
+                a->actions_count != b->actions.count)
+        {
+            return -1;
+        }
+        for (j = 0; j < a->actions_count; j++)
+        {
+            if (!view_equal(&b->actions.items[j], a->actions[j], strlen(a->actions[j])))
+            {
+                return -1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+/* a stream which isn't a memory buffer, views must be copied to the arena */
+static bool bench_read(pb_istream_t *stream, pb_byte_t *buf, size_t count)
+{
+    const pb_byte_t **pos = (const pb_byte_t **)stream->state;
+
+    if (buf != NULL)
+    {
+        memcpy(buf, *pos, count);
+    }
+    *pos += count;
+
+    return true;
+}
+
+/************************ main ************************************************/
+
+static void report(const char *name, double t, uint32_t rounds, size_t wire, uint32_t calls, uint32_t bytes, size_t mem)
+{
+    printf("%-10s %8.2f us %7.1f MB/s %6.1f heap calls %7u heap bytes %6u struct+arena bytes\n",
+           name, t * 1e6 / rounds, (double)wire * rounds / t / 1e6, (double)calls / rounds,
+           bytes / rounds, (unsigned)mem);
+}
+
+int main(int argc, char **argv)
+{
+    static pb_byte_t arena_buf[BENCH_ARENA_SIZE];
+    static pb_byte_t wire[BENCH_WIRE_MAX];
+    static NotifyListStatic ref;
+    static NotifyListStatic list_static;
+    NotifyListPtr list_ptr;
+    NotifyListView list_view;
+    pb_arena_t arena;
+    pb_ostream_t ostream;
+    pb_istream_t istream;
+    const pb_byte_t *pos;
+    size_t wire_size;
+    size_t arena_used;
+    uint32_t rounds;
+    uint32_t r;
+    double t0;
+    int ok;
+
+    rounds = (argc > 1) ? atoi(argv[1]) : BENCH_DEFAULT_ROUNDS;
+    if (0 == rounds)
+    {
+        rounds = 1;
+    }
+
+    bench_fill(&ref);
+    ostream = pb_ostream_from_buffer(wire, sizeof(wire));
+    if (!pb_encode(&ostream, NotifyListStatic_fields, &ref))
+    {
+        printf("encode failed: %s\n", PB_GET_ERROR(&ostream));
+        return 1;
+    }
+    wire_size = ostream.bytes_written;
+    pb_arena_init(&arena, arena_buf, sizeof(arena_buf));
+
+    /* every layout must give the same message first */
+    istream = pb_istream_from_buffer(wire, wire_size);
+    ok = pb_decode(&istream, NotifyListStatic_fields, &list_static) &&
+         !memcmp(&list_static, &ref, sizeof(ref));
+    istream = pb_istream_from_buffer(wire, wire_size);
+    ok = ok && pb_decode(&istream, NotifyListPtr_fields, &list_ptr) && !check_ptr(&ref, &list_ptr);
+    pb_release(NotifyListPtr_fields, &list_ptr);
+    istream = pb_istream_from_buffer(wire, wire_size);
+    ok = ok && pb_decode_arena(&istream, NotifyListPtr_fields, &list_ptr, 0, &arena) && !check_ptr(&ref, &list_ptr);
+    pb_arena_reset(&arena);
+    istream = pb_istream_from_buffer(wire, wire_size);
+    ok = ok && pb_decode_arena(&istream, NotifyListView_fields, &list_view, 0, &arena) && !check_view(&ref, &list_view);
+    /* the views point into the wire buffer */
+    ok = ok && list_view.items[0].app.bytes > wire && list_view.items[0].app.bytes < wire + wire_size;
+    pb_arena_reset(&arena);
+    pos = wire;
+    istream.callback = bench_read;
+    istream.state = &pos;
+    istream.bytes_left = wire_size;
+    istream.errmsg = NULL;
+    istream.arena = NULL;
+    ok = ok && pb_decode_arena(&istream, NotifyListView_fields, &list_view, 0, &arena) && !check_view(&ref, &list_view);
+    ok = ok && list_view.items[0].app.bytes >= arena.buf && list_view.items[0].app.bytes < arena.buf + arena.size;
+    pb_arena_reset(&arena);
+    /* views encode back to the same bytes */
+    istream = pb_istream_from_buffer(wire, wire_size);
+    ok = ok && pb_decode_arena(&istream, NotifyListView_fields, &list_view, 0, &arena);
+    ostream = pb_ostream_from_buffer(arena_buf + arena.used, sizeof(arena_buf) - arena.used);
+    ok = ok && pb_encode(&ostream, NotifyListView_fields, &list_view) && ostream.bytes_written == wire_size &&
+         !memcmp(arena_buf + arena.used, wire, wire_size);
+    pb_arena_reset(&arena);
+    if (!ok)
+    {
+        printf("layouts don't match\n");
+        return 1;
+    }
+
+    printf("%u notifications, %u bytes on the wire, rounds %u\n", BENCH_ITEMS, (unsigned)wire_size, rounds);
+
+    heap_calls = heap_bytes = 0;
+    t0 = bench_now();
+    for (r = 0; r < rounds; r++)
+    {
+        istream = pb_istream_from_buffer(wire, wire_size);
+        pb_decode(&istream, NotifyListStatic_fields, &list_static);
+    }
+    report("static", bench_now() - t0, rounds, wire_size, heap_calls, heap_bytes, sizeof(list_static));
+
+    heap_calls = heap_bytes = 0;
+    t0 = bench_now();
+    for (r = 0; r < rounds; r++)
+    {
+        istream = pb_istream_from_buffer(wire, wire_size);
+        pb_decode(&istream, NotifyListPtr_fields, &list_ptr);
+        pb_release(NotifyListPtr_fields, &list_ptr);
+    }
+    report("heap", bench_now() - t0, rounds, wire_size, heap_calls, heap_bytes, sizeof(list_ptr));
+
+    heap_calls = heap_bytes = 0;
+    arena_used = 0;
+    t0 = bench_now();
+    for (r = 0; r < rounds; r++)
+    {
+        istream = pb_istream_from_buffer(wire, wire_size);
+        pb_decode_arena(&istream, NotifyListPtr_fields, &list_ptr, 0, &arena);
+        arena_used = arena.used;
+        pb_arena_reset(&arena);
+    }
+    report("arena", bench_now() - t0, rounds, wire_size, heap_calls, heap_bytes, sizeof(list_ptr) + arena_used);
+
+    heap_calls = heap_bytes = 0;
+    t0 = bench_now();
+    for (r = 0; r < rounds; r++)
+    {
+        istream = pb_istream_from_buffer(wire, wire_size);
+        pb_decode_arena(&istream, NotifyListView_fields, &list_view, 0, &arena);
+        arena_used = arena.used;
+        pb_arena_reset(&arena);
+    }
+    report("view", bench_now() - t0, rounds, wire_size, heap_calls, heap_bytes, sizeof(list_view) + arena_used);
+
+    return 0;
+}
+
+/************************ (C) COPYRIGHT Sifli Technology *******END OF FILE****/
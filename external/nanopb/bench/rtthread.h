@@ -0,0 +1,11 @@
+/* Host stand-in of rtthread.h for the nanopb benchmark only */
+#ifndef PB_BENCH_RTTHREAD_H
+#define PB_BENCH_RTTHREAD_H
+
+#include <stddef.h>
+
+/* heap accounting of pb_arena_bench.c, used as pb_realloc and pb_free */
+void *bench_realloc(void *ptr, size_t size);
+void bench_free(void *ptr);
+
+#endif
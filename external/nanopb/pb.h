@@ -13,6 +13,11 @@
 /* Enable support for dynamically allocated fields */
 /* #define PB_ENABLE_MALLOC 1 */
 
+/* Allocate pointer fields from a caller buffer (pb_decode_arena()) and
+ * decode bytes/string fields as views into the input (pb_view_t).
+ * Implies PB_ENABLE_MALLOC. */
+/* #define PB_ENABLE_ARENA 1 */
+
 /* Define this if your CPU / compiler combination does not support
  * unaligned memory access to packed structures. Note that packed
  * structures are only used when requested in .proto options. */
@@ -88,11 +93,19 @@
 #include <limits.h>
 #include "rtthread.h"
 
-#ifdef PB_ENABLE_MALLOC
+#if defined(PKG_NANOPB_USING_ARENA) && !defined(PB_ENABLE_ARENA)
+#define PB_ENABLE_ARENA 1
+#endif
+
+#if defined(PB_ENABLE_MALLOC) || defined(PB_ENABLE_ARENA)
 #include <stdlib.h>
 #endif
 #endif
 
+#if defined(PB_ENABLE_ARENA) && !defined(PB_ENABLE_MALLOC)
+#define PB_ENABLE_MALLOC 1
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -411,6 +424,42 @@ struct pb_callback_s {
 
 extern bool pb_default_field_callback(pb_istream_t *istream, pb_ostream_t *ostream, const pb_field_t *field);
 
+#ifdef PB_ENABLE_ARENA
+/* Memory for pointer fields, given to pb_decode_arena(). Allocations are
+ * never freed one by one, pb_arena_reset() drops all of them at once. */
+typedef struct pb_arena_s pb_arena_t;
+struct pb_arena_s {
+    pb_byte_t *buf;
+    size_t size;
+    size_t used;
+    /* Offset of the newest allocation, which can grow in place. */
+    size_t last;
+};
+
+/* Zero-copy bytes, string or submessage field. When decoding from
+ * pb_istream_from_buffer() it points into the input buffer, which must then
+ * outlive the message; from other streams the data is copied to the arena.
+ * Strings are not null terminated.
+ *
+ * Select it in the .options file of the generator:
+ *   Msg.field  callback_datatype:"pb_view_t"  (repeated: "pb_view_array_t")
+ *   Msg        callback_function:"pb_view_field_callback"
+ * All callback fields of such a message are then views.
+ */
+typedef struct pb_view_s {
+    const pb_byte_t *bytes;
+    pb_size_t size;
+} pb_view_t;
+
+/* Repeated view field, the items are taken from the arena. */
+typedef struct pb_view_array_s {
+    pb_view_t *items;
+    pb_size_t count;
+} pb_view_array_t;
+
+extern bool pb_view_field_callback(pb_istream_t *istream, pb_ostream_t *ostream, const pb_field_t *field);
+#endif
+
 /* Wire types. Library user needs these only in encoder callbacks. */
 typedef enum {
     PB_WT_VARINT = 0,
@@ -4,6 +4,10 @@
  */
 
 #include "pb_common.h"
+#ifdef PB_ENABLE_ARENA
+#include "pb_decode.h"
+#include "pb_encode.h"
+#endif
 
 static bool load_descriptor_values(pb_field_iter_t *iter)
 {
@@ -321,6 +325,23 @@ bool pb_default_field_callback(pb_istream_t *istream, pb_ostream_t *ostream, con
 
 }
 
+#ifdef PB_ENABLE_ARENA
+bool pb_view_field_callback(pb_istream_t *istream, pb_ostream_t *ostream, const pb_field_t *field)
+{
+    if (istream != NULL)
+    {
+        return pb_decode_view(istream, field);
+    }
+
+    if (ostream != NULL)
+    {
+        return pb_encode_view(ostream, field);
+    }
+
+    return true;
+}
+#endif
+
 #ifdef PB_VALIDATE_UTF8
 
 /* This function checks whether a string is valid UTF-8 text.
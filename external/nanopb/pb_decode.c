@@ -49,6 +49,13 @@ static bool checkreturn pb_release_union_field(pb_istream_t *stream, pb_field_it
 static void pb_release_single_field(pb_field_iter_t *field);
 #endif
 
+#ifdef PB_ENABLE_ARENA
+static void *pb_arena_realloc(pb_arena_t *arena, void *ptr, size_t size);
+#define pb_stream_arena(stream) ((stream)->arena != NULL)
+#else
+#define pb_stream_arena(stream) false
+#endif
+
 #ifdef PB_WITHOUT_64BIT
 #define pb_int64_t int32_t
 #define pb_uint64_t uint32_t
@@ -155,6 +162,9 @@ pb_istream_t pb_istream_from_buffer(const pb_byte_t *buf, size_t msglen)
     stream.bytes_left = msglen;
 #ifndef PB_NO_ERRMSG
     stream.errmsg = NULL;
+#endif
+#ifdef PB_ENABLE_ARENA
+    stream.arena = NULL;
 #endif
     return stream;
 }
@@ -588,6 +598,18 @@ static bool checkreturn allocate_field(pb_istream_t *stream, void *pData, size_t
         }
     }
     
+#ifdef PB_ENABLE_ARENA
+    if (stream->arena != NULL)
+    {
+        ptr = pb_arena_realloc(stream->arena, ptr, array_size * data_size);
+        if (ptr == NULL)
+            PB_RETURN_ERROR(stream, "arena full");
+
+        *(void**)pData = ptr;
+        return true;
+    }
+#endif
+
     /* Allocate new or expand previous allocation */
     /* Note: on failure the old pointer will remain in the structure,
      * the message must be freed by caller also on error return. */
@@ -628,7 +650,8 @@ static bool checkreturn decode_pointer_field(pb_istream_t *stream, pb_wire_type_
         case PB_HTYPE_REQUIRED:
         case PB_HTYPE_OPTIONAL:
         case PB_HTYPE_ONEOF:
-            if (PB_LTYPE_IS_SUBMSG(field->type) && *(void**)field->pField != NULL)
+            if (PB_LTYPE_IS_SUBMSG(field->type) && *(void**)field->pField != NULL &&
+                !pb_stream_arena(stream))
             {
                 /* Duplicate field, have to release the old allocation first. */
                 /* FIXME: Does this work correctly for oneofs? */
@@ -749,6 +772,12 @@ static bool checkreturn decode_callback_field(pb_istream_t *stream, pb_wire_type
     if (!field->descriptor->field_callback)
         return pb_skip_field(stream, wire_type);
 
+#ifdef PB_ENABLE_ARENA
+    /* A scalar is passed in a stack copy, a view of it would dangle */
+    if (field->descriptor->field_callback == pb_view_field_callback && wire_type != PB_WT_STRING)
+        PB_RETURN_ERROR(stream, "wrong wire type");
+#endif
+
     if (wire_type == PB_WT_STRING)
     {
         pb_istream_t substream;
@@ -938,6 +967,13 @@ static bool pb_field_set_to_default(pb_field_iter_t *field)
     else if (PB_ATYPE(type) == PB_ATYPE_CALLBACK)
     {
         /* Don't overwrite callback */
+#ifdef PB_ENABLE_ARENA
+        if (field->descriptor->field_callback == pb_view_field_callback)
+        {
+            /* Views are plain data */
+            memset(field->pData, 0, (size_t)field->data_size);
+        }
+#endif
     }
 
     return true;
@@ -1167,7 +1203,7 @@ bool checkreturn pb_decode_ex(pb_istream_t *stream, const pb_msgdesc_t *fields,
     }
     
 #ifdef PB_ENABLE_MALLOC
-    if (!status)
+    if (!status && !pb_stream_arena(stream))
         pb_release(fields, dest_struct);
 #endif
     
@@ -1181,13 +1217,159 @@ bool checkreturn pb_decode(pb_istream_t *stream, const pb_msgdesc_t *fields, voi
     status = pb_decode_inner(stream, fields, dest_struct, 0);
 
 #ifdef PB_ENABLE_MALLOC
-    if (!status)
+    if (!status && !pb_stream_arena(stream))
         pb_release(fields, dest_struct);
 #endif
 
     return status;
 }
 
+#ifdef PB_ENABLE_ARENA
+/* Every allocation starts with its capacity, so that it can be grown */
+#define PB_ARENA_ALIGN(x) (((x) + 7) & ~(size_t)7)
+#define PB_ARENA_HDR_SIZE PB_ARENA_ALIGN(sizeof(size_t))
+
+void pb_arena_init(pb_arena_t *arena, void *buf, size_t size)
+{
+    size_t skip = PB_ARENA_ALIGN((size_t)buf) - (size_t)buf;
+
+    if (buf == NULL || size < skip)
+    {
+        skip = size;
+    }
+
+    arena->buf = (pb_byte_t*)buf + skip;
+    arena->size = size - skip;
+    pb_arena_reset(arena);
+}
+
+void pb_arena_reset(pb_arena_t *arena)
+{
+    arena->used = 0;
+    arena->last = 0;
+}
+
+static void *pb_arena_realloc(pb_arena_t *arena, void *ptr, size_t size)
+{
+    pb_byte_t *item;
+    size_t capacity = 0;
+    size_t want;
+
+    if (size > arena->size)
+        return NULL;
+    size = PB_ARENA_ALIGN(size);
+
+    if (ptr != NULL)
+    {
+        capacity = *(size_t*)((pb_byte_t*)ptr - PB_ARENA_HDR_SIZE);
+        if (size <= capacity)
+            return ptr;
+
+        if ((pb_byte_t*)ptr == arena->buf + arena->last + PB_ARENA_HDR_SIZE)
+        {
+            /* The newest allocation grows in place */
+            if (size - capacity > arena->size - arena->used)
+                return NULL;
+
+            arena->used += size - capacity;
+            *(size_t*)(arena->buf + arena->last) = size;
+            return ptr;
+        }
+    }
+
+    /* A repeated field grows one item at a time. When other allocations
+     * come in between, double it so that it isn't copied for every item. */
+    want = (capacity * 2 > size) ? capacity * 2 : size;
+    if (PB_ARENA_HDR_SIZE + want > arena->size - arena->used)
+        want = size;
+    if (PB_ARENA_HDR_SIZE + want > arena->size - arena->used)
+        return NULL;
+
+    item = arena->buf + arena->used;
+    *(size_t*)item = want;
+    arena->last = arena->used;
+    arena->used += PB_ARENA_HDR_SIZE + want;
+    item += PB_ARENA_HDR_SIZE;
+
+    if (ptr != NULL)
+        memcpy(item, ptr, capacity);
+
+    return item;
+}
+
+bool checkreturn pb_decode_arena(pb_istream_t *stream, const pb_msgdesc_t *fields, void *dest_struct, unsigned int flags, pb_arena_t *arena)
+{
+    pb_arena_t *prev = stream->arena;
+    bool status;
+
+    stream->arena = arena;
+    status = pb_decode_ex(stream, fields, dest_struct, flags);
+    stream->arena = prev;
+
+    return status;
+}
+
+bool checkreturn pb_decode_view(pb_istream_t *stream, const pb_field_t *field)
+{
+    pb_view_t *view;
+    size_t size = stream->bytes_left;
+
+    if (PB_LTYPE(field->type) != PB_LTYPE_BYTES &&
+        PB_LTYPE(field->type) != PB_LTYPE_STRING &&
+        !PB_LTYPE_IS_SUBMSG(field->type))
+        PB_RETURN_ERROR(stream, "invalid view field");
+
+    if (size > PB_SIZE_MAX)
+        PB_RETURN_ERROR(stream, "bytes overflow");
+
+    if (PB_HTYPE(field->type) == PB_HTYPE_REPEATED)
+    {
+        pb_view_array_t *array = (pb_view_array_t*)field->pData;
+        pb_view_t *items;
+
+        if (stream->arena == NULL)
+            PB_RETURN_ERROR(stream, "no arena");
+
+        if (array->count == PB_SIZE_MAX)
+            PB_RETURN_ERROR(stream, "too many array entries");
+
+        items = (pb_view_t*)pb_arena_realloc(stream->arena, array->items, sizeof(pb_view_t) * ((size_t)array->count + 1));
+        if (items == NULL)
+            PB_RETURN_ERROR(stream, "arena full");
+
+        array->items = items;
+        view = &items[array->count++];
+    }
+    else
+    {
+        view = (pb_view_t*)field->pData;
+    }
+
+    view->size = (pb_size_t)size;
+
+#ifndef PB_BUFFER_ONLY
+    if (stream->callback != buf_read)
+    {
+        /* The input is gone after this call, keep a copy */
+        pb_byte_t *copy;
+
+        if (stream->arena == NULL)
+            PB_RETURN_ERROR(stream, "no arena");
+
+        copy = (pb_byte_t*)pb_arena_realloc(stream->arena, NULL, size + 1);
+        if (copy == NULL)
+            PB_RETURN_ERROR(stream, "arena full");
+
+        view->bytes = copy;
+        return pb_read(stream, copy, size);
+    }
+#endif
+
+    view->bytes = (const pb_byte_t*)stream->state;
+    return pb_read(stream, NULL, size);
+}
+#endif
+
 #ifdef PB_ENABLE_MALLOC
 /* Given an oneof field, if there has already been a field inside this oneof,
  * release it before overwriting with a different one. */
@@ -1208,7 +1390,8 @@ static bool pb_release_union_field(pb_istream_t *stream, pb_field_iter_t *field)
     if (!pb_field_iter_find(&old_field, old_tag))
         PB_RETURN_ERROR(stream, "invalid union tag");
 
-    pb_release_single_field(&old_field);
+    if (!pb_stream_arena(stream))
+        pb_release_single_field(&old_field);
 
     if (PB_ATYPE(field->type) == PB_ATYPE_POINTER)
     {
@@ -43,9 +43,17 @@ struct pb_istream_s
 #ifndef PB_NO_ERRMSG
     const char *errmsg;
 #endif
+
+#ifdef PB_ENABLE_ARENA
+    /* Pointer fields are allocated from here when not NULL,
+     * set by pb_decode_arena(). */
+    pb_arena_t *arena;
+#endif
 };
 
-#ifndef PB_NO_ERRMSG
+#if !defined(PB_NO_ERRMSG) && defined(PB_ENABLE_ARENA)
+#define PB_ISTREAM_EMPTY {0,0,0,0,0}
+#elif !defined(PB_NO_ERRMSG) || defined(PB_ENABLE_ARENA)
 #define PB_ISTREAM_EMPTY {0,0,0,0}
 #else
 #define PB_ISTREAM_EMPTY {0,0,0}
@@ -107,6 +115,25 @@ bool pb_decode_ex(pb_istream_t *stream, const pb_msgdesc_t *fields, void *dest_s
 #define pb_decode_delimited_noinit(s,f,d) pb_decode_ex(s,f,d, PB_DECODE_DELIMITED | PB_DECODE_NOINIT)
 #define pb_decode_nullterminated(s,f,d) pb_decode_ex(s,f,d, PB_DECODE_NULLTERMINATED)
 
+#ifdef PB_ENABLE_ARENA
+/* Use buf as arena, it is aligned for any field type. */
+void pb_arena_init(pb_arena_t *arena, void *buf, size_t size);
+
+/* Release everything allocated from the arena. Messages decoded into it are
+ * no longer valid. */
+void pb_arena_reset(pb_arena_t *arena);
+
+/* Same as pb_decode_ex(), but pointer fields and repeated views are taken
+ * from the arena instead of pb_realloc(). Nothing is allocated from the heap.
+ * Don't call pb_release() for the message, reset the arena instead. Pointer
+ * fields must not be set from a heap decode when using PB_DECODE_NOINIT.
+ */
+bool pb_decode_arena(pb_istream_t *stream, const pb_msgdesc_t *fields, void *dest_struct, unsigned int flags, pb_arena_t *arena);
+
+/* Decode a pb_view_t or pb_view_array_t field, see pb_view_field_callback(). */
+bool pb_decode_view(pb_istream_t *stream, const pb_field_t *field);
+#endif
+
 #ifdef PB_ENABLE_MALLOC
 /* Release any allocated pointer fields. If you use dynamic allocation, you should
  * call this for any successfully decoded message when you are done with it. If
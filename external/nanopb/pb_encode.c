@@ -720,6 +720,37 @@ bool checkreturn pb_encode_string(pb_ostream_t *stream, const pb_byte_t *buffer,
     return pb_write(stream, buffer, size);
 }
 
+#ifdef PB_ENABLE_ARENA
+bool checkreturn pb_encode_view(pb_ostream_t *stream, const pb_field_t *field)
+{
+    const pb_view_t *view = (const pb_view_t*)field->pData;
+    pb_size_t count = 1;
+
+    if (PB_HTYPE(field->type) == PB_HTYPE_REPEATED)
+    {
+        const pb_view_array_t *array = (const pb_view_array_t*)field->pData;
+        view = array->items;
+        count = array->count;
+    }
+    else if (view->bytes == NULL)
+    {
+        /* Not set */
+        return true;
+    }
+
+    for (; count > 0; count--, view++)
+    {
+        if (!pb_encode_tag_for_field(stream, field))
+            return false;
+
+        if (!pb_encode_string(stream, view->bytes, view->size))
+            return false;
+    }
+
+    return true;
+}
+#endif
+
 bool checkreturn pb_encode_submessage(pb_ostream_t *stream, const pb_msgdesc_t *fields, const void *src_struct)
 {
     /* First calculate the message size using a non-writing substream. */
@@ -178,6 +178,12 @@ bool pb_encode_float_as_double(pb_ostream_t *stream, float value);
  */
 bool pb_encode_submessage(pb_ostream_t *stream, const pb_msgdesc_t *fields, const void *src_struct);
 
+#ifdef PB_ENABLE_ARENA
+/* Encode a pb_view_t or pb_view_array_t field with its tag, see
+ * pb_view_field_callback(). */
+bool pb_encode_view(pb_ostream_t *stream, const pb_field_t *field);
+#endif
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -0,0 +1,550 @@
+/*********************
+ *      INCLUDES
+ *********************/
+#include "gui_app_int.h"
+
+#ifdef GUI_APP_RES_PREFETCH
+
+#include <dfs_posix.h>
+#if __has_include("app_mem.h")
+    #include "app_mem.h"
+    #define res_cache_alloc(size) app_cache_alloc(size, IMAGE_CACHE_PSRAM)
+    #define res_cache_free(p) app_cache_free(p)
+#else
+    #define res_cache_alloc(size) rt_malloc(size)
+    #define res_cache_free(p) rt_free(p)
+#endif
+
+#define DBG_TAG           "APP.RES"
+#define DBG_LVL          DBG_INFO //DBG_LOG //
+#include "rtdbg.h"
+
+#if !LV_USE_FS_POSIX
+    #error "GUI_APP_RES_PREFETCH works on LVGL posix file system driver, enable LV_USE_FS_POSIX"
+#endif
+
+#ifndef GUI_APP_RES_CACHE_SIZE
+    #define GUI_APP_RES_CACHE_SIZE  1024
+#endif
+#ifndef GUI_APP_RES_DECL_NUM
+    #define GUI_APP_RES_DECL_NUM    16
+#endif
+#define RES_CACHE_BYTES         (GUI_APP_RES_CACHE_SIZE * 1024)
+
+#define RES_LOADER_STACK_SIZE   2048
+#define RES_LOADER_PRIORITY     (RT_THREAD_PRIORITY_MAX * 2 / 3)
+#define RES_EVT_QUEUE           (1 << 0)
+#define RES_EVT_DONE            (1 << 1)
+
+typedef enum
+{
+    res_st_queued,
+    res_st_loading,
+    res_st_ready,
+    res_st_failed,
+} res_state_enum;
+
+typedef struct
+{
+    rt_list_t node;
+    char app_id[GUI_APP_ID_MAX_LEN];
+    char *path;                 //!< path passed to LVGL driver, without drive letter
+    uint8_t *data;
+    uint32_t size;
+    uint16_t ref;               //!< opened LVGL file handles
+    uint8_t state;
+    uint8_t pinned : 1;         //!< owner app is running
+    uint8_t drop : 1;           //!< free it once loading finished
+    rt_tick_t use_tick;
+} res_entry_t;
+
+typedef struct
+{
+    res_entry_t *e;             //!< NULL if file is not in cache
+    void *file_p;               //!< handle of original driver
+    uint32_t pos;
+} res_file_t;
+
+typedef struct
+{
+    const char *app_id;
+    const char *const *res;
+} res_decl_t;
+
+static struct rt_mutex res_lock;
+static struct rt_event res_evt;
+static rt_list_t res_list = RT_LIST_OBJECT_INIT(res_list);
+static uint32_t res_cache_used;
+static rt_thread_t res_loader;
+static res_decl_t res_decl[GUI_APP_RES_DECL_NUM];
+
+static lv_fs_drv_t *posix_drv;
+static lv_fs_drv_t orig_drv;
+
+static uint32_t stat_hit, stat_wait, stat_miss, stat_loaded, stat_evicted;
+static rt_tick_t stat_wait_tick;
+
+static const char *res_drv_path(const char *path)
+{
+    if ((LV_FS_POSIX_LETTER == path[0]) && (':' == path[1])) return path + 2;
+    return path;
+}
+
+static void res_entry_free(res_entry_t *e)
+{
+    rt_list_remove(&e->node);
+    if (e->data)
+    {
+        res_cache_free(e->data);
+        res_cache_used -= e->size;
+    }
+    rt_free(e->path);
+    rt_free(e);
+}
+
+static res_entry_t *res_find(const char *path)
+{
+    rt_list_t *pn;
+
+    rt_list_for_each(pn, &res_list)
+    {
+        res_entry_t *e = rt_list_entry(pn, res_entry_t, node);
+        if (0 == strcmp(e->path, path)) return e;
+    }
+
+    return NULL;
+}
+
+/* Free least recently used resources of stopped apps until 'size' bytes fit */
+static bool res_make_room(uint32_t size)
+{
+    while (res_cache_used + size > RES_CACHE_BYTES)
+    {
+        rt_list_t *pn;
+        res_entry_t *victim = NULL;
+
+        rt_list_for_each(pn, &res_list)
+        {
+            res_entry_t *e = rt_list_entry(pn, res_entry_t, node);
+
+            if ((res_st_ready != e->state) || e->pinned || e->ref) continue;
+            if ((NULL == victim) || ((rt_tick_t)(e->use_tick - victim->use_tick) > RT_TICK_MAX / 2))
+                victim = e;
+        }
+
+        if (NULL == victim) return false;
+
+        LOG_D("evict %s %d", victim->path, victim->size);
+        res_entry_free(victim);
+        stat_evicted++;
+    }
+
+    return true;
+}
+
+static void res_load(res_entry_t *e)
+{
+    char buf[256];
+    struct stat st;
+    uint8_t *data = NULL;
+    int fd;
+
+    rt_snprintf(buf, sizeof(buf), LV_FS_POSIX_PATH "%s", e->path);
+
+    fd = open(buf, O_RDONLY, 0);
+    if (fd >= 0)
+    {
+        if ((0 == fstat(fd, &st)) && (st.st_size > 0))
+        {
+            rt_mutex_take(&res_lock, RT_WAITING_FOREVER);
+            if (res_make_room(st.st_size))
+            {
+                data = res_cache_alloc(st.st_size);
+                if (data) res_cache_used += st.st_size;
+            }
+            rt_mutex_release(&res_lock);
+        }
+
+        if (data && (read(fd, data, st.st_size) != st.st_size))
+        {
+            rt_mutex_take(&res_lock, RT_WAITING_FOREVER);
+            res_cache_free(data);
+            res_cache_used -= st.st_size;
+            rt_mutex_release(&res_lock);
+            data = NULL;
+        }
+        close(fd);
+    }
+
+    rt_mutex_take(&res_lock, RT_WAITING_FOREVER);
+    e->data = data;
+    e->size = data ? st.st_size : 0;
+    e->state = data ? res_st_ready : res_st_failed;
+    e->use_tick = rt_tick_get();
+    if (data) stat_loaded++;
+    if (e->drop) res_entry_free(e);
+    rt_mutex_release(&res_lock);
+
+    LOG_D("load %s %s", buf, data ? "done" : "failed");
+}
+
+static void res_loader_entry(void *param)
+{
+    rt_uint32_t evt;
+
+    while (1)
+    {
+        res_entry_t *e = NULL;
+        rt_list_t *pn;
+
+        rt_mutex_take(&res_lock, RT_WAITING_FOREVER);
+        rt_list_for_each(pn, &res_list)
+        {
+            res_entry_t *p = rt_list_entry(pn, res_entry_t, node);
+            if (res_st_queued == p->state)
+            {
+                e = p;
+                e->state = res_st_loading;
+                break;
+            }
+        }
+        rt_mutex_release(&res_lock);
+
+        if (e)
+        {
+            res_load(e);
+            rt_event_send(&res_evt, RES_EVT_DONE);
+        }
+        else
+        {
+            rt_event_recv(&res_evt, RES_EVT_QUEUE, RT_EVENT_FLAG_OR | RT_EVENT_FLAG_CLEAR, RT_WAITING_FOREVER, &evt);
+        }
+    }
+}
+
+static void res_queue(const char *app_id, const char *const *res)
+{
+    bool queued = false;
+
+    rt_mutex_take(&res_lock, RT_WAITING_FOREVER);
+    for (; *res; res++)
+    {
+        const char *path = res_drv_path(*res);
+        res_entry_t *e = res_find(path);
+
+        if (NULL == e)
+        {
+            e = rt_malloc(sizeof(res_entry_t));
+            if (NULL == e) break;
+            memset(e, 0, sizeof(res_entry_t));
+            e->path = rt_strdup(path);
+            if (NULL == e->path)
+            {
+                rt_free(e);
+                break;
+            }
+            e->state = res_st_queued;
+            rt_list_insert_before(&res_list, &e->node);
+            queued = true;
+        }
+        else if (res_st_failed == e->state)
+        {
+            e->state = res_st_queued;
+            queued = true;
+        }
+
+        strncpy(e->app_id, app_id, sizeof(e->app_id) - 1);
+        e->pinned = 1;
+        e->drop = 0;
+    }
+    rt_mutex_release(&res_lock);
+
+    if (queued) rt_event_send(&res_evt, RES_EVT_QUEUE);
+}
+
+/**************     LVGL file system driver wrapper  **************/
+
+static void *res_fs_open(lv_fs_drv_t *drv, const char *path, lv_fs_mode_t mode)
+{
+    res_file_t *f = rt_malloc(sizeof(res_file_t));
+    res_entry_t *e;
+
+    if (NULL == f) return NULL;
+    memset(f, 0, sizeof(res_file_t));
+
+    if (LV_FS_MODE_RD == mode)
+    {
+        rt_tick_t start = rt_tick_get();
+        bool waited = false;
+
+        rt_mutex_take(&res_lock, RT_WAITING_FOREVER);
+        e = res_find(path);
+        while (e && (res_st_loading == e->state))
+        {
+            //Loader is reading it, waiting costs less than reading it again.
+            rt_uint32_t evt;
+
+            waited = true;
+            rt_mutex_release(&res_lock);
+            rt_event_recv(&res_evt, RES_EVT_DONE, RT_EVENT_FLAG_OR | RT_EVENT_FLAG_CLEAR, RT_TICK_PER_SECOND / 10, &evt);
+            rt_mutex_take(&res_lock, RT_WAITING_FOREVER);
+            e = res_find(path);
+        }
+
+        if (e && (res_st_ready == e->state))
+        {
+            e->ref++;
+            e->use_tick = rt_tick_get();
+            f->e = e;
+            if (waited)
+            {
+                stat_wait++;
+                stat_wait_tick += rt_tick_get() - start;
+            }
+            else
+            {
+                stat_hit++;
+            }
+        }
+        else if (e)
+        {
+            stat_miss++;
+        }
+        rt_mutex_release(&res_lock);
+
+        if (f->e) return f;
+    }
+
+    f->file_p = orig_drv.open_cb(drv, path, mode);
+    if (NULL == f->file_p)
+    {
+        rt_free(f);
+        return NULL;
+    }
+
+    return f;
+}
+
+static lv_fs_res_t res_fs_close(lv_fs_drv_t *drv, void *file_p)
+{
+    res_file_t *f = file_p;
+    lv_fs_res_t res = LV_FS_RES_OK;
+
+    if (f->e)
+    {
+        rt_mutex_take(&res_lock, RT_WAITING_FOREVER);
+        f->e->ref--;
+        if (f->e->drop && (0 == f->e->ref)) res_entry_free(f->e);
+        rt_mutex_release(&res_lock);
+    }
+    else
+    {
+        res = orig_drv.close_cb(drv, f->file_p);
+    }
+    rt_free(f);
+
+    return res;
+}
+
+static lv_fs_res_t res_fs_read(lv_fs_drv_t *drv, void *file_p, void *buf, uint32_t btr, uint32_t *br)
+{
+    res_file_t *f = file_p;
+
+    if (NULL == f->e) return orig_drv.read_cb(drv, f->file_p, buf, btr, br);
+
+    if (f->pos >= f->e->size)
+        btr = 0;
+    else if (btr > f->e->size - f->pos)
+        btr = f->e->size - f->pos;
+
+    memcpy(buf, f->e->data + f->pos, btr);
+    f->pos += btr;
+    *br = btr;
+
+    return LV_FS_RES_OK;
+}
+
+static lv_fs_res_t res_fs_write(lv_fs_drv_t *drv, void *file_p, const void *buf, uint32_t btw, uint32_t *bw)
+{
+    res_file_t *f = file_p;
+
+    if (f->e) return LV_FS_RES_DENIED;
+
+    return orig_drv.write_cb(drv, f->file_p, buf, btw, bw);
+}
+
+static lv_fs_res_t res_fs_seek(lv_fs_drv_t *drv, void *file_p, uint32_t pos, lv_fs_whence_t whence)
+{
+    res_file_t *f = file_p;
+
+    if (NULL == f->e) return orig_drv.seek_cb(drv, f->file_p, pos, whence);
+
+    switch (whence)
+    {
+    case LV_FS_SEEK_SET:
+        f->pos = pos;
+        break;
+    case LV_FS_SEEK_CUR:
+        f->pos += pos;
+        break;
+    case LV_FS_SEEK_END:
+        f->pos = f->e->size + pos;
+        break;
+    default:
+        return LV_FS_RES_INV_PARAM;
+    }
+
+    return LV_FS_RES_OK;
+}
+
+static lv_fs_res_t res_fs_tell(lv_fs_drv_t *drv, void *file_p, uint32_t *pos_p)
+{
+    res_file_t *f = file_p;
+
+    if (NULL == f->e) return orig_drv.tell_cb(drv, f->file_p, pos_p);
+
+    *pos_p = f->pos;
+
+    return LV_FS_RES_OK;
+}
+
+/**************     Framework APIs  **************/
+
+void app_res_init(void)
+{
+    if (res_loader) return;
+
+    posix_drv = lv_fs_get_drv(LV_FS_POSIX_LETTER);
+    RT_ASSERT(posix_drv);
+
+    rt_mutex_init(&res_lock, "app_res", RT_IPC_FLAG_PRIO);
+    rt_event_init(&res_evt, "app_res", RT_IPC_FLAG_PRIO);
+
+    res_loader = rt_thread_create("app_res", res_loader_entry, NULL,
+                                  RES_LOADER_STACK_SIZE, RES_LOADER_PRIORITY, RT_THREAD_TICK_DEFAULT);
+    RT_ASSERT(res_loader);
+    rt_thread_startup(res_loader);
+
+    memcpy(&orig_drv, posix_drv, sizeof(lv_fs_drv_t));
+    posix_drv->open_cb  = res_fs_open;
+    posix_drv->close_cb = res_fs_close;
+    posix_drv->read_cb  = res_fs_read;
+    posix_drv->write_cb = res_fs_write;
+    posix_drv->seek_cb  = res_fs_seek;
+    posix_drv->tell_cb  = res_fs_tell;
+}
+
+void app_res_app_launch(const char *app_id)
+{
+    if (NULL == res_loader) return;
+
+    for (uint32_t i = 0; i < GUI_APP_RES_DECL_NUM; i++)
+    {
+        if (res_decl[i].app_id && (0 == strcmp(res_decl[i].app_id, app_id)))
+        {
+            LOG_I("app[%s] prefetch declared resources", app_id);
+            res_queue(app_id, res_decl[i].res);
+            break;
+        }
+    }
+}
+
+void app_res_app_stop(const char *app_id)
+{
+    rt_list_t *pn, *tmp;
+
+    if (NULL == res_loader) return;
+
+    rt_mutex_take(&res_lock, RT_WAITING_FOREVER);
+    rt_list_for_each_safe(pn, tmp, &res_list)
+    {
+        res_entry_t *e = rt_list_entry(pn, res_entry_t, node);
+
+        if (0 != strcmp(e->app_id, app_id)) continue;
+
+        e->pinned = 0;
+#ifndef GUI_APP_RES_WARM_START
+        if ((res_st_loading == e->state) || e->ref)
+            e->drop = 1;
+        else
+            res_entry_free(e);
+#endif /* !GUI_APP_RES_WARM_START */
+    }
+    rt_mutex_release(&res_lock);
+}
+
+int gui_app_declare_res(const char *app_id, const char *const *res)
+{
+    res_decl_t *free_decl = NULL;
+
+    for (uint32_t i = 0; i < GUI_APP_RES_DECL_NUM; i++)
+    {
+        if (res_decl[i].app_id && (0 == strcmp(res_decl[i].app_id, app_id)))
+        {
+            res_decl[i].res = res;
+            return RT_EOK;
+        }
+        if ((NULL == res_decl[i].app_id) && (NULL == free_decl)) free_decl = &res_decl[i];
+    }
+
+    if (NULL == free_decl) return -RT_EFULL;
+
+    free_decl->res = res;
+    free_decl->app_id = app_id;
+
+    return RT_EOK;
+}
+
+int gui_app_prefetch_res(const char *const *res)
+{
+    gui_runing_app_t *app = app_schedule_get_active();
+
+    if ((NULL == res_loader) || (NULL == app)) return -RT_ERROR;
+
+    res_queue(app->id, res);
+
+    return RT_EOK;
+}
+
+#ifdef RT_USING_FINSH
+static void app_res(int argc, char **argv)
+{
+    rt_list_t *pn;
+    static const char *const st_name[] = {"queued", "loading", "ready", "failed"};
+
+    if ((argc > 1) && (0 == strcmp(argv[1], "reset")))
+    {
+        stat_hit = stat_wait = stat_miss = stat_loaded = stat_evicted = 0;
+        stat_wait_tick = 0;
+        return;
+    }
+
+    rt_mutex_take(&res_lock, RT_WAITING_FOREVER);
+    rt_list_for_each(pn, &res_list)
+    {
+        res_entry_t *e = rt_list_entry(pn, res_entry_t, node);
+        rt_kprintf("%-16s %-8s %8d %c%c ref=%d %s\n", e->app_id, st_name[e->state], e->size,
+                   e->pinned ? 'P' : '-', e->drop ? 'D' : '-', e->ref, e->path);
+    }
+    rt_mutex_release(&res_lock);
+
+    rt_kprintf("cache %d/%d bytes, loaded=%d evicted=%d\n", res_cache_used, RES_CACHE_BYTES, stat_loaded, stat_evicted);
+    rt_kprintf("open hit=%d wait=%d(%dms) miss=%d\n", stat_hit, stat_wait,
+               stat_wait_tick * 1000 / RT_TICK_PER_SECOND, stat_miss);
+}
+MSH_CMD_EXPORT(app_res, Show prefetched app resources);
+#endif /* RT_USING_FINSH */
+
+#else
+
+int gui_app_declare_res(const char *app_id, const char *const *res)
+{
+    return -RT_ENOSYS;
+}
+
+int gui_app_prefetch_res(const char *const *res)
+{
+    return -RT_ENOSYS;
+}
+
+#endif /* GUI_APP_RES_PREFETCH */
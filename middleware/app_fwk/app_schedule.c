@@ -157,6 +157,7 @@ static uint32_t app_scheduler_new(void);
 static void app_destory(rt_list_t *app_node);
 static void app_destory_list(rt_list_t *list);
 static uint32_t app_run(rt_mailbox_t msg_mbx, const _intent *i, uint32_t tick);
+static void app_first_frame_cb(void *user_data);
 static uint32_t app_run_by_id(rt_mailbox_t msg_mbx, const char *id);
 
 /************************************
@@ -1005,6 +1006,9 @@ static int app_do(gui_runing_app_t *p_app, app_exe_enum op)
 
     case APP_EXEC_SUSPEND:
     {
+#ifdef GUI_APP_RES_PREFETCH
+        app_res_app_stop(p_app->id);
+#endif
         //Move app node to the head of suspend_app_list
         rt_list_remove(&p_app->node);
         rt_list_insert_after(&suspend_app_list, &p_app->node);
@@ -1022,6 +1026,9 @@ static int app_do(gui_runing_app_t *p_app, app_exe_enum op)
     {
         app_entity_info app_info;
         rt_list_remove(&p_app->node);
+#ifdef GUI_APP_RES_PREFETCH
+        app_res_app_stop(p_app->id);
+#endif
 
         app_info.entry_func = (uint32_t) p_app->entry_f;
         app_info.user_data    = (uint32_t) p_app->app_data;
@@ -1048,7 +1055,7 @@ static int app_do(gui_runing_app_t *p_app, app_exe_enum op)
     return ret_v;
 }
 
-static int app_launch_new(const char *id, intent_t intent)
+static int app_launch_new(const char *id, intent_t intent, rt_tick_t tick)
 {
     int ret_v = -1;
     gui_runing_app_t *run_app;
@@ -1061,7 +1068,12 @@ static int app_launch_new(const char *id, intent_t intent)
         rt_list_init(&run_app->page_list);
         strcpy(run_app->id, id);
         memcpy(&(run_app->param), intent, sizeof(run_app->param));
+        run_app->launch_tick = tick ? tick : rt_tick_get();
 
+#ifdef GUI_APP_RES_PREFETCH
+        //Read declared resources while app entry and pages are creating UI
+        app_res_app_launch(id);
+#endif
         ret_v = app_do(run_app, APP_EXEC_LOAD);
 
         if (ret_v != 0)
@@ -1312,6 +1324,7 @@ static rt_err_t app_refr_page(rt_list_t *app_node, const char *page_id)
     {
         //find it.
         app_sche_d("[%s] refresh subpage[%s]", p_app->id, page_id);
+        app_trans_snapshot_cache_drop(p_to_page->scr);
 
         if (page_st_resumed == p_to_page->state)
         {
@@ -1388,6 +1401,18 @@ static void app_trans_anim_finish_callback(TransResult_T res)
 }
 #endif
 
+static void app_first_frame_cb(void *user_data)
+{
+    gui_runing_app_t *p_app = (gui_runing_app_t *) user_data;
+
+    if (0 == p_app->launch_tick) return;
+
+    p_app->ttff = tick_elaps(p_app->launch_tick) * 1000 / RT_TICK_PER_SECOND;
+    p_app->launch_tick = 0;
+
+    app_sche_i("app[%s] first frame in %dms, load&start cost %d ticks", p_app->id, p_app->ttff, p_app->tick_cnt);
+}
+
 static bool is_prev_page_wait_to_stop(gui_runing_app_t *p_app, subpage_node_t *subpage)
 {
     subpage_node_t *prev_subpage;
@@ -1644,6 +1669,7 @@ static uint32_t schedule_subpage(void)
                     old_scr = port_app_sche_get_act_scr();
                     cur_page->scr = port_app_sche_create_scr();
                     port_app_sche_load_scr(cur_page->scr);
+                    if (cur_app->launch_tick) port_app_sche_first_frame_cb(cur_page->scr, app_first_frame_cb, cur_app);
                     app_subpage_do(cur_app, cur_page, GUI_APP_MSG_ONSTART);
                     /*
                         revert old scr, cause we are not want to see new scr
@@ -2085,7 +2111,7 @@ void app_schedule_task(rt_mailbox_t msg_mbx)
                     else
                     {
                         /* no running entity*/
-                        app_launch_new(id, &(p_msg->content.intnt));
+                        app_launch_new(id, &(p_msg->content.intnt), p_msg->tick);
                     }
                 }
 
@@ -2444,8 +2470,8 @@ void display_app_list(rt_list_t *app_list)
         gui_runing_app_t *cur_app;
         cur_app = rt_list_entry(pn_app, gui_runing_app_t, node);
 
-        app_sche_i("app[%s] param[%s]  %x, state[%s], tgt_st[%s], tick_cnt=%d", cur_app->id, cur_app->param.content, cur_app,
-                   app_get_state_name(cur_app->state), app_get_state_name(cur_app->target_state), cur_app->tick_cnt);
+        app_sche_i("app[%s] param[%s]  %x, state[%s], tgt_st[%s], tick_cnt=%d, ttff=%dms", cur_app->id, cur_app->param.content, cur_app,
+                   app_get_state_name(cur_app->state), app_get_state_name(cur_app->target_state), cur_app->tick_cnt, cur_app->ttff);
 
         rt_list_for_each(pn_page, &cur_app->page_list)
         {
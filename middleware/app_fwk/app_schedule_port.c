@@ -17,6 +17,8 @@ screen_t port_app_sche_create_scr(void)
 
 void port_app_sche_del_scr(screen_t scr)
 {
+    /* A new screen may get the same address */
+    app_trans_snapshot_cache_drop(scr);
     lv_obj_del((lv_obj_t *) scr);
 }
 
@@ -52,6 +54,27 @@ uint32_t port_app_sche_get_user_data(screen_t scr)
     return (uint32_t) lv_obj_get_user_data((lv_obj_t *)scr);
 }
 
+#if !(defined(DISABLE_LVGL_V8)&&defined(DISABLE_LVGL_V9))
+static port_app_sche_frame_cb_t first_frame_cb;
+
+static void first_frame_event_handler(lv_event_t *e)
+{
+    lv_obj_t *scr = lv_event_get_current_target(e);
+
+    lv_obj_remove_event_cb(scr, first_frame_event_handler);
+    if (first_frame_cb) first_frame_cb(lv_event_get_user_data(e));
+}
+#endif
+
+void port_app_sche_first_frame_cb(screen_t scr, port_app_sche_frame_cb_t cb, void *user_data)
+{
+#if !(defined(DISABLE_LVGL_V8)&&defined(DISABLE_LVGL_V9))
+    //Screen finished drawing, either on display or into a trans-anim snapshot
+    first_frame_cb = cb;
+    lv_obj_add_event_cb((lv_obj_t *)scr, first_frame_event_handler, LV_EVENT_DRAW_POST_END, user_data);
+#endif
+}
+
 void port_app_sche_reset_indev(screen_t scr)
 {
 #if defined(DISABLE_LVGL_V8)&&defined(DISABLE_LVGL_V9)
@@ -38,6 +38,8 @@ void port_app_sche_reset_indev(screen_t scr);
 task_t port_app_sche_task_create(task_handler_t task_handler, uint32_t period, void *user_data);
 void port_app_sche_task_del(task_t task_handler);
 void port_app_sche_enable_indev(bool enable, bool expect_tp);
+typedef void (*port_app_sche_frame_cb_t)(void *user_data);
+void port_app_sche_first_frame_cb(screen_t scr, port_app_sche_frame_cb_t cb, void *user_data);
 
 #endif /* APP_SCHEDULE_PORT_H */
 
@@ -920,6 +920,9 @@ void gui_app_init(void)
 
 
         app_trans_animation_init();
+#ifdef GUI_APP_RES_PREFETCH
+        app_res_init();
+#endif
 
         app_schedule_change_main_app_id("Main");
 #ifdef GUI_MAX_RUNNING_APPS
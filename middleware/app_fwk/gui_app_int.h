@@ -84,6 +84,8 @@ typedef struct
     uint8_t target_state;
     uint8_t flag;
     uint32_t tick_cnt; //!< app running ticks(including subpage's ticks)
+    rt_tick_t launch_tick; //!< tick of launch request, 0 after first frame drawn
+    uint32_t ttff;     //!< time to first frame of last launch, in ms
 } gui_runing_app_t;
 
 typedef struct _subpage_node
@@ -348,6 +350,31 @@ rt_err_t app_trans_animation_reset(void);
 typedef void (*app_trans_ex_cb_t)(void);
 void app_trans_end_cb_register(app_trans_ex_cb_t callback);
 
+#ifdef GUI_APP_RES_PREFETCH
+void app_res_init(void);
+void app_res_app_launch(const char *app_id);
+void app_res_app_stop(const char *app_id);
+#endif /* GUI_APP_RES_PREFETCH */
+
+/**
+ * @brief Copy cached snapshot of a screen to buf
+ * @param scr  - screen
+ * @param buf  - snapshot buffer
+ * @param size - snapshot size in bytes
+ * @return true if snapshot is found in cache
+ */
+bool app_trans_snapshot_cache_load(const screen_t scr, void *buf, uint32_t size);
+
+/**
+ * @brief Save snapshot of a screen to cache, the least recently used one is replaced if cache is full
+ */
+void app_trans_snapshot_cache_save(const screen_t scr, const void *buf, uint32_t size);
+
+/**
+ * @brief Drop cached snapshot of a screen, drop all if scr is NULL
+ */
+void app_trans_snapshot_cache_drop(const screen_t scr);
+
 
 /**
  * @brief Enable/Disbale input event from ui framework.
@@ -11,9 +11,24 @@
 #ifndef _MSC_VER
     #include "drv_ext_dma.h"
 #endif
+#if __has_include("app_mem.h")
+    #include "app_mem.h"
+    #define snapshot_cache_alloc(size) app_cache_alloc(size, IMAGE_CACHE_PSRAM)
+    #define snapshot_cache_free(p) app_cache_free(p)
+#else
+    #define snapshot_cache_alloc(size) rt_malloc(size)
+    #define snapshot_cache_free(p) rt_free(p)
+#endif
 
 #define TRAN_ANIM_PLAY_TIME  300
 
+#ifndef APP_TRANS_ANIM_SNAPSHOT_CACHE_NUM
+    #define APP_TRANS_ANIM_SNAPSHOT_CACHE_NUM 0
+#endif
+#ifndef APP_TRANS_ANIM_SNAPSHOT_CACHE_AGE
+    #define APP_TRANS_ANIM_SNAPSHOT_CACHE_AGE 10000
+#endif
+
 
 
 #define trans_anim_log_i LOG_I
@@ -52,6 +67,41 @@ static app_trans_ex_cb_t app_trans_ex_cb = NULL;
 static uint32_t manual_animation_start_process;
 static void print_trans_anim_info(const char *prefix, const gui_app_trans_anim_t *cfg);
 
+#if APP_TRANS_ANIM_SNAPSHOT_CACHE_NUM > 0
+/*
+    Snapshots of screens which were left by a transition animation.
+    Pages in background are paused, so going back to one of them can use
+    the cached snapshot instead of rendering the whole screen again.
+*/
+typedef struct
+{
+    screen_t scr;
+    void *buf;
+    uint32_t size;
+    rt_tick_t save_tick;
+    rt_tick_t use_tick;
+} snapshot_cache_t;
+
+static snapshot_cache_t snapshot_cache[APP_TRANS_ANIM_SNAPSHOT_CACHE_NUM];
+#endif /* APP_TRANS_ANIM_SNAPSHOT_CACHE_NUM > 0 */
+
+#ifdef APP_TRANS_ANIM_STATISTICS
+typedef struct
+{
+    uint32_t count;         /* Transitions played */
+    uint32_t setup_ms;      /* Sum of snapshot and setup time */
+    uint32_t setup_max_ms;
+    uint32_t frames;
+    uint32_t frame_ms;      /* Sum of intervals between two frames */
+    uint32_t frame_max_ms;
+} trans_anim_stat_t;
+
+static trans_anim_stat_t trans_anim_stat[GUI_APP_TRANS_ANIM_CUSTOM + 1];
+static trans_anim_stat_t *trans_anim_stat_cur;
+static rt_tick_t trans_anim_frame_tick;
+static uint32_t snapshot_cache_hit, snapshot_cache_miss, snapshot_cache_expired;
+#endif /* APP_TRANS_ANIM_STATISTICS */
+
 
 static char *ma_state_name(manual_anim_state_t s)
 {
@@ -116,11 +166,164 @@ static gui_anim_value_t app_trans_anim_process_2_value(gui_anim_value_t start, g
 }
 
 
+#define TICK_TO_MS(t) ((t) * 1000 / RT_TICK_PER_SECOND)
+
+#if APP_TRANS_ANIM_SNAPSHOT_CACHE_NUM > 0
+static snapshot_cache_t *snapshot_cache_find(const screen_t scr)
+{
+    for (uint32_t i = 0; i < APP_TRANS_ANIM_SNAPSHOT_CACHE_NUM; i++)
+    {
+        if (snapshot_cache[i].buf && (snapshot_cache[i].scr == scr))
+            return &snapshot_cache[i];
+    }
+
+    return NULL;
+}
+
+static void snapshot_cache_release(snapshot_cache_t *c)
+{
+    if (c->buf)
+    {
+        trans_anim_log_d("snapshot_cache_release scr=%p, buf=%p", c->scr, c->buf);
+        snapshot_cache_free(c->buf);
+    }
+    memset(c, 0, sizeof(snapshot_cache_t));
+}
+#endif /* APP_TRANS_ANIM_SNAPSHOT_CACHE_NUM > 0 */
+
+bool app_trans_snapshot_cache_load(const screen_t scr, void *buf, uint32_t size)
+{
+#if APP_TRANS_ANIM_SNAPSHOT_CACHE_NUM > 0
+    snapshot_cache_t *c = snapshot_cache_find(scr);
+
+    if ((NULL == c) || (c->size != size))
+    {
+#ifdef APP_TRANS_ANIM_STATISTICS
+        snapshot_cache_miss++;
+#endif
+        return false;
+    }
+
+    if ((APP_TRANS_ANIM_SNAPSHOT_CACHE_AGE > 0)
+            && (TICK_TO_MS(rt_tick_get() - c->save_tick) > APP_TRANS_ANIM_SNAPSHOT_CACHE_AGE))
+    {
+#ifdef APP_TRANS_ANIM_STATISTICS
+        snapshot_cache_expired++;
+#endif
+        snapshot_cache_release(c);
+        return false;
+    }
+
+    memcpy(buf, c->buf, size);
+    c->use_tick = rt_tick_get();
+#ifdef APP_TRANS_ANIM_STATISTICS
+    snapshot_cache_hit++;
+#endif
+    trans_anim_log_i("snapshot_cache_load scr=%p hit", scr);
+    return true;
+#else
+    return false;
+#endif /* APP_TRANS_ANIM_SNAPSHOT_CACHE_NUM > 0 */
+}
+
+void app_trans_snapshot_cache_save(const screen_t scr, const void *buf, uint32_t size)
+{
+#if APP_TRANS_ANIM_SNAPSHOT_CACHE_NUM > 0
+    snapshot_cache_t *c = snapshot_cache_find(scr);
+
+    if (NULL == c)
+    {
+        /* Use a free slot, or the least recently used one */
+        c = &snapshot_cache[0];
+        for (uint32_t i = 0; i < APP_TRANS_ANIM_SNAPSHOT_CACHE_NUM; i++)
+        {
+            if (NULL == snapshot_cache[i].buf)
+            {
+                c = &snapshot_cache[i];
+                break;
+            }
+            if ((rt_tick_t)(c->use_tick - snapshot_cache[i].use_tick) < RT_TICK_MAX / 2)
+                c = &snapshot_cache[i];
+        }
+    }
+
+    if (c->buf && (c->size != size)) snapshot_cache_release(c);
+
+    if (NULL == c->buf)
+    {
+        c->buf = snapshot_cache_alloc(size);
+        if (NULL == c->buf)
+        {
+            trans_anim_log_i("snapshot_cache_save no memory, size=%d", size);
+            return;
+        }
+    }
+
+    memcpy(c->buf, buf, size);
+    c->scr = scr;
+    c->size = size;
+    c->save_tick = rt_tick_get();
+    c->use_tick = c->save_tick;
+    trans_anim_log_d("snapshot_cache_save scr=%p, buf=%p", scr, c->buf);
+#endif /* APP_TRANS_ANIM_SNAPSHOT_CACHE_NUM > 0 */
+}
+
+void app_trans_snapshot_cache_drop(const screen_t scr)
+{
+#if APP_TRANS_ANIM_SNAPSHOT_CACHE_NUM > 0
+    for (uint32_t i = 0; i < APP_TRANS_ANIM_SNAPSHOT_CACHE_NUM; i++)
+    {
+        if ((NULL == scr) || (snapshot_cache[i].scr == scr))
+            snapshot_cache_release(&snapshot_cache[i]);
+    }
+#endif /* APP_TRANS_ANIM_SNAPSHOT_CACHE_NUM > 0 */
+}
+
+#ifdef APP_TRANS_ANIM_STATISTICS
+static void trans_anim_stat_start(gui_app_trans_anim_type_t type, rt_tick_t s_tick)
+{
+    uint32_t ms = TICK_TO_MS(rt_tick_get() - s_tick);
+
+    if (type > GUI_APP_TRANS_ANIM_CUSTOM)
+    {
+        trans_anim_stat_cur = NULL;
+        return;
+    }
+
+    trans_anim_stat_cur = &trans_anim_stat[type];
+    trans_anim_stat_cur->count++;
+    trans_anim_stat_cur->setup_ms += ms;
+    if (ms > trans_anim_stat_cur->setup_max_ms) trans_anim_stat_cur->setup_max_ms = ms;
+    trans_anim_frame_tick = 0;
+}
+
+static void trans_anim_stat_frame(void)
+{
+    rt_tick_t now = rt_tick_get();
+
+    if (NULL == trans_anim_stat_cur) return;
+
+    if (trans_anim_frame_tick)
+    {
+        uint32_t ms = TICK_TO_MS(now - trans_anim_frame_tick);
+
+        trans_anim_stat_cur->frames++;
+        trans_anim_stat_cur->frame_ms += ms;
+        if (ms > trans_anim_stat_cur->frame_max_ms) trans_anim_stat_cur->frame_max_ms = ms;
+    }
+    trans_anim_frame_tick = now;
+}
+#endif /* APP_TRANS_ANIM_STATISTICS */
+
+
 static void app_trans_anim_clean(void)
 {
     bool is_manual_anim = false;
 
     app_trans_anim_free_run_clean();
+#ifdef APP_TRANS_ANIM_STATISTICS
+    trans_anim_stat_cur = NULL;
+#endif
 
     if (enter_anim_obj)
     {
@@ -238,6 +441,9 @@ static rt_err_t app_trans_anim_process(gui_anim_obj_t img, const gui_app_trans_a
 */
 static void anim_manual_control(gui_anim_value_t process)
 {
+#ifdef APP_TRANS_ANIM_STATISTICS
+    trans_anim_stat_frame();
+#endif
     if (app_trans_anim_back)
     {
         app_trans_anim_process(exit_anim_obj,  &exit_anim_cfg, FLAG_TRANS_ANIM_REVERSE | FLAG_TRANS_ANIM_FG, process);
@@ -525,6 +731,14 @@ rt_err_t app_trans_animation_setup(const gui_app_trans_anim_group_t *g_enter,
         app_trans_animation_obj_move_foreground(exit_anim_obj);
     }
 
+#ifdef APP_TRANS_ANIM_STATISTICS
+    //Count by the animation on foreground
+    if (is_back)
+        trans_anim_stat_start((GUI_APP_TRANS_ANIM_NONE != exit_anim_cfg.type) ? exit_anim_cfg.type : enter_anim_cfg.type, s_tick);
+    else
+        trans_anim_stat_start((GUI_APP_TRANS_ANIM_NONE != enter_anim_cfg.type) ? enter_anim_cfg.type : exit_anim_cfg.type, s_tick);
+#endif /* APP_TRANS_ANIM_STATISTICS */
+
     if (RT_EOK == err)
     {
         if (is_manual_anim)
@@ -754,6 +968,41 @@ rt_err_t app_trans_animation_reset(void)
     return RT_EOK;
 }
 
+#if defined(RT_USING_FINSH) && defined(APP_TRANS_ANIM_STATISTICS)
+static void trans_anim_stat_cmd(int argc, char **argv)
+{
+    static const char *const type_name[GUI_APP_TRANS_ANIM_CUSTOM + 1] =
+    {
+        "NONE", "PUSH_RIGHT_IN", "PUSH_RIGHT_OUT", "PUSH_LEFT_IN", "PUSH_LEFT_OUT", "ZOOM_IN", "ZOOM_OUT", "CUSTOM",
+    };
+
+    if ((argc > 1) && (0 == strcmp(argv[1], "reset")))
+    {
+        memset(trans_anim_stat, 0, sizeof(trans_anim_stat));
+        snapshot_cache_hit = 0;
+        snapshot_cache_miss = 0;
+        snapshot_cache_expired = 0;
+        return;
+    }
+
+    rt_kprintf("%-16s %6s %12s %8s %12s %6s\n", "type", "count", "setup(avg/max)", "frames", "frame(avg/max)", "fps");
+    for (uint32_t i = 0; i <= GUI_APP_TRANS_ANIM_CUSTOM; i++)
+    {
+        trans_anim_stat_t *st = &trans_anim_stat[i];
+        if (0 == st->count) continue;
+
+        rt_kprintf("%-16s %6d %7d/%-6d %8d %7d/%-6d %6d\n", type_name[i], st->count,
+                   st->setup_ms / st->count, st->setup_max_ms,
+                   st->frames,
+                   st->frames ? (st->frame_ms / st->frames) : 0, st->frame_max_ms,
+                   st->frame_ms ? (st->frames * 1000 / st->frame_ms) : 0);
+    }
+    rt_kprintf("snapshot cache(%d): hit=%d miss=%d expired=%d\n", APP_TRANS_ANIM_SNAPSHOT_CACHE_NUM,
+               snapshot_cache_hit, snapshot_cache_miss, snapshot_cache_expired);
+}
+MSH_CMD_EXPORT_ALIAS(trans_anim_stat_cmd, trans_anim_stat, Show app transition animation statistics);
+#endif /* RT_USING_FINSH && APP_TRANS_ANIM_STATISTICS */
+
 
 
 #else  /* APP_TRANS_ANIMATION_NONE */
@@ -831,6 +1080,11 @@ rt_err_t app_trans_animation_reset(void)
     return RT_EOK;
 }
 
+void app_trans_snapshot_cache_drop(const screen_t scr)
+{
+    return;
+}
+
 
 #endif /* APP_TRANS_ANIMATION_NONE */
 
@@ -201,6 +201,12 @@ gui_anim_obj_t app_trans_animation_obj_create(const screen_t scr, bool is_cur_sc
             trans_anim_log_d("app_trans_animation_setup: buf_act %d \n", lv_tick_get() - start);
         }
 
+        else if (app_trans_snapshot_cache_load(scr, (void *)screen_snapshot->data, screen_snapshot->data_size))
+        {
+            //Screen in background was not changed, use its last snapshot.
+            res = LV_RES_OK;
+        }
+
 
         if (LV_RES_OK != res) //draw new screen to buf_b
         {
@@ -246,6 +252,9 @@ gui_anim_obj_t app_trans_animation_obj_create(const screen_t scr, bool is_cur_sc
         }
 #endif /* SCALE_TRANS_ANIM_USE_DIVIDED_FB */
 
+        if (is_cur_screen)
+            app_trans_snapshot_cache_save(scr, screen_snapshot->data, screen_snapshot->data_size);
+
         ret_anim_obj = lv_img_create(lv_scr_act());
         RT_ASSERT(ret_anim_obj != NULL);
 
@@ -63,6 +63,9 @@
 
 
 #include "mp3dec.h"
+#ifdef AUDIO_MP3_SEEK_INDEX
+    #include "mp3_seek_index.h"
+#endif
 
 #define DBG_TAG           "audio"
 #define DBG_LVL           LOG_LVL_INFO
@@ -75,7 +78,11 @@
 #define FADE_OUT_TIME_MS      1000
 
 #define MP3_ONE_STEREO_FRAME_SIZE (MAX_NCHAN * MAX_NGRAN * MAX_NSAMP * 2)
-#define MP3_FRAME_CACHE_COUNT (4) // if not a2dp source, 2 is enough
+#ifdef AUDIO_MP3_DECODE_AHEAD_FRAMES
+    #define MP3_FRAME_CACHE_COUNT AUDIO_MP3_DECODE_AHEAD_FRAMES
+#else
+    #define MP3_FRAME_CACHE_COUNT (4) // if not a2dp source, 2 is enough
+#endif
 #define MP3_FRAME_CACHE_SIZE  (MP3_ONE_STEREO_FRAME_SIZE * MP3_FRAME_CACHE_COUNT + 10)
 
 //event flag
@@ -100,6 +107,15 @@
                        MP3_EVENT_FLAG_SEEK|MP3_EVENT_FLAG_CLOSE| \
                        MP3_EVENT_FLAG_DECODE|MP3_EVENT_FLAG_NEXT|MP3_EVENT_FLAG_RESUME)
 
+#ifdef AUDIO_MP3_READ_AHEAD
+//read ahead thread event
+#define MP3_RA_EVENT_FILL           (1 << 0)
+#define MP3_RA_EVENT_EXIT           (1 << 1)
+#define MP3_RA_STACK_SIZE           2048
+#define MP3_RA_BLOCK_SIZE           AUDIO_MP3_READ_AHEAD_BLOCK_SIZE
+#define MP3_RA_BLOCK_NUM            AUDIO_MP3_READ_AHEAD_BLOCK_NUM
+#endif
+
 typedef enum
 {
     MP3_PLAY    = 0,
@@ -119,8 +135,44 @@ typedef struct
     int                 next_fd;
     uint8_t             *next_buffer;
     uint8_t             next_is_file;
+#ifdef AUDIO_MP3_SEEK_INDEX
+    char                *next_index_path;
+#endif
 } mp3_cmt_t;
 
+#ifdef AUDIO_MP3_READ_AHEAD
+/*
+    file blocks read by a helper thread, decoder thread copies from filled
+    blocks in load_file_to_cache() instead of blocking in read().
+    state shared with reader is changed in critical section, reader owns fd
+    only while busy is set. stopping or closing waits on idle, released by
+    the reader when it leaves the fd or exits.
+*/
+typedef struct
+{
+    rt_thread_t     thread;
+    rt_event_t      event;
+    rt_sem_t        ready;      //released when a block is filled or eof
+    rt_sem_t        idle;       //released when the read waited for is done, or on exit
+    uint8_t         *buf;
+    uint32_t        read_pos;   //file offset of next block to read
+    uint32_t        pos;        //file offset of next byte to consume
+    uint32_t        start_pos;
+    uint16_t        len[MP3_RA_BLOCK_NUM];
+    uint16_t        rd_off;     //consumed bytes of block rd
+    uint8_t         rd;
+    uint8_t         wr;
+    uint8_t         count;      //filled blocks
+    uint8_t         running;
+    uint8_t         busy;
+    uint8_t         stopping;   //mp3_ra_stop waits for the read in progress
+    uint8_t         eof;
+#if defined(SYS_HEAP_IN_PSRAM)
+    uint8_t        *stack_addr;
+#endif
+} mp3_read_ahead_t;
+#endif
+
 struct mp3ctrl_t
 {
     uint32_t        magic;
@@ -137,6 +189,11 @@ struct mp3ctrl_t
 
     audio_server_callback_func callback;
     void                      *userdata;
+    mp3ctrl_stats_t           stats;
+    mp3_cmt_t                 *prefetch;  //next file to play without gap
+#ifdef AUDIO_MP3_READ_AHEAD
+    mp3_read_ahead_t          *ra;
+#endif
 
     uint8_t         *cache_ptr;
     uint8_t         *cache_read_ptr;
@@ -160,6 +217,12 @@ struct mp3ctrl_t
     uint32_t        wave_samplerate;
     uint8_t         wave_channels;
     uint8_t         is_record;
+#ifdef AUDIO_MP3_SEEK_INDEX
+    uint8_t         index_saved;
+    uint32_t        cache_end_pos;  //stream offset of the byte after cache data
+    mp3_seek_index_t *seek_index;
+    char            *index_path;    //file to save seek index, NULL if not saved
+#endif
 #if defined(SYS_HEAP_IN_PSRAM)
     uint8_t        *stack_addr;
 #endif
@@ -312,6 +375,238 @@ inline static void mp3_slist_unlock(mp3ctrl_handle handle)
     rt_mutex_release(handle->cmd_slist_mutex);
 }
 
+/* free a next command that was not consumed by replace() */
+static void mp3_cmd_free(mp3_cmt_t *p_cmd)
+{
+#if RT_USING_DFS
+    if (p_cmd->next_is_file && p_cmd->next_fd >= 0)
+        close(p_cmd->next_fd);
+#endif
+#ifdef AUDIO_MP3_SEEK_INDEX
+    if (p_cmd->next_index_path)
+        audio_mem_free(p_cmd->next_index_path);
+#endif
+    audio_mem_free(p_cmd);
+}
+
+#ifdef AUDIO_MP3_READ_AHEAD
+static void mp3_ra_thread_entry(void *parameter)
+{
+    mp3ctrl_handle ctrl = (mp3ctrl_handle)parameter;
+    mp3_read_ahead_t *ra = ctrl->ra;
+    rt_uint32_t evt;
+    uint32_t pos;
+    uint8_t blk;
+    uint8_t stopped;
+    int readed;
+
+    while (1)
+    {
+        rt_event_recv(ra->event, MP3_RA_EVENT_FILL | MP3_RA_EVENT_EXIT, RT_EVENT_FLAG_OR | RT_EVENT_FLAG_CLEAR, RT_WAITING_FOREVER, &evt);
+        if (evt & MP3_RA_EVENT_EXIT)
+            break;
+        while (1)
+        {
+            rt_enter_critical();
+            if (!ra->running || ra->eof || ra->count == MP3_RA_BLOCK_NUM)
+            {
+                rt_exit_critical();
+                break;
+            }
+            ra->busy = 1;
+            blk = ra->wr;
+            pos = ra->read_pos;
+            rt_exit_critical();
+
+            lseek(ctrl->fd, pos, SEEK_SET);
+            readed = read(ctrl->fd, ra->buf + blk * MP3_RA_BLOCK_SIZE, MP3_RA_BLOCK_SIZE);
+
+            rt_enter_critical();
+            ra->busy = 0;
+            stopped = ra->stopping;
+            ra->stopping = 0;
+            if (ra->running)
+            {
+                if (readed > 0)
+                {
+                    ra->len[blk] = (uint16_t)readed;
+                    ra->wr = (blk + 1) % MP3_RA_BLOCK_NUM;
+                    ra->count++;
+                    ra->read_pos = pos + readed;
+                }
+                if (readed < MP3_RA_BLOCK_SIZE)
+                    ra->eof = 1;
+            }
+            rt_exit_critical();
+            if (stopped)
+                rt_sem_release(ra->idle);
+            rt_sem_release(ra->ready);
+        }
+    }
+    rt_sem_release(ra->idle);
+}
+
+static void mp3_ra_stop(mp3ctrl_handle ctrl)
+{
+    mp3_read_ahead_t *ra = ctrl->ra;
+    uint8_t wait;
+    if (!ra)
+        return;
+    rt_enter_critical();
+    ra->running = 0;
+    wait = ra->busy;
+    ra->stopping = wait;
+    rt_exit_critical();
+    if (wait)
+        rt_sem_take(ra->idle, RT_WAITING_FOREVER);
+}
+
+/* drop buffered data and read from file offset pos */
+static void mp3_ra_start(mp3ctrl_handle ctrl, uint32_t pos)
+{
+    mp3_read_ahead_t *ra = ctrl->ra;
+    if (!ra)
+        return;
+    mp3_ra_stop(ctrl);
+    rt_enter_critical();
+    ra->rd = 0;
+    ra->wr = 0;
+    ra->count = 0;
+    ra->rd_off = 0;
+    ra->eof = 0;
+    ra->read_pos = pos;
+    ra->pos = pos;
+    ra->start_pos = pos;
+    ra->running = 1;
+    rt_exit_critical();
+    rt_event_send(ra->event, MP3_RA_EVENT_FILL);
+}
+
+static int mp3_ra_read(mp3ctrl_handle ctrl, uint8_t *buf, int len)
+{
+    mp3_read_ahead_t *ra = ctrl->ra;
+    uint32_t n;
+    uint8_t eof;
+    int total = 0;
+
+    while (total < len)
+    {
+        rt_enter_critical();
+        if (ra->count == 0)
+        {
+            eof = ra->eof;
+            rt_exit_critical();
+            if (eof)
+                break;
+            if (ra->pos != ra->start_pos)
+                ctrl->stats.read_stall++;
+            rt_event_send(ra->event, MP3_RA_EVENT_FILL);
+            rt_sem_take(ra->ready, RT_WAITING_FOREVER);
+            continue;
+        }
+        rt_exit_critical();
+
+        //block rd is not touched by reader until count is decreased
+        n = ra->len[ra->rd] - ra->rd_off;
+        if (n > (uint32_t)(len - total))
+            n = len - total;
+        memcpy(buf + total, ra->buf + ra->rd * MP3_RA_BLOCK_SIZE + ra->rd_off, n);
+        total += n;
+        ra->pos += n;
+        ra->rd_off += n;
+        if (ra->rd_off == ra->len[ra->rd])
+        {
+            ra->rd_off = 0;
+            rt_enter_critical();
+            ra->rd = (ra->rd + 1) % MP3_RA_BLOCK_NUM;
+            ra->count--;
+            rt_exit_critical();
+            rt_event_send(ra->event, MP3_RA_EVENT_FILL);
+        }
+    }
+    return total;
+}
+
+static void mp3_ra_open(mp3ctrl_handle ctrl)
+{
+    mp3_read_ahead_t *ra;
+    if (!ctrl->is_file)
+        return;
+    ra = audio_mem_calloc(1, sizeof(mp3_read_ahead_t));
+    if (!ra)
+        return;
+    ra->buf = audio_mem_malloc(MP3_RA_BLOCK_SIZE * MP3_RA_BLOCK_NUM);
+    ra->event = rt_event_create("mp3rd", RT_IPC_FLAG_FIFO);
+    ra->ready = rt_sem_create("mp3rd", 0, RT_IPC_FLAG_FIFO);
+    ra->idle = rt_sem_create("mp3rd", 0, RT_IPC_FLAG_FIFO);
+    if (!ra->buf || !ra->event || !ra->ready || !ra->idle)
+        goto Error;
+    ctrl->ra = ra;
+#if !defined(SYS_HEAP_IN_PSRAM)
+    ra->thread = rt_thread_create("mp3rd", mp3_ra_thread_entry, ctrl, MP3_RA_STACK_SIZE, RT_THREAD_PRIORITY_HIGH + 1, 10);
+#else
+    ra->stack_addr = (uint8_t *)app_sram_alloc(MP3_RA_STACK_SIZE);
+    ra->thread = audio_mem_malloc(sizeof(struct rt_thread));
+    if (ra->stack_addr && ra->thread
+            && RT_EOK != rt_thread_init(ra->thread, "mp3rd", mp3_ra_thread_entry, ctrl, ra->stack_addr, MP3_RA_STACK_SIZE, RT_THREAD_PRIORITY_HIGH + 1, 10))
+    {
+        audio_mem_free(ra->thread);
+        ra->thread = NULL;
+    }
+#endif
+    if (!ra->thread)
+    {
+        ctrl->ra = NULL;
+        goto Error;
+    }
+    rt_thread_startup(ra->thread);
+    mp3_ra_start(ctrl, lseek(ctrl->fd, 0, SEEK_CUR));
+    return;
+Error:
+    LOG_I("mp3 read ahead disabled");
+    if (ra->event)
+        rt_event_delete(ra->event);
+    if (ra->ready)
+        rt_sem_delete(ra->ready);
+    if (ra->idle)
+        rt_sem_delete(ra->idle);
+    if (ra->buf)
+        audio_mem_free(ra->buf);
+#if defined(SYS_HEAP_IN_PSRAM)
+    if (ra->stack_addr)
+        app_sram_free(ra->stack_addr);
+#endif
+    audio_mem_free(ra);
+}
+
+static void mp3_ra_close(mp3ctrl_handle ctrl)
+{
+    mp3_read_ahead_t *ra = ctrl->ra;
+    if (!ra)
+        return;
+    mp3_ra_stop(ctrl);
+    rt_event_send(ra->event, MP3_RA_EVENT_EXIT);
+    rt_sem_take(ra->idle, RT_WAITING_FOREVER);
+#if defined(SYS_HEAP_IN_PSRAM)
+    while ((ra->thread->stat & RT_THREAD_STAT_MASK) != RT_THREAD_CLOSE)
+        rt_thread_mdelay(2);
+    app_sram_free(ra->stack_addr);
+    audio_mem_free(ra->thread);
+#endif
+    rt_event_delete(ra->event);
+    rt_sem_delete(ra->ready);
+    rt_sem_delete(ra->idle);
+    audio_mem_free(ra->buf);
+    audio_mem_free(ra);
+    ctrl->ra = NULL;
+}
+#else
+#define mp3_ra_stop(ctrl)
+#define mp3_ra_start(ctrl, pos)
+#define mp3_ra_open(ctrl)
+#define mp3_ra_close(ctrl)
+#endif /* AUDIO_MP3_READ_AHEAD */
+
 static int load_file_to_cache(mp3ctrl_handle ctrl)
 {
     int readed = 0;
@@ -321,12 +616,17 @@ static int load_file_to_cache(mp3ctrl_handle ctrl)
         {
             memcpy(ctrl->cache_ptr, ctrl->cache_read_ptr, ctrl->cache_bytesLeft);
         }
-#if RT_USING_DFS
-        if (ctrl->is_file)
-            readed = read(ctrl->fd, ctrl->cache_ptr + ctrl->cache_bytesLeft, CACHE_BUF_SIZE - ctrl->cache_bytesLeft);
+#ifdef AUDIO_MP3_READ_AHEAD
+        if (ctrl->ra && ctrl->ra->running)
+            readed = mp3_ra_read(ctrl, ctrl->cache_ptr + ctrl->cache_bytesLeft, CACHE_BUF_SIZE - ctrl->cache_bytesLeft);
         else
 #endif
-            readed = buf_read(ctrl, ctrl->cache_ptr + ctrl->cache_bytesLeft, CACHE_BUF_SIZE - ctrl->cache_bytesLeft);
+#if RT_USING_DFS
+            if (ctrl->is_file)
+                readed = read(ctrl->fd, ctrl->cache_ptr + ctrl->cache_bytesLeft, CACHE_BUF_SIZE - ctrl->cache_bytesLeft);
+            else
+#endif
+                readed = buf_read(ctrl, ctrl->cache_ptr + ctrl->cache_bytesLeft, CACHE_BUF_SIZE - ctrl->cache_bytesLeft);
 
         ctrl->cache_read_ptr = ctrl->cache_ptr;
 
@@ -343,6 +643,20 @@ static int load_file_to_cache(mp3ctrl_handle ctrl)
         else
         {
             ctrl->cache_bytesLeft += readed;
+            ctrl->stats.read_bytes += readed;
+#ifdef AUDIO_MP3_SEEK_INDEX
+#ifdef AUDIO_MP3_READ_AHEAD
+            if (ctrl->ra && ctrl->ra->running)
+                ctrl->cache_end_pos = ctrl->ra->pos;
+            else
+#endif
+#if RT_USING_DFS
+                if (ctrl->is_file)
+                    ctrl->cache_end_pos = lseek(ctrl->fd, 0, SEEK_CUR);
+                else
+#endif
+                    ctrl->cache_end_pos = ctrl->fd;
+#endif
         }
 
     }
@@ -369,6 +683,139 @@ static int find_sync_in_cache(mp3ctrl_handle ctrl)
     return 0;
 }
 
+#ifdef AUDIO_MP3_SEEK_INDEX
+
+#define MP3_INDEX_FILE_EXT      ".sidx"
+
+static int mp3_index_read(void *ctx, uint32_t offset, uint8_t *buf, uint32_t len)
+{
+    mp3ctrl_handle ctrl = (mp3ctrl_handle)ctx;
+#if RT_USING_DFS
+    if (ctrl->is_file)
+    {
+        if (lseek(ctrl->fd, offset, SEEK_SET) < 0)
+            return -1;
+        return read(ctrl->fd, buf, len);
+    }
+#endif
+    buf_seek(ctrl, offset);
+    return buf_read(ctrl, buf, len);
+}
+
+static char *mp3_index_path(const char *filename)
+{
+#if defined(AUDIO_MP3_SEEK_INDEX_PERSIST) && RT_USING_DFS
+    char *path = audio_mem_malloc(strlen(filename) + sizeof(MP3_INDEX_FILE_EXT));
+    if (path)
+    {
+        strcpy(path, filename);
+        strcat(path, MP3_INDEX_FILE_EXT);
+    }
+    return path;
+#else
+    return NULL;
+#endif
+}
+
+static void mp3_index_load(mp3ctrl_handle ctrl)
+{
+#if defined(AUDIO_MP3_SEEK_INDEX_PERSIST) && RT_USING_DFS
+    mp3_seek_index_t *loaded;
+    int fd = open(ctrl->index_path, O_RDONLY | O_BINARY);
+    if (fd < 0)
+        return;
+    loaded = audio_mem_malloc(sizeof(mp3_seek_index_t));
+    if (loaded
+            && read(fd, loaded, sizeof(mp3_seek_index_t)) == sizeof(mp3_seek_index_t)
+            && mp3_seek_index_match(loaded, ctrl->seek_index))
+    {
+        memcpy(ctrl->seek_index, loaded, sizeof(mp3_seek_index_t));
+        ctrl->index_saved = 1;
+        LOG_I("mp3 index loaded frames=%d", loaded->total_frames);
+    }
+    close(fd);
+    if (loaded)
+        audio_mem_free(loaded);
+#endif
+}
+
+static void mp3_index_save(mp3ctrl_handle ctrl)
+{
+#if defined(AUDIO_MP3_SEEK_INDEX_PERSIST) && RT_USING_DFS
+    int fd;
+    if (!ctrl->seek_index || !ctrl->index_path || ctrl->index_saved || !ctrl->seek_index->complete)
+        return;
+    fd = open(ctrl->index_path, O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, 0);
+    if (fd < 0)
+    {
+        LOG_I("mp3 index save %s error", ctrl->index_path);
+        return;
+    }
+    if (write(fd, ctrl->seek_index, sizeof(mp3_seek_index_t)) == sizeof(mp3_seek_index_t))
+        ctrl->index_saved = 1;
+    close(fd);
+    if (!ctrl->index_saved)
+        unlink(ctrl->index_path);
+#endif
+}
+
+/* cache_read_ptr must point to the first frame found by get_frame_info(), return duration in ms, 0 if unknown */
+static uint32_t mp3_index_open(mp3ctrl_handle ctrl, char *index_path)
+{
+    uint32_t offset = ctrl->cache_end_pos - ctrl->cache_bytesLeft;
+
+    ctrl->index_path = index_path;
+    ctrl->index_saved = 0;
+    if (!ctrl->seek_index)
+    {
+        ctrl->seek_index = audio_mem_malloc(sizeof(mp3_seek_index_t));
+        if (!ctrl->seek_index)
+            return 0;
+    }
+    if (mp3_seek_index_init(ctrl->seek_index, ctrl->cache_read_ptr, ctrl->cache_bytesLeft, offset, ctrl->mp3_data_len) != 0)
+    {
+        audio_mem_free(ctrl->seek_index);
+        ctrl->seek_index = NULL;
+        return 0;
+    }
+    if (ctrl->index_path)
+        mp3_index_load(ctrl);
+    LOG_I("mp3 index toc=%d start=%d frames=%d", ctrl->seek_index->toc_type,
+          ctrl->seek_index->data_start, ctrl->seek_index->total_frames);
+    return mp3_seek_index_duration(ctrl->seek_index);
+}
+
+/* play to end, index the tail not seen by decoder and save */
+static void mp3_index_finish(mp3ctrl_handle ctrl)
+{
+    mp3_seek_index_t *idx = ctrl->seek_index;
+    if (!idx)
+        return;
+    if (!idx->complete && idx->scan_offset + CACHE_BUF_SIZE >= idx->data_end)
+    {
+        /* cache has no frame left, use it as scan buffer */
+        mp3_seek_index_scan(idx, mp3_index_read, ctrl, ctrl->cache_ptr, CACHE_BUF_SIZE, UINT32_MAX);
+        ctrl->cache_bytesLeft = 0;
+    }
+    mp3_index_save(ctrl);
+}
+
+static void mp3_index_close(mp3ctrl_handle ctrl)
+{
+    mp3_index_save(ctrl);
+    if (ctrl->seek_index)
+    {
+        audio_mem_free(ctrl->seek_index);
+        ctrl->seek_index = NULL;
+    }
+    if (ctrl->index_path)
+    {
+        audio_mem_free(ctrl->index_path);
+        ctrl->index_path = NULL;
+    }
+}
+#endif /* AUDIO_MP3_SEEK_INDEX */
+
 static mp3ctrl_handle g_handle1 = NULL;
 static mp3ctrl_handle g_handle2 = NULL;
 
@@ -381,6 +828,8 @@ static int mp3_audio_server_callback(audio_server_callback_cmt_t cmd, void *user
     if (cmd == as_callback_cmd_cache_half_empty || cmd == as_callback_cmd_cache_empty)
     {
         LOG_D("mp3 empty: ctrl=0x%x client=0x%x", ctrl, ctrl->client);
+        if (cmd == as_callback_cmd_cache_empty && !ctrl->is_file_end)
+            ctrl->stats.underrun++;
         rt_event_send(ctrl->event, MP3_EVENT_FLAG_DECODE);
         return 0;
     }
@@ -441,6 +890,10 @@ static void replace(mp3ctrl_handle ctrl)
     MP3FrameInfo frameinfo;
     uint32_t file_size;
     mp3_cmt_t  *p_cmd;
+    mp3_ra_stop(ctrl);
+#ifdef AUDIO_MP3_SEEK_INDEX
+    mp3_index_close(ctrl);
+#endif
 #if RT_USING_DFS
     if (ctrl->is_file && ctrl->fd >= 0)
     {
@@ -483,6 +936,12 @@ static void replace(mp3ctrl_handle ctrl)
     {
         ctrl->total_time_in_seconds = (ctrl->mp3_data_len - ctrl->tag_len) * 8 / frameinfo.bitrate;
         ctrl->bitrate = frameinfo.bitrate;
+#ifdef AUDIO_MP3_SEEK_INDEX
+        uint32_t duration = mp3_index_open(ctrl, p_cmd->next_index_path);
+        p_cmd->next_index_path = NULL;
+        if (duration)
+            ctrl->total_time_in_seconds = duration / 1000;
+#endif
         LOG_I("repalce time=%d channel=%d samprate=%d samps=%d",
               ctrl->total_time_in_seconds, frameinfo.nChans, frameinfo.samprate, frameinfo.outputSamps);
     }
@@ -500,7 +959,12 @@ static void replace(mp3ctrl_handle ctrl)
     else
 #endif
         buf_seek(ctrl, ctrl->tag_len);
+    mp3_ra_start(ctrl, ctrl->tag_len);
 
+#ifdef AUDIO_MP3_SEEK_INDEX
+    if (p_cmd->next_index_path)
+        audio_mem_free(p_cmd->next_index_path);
+#endif
     audio_mem_free(p_cmd);
     ctrl->cache_bytesLeft = 0;
 }
@@ -561,6 +1025,7 @@ static void mp3ctrl_thread_entry_file(void *parameter)
     int nFrames = 0;
     rt_uint32_t evt;
     LOG_I("mp3 run...ctrl=0x%x", ctrl);
+    mp3_ra_open(ctrl);
     while (1)
     {
         if (is_closing)
@@ -660,13 +1125,29 @@ static void mp3ctrl_thread_entry_file(void *parameter)
             p_cmd = rt_slist_entry(first, mp3_cmt_t, snode);
             rt_slist_remove(&ctrl->cmd_slist, first);
             mp3_slist_unlock(ctrl);
-            offset = (uint32_t)p_cmd->cmd_paramter1 * (uint64_t)ctrl->bitrate / 8;
+            mp3_ra_stop(ctrl);
+#ifdef AUDIO_MP3_SEEK_INDEX
+            uint32_t frame;
+            if (ctrl->seek_index
+                    && mp3_seek_index_locate(ctrl->seek_index, mp3_index_read, ctrl, ctrl->cache_ptr, CACHE_BUF_SIZE,
+                                             (uint32_t)p_cmd->cmd_paramter1 * 1000, &offset, &frame) == 0)
+            {
+                LOG_I("mp3 seek frame=%d offset=%d", frame, offset);
+                ctrl->frame_index = frame;
+                mp3_index_save(ctrl);
+            }
+            else
+#endif
+            {
+                offset = ctrl->tag_len + (uint32_t)p_cmd->cmd_paramter1 * (uint64_t)ctrl->bitrate / 8;
+            }
 #if RT_USING_DFS
             if (ctrl->is_file)
-                lseek(ctrl->fd, ctrl->tag_len + offset, SEEK_SET);
+                lseek(ctrl->fd, offset, SEEK_SET);
             else
 #endif
-                buf_seek(ctrl, ctrl->tag_len + offset);
+                buf_seek(ctrl, offset);
+            mp3_ra_start(ctrl, offset);
             ctrl->cache_bytesLeft = 0;
             ctrl->is_file_end = 0;
             audio_mem_free(p_cmd);
@@ -765,6 +1246,30 @@ look_write_result:
         if (find_sync_in_cache(ctrl) < 0)
         {
             uint32_t cache_time_ms = 150;
+            mp3_ra_stop(ctrl);
+#ifdef AUDIO_MP3_SEEK_INDEX
+            mp3_index_finish(ctrl);
+#endif
+            mp3_slist_lock(ctrl);
+            if (ctrl->prefetch && ctrl->loop_times == 0)
+            {
+                /* switch to prefetched file, keep decoder and output cache so there is no gap */
+                rt_slist_insert(&ctrl->cmd_slist, &ctrl->prefetch->snode);
+                ctrl->prefetch = NULL;
+                replace(ctrl);
+                mp3_slist_unlock(ctrl);
+                LOG_I("mp3--gapless next frame=%d", nFrames);
+                frame_err = 0;
+                nFrames = 0;
+                ctrl->frame_index = 0;
+                ctrl->last_display_seconds = -1;
+                ctrl->stats.gapless_switch++;
+                if (ctrl->callback)
+                    ctrl->callback(MP3CTRL_CALLBACK_NEXT_STARTED, ctrl->userdata, 0);
+                rt_event_send(ctrl->event, MP3_EVENT_FLAG_DECODE);
+                continue;
+            }
+            mp3_slist_unlock(ctrl);
             audio_ioctl(ctrl->client, 1, &cache_time_ms);
             rt_thread_mdelay(cache_time_ms + 20);
 
@@ -779,6 +1284,7 @@ look_write_result:
                 else
 #endif
                     buf_seek(ctrl, ctrl->tag_len + 0);
+                mp3_ra_start(ctrl, ctrl->tag_len);
                 LOG_I("mp3--loo frame=%d", nFrames);
 
                 ctrl->cache_read_ptr = ctrl->cache_ptr;
@@ -802,6 +1308,11 @@ look_write_result:
             continue;
         }
 
+#ifdef AUDIO_MP3_SEEK_INDEX
+        if (ctrl->seek_index)
+            mp3_seek_index_feed(ctrl->seek_index, ctrl->cache_end_pos - ctrl->cache_bytesLeft,
+                                ctrl->cache_read_ptr, ctrl->cache_bytesLeft);
+#endif
         int err = MP3Decode(hMP3Decoder, &ctrl->cache_read_ptr, &ctrl->cache_bytesLeft, outBuf, 0);
 
         nFrames++;
@@ -923,6 +1434,15 @@ look_write_result:
     ctrl->client = NULL;
     LOG_I("mp3 exit..nFrames=%d", nFrames);
     MP3FreeDecoder(hMP3Decoder);
+    mp3_ra_close(ctrl);
+    if (ctrl->prefetch)
+    {
+        mp3_cmd_free(ctrl->prefetch);
+        ctrl->prefetch = NULL;
+    }
+#ifdef AUDIO_MP3_SEEK_INDEX
+    mp3_index_close(ctrl);
+#endif
 #if RT_USING_DFS
     if (ctrl->is_file)
         close(ctrl->fd);
@@ -1457,6 +1977,11 @@ static mp3ctrl_handle mp3ctrl_open_real(audio_type_t type,
     {
         handle->total_time_in_seconds = (handle->mp3_data_len - handle->tag_len) * 8 / frameinfo.bitrate;
         handle->bitrate = frameinfo.bitrate;
+#ifdef AUDIO_MP3_SEEK_INDEX
+        uint32_t duration = mp3_index_open(handle, handle->is_file ? mp3_index_path(filename) : NULL);
+        if (duration)
+            handle->total_time_in_seconds = duration / 1000;
+#endif
         LOG_I("f=%d d=%d time=%d channel=%d samprate=%d samps=%d", file_size, handle->mp3_data_len,
               handle->total_time_in_seconds, frameinfo.nChans, frameinfo.samprate, frameinfo.outputSamps);
     }
@@ -1610,6 +2135,72 @@ PUBLIC_API int mp3ctrl_pause(mp3ctrl_handle handle)
     return 0;
 }
 
+static mp3_cmt_t *mp3_next_cmd_create(mp3ctrl_handle handle, mp3_ioctl_cmd_param_t *p)
+{
+    mp3_cmt_t *cmd_msg;
+    if ((p->len == -1 && handle->is_file == 0) || (p->len != -1 && handle->is_file))
+    {
+        LOG_E("error switch between file and buf");
+        return NULL;
+    }
+
+    cmd_msg = audio_mem_calloc(1, sizeof(mp3_cmt_t));
+    RT_ASSERT(cmd_msg);
+    cmd_msg->cmd = MP3_NEXT;
+#if RT_USING_DFS
+    if (p->len == -1)
+    {
+        cmd_msg->next_is_file = 1;
+        LOG_I("mp3 next %s", p->filename);
+        struct stat stat_buf;
+        stat(p->filename, &stat_buf);
+        cmd_msg->cmd_paramter1 = (void *)stat_buf.st_size;
+        cmd_msg->next_fd = open(p->filename, O_RDONLY | O_BINARY);
+        if (cmd_msg->next_fd < 0)
+        {
+            LOG_E("mp3 next %s error fd=%d", p->filename, cmd_msg->next_fd);
+            audio_mem_free(cmd_msg);
+            return NULL;
+        }
+        char riff[4] = {0};
+        read(cmd_msg->next_fd, riff, 4);
+        lseek(cmd_msg->next_fd, 0, SEEK_SET);
+        if ((!memcmp((const char *)riff, "RIFF", 4) && !handle->is_wave)
+                || (memcmp((const char *)riff, "RIFF", 4) && handle->is_wave))
+        {
+            close(cmd_msg->next_fd);
+Error:
+            audio_mem_free(cmd_msg);
+            LOG_E("error switch between mp3 and wav");
+            return NULL;
+        }
+
+    }
+    else
+#endif
+    {
+        LOG_I("mp3 next buffer");
+        if ((!memcmp((const char *)p->filename, "RIFF", 4) && !handle->is_wave)
+                || (memcmp((const char *)p->filename, "RIFF", 4) && handle->is_wave))
+        {
+#if RT_USING_DFS
+            goto Error;
+#else
+            audio_mem_free(cmd_msg);
+            LOG_E("error switch between mp3 and wav");
+            return NULL;
+#endif
+        }
+        cmd_msg->next_buffer = (uint8_t *)p->filename;
+        cmd_msg->cmd_paramter1 = (void *)p->len;
+    }
+#ifdef AUDIO_MP3_SEEK_INDEX
+    if (cmd_msg->next_is_file && !handle->is_wave)
+        cmd_msg->next_index_path = mp3_index_path(p->filename);
+#endif
+    return cmd_msg;
+}
+
 PUBLIC_API int mp3ctrl_ioctl(mp3ctrl_handle handle, int cmd, uint32_t param)
 {
     if (!handle || handle->magic != MP3_HANDLE_MAGIC)
@@ -1624,64 +2215,15 @@ PUBLIC_API int mp3ctrl_ioctl(mp3ctrl_handle handle, int cmd, uint32_t param)
         mp3_ioctl_cmd_param_t *p = (mp3_ioctl_cmd_param_t *)param;
         if (!p)
             return -1;
-
-        if ((p->len == -1 && handle->is_file == 0) || (p->len != -1 && handle->is_file))
-        {
-            LOG_E("error switch between file and buf");
+        mp3_cmt_t *cmd_msg = mp3_next_cmd_create(handle, p);
+        if (!cmd_msg)
             return -1;
-        }
-
-        mp3_cmt_t *cmd_msg = audio_mem_calloc(1, sizeof(mp3_cmt_t));
-        RT_ASSERT(cmd_msg);
-        cmd_msg->cmd = MP3_NEXT;
-#if RT_USING_DFS
-        if (p->len == -1)
-        {
-            cmd_msg->next_is_file = 1;
-            LOG_I("mp3 next %s", p->filename);
-            struct stat stat_buf;
-            stat(p->filename, &stat_buf);
-            cmd_msg->cmd_paramter1 = (void *)stat_buf.st_size;
-            cmd_msg->next_fd = open(p->filename, O_RDONLY | O_BINARY);
-            if (cmd_msg->next_fd < 0)
-            {
-                LOG_E("mp3 next %s error fd=%d", p->filename, cmd_msg->next_fd);
-                audio_mem_free(cmd_msg);
-                return -1;
-            }
-            char riff[4] = {0};
-            read(cmd_msg->next_fd, riff, 4);
-            lseek(cmd_msg->next_fd, 0, SEEK_SET);
-            if ((!memcmp((const char *)riff, "RIFF", 4) && !handle->is_wave)
-                    || (memcmp((const char *)riff, "RIFF", 4) && handle->is_wave))
-            {
-                close(cmd_msg->next_fd);
-Error:
-                audio_mem_free(cmd_msg);
-                LOG_E("error switch between mp3 and wav");
-                return -1;
-            }
-
-        }
-        else
-#endif
+        mp3_slist_lock(handle);
+        if (handle->prefetch)
         {
-            LOG_I("mp3 next buffer");
-            if ((!memcmp((const char *)p->filename, "RIFF", 4) && !handle->is_wave)
-                    || (memcmp((const char *)p->filename, "RIFF", 4) && handle->is_wave))
-            {
-#if RT_USING_DFS
-                goto Error;
-#else
-                audio_mem_free(cmd_msg);
-                LOG_E("error switch between mp3 and wav");
-                return -1;
-#endif
-            }
-            cmd_msg->next_buffer = (uint8_t *)p->filename;
-            cmd_msg->cmd_paramter1 = (void *)p->len;
+            mp3_cmd_free(handle->prefetch);
+            handle->prefetch = NULL;
         }
-        mp3_slist_lock(handle);
         rt_slist_append(&handle->cmd_slist, &cmd_msg->snode);
         mp3_slist_unlock(handle);
         rt_event_send(handle->event, MP3_EVENT_FLAG_NEXT);
@@ -1696,6 +2238,30 @@ Error:
         rt_thread_control(handle->thread, RT_THREAD_CTRL_CHANGE_PRIORITY, &priority);
         return 0;
     }
+    if (cmd == 3)
+    {
+        mp3_ioctl_cmd_param_t *p = (mp3_ioctl_cmd_param_t *)param;
+        if (!p || handle->is_wave)
+            return -1;
+        mp3_cmt_t *cmd_msg = mp3_next_cmd_create(handle, p);
+        if (!cmd_msg)
+            return -1;
+        mp3_slist_lock(handle);
+        if (handle->prefetch)
+            mp3_cmd_free(handle->prefetch);
+        handle->prefetch = cmd_msg;
+        mp3_slist_unlock(handle);
+        LOG_I("mp3ctrl prefetch ok");
+        return 0;
+    }
+    if (cmd == 4)
+    {
+        mp3ctrl_stats_t *stats = (mp3ctrl_stats_t *)param;
+        if (!stats)
+            return -1;
+        memcpy(stats, &handle->stats, sizeof(mp3ctrl_stats_t));
+        return 0;
+    }
     return -1;
 }
 
@@ -1746,6 +2312,19 @@ int mp3ctrl_getinfo(const char *filename, mp3_info_t *info)
     if (handle->is_wave == 0 && get_frame_info(handle, &frameinfo) == 0)
     {
         info->total_time_in_seconds = (handle->mp3_data_len - handle->tag_len) * 8 / frameinfo.bitrate;
+#ifdef AUDIO_MP3_SEEK_INDEX
+        uint32_t duration = mp3_index_open(handle, mp3_index_path(filename));
+#ifdef AUDIO_MP3_SEEK_INDEX_SCAN_ON_INFO
+        if (!duration && handle->seek_index)
+        {
+            mp3_seek_index_scan(handle->seek_index, mp3_index_read, handle, handle->cache_ptr, CACHE_BUF_SIZE, UINT32_MAX);
+            duration = mp3_seek_index_duration(handle->seek_index);
+        }
+#endif
+        if (duration)
+            info->total_time_in_seconds = duration / 1000;
+        mp3_index_close(handle);
+#endif
         info->samplerate = frameinfo.samprate;
         info->channels = frameinfo.nChans;
         info->one_channel_sampels = frameinfo.outputSamps / frameinfo.nChans;
@@ -1930,7 +2509,8 @@ static void mp3(uint8_t argc, char **argv)
 
     if (argc < 3)
     {
-        rt_kprintf("usage: \r\n    mp3 open  filename.mp3 type\r\n    mp3 pause 1/2\r\n    mp3 close 1/2\r\n");
+        rt_kprintf("usage: \r\n    mp3 open  filename.mp3 type\r\n    mp3 pause 1/2\r\n    mp3 close 1/2\r\n"
+                   "    mp3 prefetch filename.mp3\r\n    mp3 stat 1/2\r\n");
         return;
     }
     if (strcmp(argv[1], "stress") == 0)
@@ -2086,6 +2666,31 @@ again:
         }
         LOG_I("next none");
     }
+    else if (strcmp(argv[1], "prefetch") == 0)
+    {
+        if (g_handle1)
+        {
+            mp3_ioctl_cmd_param_t para;
+            para.filename = argv[2];
+            para.len = -1;
+            mp3ctrl_ioctl(g_handle1, 0, 0);
+            mp3ctrl_ioctl(g_handle1, 3, (uint32_t)&para);
+            return;
+        }
+        LOG_I("prefetch none");
+    }
+    else if (strcmp(argv[1], "stat") == 0)
+    {
+        mp3ctrl_handle h = (argv[2][0] == '2') ? g_handle2 : g_handle1;
+        mp3ctrl_stats_t stats;
+        if (h && mp3ctrl_ioctl(h, 4, (uint32_t)&stats) == 0)
+        {
+            rt_kprintf("underrun=%d read_stall=%d read_bytes=%d gapless=%d\n",
+                       stats.underrun, stats.read_stall, stats.read_bytes, stats.gapless_switch);
+            return;
+        }
+        LOG_I("stat none");
+    }
 }
 
 MSH_CMD_EXPORT(mp3, mp3 commnad);
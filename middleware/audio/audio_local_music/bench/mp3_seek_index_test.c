@@ -0,0 +1,305 @@
+/**
+  ******************************************************************************
+  * @file   mp3_seek_index_test.c
+  * @author Sifli software development team
+  * @brief Host test of the mp3 seek index
+ *
+  * Build and run on host:
+  *   gcc -O2 -Wall -I. -I.. mp3_seek_index_test.c ../mp3_seek_index.c -o mp3_seek_index_test
+  *   ./mp3_seek_index_test
+  *
+  * Synthetic MPEG1 layer 3 streams with a Xing, Info or VBRI header, or none
+  * at all, are indexed and every seek is checked against the frame offsets
+  * the stream was built with.
+  ******************************************************************************
+*/
+/**
+ * @attention
+ * Copyright (c) 2024 - 2024,  Sifli Technology
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Sifli integrated circuit
+ *    in a product or a software update for such product, must reproduce the above
+ *    copyright notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Sifli nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Sifli integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY SIFLI TECHNOLOGY "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL SIFLI TECHNOLOGY OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "mp3_seek_index.h"
+
+#define ID3_SIZE        100
+#define FRAME_NUM       1000
+#define VBRI_FPE        10
+#define SAMPLERATE      44100
+#define FRAME_SAMPLES   1152
+
+enum
+{
+    STREAM_CBR,
+    STREAM_VBR,
+    STREAM_INFO,
+    STREAM_XING,
+    STREAM_VBRI,
+};
+
+static const char *stream_name[] = {"cbr", "vbr", "info", "xing", "vbri"};
+
+/* MPEG1 layer 3 kbps by bitrate index */
+static const uint16_t kbps[15] = {0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320};
+
+static uint8_t *stream;
+static uint32_t stream_size;
+static uint32_t frame_offset[FRAME_NUM + 1];
+static uint32_t hdr_offset, hdr_len;
+static uint32_t rand_seed = 1;
+
+static uint32_t test_rand(void)
+{
+    rand_seed = rand_seed * 1103515245 + 12345;
+    return (rand_seed >> 16) & 0x7FFF;
+}
+
+static void wr_be32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+static void wr_be16(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)(v >> 8);
+    p[1] = (uint8_t)v;
+}
+
+/* 44.1 kHz stereo frame, payload zeroed so it never looks like a sync word */
+static uint32_t frame_put(uint8_t *p, uint32_t br_idx)
+{
+    uint32_t len = 144 * kbps[br_idx] * 1000 / SAMPLERATE;
+
+    memset(p, 0, len);
+    p[0] = 0xFF;
+    p[1] = 0xFB;
+    p[2] = (uint8_t)(br_idx << 4);
+    p[3] = 0x00;
+    return len;
+}
+
+static void stream_build(int type)
+{
+    uint32_t pos, i, br_idx;
+    uint8_t *p;
+
+    stream = malloc(ID3_SIZE + 1441 * (FRAME_NUM + 1) + 128);
+    memset(stream, 0, ID3_SIZE);
+    memcpy(stream, "ID3", 3);
+    pos = ID3_SIZE;
+
+    hdr_offset = pos;
+    hdr_len = 0;
+    if (type == STREAM_INFO || type == STREAM_XING || type == STREAM_VBRI)
+    {
+        hdr_len = frame_put(stream + pos, 9);
+        pos += hdr_len;
+    }
+
+    for (i = 0; i < FRAME_NUM; i++)
+    {
+        br_idx = (type == STREAM_CBR || type == STREAM_INFO) ? 9 : 1 + test_rand() % 14;
+        frame_offset[i] = pos;
+        pos += frame_put(stream + pos, br_idx);
+    }
+    frame_offset[FRAME_NUM] = pos;
+
+    /* ID3v1 behind the last frame */
+    memset(stream + pos, 0, 128);
+    memcpy(stream + pos, "TAG", 3);
+    stream_size = pos + 128;
+
+    /* Xing/Info after the side info, VBRI 32 bytes after the frame header */
+    p = stream + hdr_offset;
+    if (type == STREAM_INFO || type == STREAM_XING)
+    {
+        p += 4 + 32;
+        memcpy(p, type == STREAM_INFO ? "Info" : "Xing", 4);
+        wr_be32(p + 4, 0x07);
+        wr_be32(p + 8, FRAME_NUM);
+        wr_be32(p + 12, frame_offset[FRAME_NUM] - hdr_offset);
+        for (i = 0; i < 100; i++)
+        {
+            uint32_t off = frame_offset[FRAME_NUM * i / 100] - hdr_offset;
+            p[16 + i] = (uint8_t)((uint64_t)off * 256 / (frame_offset[FRAME_NUM] - hdr_offset));
+        }
+    }
+    else if (type == STREAM_VBRI)
+    {
+        uint32_t n = FRAME_NUM / VBRI_FPE;
+
+        p += 4 + 32;
+        memcpy(p, "VBRI", 4);
+        wr_be16(p + 4, 1);
+        wr_be32(p + 10, frame_offset[FRAME_NUM] - hdr_offset);
+        wr_be32(p + 14, FRAME_NUM);
+        wr_be16(p + 18, n);
+        wr_be16(p + 20, 1);
+        wr_be16(p + 22, 2);
+        wr_be16(p + 24, VBRI_FPE);
+        /* the first entry counts the header frame as well */
+        for (i = 0; i < n; i++)
+        {
+            uint32_t from = i ? frame_offset[i * VBRI_FPE] : hdr_offset;
+            wr_be16(p + 26 + i * 2, frame_offset[(i + 1) * VBRI_FPE] - from);
+        }
+    }
+}
+
+static int stream_read(void *ctx, uint32_t offset, uint8_t *buf, uint32_t len)
+{
+    (void)ctx;
+    if (offset >= stream_size)
+        return 0;
+    if (len > stream_size - offset)
+        len = stream_size - offset;
+    memcpy(buf, stream + offset, len);
+    return (int)len;
+}
+
+static uint32_t frame_ms(uint32_t frame)
+{
+    /* middle of the frame, away from the rounding of the boundaries */
+    return (uint32_t)(((uint64_t)frame * FRAME_SAMPLES + FRAME_SAMPLES / 2) * 1000 / SAMPLERATE);
+}
+
+static int frame_of(uint32_t offset)
+{
+    int lo = 0, hi = FRAME_NUM - 1, mid;
+
+    while (lo <= hi)
+    {
+        mid = (lo + hi) / 2;
+        if (frame_offset[mid] == offset)
+            return mid;
+        if (frame_offset[mid] < offset)
+            lo = mid + 1;
+        else
+            hi = mid - 1;
+    }
+    return -1;
+}
+
+static int stream_test(int type)
+{
+    static mp3_seek_index_t idx;
+    static uint8_t buf[4096];
+    static const uint32_t targets[] = {0, 1, 63, 64, 65, 127, 500, 998, 999, 2000, 420, 5};
+    uint32_t i, offset, frame, target, tolerance;
+    uint32_t start;
+    int found, errors = 0;
+
+    rand_seed = 1;
+    stream_build(type);
+    start = hdr_len ? hdr_offset : frame_offset[0];
+    if (mp3_seek_index_init(&idx, stream + start, stream_size - start, start, stream_size) != 0)
+    {
+        printf("%-5s init fail\n", stream_name[type]);
+        free(stream);
+        return 1;
+    }
+    if (idx.data_start != frame_offset[0])
+    {
+        printf("%-5s data start %u, expect %u\n", stream_name[type], idx.data_start, frame_offset[0]);
+        errors++;
+    }
+
+    /* the first frames come from playing */
+    if (type == STREAM_VBR || type == STREAM_CBR)
+        for (i = 0; i < 40; i++)
+            mp3_seek_index_feed(&idx, frame_offset[i], stream + frame_offset[i], 4);
+
+    /* the Xing TOC is accurate to the byte resolution of a percent */
+    tolerance = (type == STREAM_XING) ? FRAME_NUM / 100 + 1 : 0;
+    for (i = 0; i < sizeof(targets) / sizeof(targets[0]); i++)
+    {
+        target = targets[i] < FRAME_NUM ? targets[i] : FRAME_NUM - 1;
+        if (mp3_seek_index_locate(&idx, stream_read, NULL, buf, sizeof(buf), frame_ms(targets[i]),
+                                  &offset, &frame) != 0)
+        {
+            printf("%-5s seek to %u fail\n", stream_name[type], targets[i]);
+            errors++;
+            continue;
+        }
+        found = frame_of(offset);
+        if (found < 0 || frame != target ||
+                (uint32_t)abs(found - (int)target) > tolerance)
+        {
+            printf("%-5s seek to %u: offset %u frame %d, reported %u\n", stream_name[type],
+                   targets[i], offset, found, frame);
+            errors++;
+        }
+    }
+
+    if (type != STREAM_XING && type != STREAM_INFO && !idx.complete)
+    {
+        printf("%-5s index not complete\n", stream_name[type]);
+        errors++;
+    }
+    if (idx.total_frames != FRAME_NUM)
+    {
+        printf("%-5s %u frames, expect %u\n", stream_name[type], idx.total_frames, FRAME_NUM);
+        errors++;
+    }
+    if (mp3_seek_index_duration(&idx) != (uint32_t)((uint64_t)FRAME_NUM * FRAME_SAMPLES * 1000 / SAMPLERATE))
+    {
+        printf("%-5s duration %u ms\n", stream_name[type], mp3_seek_index_duration(&idx));
+        errors++;
+    }
+
+    printf("%-5s toc %u, %4u frames, %2u entries every %2u frames: %s\n", stream_name[type],
+           idx.toc_type, idx.total_frames, idx.count, idx.interval, errors ? "FAIL" : "ok");
+    free(stream);
+    return errors;
+}
+
+int main(void)
+{
+    int errors = 0;
+    int type;
+
+    for (type = STREAM_CBR; type <= STREAM_VBRI; type++)
+        errors += stream_test(type);
+
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,8 @@
+/* Host stand-in of rtconfig.h for the mp3 seek index test only */
+#ifndef MP3_SEEK_TEST_RTCONFIG_H
+#define MP3_SEEK_TEST_RTCONFIG_H
+
+/* smallest index, so the long streams exercise the interval doubling */
+#define AUDIO_MP3_SEEK_INDEX_NUM 64
+
+#endif
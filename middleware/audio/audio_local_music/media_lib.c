@@ -0,0 +1,1017 @@
+/**
+  ******************************************************************************
+  * @file   media_lib.c
+  * @author Sifli software development team
+  * @brief  Media library index: directory scan, tag cache and sorted listing.
+ *
+  ******************************************************************************
+*/
+/**
+ * @attention
+ * Copyright (c) 2024 - 2024,  Sifli Technology
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Sifli integrated circuit
+ *    in a product or a software update for such product, must reproduce the above
+ *    copyright notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Sifli nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Sifli integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY SIFLI TECHNOLOGY "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL SIFLI TECHNOLOGY OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#include <rtthread.h>
+#include <string.h>
+#include <stdlib.h>
+#include "os_adaptor.h"
+#include "dfs_posix.h"
+#include "audio_mp3ctrl.h"
+#include "media_lib.h"
+#ifdef SOLUTION_WATCH
+    #include "app_mem.h"
+#endif
+
+#define DBG_TAG           "mlib"
+#define DBG_LVL           LOG_LVL_INFO
+#include "log.h"
+
+#undef audio_mem_malloc
+#undef audio_mem_free
+#ifdef SOLUTION_WATCH
+    #define audio_mem_malloc    app_malloc
+    #define audio_mem_free      app_free
+#else
+    #define audio_mem_malloc    rt_malloc
+    #define audio_mem_free      rt_free
+#endif
+
+/*
+    index file layout, all offsets from file start:
+
+    mlib_hdr_t
+    uint32_t rec_off[count]                     record offsets
+    uint16_t order[MEDIA_LIB_SORT_NUM][count]   record numbers in sort order
+    records, each mlib_rec_t followed by title, artist, album and path,
+    every string NUL terminated, record padded to 4 bytes
+*/
+#define MLIB_MAGIC              0x42494C4Du   /* "MLIB" */
+#define MLIB_VERSION            1
+#define MLIB_MAX_FILES          0xFFFF
+#define MLIB_MAX_DEPTH          8
+#define MLIB_TMP_EXT            ".tmp"
+#define MLIB_REC_MAX            (sizeof(mlib_rec_t) + 3 * MEDIA_LIB_TAG_MAX + MEDIA_LIB_PATH_MAX)
+#define MLIB_SCAN_STACK_SIZE    3072
+#define MLIB_ALIGN4(n)          (((n) + 3) & ~3u)
+
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t rec_size;      /* sizeof(mlib_rec_t) */
+    uint32_t count;
+    uint32_t table_off;
+    uint32_t order_off;
+    uint32_t data_off;
+    uint32_t file_size;
+    uint32_t generation;    /* bumped on every rewrite */
+} mlib_hdr_t;
+
+typedef struct
+{
+    uint32_t size;
+    uint32_t mtime;
+    uint32_t duration;
+    uint32_t audio_offset;
+    uint32_t path_hash;
+    uint16_t rec_len;
+    uint16_t path_len;
+    uint8_t  title_len;
+    uint8_t  artist_len;
+    uint8_t  album_len;
+    uint8_t  reserved;
+} mlib_rec_t;
+
+typedef struct
+{
+    /* new index */
+    uint8_t           *data;
+    uint32_t           data_len;
+    uint32_t           data_cap;
+    uint32_t          *rec_off;     /* offset in data */
+    uint32_t           count;
+    uint32_t           cap;
+    /* previous index, whole file in memory */
+    uint8_t           *old;
+    uint32_t           old_count;
+    uint32_t           old_generation;
+    const mlib_rec_t **old_sorted;  /* sorted by path_hash */
+    media_lib_stats_t *stats;
+    char               path[MEDIA_LIB_PATH_MAX];
+} mlib_builder_t;
+
+struct media_lib
+{
+    char       *index_file;
+    mlib_hdr_t  hdr;
+    uint32_t   *table;
+};
+
+typedef struct
+{
+    char                 *root;
+    char                 *index_file;
+    media_lib_scan_done_t done;
+    void                 *user_data;
+} mlib_scan_arg_t;
+
+static volatile uint8_t g_mlib_busy;
+/* qsort has no context argument, only valid while g_mlib_busy is held */
+static const mlib_builder_t *g_sort_builder;
+static media_lib_sort_t g_sort_key;
+
+static int mlib_lock(void)
+{
+    int ret = -1;
+
+    rt_enter_critical();
+    if (!g_mlib_busy)
+    {
+        g_mlib_busy = 1;
+        ret = 0;
+    }
+    rt_exit_critical();
+    return ret;
+}
+
+static void mlib_unlock(void)
+{
+    g_mlib_busy = 0;
+}
+
+static uint32_t mlib_hash(const char *s)
+{
+    uint32_t h = 2166136261u;
+
+    while (*s)
+        h = (h ^ (uint8_t) * s++) * 16777619u;
+    return h;
+}
+
+/* length limited to max - 1 bytes, cut at UTF-8 character boundary */
+static uint32_t mlib_str_len(const char *s, uint32_t len, uint32_t max)
+{
+    if (len < max)
+        return len;
+    len = max - 1;
+    while (len > 0 && ((uint8_t)s[len] & 0xC0) == 0x80)
+        len--;
+    return len;
+}
+
+static int mlib_strcmp_ci(const char *a, const char *b)
+{
+    uint8_t ca, cb;
+
+    do
+    {
+        ca = (uint8_t) * a++;
+        cb = (uint8_t) * b++;
+        if (ca >= 'A' && ca <= 'Z')
+            ca += 'a' - 'A';
+        if (cb >= 'A' && cb <= 'Z')
+            cb += 'a' - 'A';
+    }
+    while (ca && ca == cb);
+    return (int)ca - (int)cb;
+}
+
+static const char *mlib_rec_title(const mlib_rec_t *rec)
+{
+    return (const char *)(rec + 1);
+}
+
+static const char *mlib_rec_artist(const mlib_rec_t *rec)
+{
+    return mlib_rec_title(rec) + rec->title_len + 1;
+}
+
+static const char *mlib_rec_album(const mlib_rec_t *rec)
+{
+    return mlib_rec_artist(rec) + rec->artist_len + 1;
+}
+
+static const char *mlib_rec_path(const mlib_rec_t *rec)
+{
+    return mlib_rec_album(rec) + rec->album_len + 1;
+}
+
+static int mlib_rec_valid(const mlib_rec_t *rec, uint32_t avail)
+{
+    uint32_t len;
+
+    if (avail < sizeof(mlib_rec_t) || rec->rec_len > avail)
+        return 0;
+    len = sizeof(mlib_rec_t) + rec->title_len + rec->artist_len + rec->album_len + rec->path_len + 4;
+    if (len > rec->rec_len || rec->title_len >= MEDIA_LIB_TAG_MAX || rec->artist_len >= MEDIA_LIB_TAG_MAX
+            || rec->album_len >= MEDIA_LIB_TAG_MAX || rec->path_len >= MEDIA_LIB_PATH_MAX)
+        return 0;
+    return mlib_rec_path(rec)[rec->path_len] == '\0';
+}
+
+static int mlib_hdr_valid(const mlib_hdr_t *hdr, uint32_t file_size)
+{
+    if (hdr->magic != MLIB_MAGIC || hdr->version != MLIB_VERSION || hdr->rec_size != sizeof(mlib_rec_t)
+            || hdr->count > MLIB_MAX_FILES || hdr->file_size != file_size)
+        return 0;
+    return hdr->table_off == sizeof(mlib_hdr_t)
+           && hdr->order_off == hdr->table_off + hdr->count * sizeof(uint32_t)
+           && hdr->data_off == MLIB_ALIGN4(hdr->order_off + hdr->count * MEDIA_LIB_SORT_NUM * sizeof(uint16_t))
+           && hdr->data_off <= file_size;
+}
+
+static void mlib_entry_fill(media_lib_entry_t *entry, const mlib_rec_t *rec)
+{
+    memcpy(entry->title, mlib_rec_title(rec), rec->title_len + 1);
+    memcpy(entry->artist, mlib_rec_artist(rec), rec->artist_len + 1);
+    memcpy(entry->album, mlib_rec_album(rec), rec->album_len + 1);
+    memcpy(entry->path, mlib_rec_path(rec), rec->path_len + 1);
+    entry->duration = rec->duration;
+    entry->audio_offset = rec->audio_offset;
+    entry->size = rec->size;
+    entry->mtime = rec->mtime;
+}
+
+/*********************** build ***********************/
+
+static int mlib_old_cmp(const void *a, const void *b)
+{
+    uint32_t ha = (*(const mlib_rec_t **)a)->path_hash;
+    uint32_t hb = (*(const mlib_rec_t **)b)->path_hash;
+
+    return ha < hb ? -1 : ha > hb;
+}
+
+static void mlib_old_load(mlib_builder_t *b, const char *index_file)
+{
+    struct stat st;
+    const mlib_hdr_t *hdr;
+    const uint32_t *table;
+    uint32_t i;
+    int fd;
+
+    if (stat(index_file, &st) != 0 || st.st_size < sizeof(mlib_hdr_t))
+        return;
+    b->old = audio_mem_malloc(st.st_size);
+    if (!b->old)
+        return;
+    fd = open(index_file, O_RDONLY | O_BINARY);
+    if (fd < 0)
+        goto fail;
+    i = read(fd, b->old, st.st_size);
+    close(fd);
+    hdr = (const mlib_hdr_t *)b->old;
+    if (i != st.st_size || !mlib_hdr_valid(hdr, st.st_size))
+        goto fail;
+    b->old_generation = hdr->generation;
+    if (hdr->count == 0)
+        return;
+
+    b->old_sorted = audio_mem_malloc(hdr->count * sizeof(mlib_rec_t *));
+    if (!b->old_sorted)
+        goto fail;
+    table = (const uint32_t *)(b->old + hdr->table_off);
+    for (i = 0; i < hdr->count; i++)
+    {
+        const mlib_rec_t *rec = (const mlib_rec_t *)(b->old + table[i]);
+
+        if (table[i] < hdr->data_off || (table[i] & 3) || !mlib_rec_valid(rec, st.st_size - table[i]))
+        {
+            LOG_W("index %s corrupted", index_file);
+            goto fail;
+        }
+        b->old_sorted[i] = rec;
+    }
+    qsort(b->old_sorted, hdr->count, sizeof(mlib_rec_t *), mlib_old_cmp);
+    b->old_count = hdr->count;
+    return;
+
+fail:
+    if (b->old_sorted)
+        audio_mem_free(b->old_sorted);
+    audio_mem_free(b->old);
+    b->old_sorted = NULL;
+    b->old = NULL;
+    b->old_count = 0;
+}
+
+static const mlib_rec_t *mlib_old_find(const mlib_builder_t *b, uint32_t hash, const char *path)
+{
+    uint32_t lo = 0, hi = b->old_count;
+
+    while (lo < hi)
+    {
+        uint32_t mid = (lo + hi) / 2;
+
+        if (b->old_sorted[mid]->path_hash < hash)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    for (; lo < b->old_count && b->old_sorted[lo]->path_hash == hash; lo++)
+    {
+        if (strcmp(mlib_rec_path(b->old_sorted[lo]), path) == 0)
+            return b->old_sorted[lo];
+    }
+    return NULL;
+}
+
+static int mlib_reserve(mlib_builder_t *b, uint32_t rec_len)
+{
+    if (b->count == b->cap)
+    {
+        uint32_t cap = b->cap ? b->cap * 2 : 64;
+        uint32_t *p;
+
+        if (cap > MLIB_MAX_FILES)
+            cap = MLIB_MAX_FILES;
+        if (b->count == cap)
+            return -1;
+        p = audio_mem_malloc(cap * sizeof(uint32_t));
+        if (!p)
+            return -1;
+        if (b->rec_off)
+        {
+            memcpy(p, b->rec_off, b->count * sizeof(uint32_t));
+            audio_mem_free(b->rec_off);
+        }
+        b->rec_off = p;
+        b->cap = cap;
+    }
+    if (b->data_len + rec_len > b->data_cap)
+    {
+        uint32_t cap = b->data_cap ? b->data_cap * 2 : 8192;
+        uint8_t *p;
+
+        while (cap < b->data_len + rec_len)
+            cap *= 2;
+        p = audio_mem_malloc(cap);
+        if (!p)
+            return -1;
+        if (b->data)
+        {
+            memcpy(p, b->data, b->data_len);
+            audio_mem_free(b->data);
+        }
+        b->data = p;
+        b->data_cap = cap;
+    }
+    return 0;
+}
+
+static int mlib_append(mlib_builder_t *b, const mlib_rec_t *src, const char *title,
+                       const char *artist, const char *album, const char *path)
+{
+    mlib_rec_t *rec;
+    char *p;
+    uint32_t len;
+
+    len = MLIB_ALIGN4(sizeof(mlib_rec_t) + src->title_len + src->artist_len + src->album_len + src->path_len + 4);
+    if (mlib_reserve(b, len) != 0)
+        return -1;
+
+    rec = (mlib_rec_t *)(b->data + b->data_len);
+    *rec = *src;
+    rec->rec_len = len;
+    p = (char *)(rec + 1);
+    memcpy(p, title, rec->title_len);
+    p += rec->title_len;
+    *p++ = '\0';
+    memcpy(p, artist, rec->artist_len);
+    p += rec->artist_len;
+    *p++ = '\0';
+    memcpy(p, album, rec->album_len);
+    p += rec->album_len;
+    *p++ = '\0';
+    memcpy(p, path, rec->path_len + 1);
+    p += rec->path_len + 1;
+    memset(p, 0, (uint8_t *)rec + len - (uint8_t *)p);
+
+    b->rec_off[b->count++] = b->data_len;
+    b->data_len += len;
+    return 0;
+}
+
+static uint32_t mlib_id3_len(const char *path)
+{
+    uint8_t h[10];
+    uint32_t len = 0;
+    int fd;
+
+    fd = open(path, O_RDONLY | O_BINARY);
+    if (fd < 0)
+        return 0;
+    if (read(fd, h, sizeof(h)) == sizeof(h) && h[0] == 'I' && h[1] == 'D' && h[2] == '3'
+            && !((h[6] | h[7] | h[8] | h[9]) & 0x80))
+    {
+        len = 10 + ((h[6] << 21) | (h[7] << 14) | (h[8] << 7) | h[9]);
+        if (h[5] & 0x10)
+            len += 10; /* footer */
+    }
+    close(fd);
+    return len;
+}
+
+static int mlib_ext_is(const char *name, uint32_t len, const char *ext)
+{
+    return len > 4 && mlib_strcmp_ci(name + len - 4, ext) == 0;
+}
+
+static void mlib_add_file(mlib_builder_t *b, uint32_t path_len, uint32_t name_pos, int is_mp3)
+{
+    struct stat st;
+    mlib_rec_t rec;
+    const mlib_rec_t *old;
+    const char *title, *artist = "", *album = "";
+    mp3_id3_info_t id3;
+    mp3_info_t info;
+
+    if (stat(b->path, &st) != 0)
+        return;
+
+    memset(&rec, 0, sizeof(rec));
+    rec.size = st.st_size;
+    rec.mtime = st.st_mtime;
+    rec.path_hash = mlib_hash(b->path);
+    rec.path_len = path_len;
+
+    old = mlib_old_find(b, rec.path_hash, b->path);
+    if (old && old->size == rec.size && old->mtime == rec.mtime)
+    {
+        if (mlib_append(b, old, mlib_rec_title(old), mlib_rec_artist(old), mlib_rec_album(old), b->path) == 0)
+            b->stats->reused++;
+        return;
+    }
+
+    memset(&id3, 0, sizeof(id3));
+    memset(&info, 0, sizeof(info));
+    if (is_mp3)
+    {
+        mp3_get_id3_start(b->path, &id3);
+        rec.audio_offset = mlib_id3_len(b->path);
+    }
+    mp3ctrl_getinfo(b->path, &info);
+    rec.duration = info.total_time_in_seconds;
+
+    if (id3.artist)
+        artist = id3.artist;
+    if (id3.album)
+        album = id3.album;
+    if (id3.title && id3.title[0])
+    {
+        title = id3.title;
+        rec.title_len = mlib_str_len(title, strlen(title), MEDIA_LIB_TAG_MAX);
+    }
+    else
+    {
+        /* file name without extension */
+        title = b->path + name_pos;
+        rec.title_len = mlib_str_len(title, path_len - name_pos - 4, MEDIA_LIB_TAG_MAX);
+    }
+    rec.artist_len = mlib_str_len(artist, strlen(artist), MEDIA_LIB_TAG_MAX);
+    rec.album_len = mlib_str_len(album, strlen(album), MEDIA_LIB_TAG_MAX);
+
+    if (mlib_append(b, &rec, title, artist, album, b->path) == 0)
+        b->stats->parsed++;
+    if (is_mp3)
+        mp3_get_id3_end(&id3);
+}
+
+static void mlib_walk(mlib_builder_t *b, uint32_t len, int depth)
+{
+    DIR *dir;
+    struct dirent *ent;
+
+    dir = opendir(len ? b->path : "/");
+    if (!dir)
+        return;
+    while ((ent = readdir(dir)) != NULL)
+    {
+        uint32_t n = strlen(ent->d_name);
+
+        if (ent->d_name[0] == '.')
+            continue;
+        if (len + 1 + n >= MEDIA_LIB_PATH_MAX)
+        {
+            LOG_W("path too long %s/%s", b->path, ent->d_name);
+            continue;
+        }
+        b->path[len] = '/';
+        memcpy(b->path + len + 1, ent->d_name, n + 1);
+        if (ent->d_type == DT_DIR)
+        {
+            if (depth < MLIB_MAX_DEPTH)
+                mlib_walk(b, len + 1 + n, depth + 1);
+        }
+        else if (mlib_ext_is(ent->d_name, n, ".mp3"))
+        {
+            mlib_add_file(b, len + 1 + n, len + 1, 1);
+        }
+        else if (mlib_ext_is(ent->d_name, n, ".wav"))
+        {
+            mlib_add_file(b, len + 1 + n, len + 1, 0);
+        }
+        b->path[len] = '\0';
+    }
+    closedir(dir);
+}
+
+static int mlib_sort_cmp(const void *a, const void *b)
+{
+    const mlib_rec_t *ra = (const mlib_rec_t *)(g_sort_builder->data + g_sort_builder->rec_off[*(const uint16_t *)a]);
+    const mlib_rec_t *rb = (const mlib_rec_t *)(g_sort_builder->data + g_sort_builder->rec_off[*(const uint16_t *)b]);
+    int r = 0;
+
+    switch (g_sort_key)
+    {
+    case MEDIA_LIB_SORT_ARTIST:
+        r = mlib_strcmp_ci(mlib_rec_artist(ra), mlib_rec_artist(rb));
+    /* fall through */
+    case MEDIA_LIB_SORT_ALBUM:
+        if (r == 0)
+            r = mlib_strcmp_ci(mlib_rec_album(ra), mlib_rec_album(rb));
+    /* fall through */
+    case MEDIA_LIB_SORT_TITLE:
+        if (r == 0)
+            r = mlib_strcmp_ci(mlib_rec_title(ra), mlib_rec_title(rb));
+    /* fall through */
+    default:
+        if (r == 0)
+            r = strcmp(mlib_rec_path(ra), mlib_rec_path(rb));
+        break;
+    }
+    return r;
+}
+
+static int mlib_write(mlib_builder_t *b, const char *index_file)
+{
+    mlib_hdr_t hdr;
+    uint16_t *order;
+    char *tmp;
+    uint32_t i, order_size;
+    int fd, ret = -1;
+
+    order_size = b->count * MEDIA_LIB_SORT_NUM * sizeof(uint16_t);
+    order = audio_mem_malloc(order_size + 4);
+    tmp = audio_mem_malloc(strlen(index_file) + sizeof(MLIB_TMP_EXT));
+    if (!order || !tmp)
+        goto exit;
+
+    g_sort_builder = b;
+    for (g_sort_key = 0; g_sort_key < MEDIA_LIB_SORT_NUM; g_sort_key++)
+    {
+        uint16_t *o = order + g_sort_key * b->count;
+
+        for (i = 0; i < b->count; i++)
+            o[i] = i;
+        qsort(o, b->count, sizeof(uint16_t), mlib_sort_cmp);
+    }
+    g_sort_builder = NULL;
+
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.magic = MLIB_MAGIC;
+    hdr.version = MLIB_VERSION;
+    hdr.rec_size = sizeof(mlib_rec_t);
+    hdr.count = b->count;
+    hdr.table_off = sizeof(mlib_hdr_t);
+    hdr.order_off = hdr.table_off + b->count * sizeof(uint32_t);
+    hdr.data_off = MLIB_ALIGN4(hdr.order_off + order_size);
+    hdr.file_size = hdr.data_off + b->data_len;
+    hdr.generation = b->old_generation + 1;
+    for (i = 0; i < b->count; i++)
+        b->rec_off[i] += hdr.data_off;
+    memset((uint8_t *)order + order_size, 0, 4);
+
+    strcpy(tmp, index_file);
+    strcat(tmp, MLIB_TMP_EXT);
+    fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, 0);
+    if (fd < 0)
+    {
+        LOG_E("create %s failed", tmp);
+        goto exit;
+    }
+    if (write(fd, &hdr, sizeof(hdr)) == sizeof(hdr)
+            && write(fd, b->rec_off, b->count * sizeof(uint32_t)) == b->count * sizeof(uint32_t)
+            && write(fd, order, hdr.data_off - hdr.order_off) == hdr.data_off - hdr.order_off
+            && write(fd, b->data, b->data_len) == b->data_len)
+    {
+        ret = 0;
+    }
+    close(fd);
+    if (ret == 0)
+    {
+        unlink(index_file);
+        ret = rename(tmp, index_file);
+    }
+    if (ret != 0)
+    {
+        LOG_E("write %s failed", index_file);
+        unlink(tmp);
+    }
+
+exit:
+    if (order)
+        audio_mem_free(order);
+    if (tmp)
+        audio_mem_free(tmp);
+    return ret;
+}
+
+rt_err_t media_lib_update(const char *root, const char *index_file, media_lib_stats_t *stats)
+{
+    mlib_builder_t *b;
+    media_lib_stats_t local;
+    rt_tick_t start = rt_tick_get();
+    uint32_t len;
+    rt_err_t ret = -RT_ERROR;
+
+    if (!root || !index_file)
+        return -RT_EINVAL;
+    len = strlen(root);
+    while (len > 0 && root[len - 1] == '/')
+        len--;
+    if (len >= MEDIA_LIB_PATH_MAX)
+        return -RT_EINVAL;
+    if (mlib_lock() != 0)
+        return -RT_EBUSY;
+
+    b = audio_mem_malloc(sizeof(mlib_builder_t));
+    if (!b)
+    {
+        mlib_unlock();
+        return -RT_ENOMEM;
+    }
+    memset(b, 0, sizeof(mlib_builder_t));
+    memset(&local, 0, sizeof(local));
+    b->stats = &local;
+
+    mlib_old_load(b, index_file);
+    memcpy(b->path, root, len);
+    b->path[len] = '\0';
+    mlib_walk(b, len, 0);
+
+    if (mlib_write(b, index_file) == 0)
+    {
+        local.total = b->count;
+        local.removed = b->old_count - local.reused;
+        local.time_ms = (rt_tick_get() - start) * 1000 / RT_TICK_PER_SECOND;
+        LOG_I("media lib %s: %d files, %d parsed, %d reused, %d removed, %dms", index_file,
+              local.total, local.parsed, local.reused, local.removed, local.time_ms);
+        if (stats)
+            *stats = local;
+        ret = RT_EOK;
+    }
+
+    if (b->old_sorted)
+        audio_mem_free(b->old_sorted);
+    if (b->old)
+        audio_mem_free(b->old);
+    if (b->rec_off)
+        audio_mem_free(b->rec_off);
+    if (b->data)
+        audio_mem_free(b->data);
+    audio_mem_free(b);
+    mlib_unlock();
+    return ret;
+}
+
+static void mlib_scan_entry(void *p)
+{
+    mlib_scan_arg_t *arg = (mlib_scan_arg_t *)p;
+    media_lib_stats_t stats;
+    rt_err_t ret;
+
+    memset(&stats, 0, sizeof(stats));
+    ret = media_lib_update(arg->root, arg->index_file, &stats);
+    if (arg->done)
+        arg->done(ret, &stats, arg->user_data);
+    audio_mem_free(arg);
+}
+
+rt_err_t media_lib_scan_async(const char *root, const char *index_file,
+                              media_lib_scan_done_t done, void *user_data)
+{
+    mlib_scan_arg_t *arg;
+    rt_thread_t tid;
+    uint32_t root_len, index_len;
+
+    if (!root || !index_file)
+        return -RT_EINVAL;
+    if (g_mlib_busy)
+        return -RT_EBUSY;
+
+    root_len = strlen(root) + 1;
+    index_len = strlen(index_file) + 1;
+    arg = audio_mem_malloc(sizeof(mlib_scan_arg_t) + root_len + index_len);
+    if (!arg)
+        return -RT_ENOMEM;
+    arg->root = (char *)(arg + 1);
+    arg->index_file = arg->root + root_len;
+    memcpy(arg->root, root, root_len);
+    memcpy(arg->index_file, index_file, index_len);
+    arg->done = done;
+    arg->user_data = user_data;
+
+    tid = rt_thread_create("mlib", mlib_scan_entry, arg, MLIB_SCAN_STACK_SIZE, RT_THREAD_PRIORITY_LOW, 10);
+    if (!tid)
+    {
+        audio_mem_free(arg);
+        return -RT_ENOMEM;
+    }
+    rt_thread_startup(tid);
+    return RT_EOK;
+}
+
+/*********************** query ***********************/
+
+/* open index and reload record table if it was rewritten since last access */
+static int mlib_reader_open(media_lib_t lib)
+{
+    mlib_hdr_t hdr;
+    struct stat st;
+    int fd;
+
+    fd = open(lib->index_file, O_RDONLY | O_BINARY);
+    if (fd < 0)
+        return -1;
+    if (fstat(fd, &st) != 0 || read(fd, &hdr, sizeof(hdr)) != sizeof(hdr) || !mlib_hdr_valid(&hdr, st.st_size))
+        goto fail;
+    if (lib->table && memcmp(&hdr, &lib->hdr, sizeof(hdr)) == 0)
+        return fd;
+
+    if (lib->table)
+        audio_mem_free(lib->table);
+    lib->table = audio_mem_malloc(hdr.count * sizeof(uint32_t) + 4);
+    if (!lib->table)
+        goto fail;
+    if (read(fd, lib->table, hdr.count * sizeof(uint32_t)) != hdr.count * sizeof(uint32_t))
+    {
+        audio_mem_free(lib->table);
+        lib->table = NULL;
+        goto fail;
+    }
+    lib->hdr = hdr;
+    return fd;
+
+fail:
+    close(fd);
+    return -1;
+}
+
+static int mlib_read_entry(media_lib_t lib, int fd, uint16_t n, uint8_t *buf, media_lib_entry_t *entry)
+{
+    uint32_t off;
+    int len;
+
+    if (n >= lib->hdr.count)
+        return -1;
+    off = lib->table[n];
+    if (off < lib->hdr.data_off || off >= lib->hdr.file_size || lseek(fd, off, SEEK_SET) != off)
+        return -1;
+    len = read(fd, buf, MLIB_REC_MAX);
+    if (len <= 0 || !mlib_rec_valid((const mlib_rec_t *)buf, len))
+        return -1;
+    mlib_entry_fill(entry, (const mlib_rec_t *)buf);
+    return 0;
+}
+
+static int mlib_read_order(media_lib_t lib, int fd, media_lib_sort_t sort, uint32_t pos, uint16_t *n, uint32_t num)
+{
+    uint32_t off = lib->hdr.order_off + (sort * lib->hdr.count + pos) * sizeof(uint16_t);
+
+    if (lseek(fd, off, SEEK_SET) != off || read(fd, n, num * sizeof(uint16_t)) != num * sizeof(uint16_t))
+        return -1;
+    return 0;
+}
+
+media_lib_t media_lib_open(const char *index_file)
+{
+    media_lib_t lib;
+    int fd;
+
+    if (!index_file)
+        return NULL;
+    lib = audio_mem_malloc(sizeof(struct media_lib) + strlen(index_file) + 1);
+    if (!lib)
+        return NULL;
+    memset(lib, 0, sizeof(struct media_lib));
+    lib->index_file = (char *)(lib + 1);
+    strcpy(lib->index_file, index_file);
+
+    fd = mlib_reader_open(lib);
+    if (fd < 0)
+    {
+        audio_mem_free(lib);
+        return NULL;
+    }
+    close(fd);
+    return lib;
+}
+
+void media_lib_close(media_lib_t lib)
+{
+    if (!lib)
+        return;
+    if (lib->table)
+        audio_mem_free(lib->table);
+    audio_mem_free(lib);
+}
+
+uint32_t media_lib_count(media_lib_t lib)
+{
+    int fd;
+
+    if (!lib)
+        return 0;
+    fd = mlib_reader_open(lib);
+    if (fd < 0)
+        return 0;
+    close(fd);
+    return lib->hdr.count;
+}
+
+int media_lib_query(media_lib_t lib, media_lib_sort_t sort, uint32_t start,
+                    media_lib_entry_t *entries, uint32_t num)
+{
+    uint8_t *buf;
+    uint16_t *order;
+    uint32_t i;
+    int fd, ret = -1;
+
+    if (!lib || !entries || sort >= MEDIA_LIB_SORT_NUM)
+        return -1;
+    fd = mlib_reader_open(lib);
+    if (fd < 0)
+        return -1;
+    if (start >= lib->hdr.count || num == 0)
+    {
+        close(fd);
+        return 0;
+    }
+    if (num > lib->hdr.count - start)
+        num = lib->hdr.count - start;
+
+    buf = audio_mem_malloc(MLIB_REC_MAX + num * sizeof(uint16_t));
+    if (!buf)
+        goto exit;
+    order = (uint16_t *)(buf + MLIB_REC_MAX);
+    if (mlib_read_order(lib, fd, sort, start, order, num) != 0)
+        goto exit;
+    for (i = 0; i < num; i++)
+    {
+        if (mlib_read_entry(lib, fd, order[i], buf, &entries[i]) != 0)
+            goto exit;
+    }
+    ret = num;
+
+exit:
+    if (buf)
+        audio_mem_free(buf);
+    close(fd);
+    return ret;
+}
+
+int media_lib_find(media_lib_t lib, const char *path, media_lib_entry_t *entry)
+{
+    media_lib_entry_t *e;
+    uint8_t *buf;
+    uint32_t lo, hi;
+    uint16_t n;
+    int fd, ret = -1;
+
+    if (!lib || !path)
+        return -1;
+    fd = mlib_reader_open(lib);
+    if (fd < 0)
+        return -1;
+    buf = audio_mem_malloc(MLIB_ALIGN4(MLIB_REC_MAX) + sizeof(media_lib_entry_t));
+    if (!buf)
+        goto exit;
+    e = (media_lib_entry_t *)(buf + MLIB_ALIGN4(MLIB_REC_MAX));
+
+    lo = 0;
+    hi = lib->hdr.count;
+    while (lo < hi)
+    {
+        uint32_t mid = (lo + hi) / 2;
+        int r;
+
+        if (mlib_read_order(lib, fd, MEDIA_LIB_SORT_PATH, mid, &n, 1) != 0
+                || mlib_read_entry(lib, fd, n, buf, e) != 0)
+            goto exit;
+        r = strcmp(e->path, path);
+        if (r == 0)
+        {
+            if (entry)
+                *entry = *e;
+            ret = mid;
+            break;
+        }
+        if (r < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+exit:
+    if (buf)
+        audio_mem_free(buf);
+    close(fd);
+    return ret;
+}
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+#define MLIB_CMD_INDEX      "/media.mlib"
+
+static const char *const mlib_sort_name[MEDIA_LIB_SORT_NUM] = {"title", "artist", "album", "path"};
+
+static int mlib(int argc, char **argv)
+{
+    if (argc >= 3 && strcmp(argv[1], "scan") == 0)
+    {
+        media_lib_stats_t stats;
+        rt_err_t ret = media_lib_update(argv[2], argc > 3 ? argv[3] : MLIB_CMD_INDEX, &stats);
+
+        if (ret == RT_EOK)
+            rt_kprintf("total %d parsed %d reused %d removed %d, %dms\n",
+                       stats.total, stats.parsed, stats.reused, stats.removed, stats.time_ms);
+        else
+            rt_kprintf("scan failed %d\n", ret);
+        return 0;
+    }
+    if (argc >= 2 && strcmp(argv[1], "list") == 0)
+    {
+        media_lib_sort_t sort = MEDIA_LIB_SORT_TITLE;
+        uint32_t start = argc > 3 ? atoi(argv[3]) : 0;
+        uint32_t num = argc > 4 ? atoi(argv[4]) : 10;
+        media_lib_entry_t *entries;
+        media_lib_t lib;
+        int i, n;
+
+        for (i = 0; argc > 2 && i < MEDIA_LIB_SORT_NUM; i++)
+        {
+            if (strcmp(argv[2], mlib_sort_name[i]) == 0)
+                sort = i;
+        }
+        lib = media_lib_open(argc > 5 ? argv[5] : MLIB_CMD_INDEX);
+        if (!lib)
+        {
+            rt_kprintf("no index\n");
+            return 0;
+        }
+        entries = audio_mem_malloc(num * sizeof(media_lib_entry_t));
+        if (entries)
+        {
+            n = media_lib_query(lib, sort, start, entries, num);
+            for (i = 0; i < n; i++)
+                rt_kprintf("%4d %-24s %-16s %-16s %3d:%02d %s\n", start + i, entries[i].title, entries[i].artist,
+                           entries[i].album, entries[i].duration / 60, entries[i].duration % 60, entries[i].path);
+            rt_kprintf("%d of %d\n", n, media_lib_count(lib));
+            audio_mem_free(entries);
+        }
+        media_lib_close(lib);
+        return 0;
+    }
+    rt_kprintf("mlib scan <root> [index]\n");
+    rt_kprintf("mlib list [title|artist|album|path] [start] [num] [index]\n");
+    return 0;
+}
+MSH_CMD_EXPORT(mlib, media library index);
+#endif
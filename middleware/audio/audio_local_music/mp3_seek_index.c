@@ -0,0 +1,494 @@
+/**
+  ******************************************************************************
+  * @file   mp3_seek_index.c
+  * @author Sifli software development team
+  * @brief  MP3 seek index: Xing/Info/VBRI TOC and sparse frame offset index.
+ *
+  ******************************************************************************
+*/
+/**
+ * @attention
+ * Copyright (c) 2024 - 2024,  Sifli Technology
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Sifli integrated circuit
+ *    in a product or a software update for such product, must reproduce the above
+ *    copyright notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Sifli nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Sifli integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY SIFLI TECHNOLOGY "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL SIFLI TECHNOLOGY OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <string.h>
+#include "mp3_seek_index.h"
+
+/*
+    Xing/Info header is in the first frame after side info, VBRI header is
+    always 32 bytes after frame header. Frame 0 of the index is the frame
+    after the header frame.
+
+    Without a TOC the index is built by walking frame headers only, no
+    decoding, either while playing (mp3_seek_index_feed) or on demand when
+    seeking past the indexed part (mp3_seek_index_scan). When entry[] is full
+    every other entry is dropped and interval doubles, so memory is fixed and
+    any frame is at most interval - 1 header hops away from an entry.
+*/
+
+#define XING_FLAG_FRAMES    0x01
+#define XING_FLAG_BYTES     0x02
+#define XING_FLAG_TOC       0x04
+
+#define VBRI_OFFSET         (4 + 32)
+#define VBRI_HEADER_SIZE    26
+
+static const uint16_t bitrate_tab[2][3][15] =
+{
+    {
+        /* MPEG1 layer 1/2/3 */
+        {0, 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448},
+        {0, 32, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384},
+        {0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320},
+    },
+    {
+        /* MPEG2/2.5 layer 1/2/3 */
+        {0, 32, 48, 56, 64, 80, 96, 112, 128, 144, 160, 176, 192, 224, 256},
+        {0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160},
+        {0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160},
+    },
+};
+
+static const uint16_t samplerate_tab[3] = {44100, 48000, 32000};
+
+typedef struct
+{
+    mp3_seek_read_t read;
+    void           *ctx;
+    uint8_t        *buf;
+    uint32_t        size;
+    uint32_t        pos;    /* stream offset of buf[0] */
+    uint32_t        len;    /* valid bytes in buf */
+    int             err;
+} seek_reader_t;
+
+static inline uint32_t rd_be32(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static inline uint32_t rd_be16(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 8) | p[1];
+}
+
+uint32_t mp3_frame_header_parse(const uint8_t *p, mp3_frame_hdr_t *hdr)
+{
+    uint32_t ver, layer, br_idx, sr_idx, pad;
+    uint32_t len;
+
+    if (p[0] != 0xFF || (p[1] & 0xE0) != 0xE0)
+        return 0;
+
+    ver = (p[1] >> 3) & 3;          /* 0: MPEG2.5, 1: reserved, 2: MPEG2, 3: MPEG1 */
+    layer = 4 - ((p[1] >> 1) & 3);  /* 4: reserved */
+    br_idx = p[2] >> 4;
+    sr_idx = (p[2] >> 2) & 3;
+    pad = (p[2] >> 1) & 1;
+    if (ver == 1 || layer == 4 || br_idx == 0 || br_idx == 15 || sr_idx == 3)
+        return 0;
+
+    hdr->version = (ver == 3) ? 0 : (ver == 2) ? 1 : 2;
+    hdr->layer = (uint8_t)layer;
+    hdr->channels = ((p[3] >> 6) == 3) ? 1 : 2;
+    hdr->samplerate = samplerate_tab[sr_idx] >> hdr->version;
+    hdr->bitrate = bitrate_tab[hdr->version ? 1 : 0][layer - 1][br_idx] * 1000;
+
+    if (layer == 1)
+    {
+        hdr->samples = 384;
+        len = (12 * hdr->bitrate / hdr->samplerate + pad) * 4;
+    }
+    else if (layer == 2 || hdr->version == 0)
+    {
+        hdr->samples = 1152;
+        len = 144 * hdr->bitrate / hdr->samplerate + pad;
+    }
+    else
+    {
+        hdr->samples = 576;
+        len = 72 * hdr->bitrate / hdr->samplerate + pad;
+    }
+    hdr->length = (uint16_t)len;
+    return len;
+}
+
+static inline int hdr_match(const mp3_seek_index_t *idx, const mp3_frame_hdr_t *hdr)
+{
+    return hdr->version == idx->version && hdr->layer == idx->layer && hdr->samplerate == idx->samplerate;
+}
+
+static const uint8_t *reader_peek(seek_reader_t *r, uint32_t offset, uint32_t need)
+{
+    if (offset < r->pos || offset + need > r->pos + r->len)
+    {
+        int got = r->read(r->ctx, offset, r->buf, r->size);
+        if (got < 0)
+        {
+            r->err = 1;
+            got = 0;
+        }
+        r->pos = offset;
+        r->len = (uint32_t)got;
+        if (need > r->len)
+            return NULL;
+    }
+    return r->buf + (offset - r->pos);
+}
+
+/* search a frame at or after *offset whose next frame header is also valid */
+static int frame_resync(const mp3_seek_index_t *idx, seek_reader_t *r, uint32_t *offset, uint32_t *len)
+{
+    mp3_frame_hdr_t hdr;
+    const uint8_t *p;
+    uint32_t o, l;
+
+    for (o = *offset; o + 4 <= idx->data_end; o++)
+    {
+        p = reader_peek(r, o, 4);
+        if (!p)
+            return -1;
+        l = mp3_frame_header_parse(p, &hdr);
+        if (!l || !hdr_match(idx, &hdr))
+            continue;
+        if (o + l + 4 <= idx->data_end)
+        {
+            p = reader_peek(r, o + l, 4);
+            if (!p)
+                return -1;
+            /* last frame may be followed by ID3v1 */
+            if (memcmp(p, "TAG", 3) != 0 && (!mp3_frame_header_parse(p, &hdr) || !hdr_match(idx, &hdr)))
+                continue;
+        }
+        *offset = o;
+        *len = l;
+        return 0;
+    }
+    return -1;
+}
+
+static int frame_next(const mp3_seek_index_t *idx, seek_reader_t *r, uint32_t *offset, uint32_t *len, int strict)
+{
+    mp3_frame_hdr_t hdr;
+    const uint8_t *p;
+
+    if (!strict)
+    {
+        if (*offset + 4 > idx->data_end)
+            return -1;
+        p = reader_peek(r, *offset, 4);
+        if (!p)
+            return -1;
+        *len = mp3_frame_header_parse(p, &hdr);
+        if (*len && hdr_match(idx, &hdr))
+            return 0;
+    }
+    return frame_resync(idx, r, offset, len);
+}
+
+static void index_add(mp3_seek_index_t *idx, uint32_t frame, uint32_t offset)
+{
+    uint32_t i;
+
+    if (frame % idx->interval)
+        return;
+    if (idx->count == AUDIO_MP3_SEEK_INDEX_NUM)
+    {
+        for (i = 0; i < AUDIO_MP3_SEEK_INDEX_NUM / 2; i++)
+            idx->entry[i] = idx->entry[i * 2];
+        idx->count = AUDIO_MP3_SEEK_INDEX_NUM / 2;
+        idx->interval *= 2;
+        if (frame % idx->interval)
+            return;
+    }
+    idx->entry[idx->count++] = offset;
+}
+
+static void parse_vbri(mp3_seek_index_t *idx, const uint8_t *v, uint32_t len, uint32_t offset)
+{
+    uint32_t n, scale, esz, fpe, merge, i, k, size;
+    uint32_t pos;
+    const uint8_t *e;
+
+    n = rd_be16(v + 18);
+    scale = rd_be16(v + 20);
+    esz = rd_be16(v + 22);
+    fpe = rd_be16(v + 24);
+    if (n == 0 || fpe == 0 || esz == 0 || esz > 4 || VBRI_HEADER_SIZE + n * esz > len)
+        return;
+
+    idx->toc_type = MP3_SEEK_TOC_VBRI;
+    idx->toc_bytes = rd_be32(v + 10);
+    idx->total_frames = rd_be32(v + 14);
+
+    merge = (n + AUDIO_MP3_SEEK_INDEX_NUM - 1) / AUDIO_MP3_SEEK_INDEX_NUM;
+    idx->interval = fpe * merge;
+    idx->entry[0] = idx->data_start;
+    idx->count = 1;
+    pos = offset;
+    e = v + VBRI_HEADER_SIZE;
+    for (i = 1; i < n; i++, e += esz)
+    {
+        for (k = 0, size = 0; k < esz; k++)
+            size = (size << 8) | e[k];
+        pos += size * scale;
+        if (pos >= idx->data_end)
+            break;
+        if (i % merge == 0)
+            idx->entry[idx->count++] = pos;
+    }
+    idx->scan_frames = idx->total_frames;
+    idx->scan_offset = idx->data_end;
+    idx->complete = 1;
+}
+
+int mp3_seek_index_init(mp3_seek_index_t *idx, const uint8_t *frame, uint32_t len,
+                        uint32_t offset, uint32_t file_size)
+{
+    mp3_frame_hdr_t hdr;
+    uint32_t flen, side, flags;
+    const uint8_t *p;
+
+    memset(idx, 0, sizeof(mp3_seek_index_t));
+    if (len < 4)
+        return -1;
+    flen = mp3_frame_header_parse(frame, &hdr);
+    if (!flen)
+        return -1;
+
+    idx->magic = MP3_SEEK_INDEX_MAGIC;
+    idx->file_size = file_size;
+    idx->data_start = offset;
+    idx->data_end = file_size;
+    idx->samplerate = hdr.samplerate;
+    idx->samples = hdr.samples;
+    idx->version = hdr.version;
+    idx->layer = hdr.layer;
+    idx->toc_base = offset;
+    idx->interval = 1;
+    if (len > flen)
+        len = flen;
+
+    if (hdr.layer == 3)
+    {
+        if (hdr.version == 0)
+            side = (hdr.channels == 1) ? 17 : 32;
+        else
+            side = (hdr.channels == 1) ? 9 : 17;
+        p = frame + 4 + side;
+        if (4 + side + 8 <= len && (!memcmp(p, "Xing", 4) || !memcmp(p, "Info", 4)))
+        {
+            uint8_t is_info = !memcmp(p, "Info", 4);
+            const uint8_t *end = frame + len;
+
+            flags = rd_be32(p + 4);
+            p += 8;
+            if ((flags & XING_FLAG_FRAMES) && p + 4 <= end)
+            {
+                idx->total_frames = rd_be32(p);
+                p += 4;
+            }
+            if ((flags & XING_FLAG_BYTES) && p + 4 <= end)
+            {
+                idx->toc_bytes = rd_be32(p);
+                p += 4;
+            }
+            if ((flags & XING_FLAG_TOC) && p + 100 <= end)
+            {
+                memcpy(idx->toc, p, 100);
+                idx->toc_type = MP3_SEEK_TOC_XING;
+            }
+            if (is_info)
+                idx->toc_type = MP3_SEEK_TOC_INFO;
+            if (!idx->toc_bytes || offset + idx->toc_bytes > file_size)
+                idx->toc_bytes = file_size - offset;
+            idx->data_start = offset + flen;
+        }
+        else if (VBRI_OFFSET + VBRI_HEADER_SIZE <= len && !memcmp(frame + VBRI_OFFSET, "VBRI", 4))
+        {
+            idx->data_start = offset + flen;
+            parse_vbri(idx, frame + VBRI_OFFSET, len - VBRI_OFFSET, offset);
+        }
+    }
+    if (!idx->complete)
+        idx->scan_offset = idx->data_start;
+    return 0;
+}
+
+void mp3_seek_index_feed(mp3_seek_index_t *idx, uint32_t offset, const uint8_t *frame, uint32_t len)
+{
+    mp3_frame_hdr_t hdr;
+    uint32_t flen;
+
+    if (idx->complete || offset != idx->scan_offset || len < 4)
+        return;
+    flen = mp3_frame_header_parse(frame, &hdr);
+    if (!flen || !hdr_match(idx, &hdr))
+        return;
+    index_add(idx, idx->scan_frames, offset);
+    idx->scan_frames++;
+    idx->scan_offset = offset + flen;
+}
+
+int mp3_seek_index_scan(mp3_seek_index_t *idx, mp3_seek_read_t read, void *ctx,
+                        uint8_t *buf, uint32_t size, uint32_t target_frame)
+{
+    seek_reader_t r = {read, ctx, buf, size, 0, 0, 0};
+    uint32_t offset = idx->scan_offset;
+    uint32_t len;
+
+    while (!idx->complete && idx->scan_frames <= target_frame)
+    {
+        if (frame_next(idx, &r, &offset, &len, 0) < 0)
+        {
+            if (r.err)
+                return -1;
+            idx->complete = 1;
+            idx->total_frames = idx->scan_frames;
+            break;
+        }
+        index_add(idx, idx->scan_frames, offset);
+        idx->scan_frames++;
+        offset += len;
+        idx->scan_offset = offset;
+    }
+    return 0;
+}
+
+static int locate_toc(mp3_seek_index_t *idx, seek_reader_t *r, uint32_t target, uint32_t *offset)
+{
+    uint32_t pos, len;
+
+    if (idx->toc_type == MP3_SEEK_TOC_XING)
+    {
+        /* percent with 3 fractional digits, linear between TOC points */
+        uint32_t p = (uint32_t)((uint64_t)target * 100000 / idx->total_frames);
+        uint32_t i = p / 1000;
+        uint32_t a = idx->toc[i];
+        uint32_t b = (i < 99) ? idx->toc[i + 1] : 256;
+
+        if (b < a)
+            b = a;
+        pos = a * 1000 + (b - a) * (p % 1000);
+        pos = idx->toc_base + (uint32_t)((uint64_t)idx->toc_bytes * pos / (256 * 1000));
+    }
+    else
+    {
+        uint32_t bytes = idx->toc_base + idx->toc_bytes - idx->data_start;
+        pos = idx->data_start + (uint32_t)((uint64_t)bytes * target / idx->total_frames);
+    }
+    if (pos < idx->data_start)
+        pos = idx->data_start;
+    if (frame_next(idx, r, &pos, &len, 1) < 0)
+        return -1;
+    *offset = pos;
+    return 0;
+}
+
+int mp3_seek_index_locate(mp3_seek_index_t *idx, mp3_seek_read_t read, void *ctx,
+                          uint8_t *buf, uint32_t size, uint32_t ms,
+                          uint32_t *offset, uint32_t *frame)
+{
+    seek_reader_t r = {read, ctx, buf, size, 0, 0, 0};
+    uint32_t target, e, f, pos, len;
+
+    target = (uint32_t)((uint64_t)ms * idx->samplerate / 1000 / idx->samples);
+    if (idx->total_frames && target >= idx->total_frames)
+        target = idx->total_frames - 1;
+
+    if (target >= idx->scan_frames && !idx->complete)
+    {
+        /* the TOC may point past the last frame start, scan then */
+        if ((idx->toc_type == MP3_SEEK_TOC_XING || idx->toc_type == MP3_SEEK_TOC_INFO) && idx->total_frames
+                && locate_toc(idx, &r, target, offset) == 0)
+        {
+            *frame = target;
+            return 0;
+        }
+        if (r.err)
+            return -1;
+        if (mp3_seek_index_scan(idx, read, ctx, buf, size, target) < 0)
+            return -1;
+    }
+    if (idx->count == 0 || idx->scan_frames == 0)
+        return -1;
+    if (target >= idx->scan_frames)
+        target = idx->scan_frames - 1;
+
+    e = target / idx->interval;
+    if (e >= idx->count)
+        e = idx->count - 1;
+    pos = idx->entry[e];
+    f = e * idx->interval;
+    /* VBRI entries are byte counts, not exact frame starts */
+    if (frame_next(idx, &r, &pos, &len, idx->toc_type == MP3_SEEK_TOC_VBRI) < 0)
+        return -1;
+    while (f < target)
+    {
+        uint32_t next = pos + len;
+        uint32_t next_len;
+
+        if (frame_next(idx, &r, &next, &next_len, 0) < 0)
+            break;
+        pos = next;
+        len = next_len;
+        f++;
+    }
+    if (r.err)
+        return -1;
+    *offset = pos;
+    *frame = f;
+    return 0;
+}
+
+uint32_t mp3_seek_index_duration(const mp3_seek_index_t *idx)
+{
+    if (!idx->total_frames || !idx->samplerate)
+        return 0;
+    return (uint32_t)((uint64_t)idx->total_frames * idx->samples * 1000 / idx->samplerate);
+}
+
+int mp3_seek_index_match(const mp3_seek_index_t *loaded, const mp3_seek_index_t *idx)
+{
+    return loaded->magic == MP3_SEEK_INDEX_MAGIC
+           && loaded->file_size == idx->file_size
+           && loaded->data_start == idx->data_start
+           && loaded->samplerate == idx->samplerate
+           && loaded->toc_type == idx->toc_type
+           && loaded->count <= AUDIO_MP3_SEEK_INDEX_NUM
+           && loaded->interval != 0;
+}
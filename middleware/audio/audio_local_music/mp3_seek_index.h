@@ -0,0 +1,167 @@
+/**
+  ******************************************************************************
+  * @file   mp3_seek_index.h
+  * @author Sifli software development team
+  * @brief  MP3 seek index: Xing/Info/VBRI TOC and sparse frame offset index.
+ *
+  ******************************************************************************
+*/
+/**
+ * @attention
+ * Copyright (c) 2024 - 2024,  Sifli Technology
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Sifli integrated circuit
+ *    in a product or a software update for such product, must reproduce the above
+ *    copyright notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Sifli nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Sifli integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY SIFLI TECHNOLOGY "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL SIFLI TECHNOLOGY OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef MP3_SEEK_INDEX_H
+#define MP3_SEEK_INDEX_H
+
+#include <stdint.h>
+#include "rtconfig.h"
+
+#ifndef AUDIO_MP3_SEEK_INDEX_NUM
+    #define AUDIO_MP3_SEEK_INDEX_NUM    256
+#endif
+
+#define MP3_SEEK_INDEX_MAGIC            (0x58495330u + (AUDIO_MP3_SEEK_INDEX_NUM << 8))
+
+#define MP3_SEEK_TOC_NONE               0   /* no VBR header, index is built by scanning */
+#define MP3_SEEK_TOC_INFO               1   /* Xing "Info" header, stream is CBR */
+#define MP3_SEEK_TOC_XING               2   /* Xing header with 100 entry TOC */
+#define MP3_SEEK_TOC_VBRI               3   /* Fraunhofer VBRI header, TOC copied to entry[] */
+
+typedef struct
+{
+    uint32_t bitrate;       /* bits per second */
+    uint32_t samplerate;
+    uint16_t samples;       /* samples per channel in this frame */
+    uint16_t length;        /* frame length in bytes, including header */
+    uint8_t  version;       /* 0: MPEG1, 1: MPEG2, 2: MPEG2.5 */
+    uint8_t  layer;         /* 1 ~ 3 */
+    uint8_t  channels;
+} mp3_frame_hdr_t;
+
+/**
+ * Read callback used for scanning, returns bytes read at absolute offset,
+ * 0 at end of stream.
+ */
+typedef int (*mp3_seek_read_t)(void *ctx, uint32_t offset, uint8_t *buf, uint32_t len);
+
+/**
+ * Seek index of one mp3 stream. The structure is flat so it can be saved to
+ * and loaded from a file as is.
+ *
+ * entry[i] is the offset of frame i * interval, frame 0 is the first audio
+ * frame at data_start. Entries are valid for frames below scan_frames, the
+ * whole stream when complete is set.
+ */
+typedef struct
+{
+    uint32_t magic;
+    uint32_t file_size;
+    uint32_t data_start;    /* first audio frame, after ID3v2 and VBR header frame */
+    uint32_t data_end;
+    uint32_t samplerate;
+    uint16_t samples;       /* samples per frame */
+    uint8_t  version;
+    uint8_t  layer;
+    uint8_t  toc_type;
+    uint8_t  complete;
+    uint8_t  toc[100];      /* Xing TOC, valid for MP3_SEEK_TOC_XING */
+    uint16_t reserved;
+    uint32_t toc_base;      /* offset of the VBR header frame */
+    uint32_t toc_bytes;     /* stream bytes from toc_base covered by the TOC */
+    uint32_t total_frames;  /* exact frame count, 0 if still unknown */
+    uint32_t interval;      /* frames between two entries */
+    uint32_t count;         /* entries in use */
+    uint32_t scan_frames;   /* frames indexed contiguously from data_start */
+    uint32_t scan_offset;   /* offset of frame scan_frames */
+    uint32_t entry[AUDIO_MP3_SEEK_INDEX_NUM];
+} mp3_seek_index_t;
+
+/**
+ * Parse 4 bytes mp3 frame header.
+ * @return frame length in bytes, 0 if not a valid header.
+ */
+uint32_t mp3_frame_header_parse(const uint8_t *p, mp3_frame_hdr_t *hdr);
+
+/**
+ * Init index from the first frame of a stream.
+ * @param frame      first frame data, should hold at least the whole frame.
+ * @param len        bytes available at frame.
+ * @param offset     absolute offset of the first frame.
+ * @param file_size  stream size in bytes.
+ * @return 0 if frame is a valid mp3 frame.
+ */
+int mp3_seek_index_init(mp3_seek_index_t *idx, const uint8_t *frame, uint32_t len,
+                        uint32_t offset, uint32_t file_size);
+
+/**
+ * Record a frame seen by the decoder. Only frames that directly follow the
+ * indexed part are added, others are ignored.
+ */
+void mp3_seek_index_feed(mp3_seek_index_t *idx, uint32_t offset, const uint8_t *frame, uint32_t len);
+
+/**
+ * Walk frame headers until frame target_frame is indexed or end of stream.
+ * Pass UINT32_MAX to index the whole stream.
+ * @param buf   scratch buffer used for reading, 2KB or more is suggested.
+ * @return 0 on success, -1 on read error.
+ */
+int mp3_seek_index_scan(mp3_seek_index_t *idx, mp3_seek_read_t read, void *ctx,
+                        uint8_t *buf, uint32_t size, uint32_t target_frame);
+
+/**
+ * Find frame start for play position ms.
+ * Frames not indexed yet are scanned when there is no TOC to use.
+ * @param offset  absolute offset of the frame found.
+ * @param frame   number of the frame found, counted from data_start.
+ * @return 0 on success.
+ */
+int mp3_seek_index_locate(mp3_seek_index_t *idx, mp3_seek_read_t read, void *ctx,
+                          uint8_t *buf, uint32_t size, uint32_t ms,
+                          uint32_t *offset, uint32_t *frame);
+
+/**
+ * Stream duration in ms, 0 if the frame count is not known yet.
+ */
+uint32_t mp3_seek_index_duration(const mp3_seek_index_t *idx);
+
+/**
+ * Check an index loaded from storage belongs to this stream.
+ */
+int mp3_seek_index_match(const mp3_seek_index_t *loaded, const mp3_seek_index_t *idx);
+
+#endif /* MP3_SEEK_INDEX_H */
@@ -26,6 +26,16 @@ typedef struct
     const char *filename; //new filename for mp3ctrl_open or new buffer for mp3ctrl_open_buffer
     uint32_t len;         //buffer len, if handle is return by mp3ctrl_open, len must be -1;
 } mp3_ioctl_cmd_param_t;
+
+typedef struct
+{
+    uint32_t underrun;        //output cache ran empty while playing
+    uint32_t read_stall;      //decoder waited for file data, not counted after seek or open
+    uint32_t read_bytes;
+    uint32_t gapless_switch;  //switched to prefetched file without draining output
+} mp3ctrl_stats_t;
+
+#define MP3CTRL_CALLBACK_NEXT_STARTED   (as_callback_cmd_user + 1)
 /*
 open:
     return NULL if file error
@@ -38,6 +48,9 @@ open:
         in (audio_server_callback_cmt_t cmd, void *callback_userdata, uint32_t reserved)
             cmd is as_callback_cmd_user + 0
             (uint32_t)callback_userdata is current play time in seconds
+
+        MP3CTRL_CALLBACK_NEXT_STARTED --- prefetched file set by ioctl cmd 3 started,
+                                          sent instead of as_callback_cmd_play_to_end
 */
 mp3ctrl_handle mp3ctrl_open(audio_type_t type, const char *filename, audio_server_callback_func callback, void *callback_userdata);
 mp3ctrl_handle mp3ctrl_open_buffer(audio_type_t type, const char *buf, uint32_t buf_len, audio_server_callback_func callback, void *callback_userdata);
@@ -48,6 +61,10 @@ mp3ctrl_handle mp3ctrl_open_buffer(audio_type_t type, const char *buf, uint32_t
             if handle is return by mp3ctrl_open, can't switch to new buffer;
             if handle is  return by mp3ctrl_open_buffer, can't switch to new file
        2    set thread priority, param is priority value
+       3    prefetch next file, param is (mp3_ioctl_cmd_param_t *)
+            file is opened now and played right after current one without gap,
+            ignored if loop times is not 0. mp3 only.
+       4    get statistics, param is (mp3ctrl_stats_t *)
 */
 int mp3ctrl_ioctl(mp3ctrl_handle handle, int cmd, uint32_t param);
 int mp3ctrl_close(mp3ctrl_handle handle);
@@ -0,0 +1,130 @@
+/**
+  ******************************************************************************
+  * @file   media_lib.h
+  * @author Sifli software development team
+  * @brief  Persistent media library index of local music files.
+ *
+  ******************************************************************************
+*/
+/**
+ * @attention
+ * Copyright (c) 2024 - 2024,  Sifli Technology
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Sifli integrated circuit
+ *    in a product or a software update for such product, must reproduce the above
+ *    copyright notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Sifli nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Sifli integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY SIFLI TECHNOLOGY "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL SIFLI TECHNOLOGY OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#ifndef MEDIA_LIB_H
+#define MEDIA_LIB_H
+
+#include <rtthread.h>
+
+#define MEDIA_LIB_TAG_MAX       64      /* title/artist/album buffer, UTF-8 with NUL */
+#define MEDIA_LIB_PATH_MAX      128
+
+typedef enum
+{
+    MEDIA_LIB_SORT_TITLE,       /* title */
+    MEDIA_LIB_SORT_ARTIST,      /* artist, album, title */
+    MEDIA_LIB_SORT_ALBUM,       /* album, title */
+    MEDIA_LIB_SORT_PATH,        /* full path, byte order */
+    MEDIA_LIB_SORT_NUM,
+} media_lib_sort_t;
+
+typedef struct
+{
+    char     title[MEDIA_LIB_TAG_MAX];      /* file name without extension if no tag */
+    char     artist[MEDIA_LIB_TAG_MAX];
+    char     album[MEDIA_LIB_TAG_MAX];
+    char     path[MEDIA_LIB_PATH_MAX];
+    uint32_t duration;                      /* seconds */
+    uint32_t audio_offset;                  /* first byte after ID3v2 tag */
+    uint32_t size;
+    uint32_t mtime;
+} media_lib_entry_t;
+
+typedef struct
+{
+    uint32_t total;         /* entries in new index */
+    uint32_t parsed;        /* new or changed files, tags parsed */
+    uint32_t reused;        /* unchanged files, copied from old index */
+    uint32_t removed;       /* old entries whose file is gone or changed */
+    uint32_t time_ms;
+} media_lib_stats_t;
+
+typedef struct media_lib *media_lib_t;
+
+typedef void (*media_lib_scan_done_t)(rt_err_t result, const media_lib_stats_t *stats, void *user_data);
+
+/**
+ * Scan root recursively for mp3/wav files and rewrite index_file.
+ * Files whose path, size and mtime match an entry of the existing index are
+ * not opened, so a rescan of an unchanged library only costs the directory walk.
+ * Index is written to a temporary file and renamed, an open media_lib_t
+ * sees the new content on its next query.
+ * @param stats  optional, filled on success.
+ */
+rt_err_t media_lib_update(const char *root, const char *index_file, media_lib_stats_t *stats);
+
+/**
+ * Run media_lib_update in a low priority thread, done is called from that
+ * thread when finished. Only one scan runs at a time.
+ * @return -RT_EBUSY if a scan is running.
+ */
+rt_err_t media_lib_scan_async(const char *root, const char *index_file,
+                              media_lib_scan_done_t done, void *user_data);
+
+/**
+ * Open index for queries, NULL if index_file is missing or invalid.
+ * File is not kept open between queries.
+ */
+media_lib_t media_lib_open(const char *index_file);
+void media_lib_close(media_lib_t lib);
+uint32_t media_lib_count(media_lib_t lib);
+
+/**
+ * Read num entries starting at position start of the given sort order.
+ * @return entries filled, may be less than num at end of list, -1 on error.
+ */
+int media_lib_query(media_lib_t lib, media_lib_sort_t sort, uint32_t start,
+                    media_lib_entry_t *entries, uint32_t num);
+
+/**
+ * Find entry by full path.
+ * @return position in MEDIA_LIB_SORT_PATH order, -1 if not found.
+ */
+int media_lib_find(media_lib_t lib, const char *path, media_lib_entry_t *entry);
+
+#endif /* MEDIA_LIB_H */
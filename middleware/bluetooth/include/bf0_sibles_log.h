@@ -55,7 +55,22 @@
 #define SERIAL_TRANS_HEADER 4
 #define BLE_LOG_SEND_HEADER 5
 
+#ifdef BLE_LOG_USING_LZ4
+/*
+ * Version 2: BLE_LOG_GET, BLE_LOG_ASSERT_GET and BLE_LOG_METRICS_GET may carry
+ * a flag byte. With BLE_LOG_GET_FLAG_LZ4 the data is sent as a LZ4 frame of
+ * independent blocks, BLE_LOG_GET_SEND_START has a 6th byte BLE_LOG_FORMAT_LZ4
+ * and its size is still the size before compression.
+ */
+#define BLE_LOG_VERSION 2
+#else
 #define BLE_LOG_VERSION 1
+#endif
+
+#define BLE_LOG_GET_FLAG_LZ4 (1 << 0)
+
+#define BLE_LOG_FORMAT_RAW 0
+#define BLE_LOG_FORMAT_LZ4 1
 
 enum ble_log_command
 {
@@ -104,6 +119,12 @@ typedef struct
     uint8_t state;
 
     ble_phone_send_data receive_data;
+#ifdef BLE_LOG_USING_LZ4
+    // 0: raw, 1: LZ4 frame requested, 2: LZ4 frame header sent
+    uint8_t lz4;
+    uint32_t lz4_org_size;
+    uint32_t lz4_size;
+#endif
 } ble_log_env_t;
 
 typedef enum
@@ -40,6 +40,21 @@
     #include "ram_be.h"
 #endif
 
+#ifdef BLE_LOG_USING_LZ4
+    #include "lz4.h"
+
+    /* data size of one LZ4 block, callers send up to 2048 bytes at a time */
+    #define BLE_LOG_LZ4_BLOCK_SIZE 2048
+    /* LZ4 frame header: independent blocks, 64KB max block size, no checksum */
+    #define BLE_LOG_LZ4_FRAME_HDR_SIZE 7
+    #define BLE_LOG_LZ4_BLOCK_HDR_SIZE 4
+    /* block is stored without compression */
+    #define BLE_LOG_LZ4_BLOCK_RAW 0x80000000
+
+    static const uint8_t ble_log_lz4_frame_hdr[BLE_LOG_LZ4_FRAME_HDR_SIZE] = {0x04, 0x22, 0x4D, 0x18, 0x60, 0x40, 0x82};
+    static LZ4_stream_t ble_log_lz4_state;
+#endif
+
 
 static ble_log_env_t g_ble_log;
 
@@ -112,7 +127,7 @@ static int ble_log_data_send(uint8_t *raw_data, uint16_t size)
     return ble_serial_tran_send_data(&t_data);
 }
 
-static void ble_log_send_advance(uint8_t *raw_data, uint32_t size)
+static void ble_log_send_packets(uint8_t *raw_data, uint32_t size)
 {
     ble_log_env_t *env = ble_log_get_env();
     uint32_t send_index = 0;
@@ -171,6 +186,99 @@ static void ble_log_send_advance(uint8_t *raw_data, uint32_t size)
     }
 }
 
+#ifdef BLE_LOG_USING_LZ4
+/* every block is compressed alone so that the phone can decode a truncated transfer */
+static void ble_log_lz4_send(uint8_t *raw_data, uint32_t size)
+{
+    ble_log_env_t *env = ble_log_get_env();
+    uint32_t hdr_len;
+    uint32_t blk_len;
+    uint32_t blk_hdr;
+    int cmpr_len;
+    uint8_t *f_data;
+
+    f_data = (uint8_t *)bt_mem_alloc(BLE_LOG_LZ4_FRAME_HDR_SIZE + BLE_LOG_LZ4_BLOCK_HDR_SIZE + BLE_LOG_LZ4_BLOCK_SIZE);
+    BT_OOM_ASSERT(f_data);
+    if (!f_data)
+    {
+        return;
+    }
+
+    while (size > 0)
+    {
+        hdr_len = 0;
+        if (env->lz4 == 1)
+        {
+            rt_memcpy(f_data, ble_log_lz4_frame_hdr, BLE_LOG_LZ4_FRAME_HDR_SIZE);
+            hdr_len = BLE_LOG_LZ4_FRAME_HDR_SIZE;
+            env->lz4 = 2;
+        }
+
+        blk_len = size > BLE_LOG_LZ4_BLOCK_SIZE ? BLE_LOG_LZ4_BLOCK_SIZE : size;
+        cmpr_len = LZ4_compress_fast_extState(&ble_log_lz4_state, (const char *)raw_data,
+                                              (char *)(f_data + hdr_len + BLE_LOG_LZ4_BLOCK_HDR_SIZE),
+                                              blk_len, blk_len - 1, 1);
+        if (cmpr_len > 0)
+        {
+            blk_hdr = cmpr_len;
+        }
+        else
+        {
+            /* not compressible, e.g. already compressed metrics */
+            rt_memcpy(f_data + hdr_len + BLE_LOG_LZ4_BLOCK_HDR_SIZE, raw_data, blk_len);
+            blk_hdr = blk_len | BLE_LOG_LZ4_BLOCK_RAW;
+            cmpr_len = blk_len;
+        }
+        rt_memcpy(f_data + hdr_len, &blk_hdr, BLE_LOG_LZ4_BLOCK_HDR_SIZE);
+
+        ble_log_send_packets(f_data, hdr_len + BLE_LOG_LZ4_BLOCK_HDR_SIZE + cmpr_len);
+        env->lz4_org_size += blk_len;
+        env->lz4_size += hdr_len + BLE_LOG_LZ4_BLOCK_HDR_SIZE + cmpr_len;
+
+        raw_data += blk_len;
+        size -= blk_len;
+    }
+
+    bt_mem_free(f_data);
+}
+
+static void ble_log_lz4_end(void)
+{
+    ble_log_env_t *env = ble_log_get_env();
+    uint32_t end_mark = 0;
+
+    if (env->lz4 == 2)
+    {
+        ble_log_send_packets((uint8_t *)&end_mark, sizeof(end_mark));
+        env->lz4_size += sizeof(end_mark);
+        LOG_I("lz4 %d -> %d bytes", env->lz4_org_size, env->lz4_size);
+        env->lz4 = 1;
+    }
+}
+
+static void ble_log_lz4_request(ble_log_protocol_t *msg)
+{
+    ble_log_env_t *env = ble_log_get_env();
+
+    /* old phones send no flag */
+    env->lz4 = (msg->length >= 1) && (msg->data[0] & BLE_LOG_GET_FLAG_LZ4) ? 1 : 0;
+    env->lz4_org_size = 0;
+    env->lz4_size = 0;
+}
+#endif /* BLE_LOG_USING_LZ4 */
+
+static void ble_log_send_advance(uint8_t *raw_data, uint32_t size)
+{
+#ifdef BLE_LOG_USING_LZ4
+    if (ble_log_get_env()->lz4)
+    {
+        ble_log_lz4_send(raw_data, size);
+        return;
+    }
+#endif
+    ble_log_send_packets(raw_data, size);
+}
+
 #if 0
 static void ble_log_send_status_result(uint32_t size)
 {
@@ -203,6 +311,10 @@ static void ble_log_send_data_end()
 
     ble_log_env_t *env = ble_log_get_env();
 
+#ifdef BLE_LOG_USING_LZ4
+    ble_log_lz4_end();
+#endif
+
     uint16_t data_len = 1;
     uint16_t len = SERIAL_TRANS_HEADER + data_len;
     uint8_t *f_data = (uint8_t *)bt_mem_alloc(len);
@@ -522,6 +634,9 @@ static void ble_send_thread(void *param)
     ble_log_connection_recover();
 
     ble_log_send_data_finish();
+#ifdef BLE_LOG_USING_LZ4
+    env->lz4 = 0;
+#endif
 
     if (env->command == BLE_LOG_GET)
     {
@@ -582,14 +697,21 @@ static void ble_log_get_data_send()
 static void ble_log_send_data_response(uint32_t size)
 {
     uint8_t start_flag = BLE_LOG_GET_SEND_START;
-    uint8_t *start_data = (uint8_t *)bt_mem_alloc(sizeof(uint32_t) + sizeof(uint8_t));
+    uint16_t data_len = sizeof(uint32_t) + sizeof(uint8_t);
+    uint8_t *start_data = (uint8_t *)bt_mem_alloc(data_len + sizeof(uint8_t));
     BT_OOM_ASSERT(start_data);
     if (start_data)
     {
         rt_memcpy(start_data, &start_flag, sizeof(uint8_t));
 
         rt_memcpy(start_data + sizeof(uint8_t), &size, sizeof(uint32_t));
-        ble_log_data_send(start_data, sizeof(uint32_t) + sizeof(uint8_t));
+#ifdef BLE_LOG_USING_LZ4
+        if (ble_log_get_env()->lz4)
+        {
+            start_data[data_len++] = BLE_LOG_FORMAT_LZ4;
+        }
+#endif
+        ble_log_data_send(start_data, data_len);
         bt_mem_free(start_data);
     }
 }
@@ -903,6 +1025,9 @@ static void ble_log_packet_handler(ble_log_protocol_t *msg, uint16_t length)
     case BLE_LOG_GET:
     {
         env->command = BLE_LOG_GET;
+#ifdef BLE_LOG_USING_LZ4
+        ble_log_lz4_request(msg);
+#endif
         ble_log_start_send_thread();
         break;
     }
@@ -928,6 +1053,9 @@ static void ble_log_packet_handler(ble_log_protocol_t *msg, uint16_t length)
     case BLE_LOG_ASSERT_GET:
     {
         env->command = BLE_LOG_ASSERT_GET;
+#ifdef BLE_LOG_USING_LZ4
+        ble_log_lz4_request(msg);
+#endif
         ble_log_start_send_thread();
         break;
     }
@@ -999,6 +1127,9 @@ static void ble_log_packet_handler(ble_log_protocol_t *msg, uint16_t length)
     case BLE_LOG_METRICS_GET:
     {
         env->command = BLE_LOG_METRICS_GET;
+#ifdef BLE_LOG_USING_LZ4
+        ble_log_lz4_request(msg);
+#endif
         ble_log_start_send_thread();
         break;
     }
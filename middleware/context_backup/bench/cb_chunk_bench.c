@@ -0,0 +1,223 @@
+/**
+  ******************************************************************************
+  * @file   cb_chunk_bench.c
+  * @author Sifli software development team
+  * @brief Host benchmark of context backup chunked LZ4 format
+ *
+  * Build and run on host:
+  *   gcc -O2 -I.. -I../../../external/lz4 cb_chunk_bench.c ../cb_chunk.c ../../../external/lz4/lz4.c -o cb_chunk_bench
+  *   ./cb_chunk_bench [ram_dump_file] [rounds]
+  *
+  * Synthetic RAM-like data is used if no dump file is given.
+  ******************************************************************************
+*/
+/**
+ * @attention
+ * Copyright (c) 2019 - 2022,  Sifli Technology
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Sifli integrated circuit
+ *    in a product or a software update for such product, must reproduce the above
+ *    copyright notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Sifli nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Sifli integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY SIFLI TECHNOLOGY "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL SIFLI TECHNOLOGY OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "lz4.h"
+#include "cb_chunk.h"
+
+#define BENCH_DEFAULT_SIZE   (256 * 1024)
+#define BENCH_DEFAULT_ROUNDS (20)
+
+static const uint32_t chunk_size_list[] = {1024, 2048, 4096, 8192, 16384, 32768, 65536, 0};
+
+static LZ4_stream_t lz4_state;
+
+static double bench_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* zero filled areas, pointer tables, repeated structures and random payload */
+static void bench_fill(uint8_t *buf, uint32_t size)
+{
+    uint32_t i;
+    uint32_t kind;
+
+    srand(1);
+    for (i = 0; i < size; i += 4)
+    {
+        kind = (i >> 10) & 3;
+        if (0 == kind)
+        {
+            *(uint32_t *)&buf[i] = 0;
+        }
+        else if (1 == kind)
+        {
+            *(uint32_t *)&buf[i] = 0x20000000 + (rand() & 0xFFFC);
+        }
+        else if (2 == kind)
+        {
+            *(uint32_t *)&buf[i] = (i & 0x3F) * 0x01010101;
+        }
+        else
+        {
+            *(uint32_t *)&buf[i] = rand();
+        }
+    }
+}
+
+static uint8_t *bench_load(const char *path, uint32_t *size)
+{
+    FILE *fp;
+    uint8_t *buf;
+    long len;
+
+    fp = fopen(path, "rb");
+    if (!fp)
+    {
+        return NULL;
+    }
+    fseek(fp, 0, SEEK_END);
+    len = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    /* keep 4 bytes alignment */
+    len &= ~3L;
+    buf = malloc(len > 0 ? len : 4);
+    if (buf && (len > 0) && (fread(buf, 1, len, fp) != (size_t)len))
+    {
+        free(buf);
+        buf = NULL;
+    }
+    fclose(fp);
+    *size = (uint32_t)len;
+
+    return buf;
+}
+
+int main(int argc, char **argv)
+{
+    uint8_t *src;
+    uint8_t *cmpr;
+    uint8_t *out;
+    uint32_t size;
+    uint32_t cmpr_bound;
+    uint32_t cmpr_size;
+    uint32_t out_size;
+    uint32_t rounds;
+    uint32_t i;
+    uint32_t r;
+    double t0;
+    double cmpr_time;
+    double dec_time;
+
+    size = BENCH_DEFAULT_SIZE;
+    rounds = (argc > 2) ? atoi(argv[2]) : BENCH_DEFAULT_ROUNDS;
+    if ((argc > 1) && strcmp(argv[1], "-"))
+    {
+        src = bench_load(argv[1], &size);
+        if (!src || (0 == size))
+        {
+            printf("fail to load %s\n", argv[1]);
+            return 1;
+        }
+    }
+    else
+    {
+        src = malloc(size);
+        if (!src)
+        {
+            return 1;
+        }
+        bench_fill(src, size);
+    }
+    if (0 == rounds)
+    {
+        rounds = 1;
+    }
+
+    /* worst case: every chunk is 1KB and incompressible */
+    cmpr_bound = LZ4_compressBound(size) + (size / 1024 + 1) * (CB_CHUNK_HDR_SIZE + 4);
+    cmpr = malloc(cmpr_bound);
+    out = malloc(size);
+    if (!cmpr || !out)
+    {
+        return 1;
+    }
+
+    printf("data size %u, rounds %u\n", size, rounds);
+    printf("chunk    ratio   compress(MB/s) decompress(MB/s)\n");
+    for (i = 0; i < sizeof(chunk_size_list) / sizeof(chunk_size_list[0]); i++)
+    {
+        cmpr_size = 0;
+        t0 = bench_now();
+        for (r = 0; r < rounds; r++)
+        {
+            cmpr_size = cb_chunk_compress(&lz4_state, cmpr, src, size, cmpr_bound, chunk_size_list[i], 1);
+        }
+        cmpr_time = bench_now() - t0;
+        if (0 == cmpr_size)
+        {
+            printf("%-8u compress fail\n", chunk_size_list[i]);
+            continue;
+        }
+
+        out_size = 0;
+        t0 = bench_now();
+        for (r = 0; r < rounds; r++)
+        {
+            out_size = cb_chunk_decompress(out, cmpr, cmpr_size, size, cb_chunk_sw_decode, NULL);
+        }
+        dec_time = bench_now() - t0;
+        if ((out_size != size) || memcmp(out, src, size))
+        {
+            printf("%-8u round-trip mismatch\n", chunk_size_list[i]);
+            return 1;
+        }
+
+        printf("%-8u %-7.3f %-14.1f %.1f\n", chunk_size_list[i], (double)cmpr_size / size,
+               (double)size * rounds / cmpr_time / 1e6, (double)size * rounds / dec_time / 1e6);
+    }
+
+    free(src);
+    free(cmpr);
+    free(out);
+
+    return 0;
+}
+
+/************************ (C) COPYRIGHT Sifli Technology *******END OF FILE****/
@@ -0,0 +1,158 @@
+/**
+  ******************************************************************************
+  * @file   cb_chunk.c
+  * @author Sifli software development team
+  * @brief Chunked LZ4 format of context backup
+ *
+  ******************************************************************************
+*/
+/**
+ * @attention
+ * Copyright (c) 2019 - 2022,  Sifli Technology
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Sifli integrated circuit
+ *    in a product or a software update for such product, must reproduce the above
+ *    copyright notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Sifli nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Sifli integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY SIFLI TECHNOLOGY "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL SIFLI TECHNOLOGY OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#include <stdint.h>
+#include <stddef.h>
+#include "lz4.h"
+#include "cb_chunk.h"
+
+/* no RT-Thread dependency so that it can be built on host */
+
+uint32_t cb_chunk_compress(void *state, void *dst, const void *src, uint32_t src_size,
+                           uint32_t dst_size, uint32_t chunk_size, int acceleration)
+{
+    uint8_t *wr_ptr;
+    const uint8_t *rd_ptr;
+    uint32_t remaining;
+    uint32_t org_size;
+    uint32_t used_size;
+    int cmpr_size;
+
+    if ((0 == chunk_size) || (chunk_size > src_size))
+    {
+        chunk_size = src_size;
+    }
+
+    wr_ptr = (uint8_t *)dst;
+    rd_ptr = (const uint8_t *)src;
+    remaining = src_size;
+    used_size = 0;
+    while (remaining > 0)
+    {
+        org_size = (remaining > chunk_size) ? chunk_size : remaining;
+        if ((dst_size - used_size) <= CB_CHUNK_HDR_SIZE)
+        {
+            return 0;
+        }
+        /* every chunk is compressed with a fresh dictionary so that it can be decoded alone */
+        cmpr_size = LZ4_compress_fast_extState(state, (const char *)rd_ptr, (char *)(wr_ptr + CB_CHUNK_HDR_SIZE),
+                                               org_size, dst_size - used_size - CB_CHUNK_HDR_SIZE, acceleration);
+        if ((cmpr_size <= 0) || (CB_CHUNK_SIZE(cmpr_size) > (dst_size - used_size)))
+        {
+            return 0;
+        }
+        *(uint32_t *)wr_ptr = org_size;
+        /* compressed size is also needed by ezip */
+        *((uint32_t *)wr_ptr + 1) = cmpr_size;
+
+        wr_ptr += CB_CHUNK_SIZE(cmpr_size);
+        used_size += CB_CHUNK_SIZE(cmpr_size);
+        rd_ptr += org_size;
+        remaining -= org_size;
+    }
+
+    return used_size;
+}
+
+uint32_t cb_chunk_decompress(void *dst, const void *src, uint32_t src_size,
+                             uint32_t dst_size, cb_chunk_decoder_t decoder, void *ctx)
+{
+    const uint8_t *rd_ptr;
+    uint8_t *wr_ptr;
+    uint32_t org_size;
+    uint32_t cmpr_size;
+    uint32_t out_size;
+    uint32_t consumed;
+
+    rd_ptr = (const uint8_t *)src;
+    wr_ptr = (uint8_t *)dst;
+    out_size = 0;
+    consumed = 0;
+    while (consumed < src_size)
+    {
+        if ((src_size - consumed) < CB_CHUNK_HDR_SIZE)
+        {
+            return 0;
+        }
+        org_size = *(const uint32_t *)rd_ptr;
+        cmpr_size = *((const uint32_t *)rd_ptr + 1);
+        if ((CB_CHUNK_SIZE(cmpr_size) > (src_size - consumed))
+                || (org_size > (dst_size - out_size)))
+        {
+            return 0;
+        }
+
+        if (decoder(ctx, wr_ptr, rd_ptr, org_size, cmpr_size) != org_size)
+        {
+            return 0;
+        }
+
+        rd_ptr += CB_CHUNK_SIZE(cmpr_size);
+        consumed += CB_CHUNK_SIZE(cmpr_size);
+        wr_ptr += org_size;
+        out_size += org_size;
+    }
+
+    return out_size;
+}
+
+uint32_t cb_chunk_sw_decode(void *ctx, void *dst, const void *chunk, uint32_t org_size, uint32_t cmpr_size)
+{
+    int output_size;
+
+    (void)ctx;
+
+    output_size = LZ4_decompress_safe((const char *)chunk + CB_CHUNK_HDR_SIZE, (char *)dst,
+                                      (int)cmpr_size, (int)org_size);
+    if (output_size < 0)
+    {
+        return 0;
+    }
+
+    return (uint32_t)output_size;
+}
+
+/************************ (C) COPYRIGHT Sifli Technology *******END OF FILE****/
@@ -0,0 +1,119 @@
+/**
+  ******************************************************************************
+  * @file   cb_chunk.h
+  * @author Sifli software development team
+  * @brief Chunked LZ4 format of context backup
+ *
+  ******************************************************************************
+*/
+/**
+ * @attention
+ * Copyright (c) 2019 - 2022,  Sifli Technology
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Sifli integrated circuit
+ *    in a product or a software update for such product, must reproduce the above
+ *    copyright notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Sifli nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Sifli integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY SIFLI TECHNOLOGY "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL SIFLI TECHNOLOGY OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef CB_CHUNK_H
+#define CB_CHUNK_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Compressed data is a list of independent chunks, each chunk is 4 bytes aligned
+ *
+ *   chunk := [original size (32bit)][compressed size (32bit)][LZ4 block][padding]
+ *
+ * A chunk can be decoded as soon as it's available, either by EZIP which takes
+ * input from the compressed size field, or by software LZ4.
+ */
+
+/** chunk header size */
+#define CB_CHUNK_HDR_SIZE       (sizeof(uint32_t) * 2)
+/** chunk size including header and padding */
+#define CB_CHUNK_SIZE(cmpr_size)  ((CB_CHUNK_HDR_SIZE + (cmpr_size) + 3) & ~3U)
+
+/**
+ * @brief Decode one chunk
+ * @param[in] ctx context given to cb_chunk_decompress
+ * @param[in] dst output buffer, at least org_size bytes
+ * @param[in] chunk chunk start address, i.e. address of original size field
+ * @param[in] org_size original size of the chunk
+ * @param[in] cmpr_size compressed size of the chunk
+ * @retval decoded size, 0 if failed
+ */
+typedef uint32_t (*cb_chunk_decoder_t)(void *ctx, void *dst, const void *chunk, uint32_t org_size, uint32_t cmpr_size);
+
+/**
+ * @brief Compress data into chunks
+ * @param[in] state LZ4 state, LZ4_stream_t
+ * @param[in] dst output buffer, 4 bytes aligned
+ * @param[in] src data to be compressed
+ * @param[in] src_size data size in byte
+ * @param[in] dst_size output buffer size
+ * @param[in] chunk_size original size of each chunk, 0: single chunk
+ * @param[in] acceleration LZ4 acceleration factor
+ * @retval compressed size including chunk headers, 0 if output buffer is too small
+ */
+uint32_t cb_chunk_compress(void *state, void *dst, const void *src, uint32_t src_size,
+                           uint32_t dst_size, uint32_t chunk_size, int acceleration);
+
+/**
+ * @brief Decompress chunks
+ * @param[in] dst output buffer
+ * @param[in] src compressed data, 4 bytes aligned
+ * @param[in] src_size compressed size including chunk headers
+ * @param[in] dst_size output buffer size
+ * @param[in] decoder chunk decoder
+ * @param[in] ctx context passed to decoder
+ * @retval decompressed size, 0 if data is corrupted or output buffer is too small
+ */
+uint32_t cb_chunk_decompress(void *dst, const void *src, uint32_t src_size,
+                             uint32_t dst_size, cb_chunk_decoder_t decoder, void *ctx);
+
+/**
+ * @brief Decode one chunk by software LZ4, @see cb_chunk_decoder_t
+ */
+uint32_t cb_chunk_sw_decode(void *ctx, void *dst, const void *chunk, uint32_t org_size, uint32_t cmpr_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CB_CHUNK_H */
+/************************ (C) COPYRIGHT Sifli Technology *******END OF FILE****/
@@ -48,12 +48,14 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <string.h>
+#include <stdlib.h>
 #include "board.h"
 #include "context_backup.h"
 #include "log.h"
 #include "mem_section.h"
 #ifdef CONTEXT_BACKUP_COMPRESSION_ENABLED
     #include "lz4.h"
+    #include "cb_chunk.h"
 #endif /* CONTEXT_BACKUP_COMPRESSION_ENABLED */
 
 #ifdef SOC_BF0_HCPU
@@ -61,9 +63,9 @@
 /** context data type  */
 typedef enum
 {
-    CB_DATA_STACK,
-    CB_DATA_HEAP,
-    CB_DATA_STATIC
+    CB_DATA_STACK = CB_REGION_STACK,
+    CB_DATA_HEAP = CB_REGION_HEAP,
+    CB_DATA_STATIC = CB_REGION_STATIC
 } cb_data_type_t;
 
 
@@ -149,6 +151,42 @@ typedef struct
 
 #define CB_MAX_BLOCK_HDR_LIST_LEN     (32)
 
+#ifndef CONTEXT_BACKUP_COMPRESSION_ACCELERATION
+    #define CONTEXT_BACKUP_COMPRESSION_ACCELERATION  (1)
+#endif /* CONTEXT_BACKUP_COMPRESSION_ACCELERATION */
+
+#ifndef CONTEXT_BACKUP_COMPRESSION_CHUNK_SIZE
+    #define CONTEXT_BACKUP_COMPRESSION_CHUNK_SIZE    (0)
+#endif /* CONTEXT_BACKUP_COMPRESSION_CHUNK_SIZE */
+
+#ifdef CONTEXT_BACKUP_INCREMENTAL_ENABLED
+#ifndef CONTEXT_BACKUP_INCREMENTAL_RECORD_NUM
+    #define CONTEXT_BACKUP_INCREMENTAL_RECORD_NUM    (16)
+#endif /* CONTEXT_BACKUP_INCREMENTAL_RECORD_NUM */
+
+/** Compressed block saved by last backup
+ *
+ *  Used to skip compression of data which is unchanged since last backup,
+ *  the compressed data is still in retention memory and can be reused
+ *  as long as it has not been overwritten by the blocks saved before it.
+ */
+typedef struct
+{
+    /** source address */
+    uint32_t src;
+    /** source size in byte */
+    uint32_t src_size;
+    /** checksum of source data */
+    uint32_t src_sum[2];
+    /** address of compressed data in retention memory */
+    uint32_t dst;
+    /** compressed data length in byte */
+    uint32_t dst_len;
+    /** checksum of compressed data */
+    uint32_t dst_sum[2];
+} cb_incr_record_t;
+#endif /* CONTEXT_BACKUP_INCREMENTAL_ENABLED */
+
 
 RETM_BSS_SECT_BEGIN(cb_context_db)
 static cb_context_db_t *cb_context_db RETM_BSS_SECT(cb_context_db);
@@ -157,8 +195,29 @@ RETM_BSS_SECT_END
 RETM_BSS_SECT_BEGIN(cb_context_db_stats)
 static uint32_t cb_max_used_size RETM_BSS_SECT(cb_context_db_stats);
 static uint32_t cb_total_size RETM_BSS_SECT(cb_context_db_stats);
+/* kept in retention memory as static data is overwritten by restore */
+static cb_region_stats_t cb_region_stats[CB_REGION_TYPE_NUM] RETM_BSS_SECT(cb_context_db_stats);
 RETM_BSS_SECT_END
 
+#ifdef CONTEXT_BACKUP_INCREMENTAL_ENABLED
+RETM_BSS_SECT_BEGIN(cb_incr_record)
+static cb_incr_record_t cb_incr_record[CONTEXT_BACKUP_INCREMENTAL_RECORD_NUM] RETM_BSS_SECT(cb_incr_record);
+/** valid record number of last backup */
+static uint32_t cb_incr_record_num RETM_BSS_SECT(cb_incr_record);
+RETM_BSS_SECT_END
+
+/** next record to be written in current backup */
+static uint32_t cb_incr_wr_idx;
+/** next record of last backup to be searched */
+static uint32_t cb_incr_rd_idx;
+/** checksum of the source data being compressed */
+static uint32_t cb_incr_src_sum[2];
+#endif /* CONTEXT_BACKUP_INCREMENTAL_ENABLED */
+
+/** data type of the blocks being saved, used for statistics */
+static cb_data_type_t cb_curr_data_type;
+static uint32_t cb_acceleration = CONTEXT_BACKUP_COMPRESSION_ACCELERATION;
+
 
 L1_NON_RET_BSS_SECT_BEGIN(last_context_db)
 L1_NON_RET_BSS_SECT(last_context_db, RT_USED static cb_context_db_t last_context_db);
@@ -217,6 +276,14 @@ static void cb_update_db(void *user_data, cb_restore_callback_t callback,
     cb_context_db->total_block_len += CB_BLOCK_SIZE(hdr->data_len);
     RT_ASSERT(cb_context_db->total_block_len <= cb_context_db->max_len);
 
+    cb_region_stats[data_type].block_num++;
+    cb_region_stats[data_type].saved_size += CB_BLOCK_SIZE(hdr->data_len);
+    if (!compressed)
+    {
+        /* raw size of compressed block is counted by compressor */
+        cb_region_stats[data_type].raw_size += used_size;
+    }
+
 }
 
 #if 0
@@ -330,69 +397,209 @@ static rt_err_t cb_save_all_stacks(void)
 }
 
 #ifdef CONTEXT_BACKUP_COMPRESSION_ENABLED
+#ifdef CONTEXT_BACKUP_INCREMENTAL_ENABLED
+static void cb_checksum(const void *data, uint32_t size, uint32_t sum[2])
+{
+    const uint8_t *p;
+    uint32_t a;
+    uint32_t b;
+    uint32_t w;
+    uint32_t n;
+
+    p = (const uint8_t *)data;
+    /* FNV-1a and rotate-add over 32bit words, 64bit in total */
+    a = 0x811C9DC5 ^ size;
+    b = size;
+    if (0 == ((uint32_t)p & 3))
+    {
+        for (n = size >> 2; n > 0; n--)
+        {
+            w = *(const uint32_t *)p;
+            a = (a ^ w) * 0x01000193;
+            b = ((b << 7) | (b >> 25)) + w;
+            p += 4;
+        }
+        size &= 3;
+    }
+    for (; size > 0; size--)
+    {
+        w = *p++;
+        a = (a ^ w) * 0x01000193;
+        b = ((b << 7) | (b >> 25)) + w;
+    }
+
+    sum[0] = a;
+    sum[1] = b;
+}
+
+/** Find compressed data of last backup which can be reused
+ *
+ * @return length of reused data, 0 if data has to be compressed
+ */
+static rt_ubase_t cb_incr_reuse(void *dst, const void *src, rt_ubase_t src_size, rt_ubase_t dst_size)
+{
+    cb_incr_record_t *rec;
+    uint32_t sum[2];
+    uint32_t i;
+
+    cb_checksum(src, src_size, cb_incr_src_sum);
+
+    /* records before write index have been overwritten by current backup */
+    i = (cb_incr_rd_idx > cb_incr_wr_idx) ? cb_incr_rd_idx : cb_incr_wr_idx;
+    for (; i < cb_incr_record_num; i++)
+    {
+        if (cb_incr_record[i].src == (uint32_t)src)
+        {
+            break;
+        }
+    }
+    if (i >= cb_incr_record_num)
+    {
+        return 0;
+    }
+    cb_incr_rd_idx = i + 1;
+
+    rec = &cb_incr_record[i];
+    if ((rec->src_size != src_size)
+            || (rec->src_sum[0] != cb_incr_src_sum[0])
+            || (rec->src_sum[1] != cb_incr_src_sum[1]))
+    {
+        return 0;
+    }
+
+    /* all data saved in current backup is below dst,
+     * compressed data at or above dst is not overwritten yet
+     */
+    if ((rec->dst < (uint32_t)dst)
+            || ((rec->dst + rec->dst_len) > ((uint32_t)dst + dst_size)))
+    {
+        return 0;
+    }
+
+    cb_checksum((void *)rec->dst, rec->dst_len, sum);
+    if ((rec->dst_sum[0] != sum[0]) || (rec->dst_sum[1] != sum[1]))
+    {
+        return 0;
+    }
+
+    if (rec->dst != (uint32_t)dst)
+    {
+        memmove(dst, (void *)rec->dst, rec->dst_len);
+    }
+
+    return rec->dst_len;
+}
+
+static void cb_incr_update(void *dst, const void *src, rt_ubase_t src_size, rt_ubase_t dst_len, bool reused)
+{
+    cb_incr_record_t *rec;
+
+    if (cb_incr_wr_idx >= CONTEXT_BACKUP_INCREMENTAL_RECORD_NUM)
+    {
+        return;
+    }
+
+    rec = &cb_incr_record[cb_incr_wr_idx];
+    if (reused)
+    {
+        /* reused record is at or after write index, compressed data is unchanged */
+        RT_ASSERT((cb_incr_rd_idx > 0) && ((cb_incr_rd_idx - 1) >= cb_incr_wr_idx));
+        rec->dst_sum[0] = cb_incr_record[cb_incr_rd_idx - 1].dst_sum[0];
+        rec->dst_sum[1] = cb_incr_record[cb_incr_rd_idx - 1].dst_sum[1];
+    }
+    else
+    {
+        cb_checksum(dst, dst_len, rec->dst_sum);
+    }
+    rec->src = (uint32_t)src;
+    rec->src_size = src_size;
+    rec->src_sum[0] = cb_incr_src_sum[0];
+    rec->src_sum[1] = cb_incr_src_sum[1];
+    rec->dst = (uint32_t)dst;
+    rec->dst_len = dst_len;
+    cb_incr_wr_idx++;
+}
+#endif /* CONTEXT_BACKUP_INCREMENTAL_ENABLED */
+
 static rt_ubase_t cb_compress_data(void *dst, const void *src, rt_ubase_t src_size, rt_ubase_t dst_size)
 {
     rt_ubase_t cmpr_len;
-    uint32_t size_field_len = sizeof(uint32_t) * 2;
-    cmpr_len = LZ4_compress_fast_extState(&lz4_ctx, (const char *)src, (void *)((uint32_t)dst + size_field_len),
-                                          src_size, dst_size - size_field_len, 1);
+
+    cb_region_stats[cb_curr_data_type].raw_size += src_size;
+
+#ifdef CONTEXT_BACKUP_INCREMENTAL_ENABLED
+    cmpr_len = cb_incr_reuse(dst, src, src_size, dst_size);
     if (cmpr_len > 0)
     {
-        /* save orignal size */
-        *(uint32_t *)dst = src_size;
-        /* save compressed size which is needed by ezip for decompression */
-        *((uint32_t *)dst + 1) = cmpr_len;
-        return (cmpr_len + size_field_len);
+        cb_incr_update(dst, src, src_size, cmpr_len, true);
+        cb_region_stats[cb_curr_data_type].reused_num++;
+        return cmpr_len;
     }
-    else
+#endif /* CONTEXT_BACKUP_INCREMENTAL_ENABLED */
+
+    cmpr_len = cb_chunk_compress(&lz4_ctx, dst, src, src_size, dst_size,
+                                 CONTEXT_BACKUP_COMPRESSION_CHUNK_SIZE, cb_acceleration);
+#ifdef CONTEXT_BACKUP_INCREMENTAL_ENABLED
+    if (cmpr_len > 0)
     {
-        return 0;
+        cb_incr_update(dst, src, src_size, cmpr_len, false);
     }
+#endif /* CONTEXT_BACKUP_INCREMENTAL_ENABLED */
+
+    return cmpr_len;
 }
 
-static rt_ubase_t cb_decompress_data(void *dst, const void *src, rt_ubase_t src_size, rt_ubase_t dst_size)
+#ifndef CONTEXT_BACKUP_SW_DECOMPRESSION
+/* ctx is the EZIP handle, it must not be in static RAM which is being restored */
+static uint32_t cb_ezip_decode(void *ctx, void *dst, const void *chunk, uint32_t org_size, uint32_t cmpr_size)
 {
     EZIP_DecodeConfigTypeDef config;
     HAL_StatusTypeDef res;
-    uint32_t size_field_len = sizeof(uint32_t) * 2;
-    EZIP_HandleTypeDef ezip_handle = {0};
-    uint32_t org_size;
-    uint32_t cmpr_size;
-    uint32_t output_size;
 
-    org_size = *(uint32_t *)src;
-    cmpr_size = *((uint32_t *)src + 1);
-    if (org_size > dst_size)
-    {
-        return 0;
-    }
+    /* skip orignal size field, ezip takes compressed size field as input header */
+    config.input = (uint8_t *)((uint32_t)chunk + sizeof(uint32_t));
+    config.output = dst;
+    config.start_x = 0;
+    config.start_y = 0;
+    config.width = 0;
+    config.height = 0;
+    config.work_mode = HAL_EZIP_MODE_LZ4;
+    config.output_mode = HAL_EZIP_OUTPUT_AHB;
+    res = HAL_EZIP_Decode((EZIP_HandleTypeDef *)ctx, &config);
+    RT_ASSERT(HAL_OK == res);
+
+    return org_size;
+}
+#endif /* !CONTEXT_BACKUP_SW_DECOMPRESSION */
 
+static rt_ubase_t cb_decompress_data(void *dst, const void *src, rt_ubase_t src_size, rt_ubase_t dst_size)
+{
+    cb_chunk_decoder_t decoder;
+    void *ctx;
+    uint32_t output_size;
+#ifndef CONTEXT_BACKUP_SW_DECOMPRESSION
+    EZIP_HandleTypeDef ezip_handle;
+#endif /* !CONTEXT_BACKUP_SW_DECOMPRESSION */
+
+    /* Use software decompression if EZIP cannot access src or dst buffer */
+    decoder = cb_chunk_sw_decode;
+    ctx = RT_NULL;
+#ifndef CONTEXT_BACKUP_SW_DECOMPRESSION
     if (CB_IS_IN_EZIP_ADDR_RANGE((uint32_t)dst) && CB_IS_IN_EZIP_ADDR_RANGE((uint32_t)src))
     {
-        /* skip orignal size field */
-        config.input = (uint8_t *)((uint32_t)src + sizeof(uint32_t));
-        config.output = dst;
-        config.start_x = 0;
-        config.start_y = 0;
-        config.width = 0;
-        config.height = 0;
-        config.work_mode = HAL_EZIP_MODE_LZ4;
-        config.output_mode = HAL_EZIP_OUTPUT_AHB;
+        memset(&ezip_handle, 0, sizeof(ezip_handle));
         ezip_handle.Instance = hwp_ezip;
         HAL_EZIP_Init(&ezip_handle);
-        res = HAL_EZIP_Decode(&ezip_handle, &config);
-        RT_ASSERT(HAL_OK == res);
-    }
-    else
-    {
-        /* Use software decompression instead as EZIP cannot access src or dst buffer */
-        /* skip two size fields */
-        src = (void *)((uint32_t *)src + 2);
-        output_size = LZ4_decompress_safe(src, (char *)dst, cmpr_size, org_size);
-        RT_ASSERT(output_size == org_size);
+        decoder = cb_ezip_decode;
+        ctx = &ezip_handle;
     }
+#endif /* !CONTEXT_BACKUP_SW_DECOMPRESSION */
 
-    return org_size;
+    /* chunks are decoded one by one, output of decoded chunks is ready before the end */
+    output_size = cb_chunk_decompress(dst, src, src_size, dst_size, decoder, ctx);
+    RT_ASSERT(output_size > 0);
+
+    return output_size;
 }
 
 #endif
@@ -626,39 +833,55 @@ rt_err_t cb_deinit(void)
 rt_err_t cb_save_context(void)
 {
     rt_err_t err;
+    uint32_t start_time;
 
     if (!cb_context_db)
     {
         return RT_ERROR;
     }
 
+    memset(cb_region_stats, 0, sizeof(cb_region_stats));
+#ifdef CONTEXT_BACKUP_INCREMENTAL_ENABLED
+    cb_incr_wr_idx = 0;
+    cb_incr_rd_idx = 0;
+#endif /* CONTEXT_BACKUP_INCREMENTAL_ENABLED */
+
     /* static data is restored first as heap restore needs static variable */
     if (cb_context_db->backup_mask & CB_BACKUP_STATIC_DATA_MASK)
     {
+        start_time = HAL_GTIMER_READ();
+        cb_curr_data_type = CB_DATA_STATIC;
         err = cb_save_static_data();
         if (RT_EOK != err)
         {
             goto __EXIT;
         }
+        cb_region_stats[CB_DATA_STATIC].save_time = HAL_GTIMER_READ() - start_time;
     }
 
     if (cb_context_db->backup_mask & CB_BACKUP_HEAP_MASK)
     {
+        start_time = HAL_GTIMER_READ();
+        cb_curr_data_type = CB_DATA_HEAP;
         err = cb_save_all_heaps();
         if (RT_EOK != err)
         {
             goto __EXIT;
         }
+        cb_region_stats[CB_DATA_HEAP].save_time = HAL_GTIMER_READ() - start_time;
     }
 
     /* stack is restored after static data and heap, as thread control block is needed by stack restore  */
     if (cb_context_db->backup_mask & CB_BACKUP_STACK_MASK)
     {
+        start_time = HAL_GTIMER_READ();
+        cb_curr_data_type = CB_DATA_STACK;
         err = cb_save_all_stacks();
         if (RT_EOK != err)
         {
             goto __EXIT;
         }
+        cb_region_stats[CB_DATA_STACK].save_time = HAL_GTIMER_READ() - start_time;
     }
 
     if (cb_context_db->total_block_len > cb_max_used_size)
@@ -667,9 +890,17 @@ rt_err_t cb_save_context(void)
         cb_total_size = cb_context_db->max_len;
     }
 
+#ifdef CONTEXT_BACKUP_INCREMENTAL_ENABLED
+    cb_incr_record_num = cb_incr_wr_idx;
+#endif /* CONTEXT_BACKUP_INCREMENTAL_ENABLED */
+
     return RT_EOK;
 
 __EXIT:
+#ifdef CONTEXT_BACKUP_INCREMENTAL_ENABLED
+    /* records have been partially overwritten */
+    cb_incr_record_num = 0;
+#endif /* CONTEXT_BACKUP_INCREMENTAL_ENABLED */
 
     return err;
 }
@@ -732,5 +963,178 @@ void cb_get_stats(uint32_t *total, uint32_t *min_free)
         *min_free = cb_total_size - cb_max_used_size;
     }
 }
+rt_err_t cb_get_region_stats(cb_region_type_t type, cb_region_stats_t *stats)
+{
+    if ((type >= CB_REGION_TYPE_NUM) || !stats)
+    {
+        return RT_EINVAL;
+    }
+
+    memcpy(stats, &cb_region_stats[type], sizeof(*stats));
+
+    return RT_EOK;
+}
+
+void cb_set_compression_level(uint32_t acceleration)
+{
+    /* LZ4 treats acceleration below 1 as 1 */
+    cb_acceleration = acceleration;
+}
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+static void cb_print_region_stats(void)
+{
+    static const char *const type_name[CB_REGION_TYPE_NUM] = {"stack", "heap", "static"};
+    cb_region_stats_t *stats;
+    uint32_t i;
+
+    rt_kprintf("type    blocks reused raw      saved    time(us)\n");
+    for (i = 0; i < CB_REGION_TYPE_NUM; i++)
+    {
+        stats = &cb_region_stats[i];
+        rt_kprintf("%-7s %-6d %-6d %-8d %-8d %d\n", type_name[i], stats->block_num, stats->reused_num,
+                   stats->raw_size, stats->saved_size,
+                   (uint32_t)((uint64_t)stats->save_time * 1000000 / HAL_LPTIM_GetFreq()));
+    }
+    rt_kprintf("acceleration: %d, total: %d, min free: %d\n", cb_acceleration,
+               cb_total_size, cb_total_size - cb_max_used_size);
+}
+
+#ifdef CONTEXT_BACKUP_TEST
+/* Backup heap buffers as static data regions and check round-trip */
+static rt_err_t cb_test(uint32_t size, uint32_t rounds)
+{
+    cb_backup_param_t param;
+    uint8_t *src;
+    uint8_t *ref;
+    uint8_t *ret_mem;
+    uint32_t region_len;
+    uint32_t i;
+    uint32_t r;
+    uint32_t start_time;
+    uint32_t save_time;
+    uint32_t restore_time;
+    rt_err_t err;
+
+    if (cb_context_db)
+    {
+        rt_kprintf("context backup is in use\n");
+        return RT_EBUSY;
+    }
+
+    region_len = RT_ALIGN_DOWN(size / CB_MAX_BACKUP_REGION_NUM, 4);
+    size = region_len * CB_MAX_BACKUP_REGION_NUM;
+    src = rt_malloc(size);
+    ref = rt_malloc(size);
+    /* space for incompressible data */
+    ret_mem = rt_malloc(CB_CONTEXT_DB_HDR_SIZE + size + size / 128 + 256);
+    if (!src || !ref || !ret_mem || (0 == region_len))
+    {
+        err = RT_ENOMEM;
+        goto __EXIT;
+    }
+
+    for (i = 0; i < size; i++)
+    {
+        /* partially compressible pattern */
+        src[i] = (i & 0x40) ? (uint8_t)(i >> 3) : (uint8_t)rand();
+    }
+
+    param.ret_mem_start_addr = (uint32_t)ret_mem;
+    param.ret_mem_size = CB_CONTEXT_DB_HDR_SIZE + size + size / 128 + 256;
+    param.backup_mask = CB_BACKUP_STATIC_DATA_MASK;
+    param.backup_region_num = CB_MAX_BACKUP_REGION_NUM;
+    for (i = 0; i < CB_MAX_BACKUP_REGION_NUM; i++)
+    {
+        param.backup_region_list[i].start_addr = (uint32_t)src + i * region_len;
+        param.backup_region_list[i].len = region_len;
+    }
+
+    err = RT_EOK;
+    for (r = 0; (r < rounds) && (RT_EOK == err); r++)
+    {
+        /* change one region per round, others can be reused */
+        if (r > 0)
+        {
+            src[(r % CB_MAX_BACKUP_REGION_NUM) * region_len + (r % region_len)] ^= 0x5A;
+        }
+        memcpy(ref, src, size);
+
+        err = cb_init(&param);
+        if (RT_EOK != err)
+        {
+            break;
+        }
+        start_time = HAL_GTIMER_READ();
+        err = cb_save_context();
+        save_time = HAL_GTIMER_READ() - start_time;
+        if (RT_EOK == err)
+        {
+            memset(src, 0, size);
+            start_time = HAL_GTIMER_READ();
+            err = cb_restore_context();
+            restore_time = HAL_GTIMER_READ() - start_time;
+        }
+        if ((RT_EOK == err) && (0 != memcmp(src, ref, size)))
+        {
+            err = RT_ERROR;
+        }
+        cb_deinit();
+
+        rt_kprintf("round %d: %s, reused %d/%d, saved %d/%d, save %dus, restore %dus\n", r,
+                   (RT_EOK == err) ? "ok" : "fail",
+                   cb_region_stats[CB_DATA_STATIC].reused_num, cb_region_stats[CB_DATA_STATIC].block_num,
+                   cb_region_stats[CB_DATA_STATIC].saved_size, size,
+                   (uint32_t)((uint64_t)save_time * 1000000 / HAL_LPTIM_GetFreq()),
+                   (uint32_t)((uint64_t)restore_time * 1000000 / HAL_LPTIM_GetFreq()));
+    }
+
+__EXIT:
+#ifdef CONTEXT_BACKUP_INCREMENTAL_ENABLED
+    /* test blocks must not be reused by system backup */
+    cb_incr_record_num = 0;
+#endif /* CONTEXT_BACKUP_INCREMENTAL_ENABLED */
+    rt_free(src);
+    rt_free(ref);
+    rt_free(ret_mem);
+
+    return err;
+}
+#endif /* CONTEXT_BACKUP_TEST */
+
+static int cmd_cb(int argc, char **argv)
+{
+    if ((argc >= 3) && (0 == strcmp(argv[1], "level")))
+    {
+        cb_set_compression_level(atoi(argv[2]));
+    }
+#ifdef CONTEXT_BACKUP_TEST
+    else if ((argc >= 2) && (0 == strcmp(argv[1], "test")))
+    {
+        uint32_t size = (argc >= 3) ? atoi(argv[2]) : 16384;
+        uint32_t rounds = (argc >= 4) ? atoi(argv[3]) : 4;
+
+        if (RT_EOK != cb_test(size, rounds))
+        {
+            rt_kprintf("test fail\n");
+        }
+        return 0;
+    }
+#endif /* CONTEXT_BACKUP_TEST */
+    else if (argc >= 2)
+    {
+        rt_kprintf("usage: cb [level <acceleration>|test [size] [rounds]]\n");
+        return 0;
+    }
+
+    cb_print_region_stats();
+
+    return 0;
+}
+MSH_CMD_EXPORT_ALIAS(cmd_cb, cb, context backup statistics and test);
+#endif /* RT_USING_FINSH */
+
 #endif // SOC_BF0_HCPU
 
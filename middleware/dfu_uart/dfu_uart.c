@@ -114,6 +114,9 @@ static uint32_t crc32mpeg2_table[] = {
 static dfu_uart_env_t g_dfu_uart_env;
 static void dfu_uart_send(uint8_t *data, uint16_t len);
 int dfu_uart_forward_init(void);
+#ifdef DFU_UART_USING_WINDOW
+static void dfu_uart_window_stop(dfu_uart_env_t *env);
+#endif
 
 static void run_img(uint8_t *dest)
 {
@@ -501,6 +504,10 @@ static void dfu_uart_image_end_rsp(dfu_uart_env_t *env, uint16_t result)
 static void dfu_uart_image_end_handler(dfu_uart_env_t *env, uint8_t *data, uint16_t data_len)
 {
     uint8_t status = DFU_UART_ERROR_NO_ERROR;
+#ifdef DFU_UART_USING_WINDOW
+    // let the writer program the packets in flight
+    dfu_uart_window_stop(env);
+#endif
     LOG_I("dfu_uart_image_end_handler %d", env->image_current_length);
     if (env->image_current_length != env->image_total_length)
     {
@@ -569,6 +576,347 @@ static void dfu_uart_end_handler(dfu_uart_env_t *env, uint8_t *data, uint16_t da
     }
 }
 
+#ifdef DFU_UART_USING_WINDOW
+// below the receiver thread, the uart is not to be held off by the flash
+#define DFU_UART_WRITER_PRIORITY    16
+// sectors erased ahead of the data written
+#define DFU_UART_ERASE_AHEAD        4
+// ms before an index error is reported again
+#define DFU_UART_NAK_TIMEOUT        200
+
+static uint32_t dfu_uart_erase_align(void)
+{
+#ifdef SF32LB55X
+    return 0x2000;
+#else
+    return 0x1000;
+#endif
+}
+
+static void dfu_uart_data_ack(dfu_uart_env_t *env, uint16_t result, uint16_t next_index)
+{
+    dfu_image_data_ack_t ack;
+    ack.command = DFU_UART_IMAGE_DATA_ACK;
+    ack.length = 4;
+    ack.result = result;
+    ack.next_index = next_index;
+
+    dfu_uart_send((uint8_t *)&ack, sizeof(dfu_image_data_ack_t));
+}
+
+// erase the sectors up to end, which are not yet erased
+static uint16_t dfu_uart_erase_to(dfu_uart_env_t *env, uint32_t end)
+{
+    uint32_t align = dfu_uart_erase_align();
+    int ret;
+
+    while (env->erased_end < end)
+    {
+        ret = rt_flash_erase(env->erased_end, align);
+        if (ret != 0)
+        {
+            LOG_E("flash erase 0x%x error with %d", env->erased_end, ret);
+            return DFU_UART_ERROR_FLASH_ERASE_ERROR;
+        }
+        env->erased_end += align;
+    }
+    return DFU_UART_ERROR_NO_ERROR;
+}
+
+static void dfu_uart_writer_entry(void *param)
+{
+    dfu_uart_env_t *env = (dfu_uart_env_t *)param;
+    rt_ubase_t value;
+    rt_int32_t timeout;
+    uint8_t *slot;
+    uint16_t len, index;
+
+    while (1)
+    {
+        // nothing to write, erase ahead a few sectors, one per tick so the
+        // receiver is not held off
+        timeout = RT_WAITING_FOREVER;
+        if (env->win_active && env->win_result == DFU_UART_ERROR_NO_ERROR &&
+                env->erased_end < env->base_addr + env->image_total_length &&
+                env->erased_end < env->base_addr + env->image_current_length +
+                DFU_UART_ERASE_AHEAD * dfu_uart_erase_align())
+        {
+            timeout = 1;
+        }
+
+        if (rt_mb_recv(env->win_mb, &value, timeout) != RT_EOK)
+        {
+            rt_mutex_take(env->win_lock, RT_WAITING_FOREVER);
+            if (env->win_active)
+                env->win_result = dfu_uart_erase_to(env, env->erased_end + 1);
+            rt_mutex_release(env->win_lock);
+            continue;
+        }
+
+        if (value == 0)
+            continue;
+
+        slot = (uint8_t *)value;
+        memcpy(&len, slot, 2);
+        memcpy(&index, slot + 2, 2);
+
+        rt_mutex_take(env->win_lock, RT_WAITING_FOREVER);
+        if (env->win_result == DFU_UART_ERROR_NO_ERROR)
+        {
+            env->win_result = dfu_uart_erase_to(env, env->base_addr + env->image_current_length + len);
+        }
+        if (env->win_result == DFU_UART_ERROR_NO_ERROR)
+        {
+            if (rt_flash_write(env->base_addr + env->image_current_length, slot + 4, len) != len)
+            {
+                LOG_E("flash write 0x%x error", env->base_addr + env->image_current_length);
+                env->win_result = DFU_UART_ERROR_FLASH_WRITE_ERROR;
+            }
+        }
+        if (env->win_result == DFU_UART_ERROR_NO_ERROR)
+        {
+            env->image_current_length += len;
+            env->image_data_index = index;
+        }
+        rt_mutex_release(env->win_lock);
+
+        rt_sem_release(env->win_free);
+        dfu_uart_data_ack(env, env->win_result, env->image_data_index + 1);
+    }
+}
+
+// wait for the writer to program the packets in flight and free the slots
+static void dfu_uart_window_stop(dfu_uart_env_t *env)
+{
+    uint16_t i;
+    rt_tick_t tick;
+
+    if (!env->win_active)
+        return;
+
+    for (i = 0; i < env->win_size; i++)
+        rt_sem_take(env->win_free, RT_WAITING_FOREVER);
+    // and to finish erasing ahead
+    rt_mutex_take(env->win_lock, RT_WAITING_FOREVER);
+    env->win_active = 0;
+    rt_mutex_release(env->win_lock);
+
+    tick = rt_tick_get() - env->win_start_tick;
+    LOG_I("window %d: %d bytes in %d ms, %d B/s, %d index errors", env->win_size,
+          env->image_current_length, tick * 1000 / RT_TICK_PER_SECOND,
+          tick ? (uint32_t)((uint64_t)env->image_current_length * RT_TICK_PER_SECOND / tick) : 0,
+          env->win_naks);
+
+    free(env->win_buf);
+    env->win_buf = NULL;
+}
+
+static void dfu_uart_image_start_ex_handler(dfu_uart_env_t *env, uint8_t *data, uint16_t data_len)
+{
+    dfu_image_start_ex_req_t req;
+    dfu_image_start_ex_rsp_t rsp;
+    uint16_t window, i;
+
+    LOG_I("dfu_uart_image_start_ex_handler");
+    if (data_len != sizeof(dfu_image_start_ex_req_t))
+    {
+        LOG_I("SIZE ERROR");
+        return;
+    }
+    memcpy(&req, data, sizeof(req));
+    LOG_I("image len %d, ADDR 0x%x, crc 0x%x, data size %d, window %d",
+          req.image_length, req.addr, req.crc, req.data_size, req.window);
+
+    dfu_uart_window_stop(env);
+
+    if (env->win_mb == NULL)
+    {
+        env->win_mb = rt_mb_create("dfu_wr", DFU_UART_WINDOW_SIZE + 1, RT_IPC_FLAG_FIFO);
+        env->win_free = rt_sem_create("dfu_wr", 0, RT_IPC_FLAG_FIFO);
+        env->win_lock = rt_mutex_create("dfu_wr", RT_IPC_FLAG_FIFO);
+        env->win_writer = rt_thread_create("dfu_wr", dfu_uart_writer_entry, env, 2048, DFU_UART_WRITER_PRIORITY, 10);
+        RT_ASSERT(env->win_mb && env->win_free && env->win_lock && env->win_writer);
+        rt_thread_startup(env->win_writer);
+    }
+
+    // the slot holds the packet length, the index and the packet
+    window = req.window < DFU_UART_WINDOW_SIZE ? req.window : DFU_UART_WINDOW_SIZE;
+    if (window == 0)
+        window = 1;
+    env->win_slot_size = RT_ALIGN(4 + req.data_size * 1024, 4);
+    while (window > 0 && (env->win_buf = malloc(window * env->win_slot_size)) == NULL)
+        window--;
+
+    rsp.command = DFU_UART_IMAGE_START_EX_RSP;
+    rsp.length = 4;
+    rsp.result = DFU_UART_ERROR_NO_ERROR;
+    rsp.window = window;
+
+    if (window == 0 || req.data_size == 0)
+    {
+        LOG_E("no memory for window");
+        rsp.result = DFU_UART_ERROR_PACKET_LENGTH_ERROR;
+    }
+    else
+    {
+        // erasing goes on in the writer thread while the data comes
+        env->image_data_index = 0;
+        env->image_current_length = 0;
+        env->image_total_length = req.image_length;
+        env->base_addr = req.addr;
+        env->remote_crc = req.crc;
+        env->single_packet_size = req.data_size * 1024;
+        env->erased_end = RT_ALIGN_DOWN(req.addr, dfu_uart_erase_align());
+
+        env->win_size = window;
+        env->win_slot = 0;
+        env->win_rx_index = 1;
+        env->win_rx_length = 0;
+        env->win_nak = 0;
+        env->win_naks = 0;
+        env->win_result = DFU_UART_ERROR_NO_ERROR;
+        env->win_start_tick = rt_tick_get();
+        for (i = 0; i < window; i++)
+            rt_sem_release(env->win_free);
+        env->win_active = 1;
+        // wake the writer up to erase ahead
+        rt_mb_send(env->win_mb, 0);
+    }
+
+    dfu_uart_send((uint8_t *)&rsp, sizeof(rsp));
+}
+
+static void dfu_uart_read_full(dfu_uart_env_t *env, uint8_t *buf, uint32_t len)
+{
+    rt_uint32_t size;
+    rt_size_t read_len;
+
+    while (len)
+    {
+        read_len = rt_device_read(env->device, 0, buf, len);
+        if (read_len == 0)
+        {
+            rt_mb_recv(env->to_mb, &size, RT_WAITING_FOREVER);
+            continue;
+        }
+        buf += read_len;
+        len -= read_len;
+    }
+}
+
+/*
+ * Take a data packet of the window, the body is read from the uart
+ * straight into a free slot, no assembling. The packets out of order are
+ * dropped, and the first of them reported.
+ */
+static void dfu_uart_window_data(dfu_uart_env_t *env, uint16_t data_len)
+{
+    uint8_t *slot;
+    uint16_t index, len;
+    uint16_t result = DFU_UART_ERROR_NO_ERROR;
+
+    rt_sem_take(env->win_free, RT_WAITING_FOREVER);
+    slot = env->win_buf + env->win_slot * env->win_slot_size;
+    dfu_uart_read_full(env, slot + 2, data_len);
+
+    memcpy(&index, slot + 2, 2);
+    len = data_len - 2;
+    if (index != env->win_rx_index)
+    {
+        result = DFU_UART_ERROR_INDEX_ERROR;
+    }
+    else if (len != env->single_packet_size &&
+             env->win_rx_length + len != env->image_total_length)
+    {
+        result = DFU_UART_ERROR_PACKET_LENGTH_ERROR;
+    }
+
+    if (result != DFU_UART_ERROR_NO_ERROR)
+    {
+        rt_sem_release(env->win_free);
+        // report again when the host goes back for a new round, the resend
+        // may be lost or broken as well, or when the report may be lost
+        if (!env->win_nak || index <= env->win_nak_index ||
+                rt_tick_get() - env->win_nak_tick >= rt_tick_from_millisecond(DFU_UART_NAK_TIMEOUT))
+        {
+            LOG_E("window error %d, expect %d, receive %d", result, env->win_rx_index, index);
+            env->win_nak = 1;
+            env->win_naks++;
+            env->win_nak_tick = rt_tick_get();
+            dfu_uart_data_ack(env, result, env->win_rx_index);
+        }
+        env->win_nak_index = index;
+        return;
+    }
+
+    memcpy(slot, &len, 2);
+    env->win_nak = 0;
+    env->win_rx_index++;
+    env->win_rx_length += len;
+    env->win_slot = (env->win_slot + 1) % env->win_size;
+    rt_mb_send_wait(env->win_mb, (rt_ubase_t)slot, RT_WAITING_FOREVER);
+}
+
+static void dfu_uart_skip(dfu_uart_env_t *env, uint16_t len)
+{
+    uint8_t temp[32];
+    uint16_t size;
+
+    while (len)
+    {
+        size = len < sizeof(temp) ? len : sizeof(temp);
+        dfu_uart_read_full(env, temp, size);
+        len -= size;
+    }
+}
+
+static void dfu_uart_command_process(dfu_uart_env_t *env, uint16_t command, uint8_t *data, rt_uint32_t size);
+
+// frame by frame, resynchronise on the header after garbage
+static void dfu_uart_rx_stream(dfu_uart_env_t *env)
+{
+    uint8_t hdr[DFU_UART_HEADER_EX_LEN];
+    uint32_t header_front = SFUART_HEADER_FRONT;
+    uint16_t header_rear = SFUART_HEADER_REAR;
+    uint16_t have = 0, command, data_len;
+    uint8_t *data;
+
+    while (1)
+    {
+        dfu_uart_read_full(env, hdr + have, sizeof(hdr) - have);
+        have = sizeof(hdr);
+        if (memcmp(hdr, &header_front, SFUART_HEADER_FRONT_LEN) != 0 ||
+                memcmp(hdr + SFUART_HEADER_FRONT_LEN, &header_rear, SFUART_HEADER_REAR_LEN) != 0)
+        {
+            memmove(hdr, hdr + 1, --have);
+            continue;
+        }
+        have = 0;
+
+        memcpy(&command, hdr + SFUART_HEADER_LEN, 2);
+        memcpy(&data_len, hdr + SFUART_HEADER_LEN + 2, 2);
+
+        if (command == DFU_UART_IMAGE_DATA_IND && env->win_active)
+        {
+            if (data_len < 2 || data_len - 2 > env->single_packet_size)
+            {
+                LOG_E("packet length error %d", data_len);
+                dfu_uart_skip(env, data_len);
+                dfu_uart_data_ack(env, DFU_UART_ERROR_PACKET_LENGTH_ERROR, env->win_rx_index);
+                continue;
+            }
+            dfu_uart_window_data(env, data_len);
+            continue;
+        }
+
+        data = malloc(data_len ? data_len : 1);
+        RT_ASSERT(data);
+        dfu_uart_read_full(env, data, data_len);
+        dfu_uart_command_process(env, command, data, data_len);
+        free(data);
+    }
+}
+#endif /* DFU_UART_USING_WINDOW */
 
 static void dfu_uart_command_process(dfu_uart_env_t *env, uint16_t command, uint8_t *data, rt_uint32_t size)
 {
@@ -600,6 +948,13 @@ static void dfu_uart_command_process(dfu_uart_env_t *env, uint16_t command, uint
             dfu_uart_end_handler(env, data, size);
             break;
         }
+#ifdef DFU_UART_USING_WINDOW
+        case DFU_UART_IMAGE_START_EX_REQ:
+        {
+            dfu_uart_image_start_ex_handler(env, data, size);
+            break;
+        }
+#endif
     }
 }
 
@@ -702,11 +1057,17 @@ void dfu_forward_to_mb_entry(void *param)
 {
     dfu_uart_env_t *env = dfu_uart_get_env();
     env->to_mb = rt_mb_create("fwd_mb", 64, RT_IPC_FLAG_FIFO);
+#ifdef DFU_UART_USING_WINDOW
+    env->tx_lock = rt_mutex_create("dfu_tx", RT_IPC_FLAG_FIFO);
+#endif
     dfu_uart_device_init();
 
     // always send start rsp in power on in ota
     dfu_uart_start_rsp(env, 0);
 
+#ifdef DFU_UART_USING_WINDOW
+    dfu_uart_rx_stream(env);
+#else
     rt_uint32_t size;
     uint8_t *ptr;
     int written, offset = 0;
@@ -740,6 +1101,7 @@ void dfu_forward_to_mb_entry(void *param)
         }
         rt_thread_mdelay(10);
     }
+#endif
 }
 
 int dfu_uart_forward_init(void)
@@ -776,7 +1138,14 @@ void dfu_uart_send(uint8_t *data, uint16_t len)
 
         // LOG_HEX("UART SEND", 16, send_data, send_len);
 
+#ifdef DFU_UART_USING_WINDOW
+        // the writer thread acks while the receiver answers
+        rt_mutex_take(env->tx_lock, RT_WAITING_FOREVER);
+#endif
         rt_size_t written = rt_device_write(env->device, 0, send_data, send_len);
+#ifdef DFU_UART_USING_WINDOW
+        rt_mutex_release(env->tx_lock);
+#endif
         RT_ASSERT(send_len == written);
 
         free(send_data);
@@ -79,6 +79,30 @@ typedef struct
     uint32_t single_packet_size;
 
     uint8_t mode;
+
+#ifdef DFU_UART_USING_WINDOW
+    // windowed transfer, packets are received while the writer thread
+    // erases and programs the flash
+    uint8_t win_active;
+    uint8_t win_nak;             // index error reported, wait for the resend
+    uint16_t win_size;           // packets in flight
+    uint16_t win_slot;           // next slot to fill
+    uint16_t win_rx_index;       // next index to receive
+    uint16_t win_result;         // first writer error
+    uint32_t win_rx_length;
+    uint32_t win_slot_size;
+    uint8_t *win_buf;
+    rt_sem_t win_free;           // free slots
+    rt_mailbox_t win_mb;         // filled slots, to the writer
+    rt_thread_t win_writer;
+    rt_mutex_t win_lock;         // session state against the writer
+    uint32_t erased_end;
+    rt_tick_t win_start_tick;
+    uint32_t win_naks;
+    uint16_t win_nak_index;      // last index dropped since the report
+    rt_tick_t win_nak_tick;
+    rt_mutex_t tx_lock;
+#endif
 } dfu_uart_env_t;
 
 typedef enum
@@ -99,6 +123,9 @@ typedef enum
     DFU_UART_IMAGE_END_RSP,
     DFU_UART_END_REQ,
     DFU_UART_END_RSP,
+    DFU_UART_IMAGE_START_EX_REQ,
+    DFU_UART_IMAGE_START_EX_RSP,
+    DFU_UART_IMAGE_DATA_ACK,
 } dfu_uart_command_t;
 
 typedef enum
@@ -119,6 +146,7 @@ typedef enum
     DFU_UART_ERROR_FILE_LENGTH_ERROR,
     DFU_UART_ERROR_PACKET_LENGTH_ERROR,
     DFU_UART_ERROR_CRC_ERROR,
+    DFU_UART_ERROR_FLASH_WRITE_ERROR,
 } dfu_uart_error_t;
 
 // save image state position
@@ -147,7 +175,11 @@ typedef enum
 
 #define DFU_UART_MAX_BLOCK_SIZE 2048
 
+#ifdef DFU_UART_USING_WINDOW
+#define DFU_UART_VERSION 2
+#else
 #define DFU_UART_VERSION 1
+#endif
 
 typedef struct
 {
@@ -170,6 +202,37 @@ typedef struct
     uint8_t packet[0];
 } dfu_image_data_t;
 
+/*
+ * Windowed transfer, from version 2. The host sends up to "window" data
+ * packets ahead and each DFU_UART_IMAGE_DATA_ACK tells that every packet
+ * before next_index is written. On an index error the device drops the
+ * packets until the host resends from next_index.
+ */
+typedef struct
+{
+    uint32_t image_length;
+    uint32_t addr;
+    uint32_t crc;
+    uint16_t data_size;
+    uint16_t window;
+} dfu_image_start_ex_req_t;
+
+typedef struct
+{
+    uint16_t command;
+    uint16_t length;
+    uint16_t result;
+    uint16_t window;
+} dfu_image_start_ex_rsp_t;
+
+typedef struct
+{
+    uint16_t command;
+    uint16_t length;
+    uint16_t result;
+    uint16_t next_index;
+} dfu_image_data_ack_t;
+
 typedef struct
 {
     uint16_t command;
@@ -78,6 +78,13 @@
 /* preceding bytes before the actual ezipa header in the file */
 #define EZ_FILE_LEADING_HDR_SIZE   (4)
 
+#define EZ_FILE_POS_UNKNOWN        (0xFFFFFFFF)
+#define EZ_FRAME_SEQ_NONE          (0xFFFFFFFF)
+
+#ifdef EZIPA_PREFETCH
+#define EZ_PREFETCH_MB_SIZE        (8)
+#endif /* EZIPA_PREFETCH */
+
 typedef struct
 {
     uint8_t data0[13];
@@ -668,6 +675,25 @@ static void ezipa_init_file_mode(ezipa_obj_t *obj, const char *filename)
     rd_size = read(obj->fd, (void *)(obj->ezipa_data + frame_hdr_offset), sizeof(ezipa_frame_hdr_t));
     RT_ASSERT(rd_size == sizeof(ezipa_frame_hdr_t));
     obj->fake_frame_offset_tbl[0] = EZ_SWAP32(frame_hdr_offset);
+    obj->hdr_src = obj->ezipa_data + frame_hdr_offset;
+    obj->hdr_src_seq = 0;
+    /* header is read sequentially, position is at frame 0 data now */
+    obj->file_pos = lseek(obj->fd, 0, SEEK_CUR);
+    obj->frame_buf[0] = obj->ezipa_data;
+    obj->prefetch_seq = EZ_FRAME_SEQ_NONE;
+
+#ifdef EZIPA_PREFETCH
+    /* second buffer gets the same header, frame area is filled by prefetch */
+    obj->frame_buf[1] = EZIPA_LARGE_BUF_MALLOC(obj->ezipa_hdr_size + obj->max_frame_size);
+    if (obj->frame_buf[1])
+    {
+        memcpy(obj->frame_buf[1], obj->ezipa_data, obj->ezipa_hdr_size);
+    }
+    else
+    {
+        LOG_D("ezipa prefetch disabled, no memory\n");
+    }
+#endif /* EZIPA_PREFETCH */
 
     if (IS_DCACHED_RAM((uint32_t)obj->ezipa_data))
     {
@@ -680,10 +706,31 @@ static void ezipa_init_file_mode(ezipa_obj_t *obj, const char *filename)
     }
 }
 
-static void ezipa_load_file_data(ezipa_obj_t *obj)
+/* Read at file offset. Only one thread uses obj->fd at a time, so the
+   position of the last read is known and sequential reads skip lseek. */
+static int ezipa_pread(ezipa_obj_t *obj, void *buf, uint32_t len, uint32_t offset)
+{
+    int rd_size;
+
+    if (obj->file_pos != offset)
+    {
+        obj->stats.seeks++;
+        if (lseek(obj->fd, offset, SEEK_SET) != offset)
+        {
+            obj->file_pos = EZ_FILE_POS_UNKNOWN;
+            return -1;
+        }
+    }
+    rd_size = read(obj->fd, buf, len);
+    obj->file_pos = (rd_size > 0) ? (offset + rd_size) : EZ_FILE_POS_UNKNOWN;
+
+    return rd_size;
+}
+
+/* Load frame seq into buf, fake frame offset table of buf is updated for seq and the next frame */
+static void ezipa_load_frame(ezipa_obj_t *obj, uint8_t *buf, uint32_t seq)
 {
-    uint8_t *frame_hdr;
-    uint32_t prev_frame_offset;
+    uint32_t *fake_frame_offset_tbl;
     uint32_t curr_frame_offset;
     uint32_t next_frame_offset;
     uint8_t *frame_data;
@@ -691,60 +738,176 @@ static void ezipa_load_file_data(ezipa_obj_t *obj)
     uint32_t frame_size;
     uint32_t fake_frame_offset;
 
-    RT_ASSERT(obj->org_frame_offset_tbl);
-    RT_ASSERT(obj->fake_frame_offset_tbl)
-    RT_ASSERT(obj->next_frame.seq_num < obj->header.frame_num);
-
-    curr_frame_offset = obj->org_frame_offset_tbl[obj->next_frame.seq_num];
+    fake_frame_offset_tbl = (uint32_t *)(buf + ((uint8_t *)obj->fake_frame_offset_tbl - obj->ezipa_data));
+    curr_frame_offset = obj->org_frame_offset_tbl[seq];
     fake_frame_offset = obj->org_frame_offset_tbl[0];
     /* must be 4 bytes aligned */
     RT_ASSERT(0 == (fake_frame_offset & 3));
     /* copy prefetched frame header to the beginning  */
-    memcpy(obj->ezipa_data + fake_frame_offset,
-           obj->ezipa_data + EZ_SWAP32(obj->fake_frame_offset_tbl[obj->next_frame.seq_num]),
-           sizeof(ezipa_frame_hdr_t));
+    if (obj->hdr_src_seq == seq)
+    {
+        memcpy(buf + fake_frame_offset, obj->hdr_src, sizeof(ezipa_frame_hdr_t));
+    }
+    else
+    {
+        rd_size = ezipa_pread(obj, buf + fake_frame_offset, sizeof(ezipa_frame_hdr_t),
+                              curr_frame_offset + EZ_FILE_LEADING_HDR_SIZE);
+        RT_ASSERT(rd_size == sizeof(ezipa_frame_hdr_t));
+    }
 
     /* update current fake frame start position */
-    obj->fake_frame_offset_tbl[obj->next_frame.seq_num] = EZ_SWAP32(obj->org_frame_offset_tbl[0]);
+    fake_frame_offset_tbl[seq] = EZ_SWAP32(fake_frame_offset);
 
-    frame_data = obj->ezipa_data + fake_frame_offset + sizeof(ezipa_frame_hdr_t);
-    if ((obj->next_frame.seq_num + 1) == obj->frame_num) /* last frame */
+    frame_data = buf + fake_frame_offset + sizeof(ezipa_frame_hdr_t);
+    if ((seq + 1) == obj->frame_num) /* last frame */
     {
         frame_size = obj->file_size - curr_frame_offset;
         /* update offset for frame 0 */
         if (obj->frame_num > 1)
         {
-            obj->fake_frame_offset_tbl[0] = EZ_SWAP32(fake_frame_offset + RT_ALIGN(frame_size, 4));
+            fake_frame_offset_tbl[0] = EZ_SWAP32(fake_frame_offset + RT_ALIGN(frame_size, 4));
         }
-        /* seek to the read position as same file handle might be shared by multiple ezipa objects */
-        lseek(obj->fd, curr_frame_offset + EZ_FILE_LEADING_HDR_SIZE + sizeof(ezipa_frame_hdr_t), SEEK_SET);
-        rd_size = read(obj->fd, (void *)frame_data, frame_size - sizeof(ezipa_frame_hdr_t));
+        rd_size = ezipa_pread(obj, (void *)frame_data, frame_size - sizeof(ezipa_frame_hdr_t),
+                              curr_frame_offset + EZ_FILE_LEADING_HDR_SIZE + sizeof(ezipa_frame_hdr_t));
         RT_ASSERT(rd_size == frame_size - sizeof(ezipa_frame_hdr_t));
-        /* seek to the begin of frame offset table */
-        rd_size = lseek(obj->fd, fake_frame_offset + EZ_FILE_LEADING_HDR_SIZE, SEEK_SET);
-        RT_ASSERT(rd_size == (fake_frame_offset + EZ_FILE_LEADING_HDR_SIZE));
-        rd_size = read(obj->fd, (void *)(obj->ezipa_data + fake_frame_offset + RT_ALIGN(frame_size, 4)),
-                       sizeof(ezipa_frame_hdr_t));
+        /* header of frame 0 is at the begin of frame data */
+        obj->hdr_src = buf + fake_frame_offset + RT_ALIGN(frame_size, 4);
+        rd_size = ezipa_pread(obj, (void *)obj->hdr_src, sizeof(ezipa_frame_hdr_t),
+                              fake_frame_offset + EZ_FILE_LEADING_HDR_SIZE);
         RT_ASSERT(rd_size == sizeof(ezipa_frame_hdr_t));
+        obj->hdr_src_seq = 0;
     }
     else
     {
-        next_frame_offset = obj->org_frame_offset_tbl[obj->next_frame.seq_num + 1];
+        next_frame_offset = obj->org_frame_offset_tbl[seq + 1];
         frame_size = next_frame_offset - curr_frame_offset;
         /* must be 4 bytes aligned */
         RT_ASSERT(0 == (frame_size & 3));
-        obj->fake_frame_offset_tbl[obj->next_frame.seq_num + 1] = EZ_SWAP32(fake_frame_offset + frame_size);
-        /* seek to the read position as same file handle might be shared by multiple ezipa objects */
-        lseek(obj->fd, curr_frame_offset + EZ_FILE_LEADING_HDR_SIZE + sizeof(ezipa_frame_hdr_t), SEEK_SET);
+        fake_frame_offset_tbl[seq + 1] = EZ_SWAP32(fake_frame_offset + frame_size);
         /* read frame data and next frame header */
-        rd_size = read(obj->fd, (void *)frame_data, frame_size);
+        rd_size = ezipa_pread(obj, (void *)frame_data, frame_size,
+                              curr_frame_offset + EZ_FILE_LEADING_HDR_SIZE + sizeof(ezipa_frame_hdr_t));
         RT_ASSERT(rd_size == frame_size);
+        obj->hdr_src = buf + fake_frame_offset + frame_size;
+        obj->hdr_src_seq = seq + 1;
     }
+    obj->stats.frames++;
 
-    if (IS_DCACHED_RAM((uint32_t)obj->ezipa_data))
+    if (IS_DCACHED_RAM((uint32_t)buf))
     {
-        mpu_dcache_clean(obj->ezipa_data, obj->ezipa_hdr_size + obj->max_frame_size);
+        mpu_dcache_clean(buf, obj->ezipa_hdr_size + obj->max_frame_size);
+    }
+}
+
+#ifdef EZIPA_PREFETCH
+static struct rt_mailbox ezipa_prefetch_mb;
+static rt_uint32_t ezipa_prefetch_mb_pool[EZ_PREFETCH_MB_SIZE];
+
+static void ezipa_prefetch_entry(void *param)
+{
+    ezipa_obj_t *obj;
+
+    while (1)
+    {
+        if (RT_EOK != rt_mb_recv(&ezipa_prefetch_mb, (rt_uint32_t *)&obj, RT_WAITING_FOREVER))
+        {
+            continue;
+        }
+        ezipa_load_frame(obj, (obj->ezipa_data == obj->frame_buf[0]) ? obj->frame_buf[1] : obj->frame_buf[0],
+                         obj->prefetch_seq);
+        rt_sem_release(&obj->load_sem);
+    }
+}
+
+static int ezipa_prefetch_init(void)
+{
+    rt_thread_t tid;
+
+    rt_mb_init(&ezipa_prefetch_mb, "ezipa_pf", ezipa_prefetch_mb_pool, EZ_PREFETCH_MB_SIZE, RT_IPC_FLAG_FIFO);
+    tid = rt_thread_create("ezipa_pf", ezipa_prefetch_entry, RT_NULL, EZIPA_PREFETCH_THREAD_STACK_SIZE,
+                           EZIPA_PREFETCH_THREAD_PRIORITY, RT_THREAD_TICK_DEFAULT);
+    RT_ASSERT(tid);
+    rt_thread_startup(tid);
+
+    return 0;
+}
+INIT_COMPONENT_EXPORT(ezipa_prefetch_init);
+
+/* Wait for the running prefetch, return true if it had finished already */
+static bool ezipa_prefetch_wait(ezipa_obj_t *obj)
+{
+    bool done = true;
+
+    if (obj->prefetch_busy)
+    {
+        if (RT_EOK != rt_sem_trytake(&obj->load_sem))
+        {
+            done = false;
+            rt_sem_take(&obj->load_sem, RT_WAITING_FOREVER);
+        }
+        obj->prefetch_busy = false;
+    }
+
+    return done;
+}
+
+/* Load frame seq into the buffer not used by ezipa_data in loader thread */
+static void ezipa_prefetch_start(ezipa_obj_t *obj, uint32_t seq)
+{
+    obj->prefetch_seq = seq;
+    obj->prefetch_busy = true;
+    if (RT_EOK != rt_mb_send(&ezipa_prefetch_mb, (rt_uint32_t)obj))
+    {
+        obj->prefetch_busy = false;
+        obj->prefetch_seq = EZ_FRAME_SEQ_NONE;
+    }
+}
+#endif /* EZIPA_PREFETCH */
+
+static void ezipa_load_file_data(ezipa_obj_t *obj)
+{
+    uint32_t seq;
+    rt_tick_t start;
+
+    RT_ASSERT(obj->org_frame_offset_tbl);
+    RT_ASSERT(obj->fake_frame_offset_tbl)
+    RT_ASSERT(obj->next_frame.seq_num < obj->header.frame_num);
+
+    seq = obj->next_frame.seq_num;
+    start = rt_tick_get();
+
+#ifdef EZIPA_PREFETCH
+    if (obj->frame_buf[1])
+    {
+        uint8_t *buf = (obj->ezipa_data == obj->frame_buf[0]) ? obj->frame_buf[1] : obj->frame_buf[0];
+        bool hit = ezipa_prefetch_wait(obj) && (obj->prefetch_seq == seq);
+
+        if (obj->prefetch_seq != seq)
+        {
+            ezipa_load_frame(obj, buf, seq);
+        }
+        if (hit)
+        {
+            obj->stats.prefetch_hit++;
+        }
+        else
+        {
+            obj->stats.prefetch_miss++;
+        }
+
+        obj->fake_frame_offset_tbl = (uint32_t *)(buf + ((uint8_t *)obj->fake_frame_offset_tbl - obj->ezipa_data));
+        obj->ezipa_data = buf;
+        obj->stats.stall_ms += (rt_tick_get() - start) * 1000 / RT_TICK_PER_SECOND;
+
+        /* read the following frame while this one is decoded */
+        ezipa_prefetch_start(obj, (seq + 1) % obj->frame_num);
+        return;
     }
+#endif /* EZIPA_PREFETCH */
+
+    ezipa_load_frame(obj, obj->ezipa_data, seq);
+    obj->stats.prefetch_miss++;
+    obj->stats.stall_ms += (rt_tick_get() - start) * 1000 / RT_TICK_PER_SECOND;
 }
 #endif /* RT_USING_DFS */
 
@@ -1037,6 +1200,8 @@ ezipa_obj_t *ezipa_open(const void *data, ezipa_color_fmt_t output_color_fmt)
     memset(obj, 0, sizeof(*obj));
     err = rt_sem_init(&obj->sem, "ezipa_dec", 0, RT_IPC_FLAG_FIFO);
     RT_ASSERT(RT_EOK == err);
+    err = rt_sem_init(&obj->load_sem, "ezipa_ld", 0, RT_IPC_FLAG_FIFO);
+    RT_ASSERT(RT_EOK == err);
 
 #ifdef EZIPA_USE_EZIP2
     obj->ezip_handle = drv_get_ezip2_handle();
@@ -1216,8 +1381,15 @@ int32_t ezipa_close(ezipa_obj_t *obj)
         return -1;
     }
 
+#ifdef EZIPA_PREFETCH
+    /* loader thread may still be reading into the spare buffer */
+    ezipa_prefetch_wait(obj);
+#endif /* EZIPA_PREFETCH */
+
     err = rt_sem_detach(&obj->sem);
     RT_ASSERT(RT_EOK == err);
+    err = rt_sem_detach(&obj->load_sem);
+    RT_ASSERT(RT_EOK == err);
 
     err = drv_epic_take(EPIC_TIMEOUT_MS);
     RT_ASSERT(RT_EOK == err);
@@ -1239,7 +1411,11 @@ int32_t ezipa_close(ezipa_obj_t *obj)
     if (obj->fd >= 0)
     {
         close(obj->fd);
-        EZIPA_LARGE_BUF_FREE(obj->ezipa_data);
+        EZIPA_LARGE_BUF_FREE(obj->frame_buf[0]);
+        if (obj->frame_buf[1])
+        {
+            EZIPA_LARGE_BUF_FREE(obj->frame_buf[1]);
+        }
         rt_free(obj->org_frame_offset_tbl);
     }
 #endif /* RT_USING_DFS */
@@ -1320,5 +1496,15 @@ __EXIT:
     return error;
 }
 
+int32_t ezipa_get_stats(ezipa_obj_t *obj, ezipa_stats_t *stats)
+{
+    if (!obj || !stats)
+    {
+        return -1;
+    }
+
+    memcpy(stats, &obj->stats, sizeof(*stats));
 
+    return 0;
+}
 
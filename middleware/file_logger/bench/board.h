@@ -0,0 +1 @@
+/* Host stand-in of board.h for the file logger wrap test only */
@@ -0,0 +1,10 @@
+/* Host stand-in of dfs_posix.h for the file logger wrap test only */
+#ifndef FL_TEST_DFS_POSIX_H
+#define FL_TEST_DFS_POSIX_H
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#define O_BINARY    0
+
+#endif
@@ -0,0 +1,337 @@
+/**
+  ******************************************************************************
+  * @file   fl_lz4_bench.c
+  * @author Sifli software development team
+  * @brief Host benchmark of file logger LZ4 blocks
+ *
+  * Build and run on host:
+  *   gcc -O2 -I.. -I../../../external/lz4 fl_lz4_bench.c ../fl_lz4.c ../../../external/lz4/lz4.c -o fl_lz4_bench
+  *   ./fl_lz4_bench [log_file] [rounds]
+  *
+  * Every line of log_file is a record. Synthetic log lines and metrics records
+  * are used if no file is given. Block 2048 is also what BLE log sends.
+  ******************************************************************************
+*/
+/**
+ * @attention
+ * Copyright (c) 2019 - 2022,  Sifli Technology
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Sifli integrated circuit
+ *    in a product or a software update for such product, must reproduce the above
+ *    copyright notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Sifli nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Sifli integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY SIFLI TECHNOLOGY "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL SIFLI TECHNOLOGY OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "lz4.h"
+#include "fl_lz4.h"
+
+#define BENCH_DEFAULT_RECORDS (8000)
+#define BENCH_DEFAULT_ROUNDS  (20)
+/* packet header and tail of file logger */
+#define BENCH_PACKET_OVERHEAD (6)
+#define BENCH_RING_SIZE       (64 * 1024)
+
+static const uint32_t block_size_list[] = {256, 512, 1024, 2048, 4096, 8192, 16384};
+
+static LZ4_stream_t lz4_state;
+
+typedef struct
+{
+    uint8_t *data;
+    uint32_t len;
+} bench_record_t;
+
+static double bench_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* ulog like text lines mixed with binary metrics records */
+static uint32_t bench_fill(bench_record_t *rec, uint32_t count)
+{
+    static const char *tag[] = {"BLE_LOG", "drv.lcd", "app.main", "sensor", "pm"};
+    static const char *msg[] = {"conn update interval %d", "battery level %d", "step count %d",
+                                "hr sample %d", "lcd flush done in %d us", "enter sleep, wakeup src %d"
+                               };
+    char line[128];
+    uint32_t i;
+    uint32_t j;
+    int len;
+
+    srand(1);
+    for (i = 0; i < count; i++)
+    {
+        if (i % 4 == 3)
+        {
+            /* metrics: id, timestamp and a few counters */
+            rec[i].len = 32;
+            rec[i].data = malloc(rec[i].len);
+            for (j = 0; j < rec[i].len; j += 4)
+            {
+                *(uint32_t *)&rec[i].data[j] = (j == 0) ? 0x1001 + (uint32_t)(rand() & 3) : (j == 4) ? i * 1000 : (uint32_t)(rand() & 0x3FF);
+            }
+            continue;
+        }
+        len = snprintf(line, sizeof(line), "[%u] I/%s: ", i * 37, tag[rand() % 5]);
+        len += snprintf(line + len, sizeof(line) - len, msg[rand() % 6], rand() % 1000);
+        rec[i].len = len;
+        rec[i].data = malloc(len);
+        memcpy(rec[i].data, line, len);
+    }
+
+    return count;
+}
+
+static uint32_t bench_load(const char *path, bench_record_t **list)
+{
+    FILE *fp;
+    char line[1024];
+    uint32_t count = 0;
+    uint32_t max = 1024;
+    bench_record_t *rec;
+
+    fp = fopen(path, "rb");
+    if (!fp)
+    {
+        return 0;
+    }
+    rec = malloc(max * sizeof(*rec));
+    while (rec && fgets(line, sizeof(line), fp))
+    {
+        if (count == max)
+        {
+            max *= 2;
+            rec = realloc(rec, max * sizeof(*rec));
+            if (!rec)
+            {
+                break;
+            }
+        }
+        rec[count].len = strlen(line);
+        rec[count].data = malloc(rec[count].len);
+        memcpy(rec[count].data, line, rec[count].len);
+        count++;
+    }
+    fclose(fp);
+    *list = rec;
+
+    return rec ? count : 0;
+}
+
+int main(int argc, char **argv)
+{
+    bench_record_t *rec;
+    uint8_t *blk;
+    uint8_t *cmpr;
+    uint8_t *out;
+    uint32_t *blk_first;
+    uint32_t *cmpr_size;
+    uint32_t cmpr_pos;
+    uint32_t cmpr_bound;
+    uint32_t count;
+    uint32_t plain_size;
+    uint32_t total_size;
+    uint32_t blk_count;
+    uint32_t blk_len;
+    uint32_t org_size;
+    uint32_t data_size;
+    uint32_t ring_records;
+    uint32_t rounds;
+    uint32_t i;
+    uint32_t b;
+    uint32_t r;
+    uint32_t n;
+    double t0;
+    double cmpr_time;
+    double dec_time;
+
+    rounds = (argc > 2) ? atoi(argv[2]) : BENCH_DEFAULT_ROUNDS;
+    if ((argc > 1) && strcmp(argv[1], "-"))
+    {
+        count = bench_load(argv[1], &rec);
+        if (0 == count)
+        {
+            printf("fail to load %s\n", argv[1]);
+            return 1;
+        }
+    }
+    else
+    {
+        rec = malloc(BENCH_DEFAULT_RECORDS * sizeof(*rec));
+        if (!rec)
+        {
+            return 1;
+        }
+        count = bench_fill(rec, BENCH_DEFAULT_RECORDS);
+    }
+    if (0 == rounds)
+    {
+        rounds = 1;
+    }
+
+    plain_size = 0;
+    org_size = 0;
+    for (i = 0; i < count; i++)
+    {
+        plain_size += BENCH_PACKET_OVERHEAD + rec[i].len;
+        org_size += rec[i].len;
+    }
+    /* newest records a plain ring keeps */
+    ring_records = 0;
+    for (i = count, n = 0; i > 0 && n + BENCH_PACKET_OVERHEAD + rec[i - 1].len <= BENCH_RING_SIZE; i--)
+    {
+        n += BENCH_PACKET_OVERHEAD + rec[i - 1].len;
+        ring_records++;
+    }
+
+    blk = malloc(block_size_list[sizeof(block_size_list) / sizeof(block_size_list[0]) - 1]);
+    /* every record may take a block */
+    cmpr_bound = count * FL_LZ4_BLOCK_BOUND(FL_LZ4_REC_HDR_SIZE) + FL_LZ4_BLOCK_BOUND(org_size + count * FL_LZ4_REC_HDR_SIZE);
+    cmpr = malloc(cmpr_bound);
+    blk_first = malloc((count + 1) * sizeof(uint32_t));
+    cmpr_size = malloc((count + 1) * sizeof(uint32_t));
+    out = malloc(block_size_list[sizeof(block_size_list) / sizeof(block_size_list[0]) - 1]);
+    if (!blk || !cmpr || !blk_first || !cmpr_size || !out)
+    {
+        return 1;
+    }
+
+    data_size = org_size;
+    printf("%u records, %u bytes, %u bytes in plain packets, rounds %u\n", count, data_size, plain_size, rounds);
+    printf("plain    ratio 1.000, %u newest records in a %u bytes ring\n", ring_records, BENCH_RING_SIZE);
+    printf("block    ratio   compress(MB/s) decompress(MB/s) records in ring\n");
+    for (b = 0; b < sizeof(block_size_list) / sizeof(block_size_list[0]); b++)
+    {
+        /* split records into blocks the way file logger does */
+        blk_count = 0;
+        blk_len = 0;
+        for (i = 0; i < count; i++)
+        {
+            if ((0 == i) || (blk_len + FL_LZ4_REC_HDR_SIZE + rec[i].len > block_size_list[b]))
+            {
+                blk_first[blk_count++] = i;
+                blk_len = 0;
+            }
+            blk_len += FL_LZ4_REC_HDR_SIZE + rec[i].len;
+        }
+        blk_first[blk_count] = count;
+
+        total_size = 0;
+        t0 = bench_now();
+        for (r = 0; r < rounds; r++)
+        {
+            total_size = 0;
+            cmpr_pos = 0;
+            for (n = 0; n < blk_count; n++)
+            {
+                blk_len = 0;
+                for (i = blk_first[n]; i < blk_first[n + 1]; i++)
+                {
+                    uint16_t rec_len = rec[i].len;
+
+                    memcpy(blk + blk_len, &rec_len, FL_LZ4_REC_HDR_SIZE);
+                    memcpy(blk + blk_len + FL_LZ4_REC_HDR_SIZE, rec[i].data, rec[i].len);
+                    blk_len += FL_LZ4_REC_HDR_SIZE + rec[i].len;
+                }
+                cmpr_size[n] = fl_lz4_block_compress(&lz4_state, cmpr + cmpr_pos, cmpr_bound - cmpr_pos, blk, blk_len);
+                cmpr_pos += cmpr_size[n];
+                total_size += BENCH_PACKET_OVERHEAD + cmpr_size[n];
+            }
+        }
+        cmpr_time = bench_now() - t0;
+
+        t0 = bench_now();
+        for (r = 0; r < rounds; r++)
+        {
+            cmpr_pos = 0;
+            for (n = 0; n < blk_count; n++)
+            {
+                blk_len = fl_lz4_block_decompress(out, block_size_list[b], cmpr + cmpr_pos, cmpr_size[n]);
+                cmpr_pos += cmpr_size[n];
+                if ((r + 1) < rounds)
+                {
+                    continue;
+                }
+                /* check the records of the last round */
+                org_size = 0;
+                for (i = blk_first[n]; i < blk_first[n + 1]; i++)
+                {
+                    if (memcmp(out + org_size + FL_LZ4_REC_HDR_SIZE, rec[i].data, rec[i].len))
+                    {
+                        break;
+                    }
+                    org_size += FL_LZ4_REC_HDR_SIZE + rec[i].len;
+                }
+                if ((i != blk_first[n + 1]) || (org_size != blk_len))
+                {
+                    printf("%-8u round-trip mismatch\n", block_size_list[b]);
+                    return 1;
+                }
+            }
+        }
+        dec_time = bench_now() - t0;
+
+        /* newest whole blocks a ring keeps, the block cut by the ring is lost */
+        ring_records = 0;
+        for (i = blk_count, n = 0; i > 0 && n + BENCH_PACKET_OVERHEAD + cmpr_size[i - 1] <= BENCH_RING_SIZE; i--)
+        {
+            n += BENCH_PACKET_OVERHEAD + cmpr_size[i - 1];
+            ring_records += blk_first[i] - blk_first[i - 1];
+        }
+
+        printf("%-8u %-7.3f %-14.1f %-16.1f %u\n", block_size_list[b], (double)total_size / plain_size,
+               (double)data_size * rounds / cmpr_time / 1e6, (double)data_size * rounds / dec_time / 1e6,
+               ring_records);
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        free(rec[i].data);
+    }
+    free(rec);
+    free(blk);
+    free(cmpr);
+    free(out);
+    free(blk_first);
+    free(cmpr_size);
+
+    return 0;
+}
+
+/************************ (C) COPYRIGHT Sifli Technology *******END OF FILE****/
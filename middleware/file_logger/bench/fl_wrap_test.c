@@ -0,0 +1,210 @@
+/**
+  ******************************************************************************
+  * @file   fl_wrap_test.c
+  * @author Sifli software development team
+  * @brief Host test of file logger LZ4 packets across the ring wrap
+ *
+  * Build and run on host:
+  *   gcc -O2 -Wall -I. -I.. -I../../include -I../../../external/lz4 fl_wrap_test.c ../file_logger.c \
+  *       ../fl_lz4.c ../../../external/lz4/lz4.c -o fl_wrap_test
+  *   ./fl_wrap_test [log_file]
+  *
+  * Records are written to a small LZ4 logger and read back with
+  * file_logger_iter at irregular points, so the packets are cut by the end
+  * of the ring at every position: in the header, the block or the tail.
+  * Every read must give the newest records, complete and in order.
+  ******************************************************************************
+*/
+/**
+ * @attention
+ * Copyright (c) 2019 - 2022,  Sifli Technology
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Sifli integrated circuit
+ *    in a product or a software update for such product, must reproduce the above
+ *    copyright notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Sifli nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Sifli integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY SIFLI TECHNOLOGY "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL SIFLI TECHNOLOGY OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "file_logger.h"
+
+#define TEST_RING_SIZE      (4096)
+#define TEST_RECORDS        (6000)
+
+typedef struct
+{
+    int first;
+    int next;
+    int count;
+    int bad;
+} test_iter_t;
+
+static uint32_t test_seed;
+
+static uint32_t test_rand(void)
+{
+    test_seed = test_seed * 1103515245 + 12345;
+    return (test_seed >> 16) & 0x7FFF;
+}
+
+/* record i is "rec <i>:" and a tail of 8 ~ 120 bytes both sides can rebuild */
+static uint32_t test_record(int i, char *buf)
+{
+    uint32_t seed = (uint32_t)i * 2654435761u;
+    uint32_t len, tail, j;
+
+    len = (uint32_t)sprintf(buf, "rec %d:", i);
+    tail = 8 + seed % 113;
+    for (j = 0; j < tail; j++)
+    {
+        seed = seed * 1103515245 + 12345;
+        /* some runs, some noise, like a log */
+        buf[len + j] = (j % 16 < 8) ? 'a' + i % 7 : 'a' + (seed >> 16) % 26;
+    }
+
+    return len + tail;
+}
+
+static bool test_iter_cb(void *data, uint32_t data_len, void *arg)
+{
+    test_iter_t *it = (test_iter_t *)arg;
+    char buf[160];
+    int i;
+
+    if (data_len >= sizeof(buf) || sscanf(data, "rec %d:", &i) != 1 ||
+            test_record(i, buf) != data_len || memcmp(buf, data, data_len))
+    {
+        it->bad++;
+        return true;
+    }
+    if (it->count == 0)
+        it->first = i;
+    else if (i != it->next)
+        it->bad++;
+    it->next = i + 1;
+    it->count++;
+
+    return true;
+}
+
+/* all the records read must be the newest ones, without gap */
+static int test_check(void *logger, int written, const char *when)
+{
+    test_iter_t it = {0};
+
+    file_logger_iter(logger, test_iter_cb, &it);
+    if (it.bad || it.count == 0 || it.next != written)
+    {
+        printf("%s after %d records: read %d (%d ~ %d), %d bad\n", when, written,
+               it.count, it.first, it.next - 1, it.bad);
+        return 1;
+    }
+
+    return 0;
+}
+
+static int32_t test_wr_pos(const char *name)
+{
+    int32_t hdr[2] = {0};
+    int fd = open(name, O_RDONLY);
+
+    if (fd >= 0)
+    {
+        if (read(fd, hdr, sizeof(hdr)) != sizeof(hdr))
+            hdr[1] = 0;
+        close(fd);
+    }
+
+    return hdr[1];
+}
+
+int main(int argc, char **argv)
+{
+    const char *name = (argc > 1) ? argv[1] : "fl_wrap_test.log";
+    char buf[160];
+    void *logger;
+    int32_t wr_pos, last_pos = 0;
+    int i, next_check, checks = 0, wraps = 0, errors = 0;
+
+    unlink(name);
+    logger = file_logger_init_ex(name, TEST_RING_SIZE, FL_FLAG_LZ4);
+    if (!logger)
+    {
+        printf("fail to create %s\n", name);
+        return 1;
+    }
+
+    test_seed = 1;
+    next_check = 1;
+    for (i = 0; i < TEST_RECORDS; i++)
+    {
+        if (file_logger_write(logger, buf, test_record(i, buf)) != FL_OK)
+        {
+            printf("write %d fail\n", i);
+            return 1;
+        }
+        if (i + 1 < next_check)
+            continue;
+
+        /* flushes the block as a packet, cut wherever the ring is */
+        errors += test_check(logger, i + 1, "iter");
+        checks++;
+        file_logger_flush(logger);
+        wr_pos = test_wr_pos(name);
+        if (wr_pos < last_pos)
+            wraps++;
+        last_pos = wr_pos;
+        next_check = i + 1 + 1 + test_rand() % 24;
+    }
+
+    /* and what a reader gets after reboot */
+    file_logger_close(logger);
+    logger = file_logger_init_ex(name, TEST_RING_SIZE, FL_FLAG_LZ4);
+    errors += test_check(logger, TEST_RECORDS, "reopen");
+    file_logger_close(logger);
+    unlink(name);
+
+    printf("%d records, %d reads, %d wraps: %s\n", TEST_RECORDS, checks, wraps, errors ? "FAIL" : "ok");
+    if (wraps < 10)
+    {
+        printf("ring wraps too few\n");
+        return 1;
+    }
+
+    return errors ? 1 : 0;
+}
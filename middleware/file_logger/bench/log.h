@@ -0,0 +1,9 @@
+/* Host stand-in of log.h for the file logger wrap test only */
+#ifndef FL_TEST_LOG_H
+#define FL_TEST_LOG_H
+
+#include <stdio.h>
+
+#define LOG_W(...)  (printf(__VA_ARGS__), printf("\n"))
+
+#endif
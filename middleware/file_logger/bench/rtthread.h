@@ -0,0 +1,18 @@
+/* Host stand-in of rtthread.h for the file logger wrap test only */
+#ifndef FL_TEST_RTTHREAD_H
+#define FL_TEST_RTTHREAD_H
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <stdint.h>
+
+/* small blocks, so the packets wrap the small test ring often */
+#define FILE_LOGGER_USING_LZ4
+#define FILE_LOGGER_LZ4_BLOCK_SIZE  512
+
+#define RT_ASSERT   assert
+#define rt_malloc   malloc
+#define rt_free     free
+
+#endif
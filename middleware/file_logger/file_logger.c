@@ -52,6 +52,10 @@
 
 #include "dfs_posix.h"
 #include "log.h"
+#ifdef FILE_LOGGER_USING_LZ4
+    #include "lz4.h"
+    #include "fl_lz4.h"
+#endif
 
 
 #define FL_FILE_HDR_MAGIC  (0x5354454D)   //METS
@@ -60,6 +64,7 @@
 #define FL_FILE_OFFSET(data_pos)   (FL_FILE_HDR_SIZE + (data_pos))
 
 #define FL_PACKET_HDR_MAGIC  (0x4448) //HD
+#define FL_PACKET_LZ4_MAGIC  (0x5A4C) //LZ, data is a LZ4 block of records, see fl_lz4.h
 #define FL_PACKET_TAIL_MAGIC (0x4154) //TA
 
 #define FL_PACKET_LEN(data_len)    ((data_len) + sizeof(fl_packet_hdr_t) + sizeof(fl_packet_tail_t))
@@ -106,6 +111,15 @@ typedef struct
     /* true: reach the file end and go the beginning */
     bool turnaround;
     fl_file_hdr_t cursor;
+#ifdef FILE_LOGGER_USING_LZ4
+    uint32_t flags;
+    /* records not compressed yet */
+    uint8_t *blk;
+    uint32_t blk_len;
+    /* compressed block */
+    uint8_t *cmpr;
+    LZ4_stream_t *lz4;
+#endif
 } fl_handle_t;
 
 
@@ -268,6 +282,7 @@ static fl_err_t fl_find_packet(fl_handle_t *handle, uint32_t *pos, fl_packet_hdr
     fl_err_t err;
     uint32_t tail_pos;
     uint32_t pos_bak;
+    bool turnaround;
     fl_packet_tail_t tail;
 
     RT_ASSERT(hdr && pos);
@@ -284,16 +299,17 @@ __TRY_AGAIN:
                 goto __EXIT;
             }
         }
-        while ((hdr->magic & 0XFF) != (FL_PACKET_HDR_MAGIC & 0xFF));
+        while (((hdr->magic & 0XFF) != (FL_PACKET_HDR_MAGIC & 0xFF))
+                && ((hdr->magic & 0XFF) != (FL_PACKET_LZ4_MAGIC & 0xFF)));
 
         pos_bak = *pos;
-        err = fl_read_file(handle, pos, (uint8_t *)&hdr->magic + 1, sizeof(hdr) - 1);
+        err = fl_read_file(handle, pos, (uint8_t *)&hdr->magic + 1, sizeof(*hdr) - 1);
         if (FL_OK != err)
         {
             goto __EXIT;
         }
 
-        if (hdr->magic == FL_PACKET_HDR_MAGIC)
+        if ((hdr->magic == FL_PACKET_HDR_MAGIC) || (hdr->magic == FL_PACKET_LZ4_MAGIC))
         {
             break;
         }
@@ -304,13 +320,16 @@ __TRY_AGAIN:
     }
     while (1);
 
-    /* check tail magic */
+    /* check tail magic, a tail ending at the file end must not mark
+       the data before it as turned around */
     tail_pos = *pos + hdr->len;
     if (tail_pos >= handle->max_size)
     {
         tail_pos -= handle->max_size;
     }
+    turnaround = handle->turnaround;
     err = fl_read_file(handle, &tail_pos, &tail, sizeof(tail));
+    handle->turnaround = turnaround;
 
     if (FL_OK != err)
     {
@@ -326,8 +345,164 @@ __EXIT:
     return err;
 }
 
+static fl_err_t fl_write_packet(fl_handle_t *handle, uint16_t magic, void *data, uint32_t data_len)
+{
+    int wr_size;
+    fl_err_t err = FL_OK;
+    fl_packet_hdr_t packet_hdr;
+    fl_packet_tail_t packet_tail;
+
+    if ((FL_PACKET_LEN(data_len) > handle->max_size) || (data_len > UINT16_MAX))
+    {
+        err = FL_INVALID_DATA_LEN;
+        goto __EXIT;
+    }
+
+    wr_size = lseek(handle->fd, FL_FILE_HDR_SIZE + handle->cursor.wr_pos, SEEK_SET);
+    if (wr_size != (FL_FILE_HDR_SIZE + handle->cursor.wr_pos))
+    {
+        err = FL_WRITE_ERR;
+        goto __EXIT;
+    }
+
+    /* write header */
+    packet_hdr.magic = magic;
+    packet_hdr.len = data_len;
+    err = fl_write_file(handle, &packet_hdr, sizeof(packet_hdr));
+    if (FL_OK != err)
+    {
+        goto __EXIT;
+    }
+
+    /* write data */
+    err = fl_write_file(handle, data, data_len);
+    if (FL_OK != err)
+    {
+        goto __EXIT;
+    }
+
+    /* write tail */
+    packet_tail.magic = FL_PACKET_TAIL_MAGIC;
+    err = fl_write_file(handle, &packet_tail, sizeof(packet_tail));
+    if (FL_OK != err)
+    {
+        goto __EXIT;
+    }
+
+__EXIT:
+
+    return err;
+}
+
+#ifdef FILE_LOGGER_USING_LZ4
+static void fl_lz4_free(fl_handle_t *handle)
+{
+    if (handle->blk)
+    {
+        rt_free(handle->blk);
+        handle->blk = NULL;
+    }
+    if (handle->lz4)
+    {
+        rt_free(handle->lz4);
+        handle->lz4 = NULL;
+    }
+    handle->cmpr = NULL;
+    handle->blk_len = 0;
+}
+
+/* compress the buffered records into one packet */
+static fl_err_t fl_lz4_flush(fl_handle_t *handle)
+{
+    uint32_t cmpr_len;
+
+    if (0 == handle->blk_len)
+    {
+        return FL_OK;
+    }
+
+    cmpr_len = fl_lz4_block_compress(handle->lz4, handle->cmpr, FL_LZ4_BLOCK_BOUND(FILE_LOGGER_LZ4_BLOCK_SIZE),
+                                     handle->blk, handle->blk_len);
+    handle->blk_len = 0;
+    if (0 == cmpr_len)
+    {
+        return FL_ERROR;
+    }
+
+    return fl_write_packet(handle, FL_PACKET_LZ4_MAGIC, handle->cmpr, cmpr_len);
+}
+
+static fl_err_t fl_lz4_write(fl_handle_t *handle, void *data, uint32_t data_len)
+{
+    fl_err_t err;
+    uint16_t rec_len;
+
+    if ((handle->blk_len + FL_LZ4_REC_HDR_SIZE + data_len) > FILE_LOGGER_LZ4_BLOCK_SIZE)
+    {
+        err = fl_lz4_flush(handle);
+        if (FL_OK != err)
+        {
+            return err;
+        }
+    }
+
+    if ((FL_LZ4_REC_HDR_SIZE + data_len) > FILE_LOGGER_LZ4_BLOCK_SIZE)
+    {
+        /* larger than a block, keep it as a plain packet */
+        return fl_write_packet(handle, FL_PACKET_HDR_MAGIC, data, data_len);
+    }
+
+    rec_len = data_len;
+    memcpy(handle->blk + handle->blk_len, &rec_len, FL_LZ4_REC_HDR_SIZE);
+    memcpy(handle->blk + handle->blk_len + FL_LZ4_REC_HDR_SIZE, data, data_len);
+    handle->blk_len += FL_LZ4_REC_HDR_SIZE + data_len;
+
+    return FL_OK;
+}
+
+/* call cb for every record in a LZ4 packet */
+static fl_err_t fl_lz4_iter(void *packet, uint32_t packet_len, fl_iter_cb_t cb, void *arg)
+{
+    uint8_t *blk;
+    uint32_t blk_len;
+    uint32_t pos;
+    uint16_t rec_len;
+
+    blk_len = fl_lz4_block_size(packet);
+    blk = rt_malloc(blk_len ? blk_len : 1);
+    RT_ASSERT(blk);
+    if (fl_lz4_block_decompress(blk, blk_len, packet, packet_len) != blk_len)
+    {
+        /* skip the broken block, the following ones are still readable */
+        LOG_W("bad lz4 block");
+        rt_free(blk);
+        return FL_OK;
+    }
+
+    pos = 0;
+    while ((pos + FL_LZ4_REC_HDR_SIZE) <= blk_len)
+    {
+        memcpy(&rec_len, blk + pos, FL_LZ4_REC_HDR_SIZE);
+        pos += FL_LZ4_REC_HDR_SIZE;
+        if ((pos + rec_len) > blk_len)
+        {
+            break;
+        }
+        cb(blk + pos, rec_len, arg);
+        pos += rec_len;
+    }
+    rt_free(blk);
+
+    return FL_OK;
+}
+#endif /* FILE_LOGGER_USING_LZ4 */
 
 void *file_logger_init(const char *name, uint32_t max_size)
+{
+    return file_logger_init_ex(name, max_size, 0);
+}
+
+void *file_logger_init_ex(const char *name, uint32_t max_size, uint32_t flags)
 {
     int fd = -1;
     fl_handle_t *handle = NULL;
@@ -364,6 +539,25 @@ void *file_logger_init(const char *name, uint32_t max_size)
     handle->fd = fd;
     handle->name = name;
     handle->max_size = max_size - FL_FILE_HDR_SIZE;
+#ifdef FILE_LOGGER_USING_LZ4
+    handle->flags = flags;
+    handle->blk = NULL;
+    handle->blk_len = 0;
+    handle->cmpr = NULL;
+    handle->lz4 = NULL;
+    if (flags & FL_FLAG_LZ4)
+    {
+        /* records and compressed block in one buffer */
+        handle->blk = rt_malloc(FILE_LOGGER_LZ4_BLOCK_SIZE + FL_LZ4_BLOCK_BOUND(FILE_LOGGER_LZ4_BLOCK_SIZE));
+        handle->lz4 = rt_malloc(sizeof(LZ4_stream_t));
+        if (!handle->blk || !handle->lz4)
+        {
+            LOG_W("no memory for lz4");
+            goto __ERROR;
+        }
+        handle->cmpr = handle->blk + FILE_LOGGER_LZ4_BLOCK_SIZE;
+    }
+#endif
     if (is_new)
     {
         handle->used_size = 0;
@@ -446,6 +640,9 @@ __ERROR:
 
     if (handle)
     {
+#ifdef FILE_LOGGER_USING_LZ4
+        fl_lz4_free(handle);
+#endif
         rt_free(handle);
     }
 
@@ -455,11 +652,6 @@ __ERROR:
 fl_err_t file_logger_write(void *logger, void *data, uint32_t data_len)
 {
     fl_handle_t *handle = (fl_handle_t *)logger;
-    int wr_size;
-    fl_err_t err = FL_OK;
-    uint32_t total_len;
-    fl_packet_hdr_t packet_hdr;
-    fl_packet_tail_t packet_tail;
 
     RT_ASSERT(logger && data);
 
@@ -468,47 +660,14 @@ fl_err_t file_logger_write(void *logger, void *data, uint32_t data_len)
         return FL_OK;
     }
 
-    total_len = FL_PACKET_LEN(data_len);
-    if (total_len > handle->max_size)
-    {
-        err = FL_INVALID_DATA_LEN;
-        goto __EXIT;
-    }
-
-    wr_size = lseek(handle->fd, FL_FILE_HDR_SIZE + handle->cursor.wr_pos, SEEK_SET);
-    if (wr_size != (FL_FILE_HDR_SIZE + handle->cursor.wr_pos))
-    {
-        err = FL_WRITE_ERR;
-        goto __EXIT;
-    }
-
-    /* write header */
-    packet_hdr.magic = FL_PACKET_HDR_MAGIC;
-    packet_hdr.len = data_len;
-    err = fl_write_file(handle, &packet_hdr, sizeof(packet_hdr));
-    if (FL_OK != err)
-    {
-        goto __EXIT;
-    }
-
-    /* write data */
-    err = fl_write_file(handle, data, data_len);
-    if (FL_OK != err)
-    {
-        goto __EXIT;
-    }
-
-    /* write tail */
-    packet_tail.magic = FL_PACKET_TAIL_MAGIC;
-    err = fl_write_file(handle, &packet_tail, sizeof(packet_tail));
-    if (FL_OK != err)
+#ifdef FILE_LOGGER_USING_LZ4
+    if (handle->flags & FL_FLAG_LZ4)
     {
-        goto __EXIT;
+        return fl_lz4_write(handle, data, data_len);
     }
+#endif
 
-__EXIT:
-
-    return err;
+    return fl_write_packet(handle, FL_PACKET_HDR_MAGIC, data, data_len);
 }
 
 fl_err_t file_logger_write_noheader(void *logger, void *data, uint32_t data_len)
@@ -530,6 +689,15 @@ fl_err_t file_logger_write_noheader(void *logger, void *data, uint32_t data_len)
         goto __EXIT;
     }
 
+#ifdef FILE_LOGGER_USING_LZ4
+    /* keep the write order */
+    err = fl_lz4_flush(handle);
+    if (FL_OK != err)
+    {
+        goto __EXIT;
+    }
+#endif
+
     wr_size = lseek(handle->fd, FL_FILE_HDR_SIZE + handle->cursor.wr_pos, SEEK_SET);
     if (wr_size != (FL_FILE_HDR_SIZE + handle->cursor.wr_pos))
     {
@@ -558,6 +726,15 @@ fl_err_t file_logger_iter(void *logger, fl_iter_cb_t cb, void *arg)
     uint8_t *data = NULL;
     uint32_t rd_pos;
 
+#ifdef FILE_LOGGER_USING_LZ4
+    /* records still in buffer are iterated too */
+    err = fl_lz4_flush(handle);
+    if (FL_OK != err)
+    {
+        goto __EXIT;
+    }
+#endif
+
     if (0 == handle->used_size)
     {
         goto __EXIT;
@@ -598,7 +775,16 @@ fl_err_t file_logger_iter(void *logger, fl_iter_cb_t cb, void *arg)
             goto __EXIT;
         }
 
-        cb(data, hdr.len, arg);
+#ifdef FILE_LOGGER_USING_LZ4
+        if (FL_PACKET_LZ4_MAGIC == hdr.magic)
+        {
+            fl_lz4_iter(data, hdr.len, cb, arg);
+        }
+        else
+#endif
+        {
+            cb(data, hdr.len, arg);
+        }
         rt_free(data);
         data = NULL;
         /* skip tail */
@@ -606,6 +792,7 @@ fl_err_t file_logger_iter(void *logger, fl_iter_cb_t cb, void *arg)
         if (rd_pos >= handle->max_size)
         {
             rd_pos -= handle->max_size;
+            handle->turnaround = true;
         }
     }
     while (1);
@@ -625,6 +812,9 @@ fl_err_t file_logger_clear(void *logger)
     int ret;
     int wr_size;
 
+#ifdef FILE_LOGGER_USING_LZ4
+    handle->blk_len = 0;
+#endif
     ret = close(handle->fd);
     if (ret)
     {
@@ -650,6 +840,14 @@ fl_err_t file_logger_flush(void *logger)
     int wr_size;
     fl_err_t err = FL_OK;
 
+#ifdef FILE_LOGGER_USING_LZ4
+    err = fl_lz4_flush(handle);
+    if (FL_OK != err)
+    {
+        goto __EXIT;
+    }
+#endif
+
     /* write file header */
     wr_size = lseek(handle->fd, 0, SEEK_SET);
     if (wr_size != 0)
@@ -692,6 +890,9 @@ fl_err_t file_logger_close(void *logger)
 
     close(handle->fd);
 
+#ifdef FILE_LOGGER_USING_LZ4
+    fl_lz4_free(handle);
+#endif
     rt_free(handle);
 
 __EXIT:
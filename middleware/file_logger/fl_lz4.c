@@ -0,0 +1,110 @@
+/**
+  ******************************************************************************
+  * @file   fl_lz4.c
+  * @author Sifli software development team
+  * @brief LZ4 block format of file logger
+ *
+  ******************************************************************************
+*/
+/**
+ * @attention
+ * Copyright (c) 2019 - 2022,  Sifli Technology
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Sifli integrated circuit
+ *    in a product or a software update for such product, must reproduce the above
+ *    copyright notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Sifli nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Sifli integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY SIFLI TECHNOLOGY "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL SIFLI TECHNOLOGY OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#include <stdint.h>
+#include <stddef.h>
+#include "lz4.h"
+#include "fl_lz4.h"
+
+/* no RT-Thread dependency so that it can be built on host */
+
+uint32_t fl_lz4_block_compress(void *state, void *dst, uint32_t dst_size, const void *src, uint32_t src_size)
+{
+    uint8_t *wr_ptr = (uint8_t *)dst;
+    int cmpr_size;
+
+    if ((0 == src_size) || (src_size > UINT16_MAX) || (dst_size <= FL_LZ4_HDR_SIZE))
+    {
+        return 0;
+    }
+
+    cmpr_size = LZ4_compress_fast_extState(state, (const char *)src, (char *)(wr_ptr + FL_LZ4_HDR_SIZE),
+                                           src_size, dst_size - FL_LZ4_HDR_SIZE, 1);
+    if (cmpr_size <= 0)
+    {
+        return 0;
+    }
+    /* block may be placed at any offset of the ring */
+    wr_ptr[0] = src_size & 0xFF;
+    wr_ptr[1] = src_size >> 8;
+
+    return FL_LZ4_HDR_SIZE + cmpr_size;
+}
+
+uint32_t fl_lz4_block_decompress(void *dst, uint32_t dst_size, const void *src, uint32_t src_size)
+{
+    uint32_t org_size;
+    int output_size;
+
+    if (src_size <= FL_LZ4_HDR_SIZE)
+    {
+        return 0;
+    }
+
+    org_size = fl_lz4_block_size(src);
+    if (org_size > dst_size)
+    {
+        return 0;
+    }
+
+    output_size = LZ4_decompress_safe((const char *)src + FL_LZ4_HDR_SIZE, (char *)dst,
+                                      (int)(src_size - FL_LZ4_HDR_SIZE), (int)org_size);
+    if (output_size != (int)org_size)
+    {
+        return 0;
+    }
+
+    return org_size;
+}
+
+uint32_t fl_lz4_block_size(const void *src)
+{
+    const uint8_t *rd_ptr = (const uint8_t *)src;
+
+    return rd_ptr[0] | ((uint32_t)rd_ptr[1] << 8);
+}
+
+/************************ (C) COPYRIGHT Sifli Technology *******END OF FILE****/
@@ -0,0 +1,108 @@
+/**
+  ******************************************************************************
+  * @file   fl_lz4.h
+  * @author Sifli software development team
+  * @brief LZ4 block format of file logger
+ *
+  ******************************************************************************
+*/
+/**
+ * @attention
+ * Copyright (c) 2019 - 2022,  Sifli Technology
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Sifli integrated circuit
+ *    in a product or a software update for such product, must reproduce the above
+ *    copyright notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Sifli nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Sifli integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY SIFLI TECHNOLOGY "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL SIFLI TECHNOLOGY OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef FL_LZ4_H
+#define FL_LZ4_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Records are gathered in a block which is compressed with a fresh dictionary,
+ * so that every block can be decoded alone after the ring has overwritten the
+ * blocks before it.
+ *
+ *   block  := [original size (16bit)][LZ4 block]
+ *   record := [record size (16bit)][record data]
+ *
+ * A decompressed block is a list of records.
+ */
+
+/** block header size */
+#define FL_LZ4_HDR_SIZE         (sizeof(uint16_t))
+/** record header size */
+#define FL_LZ4_REC_HDR_SIZE     (sizeof(uint16_t))
+/** worst case block size of org_size bytes */
+#define FL_LZ4_BLOCK_BOUND(org_size)  (FL_LZ4_HDR_SIZE + (org_size) + (org_size) / 255 + 16)
+
+/**
+ * @brief Compress a block
+ * @param[in] state LZ4 state, LZ4_stream_t
+ * @param[in] dst output buffer
+ * @param[in] dst_size output buffer size
+ * @param[in] src records to be compressed
+ * @param[in] src_size records size in byte, not more than 65535
+ * @retval block size including header, 0 if output buffer is too small
+ */
+uint32_t fl_lz4_block_compress(void *state, void *dst, uint32_t dst_size, const void *src, uint32_t src_size);
+
+/**
+ * @brief Decompress a block
+ * @param[in] dst output buffer
+ * @param[in] dst_size output buffer size
+ * @param[in] src block
+ * @param[in] src_size block size including header
+ * @retval records size, 0 if block is corrupted or output buffer is too small
+ */
+uint32_t fl_lz4_block_decompress(void *dst, uint32_t dst_size, const void *src, uint32_t src_size);
+
+/**
+ * @brief Original size of a block
+ * @param[in] src block
+ * @retval records size after decompression
+ */
+uint32_t fl_lz4_block_size(const void *src);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FL_LZ4_H */
+/************************ (C) COPYRIGHT Sifli Technology *******END OF FILE****/
@@ -83,6 +83,33 @@ typedef struct
 
 #define CB_MAX_BACKUP_REGION_NUM  (4)
 
+/** backup region type */
+typedef enum
+{
+    /** thread stack */
+    CB_REGION_STACK,
+    /** heap */
+    CB_REGION_HEAP,
+    /** static data */
+    CB_REGION_STATIC,
+    CB_REGION_TYPE_NUM
+} cb_region_type_t;
+
+/** statistics of last backup */
+typedef struct
+{
+    /** number of saved blocks */
+    uint32_t block_num;
+    /** number of compressed blocks reused from previous backup */
+    uint32_t reused_num;
+    /** size of original data in byte */
+    uint32_t raw_size;
+    /** size of saved data in byte, including block header */
+    uint32_t saved_size;
+    /** save time in GTIMER tick */
+    uint32_t save_time;
+} cb_region_stats_t;
+
 
 
 typedef struct
@@ -110,6 +137,24 @@ rt_err_t cb_save_context(void);
 rt_err_t cb_restore_context(void);
 void cb_get_stats(uint32_t *total, uint32_t *min_free);
 
+/**
+ * @brief Get statistics of last backup
+ * @param[in] type region type
+ * @param[out] stats statistics
+ * @retval RT_EOK if successful, otherwise RT_EINVAL
+ */
+rt_err_t cb_get_region_stats(cb_region_type_t type, cb_region_stats_t *stats);
+
+/**
+ * @brief Set LZ4 acceleration used by compression
+ *
+ * 1 gives the best compression ratio, larger value is faster but compresses less.
+ * Default value is CONTEXT_BACKUP_COMPRESSION_ACCELERATION.
+ *
+ * @param[in] acceleration LZ4 acceleration factor
+ */
+void cb_set_compression_level(uint32_t acceleration);
+
 /// @}  context_backup
 
 #ifdef __cplusplus
@@ -91,6 +91,21 @@ typedef enum
     EZIPA_RGB888,
 } ezipa_color_fmt_t;
 
+/** File mode load statistics */
+typedef struct
+{
+    /** frames read from file */
+    uint32_t frames;
+    /** frame was already loaded by prefetch when drawn */
+    uint32_t prefetch_hit;
+    /** draw had to wait for or do the file read */
+    uint32_t prefetch_miss;
+    /** total time draw waited for frame data */
+    uint32_t stall_ms;
+    /** reads not continuing from the last file position */
+    uint32_t seeks;
+} ezipa_stats_t;
+
 typedef struct
 {
     uint8_t *ezipa_data;
@@ -119,6 +134,16 @@ typedef struct
     uint32_t *org_frame_offset_tbl;
     uint32_t *fake_frame_offset_tbl;
     uint32_t frame_num;
+    /* frame buffers, ezipa_data is one of them, the other is filled by prefetch */
+    uint8_t *frame_buf[2];
+    /* header of frame hdr_src_seq, read along with the previous frame */
+    const uint8_t *hdr_src;
+    uint32_t hdr_src_seq;
+    uint32_t file_pos;
+    uint32_t prefetch_seq;
+    bool prefetch_busy;
+    struct rt_semaphore load_sem;
+    ezipa_stats_t stats;
 } ezipa_obj_t;
 
 
@@ -177,6 +202,16 @@ int32_t ezipa_close(ezipa_obj_t *obj);
  */
 int32_t ezipa_draw(ezipa_obj_t *obj, ezipa_canvas_t *canvas, bool next);
 
+/**
+ * @brief  Get file mode load statistics
+ *
+ * @param[in]  obj ezipa object instance
+ * @param[out] stats statistics since open
+ *
+ * @retval 0: no error, < 0: error code
+ */
+int32_t ezipa_get_stats(ezipa_obj_t *obj, ezipa_stats_t *stats);
+
 
 /// @}  ezipa_dec
 
@@ -81,6 +81,14 @@ typedef enum fl_err_tag
 
 typedef bool (*fl_iter_cb_t)(void *data, uint32_t data_len, void *arg);
 
+/** Records are buffered and written as LZ4 compressed blocks, need FILE_LOGGER_USING_LZ4
+ *
+ * Every block is compressed alone so that the blocks left in the file are readable
+ * after the older ones are overwritten. Buffered records are written by
+ * file_logger_flush, file_logger_iter and file_logger_close.
+ */
+#define FL_FLAG_LZ4   (1 << 0)
+
 
 /** Create a file logger
  *
@@ -94,6 +102,19 @@ typedef bool (*fl_iter_cb_t)(void *data, uint32_t data_len, void *arg);
  */
 void *file_logger_init(const char *name, uint32_t max_len);
 
+/** Create a file logger with options
+ *
+ * Same as file_logger_init, records written by any option can be read back by file_logger_iter
+ *
+ *
+ * @param[in] name           file full path
+ * @param[in] max_len        file max size
+ * @param[in] flags          FL_FLAG_xxx
+ *
+ * @return file logger handle
+ */
+void *file_logger_init_ex(const char *name, uint32_t max_len, uint32_t flags);
+
 /** Write data in file logger
  *
  *
@@ -173,6 +173,24 @@ int gui_app_create_page_ext(const char *pg_id, gui_page_msg_cb_t handler, void *
 int gui_app_create_page_for_app_ext(const char *app_id, const char *pg_id, gui_page_msg_cb_t handler, void *usr_data);
 #define gui_app_create_page_for_app(app_id,pg_id,pg_handler) gui_app_create_page_for_app_ext(app_id,pg_id,pg_handler,NULL)
 
+/**
+    @brief Declare files which an app opens while creating its pages, like images and fonts.
+           They are read into memory by a loader thread once the app is launched,
+           in parallel with app entry and page creation. Need GUI_APP_RES_PREFETCH.
+    @param[in] app_id Identification of application, should stay valid
+    @param[in] res NULL terminated list of LVGL file path, like "A:/app/bg.ezip", should stay valid
+    @retval RT_EOK if successful, otherwise return error number < 0.
+ */
+int gui_app_declare_res(const char *app_id, const char *const *res);
+
+/**
+    @brief Read files into memory for current actived app in loader thread,
+           e.g. before creating a subpage.
+    @param[in] res NULL terminated list of LVGL file path
+    @retval RT_EOK if successful, otherwise return error number < 0.
+ */
+int gui_app_prefetch_res(const char *const *res);
+
 /************************ Application transfer animation *******************************************************/
 
 
@@ -177,6 +177,36 @@ int32_t share_prefs_get_block(share_prefs_t *prfs, const char *key, void *buf, i
 */
 rt_err_t share_prefs_set_block(share_prefs_t *prfs, const char *key, const void *buf, int32_t buf_len);
 
+//transaction
+/**
+    @brief Begin a transaction
+
+    Following set and remove calls through the handle are kept in RAM and written
+    together by share_prefs_commit(), later value of the same key replaces the earlier one.
+    Get calls see the pending values. Pending writes may be written in advance if
+    transaction buffer is full.
+    @param[in] prfs Handle of shared preference database
+    @retval RT_EOK if successful, otherwise return error number <0
+*/
+rt_err_t share_prefs_begin(share_prefs_t *prfs);
+
+/**
+    @brief Write pending values of the transaction and end it
+
+    If it fails, the transaction is kept with all pending values, call it again
+    to retry or share_prefs_rollback() to discard them.
+    @param[in] prfs Handle of shared preference database
+    @retval RT_EOK if successful, otherwise return error number <0
+*/
+rt_err_t share_prefs_commit(share_prefs_t *prfs);
+
+/**
+    @brief Discard pending values of the transaction and end it
+    @param[in] prfs Handle of shared preference database
+    @retval RT_EOK if successful, otherwise return error number <0
+*/
+rt_err_t share_prefs_rollback(share_prefs_t *prfs);
+
 /// @} shard_pref
 /// @} file
 
@@ -54,6 +54,8 @@
 #include "lv_epic_utils.h"
 
 #include "lv_display_private.h"
+#include "../../misc/lv_area_private.h"
+#include <string.h>
 
 /*********************
  *      DEFINES
@@ -61,6 +63,14 @@
 
 #define DRAW_UNIT_ID_EPIC 5
 
+#define DRAW_TASK_TYPE_NUM  (LV_DRAW_TASK_TYPE_VECTOR + 1)
+
+/*lv_epic_draw_blend_masked needs SW masks and EPIC A8 mask layers (not on SF32LB55X)*/
+#if LV_DRAW_SW_COMPLEX && defined(EPIC_SUPPORT_MONOCHROME_LAYER) && defined(EPIC_SUPPORT_MASK)
+    #define EPIC_MASKED_BLEND   1
+#else
+    #define EPIC_MASKED_BLEND   0
+#endif
 
 /**********************
  *      TYPEDEFS
@@ -95,6 +105,8 @@ static int32_t dispatch(lv_draw_unit_t *draw_unit, lv_layer_t *layer);
  */
 static int32_t evaluate(lv_draw_unit_t *draw_unit, lv_draw_task_t *task);
 
+static int32_t evaluate_task(lv_draw_unit_t *draw_unit, lv_draw_task_t *t);
+
 #if LV_USE_OS
     static int32_t wait_for_finish(lv_draw_unit_t *draw_unit);
     static void render_thread_cb(void *ptr);
@@ -110,6 +122,7 @@ static void execute_drawing(lv_draw_epic_unit_t *u);
     volatile uint32_t g_enable_epic = 0xFFFFFFFF;
 #endif
 static uint8_t initialized = 0;
+static lv_draw_epic_stat_t draw_stat[DRAW_TASK_TYPE_NUM];
 /**********************
  *      MACROS
  **********************/
@@ -145,6 +158,19 @@ void lv_draw_epic_deinit(void)
     }
 }
 
+const lv_draw_epic_stat_t *lv_draw_epic_get_stat(lv_draw_task_type_t type)
+{
+    if ((uint32_t)type >= DRAW_TASK_TYPE_NUM)
+        return NULL;
+
+    return &draw_stat[type];
+}
+
+void lv_draw_epic_reset_stat(void)
+{
+    lv_memzero(draw_stat, sizeof(draw_stat));
+}
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
@@ -164,7 +190,39 @@ static inline bool cf_supported(lv_color_format_t cf, uint32_t flags)
     return (!is_cf_unsupported);
 }
 
+/*
+ * EPIC unit is evaluated before the SW unit and the SW unit never takes a task
+ * preferred by EPIC, so the result is known here for every task.
+ */
 static int32_t evaluate(lv_draw_unit_t *draw_unit, lv_draw_task_t *t)
+{
+    int32_t ret = evaluate_task(draw_unit, t);
+
+    if ((uint32_t)t->type < DRAW_TASK_TYPE_NUM)
+    {
+        lv_draw_epic_stat_t *stat = &draw_stat[t->type];
+        lv_area_t draw_area;
+        uint32_t pixels = 0;
+
+        if (lv_area_intersect(&draw_area, &t->area, &t->clip_area))
+            pixels = lv_area_get_size(&draw_area);
+
+        if (DRAW_UNIT_ID_EPIC == t->preferred_draw_unit_id)
+        {
+            stat->epic_tasks++;
+            stat->epic_pixels += pixels;
+        }
+        else
+        {
+            stat->sw_tasks++;
+            stat->sw_pixels += pixels;
+        }
+    }
+
+    return ret;
+}
+
+static int32_t evaluate_task(lv_draw_unit_t *draw_unit, lv_draw_task_t *t)
 {
     lv_draw_epic_unit_t *draw_epic_unit = (lv_draw_epic_unit_t *) draw_unit;
 
@@ -180,11 +238,16 @@ static int32_t evaluate(lv_draw_unit_t *draw_unit, lv_draw_task_t *t)
     case LV_DRAW_TASK_TYPE_FILL:
     {
         const lv_draw_fill_dsc_t *draw_dsc = (const lv_draw_fill_dsc_t *) t->draw_dsc;
+        lv_grad_dir_t grad_dir = (lv_grad_dir_t)draw_dsc->grad.dir;
 
-        if (draw_dsc->radius != 0)
+        /*Rounded corners are blended with SW generated masks*/
+        if ((draw_dsc->radius != 0) && (!EPIC_MASKED_BLEND || (grad_dir != (lv_grad_dir_t)LV_GRAD_DIR_NONE)))
             return 0;
 
-        if ((LV_GRADIENT_MAX_STOPS > 2) && (draw_dsc->grad.dir != (lv_grad_dir_t)LV_GRAD_DIR_NONE))
+        /*Multi-stop gradients are split into 2 color segments*/
+        if ((grad_dir != (lv_grad_dir_t)LV_GRAD_DIR_NONE)
+                && (grad_dir != (lv_grad_dir_t)LV_GRAD_DIR_HOR)
+                && (grad_dir != (lv_grad_dir_t)LV_GRAD_DIR_VER))
             return 0;
 
         if (t->preference_score > 70)
@@ -194,17 +257,44 @@ static int32_t evaluate(lv_draw_unit_t *draw_unit, lv_draw_task_t *t)
         }
         return 1;
     }
-#if 0
+
     case LV_DRAW_TASK_TYPE_LINE:
-    case LV_DRAW_TASK_TYPE_ARC:
+    {
+        const lv_draw_line_dsc_t *draw_dsc = (const lv_draw_line_dsc_t *) t->draw_dsc;
+
+        if (draw_dsc->blend_mode != LV_BLEND_MODE_NORMAL)
+            return 0;
+
+        if (!EPIC_MASKED_BLEND)
+        {
+            bool skew = (draw_dsc->p1.x != draw_dsc->p2.x) && (draw_dsc->p1.y != draw_dsc->p2.y);
+            bool dashed = draw_dsc->dash_gap && draw_dsc->dash_width;
+            if (skew || dashed || draw_dsc->round_start || draw_dsc->round_end)
+                return 0;
+        }
+
         if (t->preference_score > 90)
         {
             t->preference_score = 90;
             t->preferred_draw_unit_id = DRAW_UNIT_ID_EPIC;
         }
         return 1;
+    }
 
-#endif
+    case LV_DRAW_TASK_TYPE_ARC:
+    {
+        const lv_draw_arc_dsc_t *draw_dsc = (const lv_draw_arc_dsc_t *) t->draw_dsc;
+
+        if (!EPIC_MASKED_BLEND || (draw_dsc->img_src != NULL))
+            return 0;
+
+        if (t->preference_score > 90)
+        {
+            t->preference_score = 90;
+            t->preferred_draw_unit_id = DRAW_UNIT_ID_EPIC;
+        }
+        return 1;
+    }
 
     case LV_DRAW_TASK_TYPE_LABEL:
         if (t->preference_score > 95)
@@ -218,10 +308,7 @@ static int32_t evaluate(lv_draw_unit_t *draw_unit, lv_draw_task_t *t)
     {
         const lv_draw_border_dsc_t *draw_dsc = (lv_draw_border_dsc_t *) t->draw_dsc;
 
-        if (draw_dsc->side != (lv_border_side_t)LV_BORDER_SIDE_FULL)
-            return 0;
-
-        if (draw_dsc->radius != 0)
+        if ((draw_dsc->radius != 0) && !EPIC_MASKED_BLEND)
             return 0;
 
         if (t->preference_score > 90)
@@ -404,14 +491,9 @@ static void execute_drawing(lv_draw_epic_unit_t *u)
     case LV_DRAW_TASK_TYPE_LAYER: /*6*/
         lv_draw_epic_layer(draw_unit, t->draw_dsc, &t->area);
         break;
-#if 0
-
-
     case LV_DRAW_TASK_TYPE_LINE:/*7*/
         lv_draw_epic_line(draw_unit, t->draw_dsc);
         break;
-
-#endif
     case LV_DRAW_TASK_TYPE_ARC:/*8*/
         lv_draw_epic_arc(draw_unit, t->draw_dsc, &t->area);
         break;
@@ -521,4 +603,34 @@ static void render_thread_cb(void *ptr)
 }
 #endif
 
+#ifdef RT_USING_FINSH
+static const char *const draw_task_name[DRAW_TASK_TYPE_NUM] =
+{
+    "none", "fill", "border", "shadow", "label", "image", "layer", "line",
+    "arc", "triangle", "mask_rect", "mask_bmp", "vector",
+};
+
+static rt_err_t epic_stat(int argc, char **argv)
+{
+    if ((argc > 1) && (0 == strcmp(argv[1], "reset")))
+    {
+        lv_draw_epic_reset_stat();
+        return RT_EOK;
+    }
+
+    rt_kprintf("%-10s %10s %10s %12s %12s\n", "type", "epic_task", "sw_task", "epic_kpix", "sw_kpix");
+    for (uint32_t i = 1; i < DRAW_TASK_TYPE_NUM; i++)
+    {
+        const lv_draw_epic_stat_t *stat = &draw_stat[i];
+        if ((0 == stat->epic_tasks) && (0 == stat->sw_tasks))
+            continue;
+
+        rt_kprintf("%-10s %10d %10d %12d %12d\n", draw_task_name[i], stat->epic_tasks, stat->sw_tasks,
+                   (uint32_t)(stat->epic_pixels / 1000), (uint32_t)(stat->sw_pixels / 1000));
+    }
+    return RT_EOK;
+}
+MSH_CMD_EXPORT(epic_stat, EPIC draw unit task statistics: epic_stat [reset]);
+#endif /* RT_USING_FINSH */
+
 #endif /*LV_USE_DRAW_EPIC*/
@@ -72,6 +72,15 @@ extern "C" {
 
 typedef lv_layer_t lv_epic_layer_t;
 
+/** Draw tasks of one type handled by EPIC and left to the SW renderer */
+typedef struct
+{
+    uint32_t epic_tasks;
+    uint32_t sw_tasks;
+    uint64_t epic_pixels;   /*Clipped task area*/
+    uint64_t sw_pixels;
+} lv_draw_epic_stat_t;
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -97,6 +106,15 @@ void lv_draw_epic_label(lv_draw_unit_t *draw_unit, const lv_draw_label_dsc_t *ds
 void lv_draw_epic_border(lv_draw_unit_t *draw_unit, const lv_draw_border_dsc_t *dsc,
                          const lv_area_t *coords);
 void lv_draw_epic_arc(lv_draw_unit_t *draw_unit, const lv_draw_arc_dsc_t *dsc, const lv_area_t *coords);
+
+void lv_draw_epic_line(lv_draw_unit_t *draw_unit, const lv_draw_line_dsc_t *dsc);
+
+/**
+ * Get EPIC/SW accounting of a draw task type, counted since init or the last reset.
+ */
+const lv_draw_epic_stat_t *lv_draw_epic_get_stat(lv_draw_task_type_t type);
+
+void lv_draw_epic_reset_stat(void);
 /**********************
  *      MACROS
  **********************/
@@ -68,6 +68,7 @@
 static void add_circle(const lv_opa_t *circle_mask, const lv_area_t *blend_area, const lv_area_t *circle_area,
                        lv_opa_t *mask_buf,  int32_t width);
 static void get_rounded_area(int16_t angle, int32_t radius, uint8_t thickness, lv_area_t *res_area);
+static lv_draw_sw_mask_res_t arc_mask_row(void *user_data, lv_opa_t *mask_buf, int32_t x, int32_t y, int32_t len);
 
 /*********************
  *      DEFINES
@@ -76,10 +77,20 @@ static void get_rounded_area(int16_t angle, int32_t radius, uint8_t thickness, l
 #define SPLIT_ANGLE_GAP_LIMIT 60  /*With small gaps in the arc don't bother with splitting because there is nothing to skip.*/
 
 
-//#define MULTI_LINE_MASK_ENABLE
 /**********************
  *      TYPEDEFS
  **********************/
+typedef struct
+{
+    void **mask_list;
+    const lv_opa_t *circle_mask;    /*Rounded ending, NULL if not rounded*/
+    lv_area_t round_area_1;
+    lv_area_t round_area_2;
+    int32_t width;
+    const uint8_t *img_mask;        /*A8 part of an RGB565A8 image, NULL if none*/
+    const lv_area_t *img_area;
+    int32_t img_stride;
+} arc_mask_ctx_t;
 
 /**********************
  *  STATIC PROTOTYPES
@@ -121,7 +132,7 @@ void lv_draw_epic_arc(lv_draw_unit_t *draw_unit, const lv_draw_arc_dsc_t *dsc, c
         cir_dsc.width = width;
         cir_dsc.radius = LV_RADIUS_CIRCLE;
         cir_dsc.side = LV_BORDER_SIDE_FULL;
-        lv_draw_sw_border(draw_unit, &cir_dsc, &area_out);
+        lv_draw_epic_border(draw_unit, &cir_dsc, &area_out);
         return;
     }
 
@@ -158,28 +169,17 @@ void lv_draw_epic_arc(lv_draw_unit_t *draw_unit, const lv_draw_arc_dsc_t *dsc, c
         mask_in_param_valid = true;
     }
 
-    int32_t blend_h = lv_area_get_height(&clipped_area);
-    int32_t blend_w = lv_area_get_width(&clipped_area);
     int32_t h;
 
-#ifdef MULTI_LINE_MASK_ENABLE
-    //Allocate maximum 4KB ping-pong buffer for CPU and GPU paralell
-    int32_t  mask_buf_h = LV_MIN(2048 / blend_w, blend_h);
-    lv_opa_t *mask_buf = lv_mem_alloc(blend_w * mask_buf_h * 2);
-    lv_opa_t *mask_buf_ping_pong = mask_buf;
-#else
-    lv_opa_t *mask_buf = lv_malloc(blend_w);
-#endif /* MULTI_LINE_MASK_ENABLE */
+    arc_mask_ctx_t ctx;
+    lv_memzero(&ctx, sizeof(ctx));
+    ctx.mask_list = mask_list;
+    ctx.width = width;
 
-    lv_area_t blend_area = clipped_area;
     lv_area_t img_area;
     lv_draw_sw_blend_dsc_t blend_dsc = {0};
-    blend_dsc.mask_buf = mask_buf;
     blend_dsc.opa = dsc->opa;
-    blend_dsc.blend_area = &blend_area;
-    blend_dsc.mask_area = &blend_area;
 
-    const uint8_t *img_mask = NULL;
     lv_image_decoder_dsc_t decoder_dsc;
     if (dsc->img_src == NULL)
     {
@@ -208,14 +208,14 @@ void lv_draw_epic_arc(lv_draw_unit_t *draw_unit, const lv_draw_arc_dsc_t *dsc, c
             if (blend_dsc.src_color_format == LV_COLOR_FORMAT_RGB565A8)
             {
                 blend_dsc.src_color_format = LV_COLOR_FORMAT_RGB565;
-                img_mask = (uint8_t *)blend_dsc.src_buf + blend_dsc.src_stride * lv_area_get_height(blend_dsc.src_area);
+                ctx.img_mask = (uint8_t *)blend_dsc.src_buf + blend_dsc.src_stride * lv_area_get_height(blend_dsc.src_area);
+                ctx.img_area = &img_area;
+                ctx.img_stride = blend_dsc.src_stride / 2;
             }
         }
     }
 
     lv_opa_t *circle_mask = NULL;
-    lv_area_t round_area_1;
-    lv_area_t round_area_2;
     if (dsc->rounded)
     {
         circle_mask = lv_malloc(width * width);
@@ -236,174 +236,105 @@ void lv_draw_epic_arc(lv_draw_unit_t *draw_unit, const lv_draw_arc_dsc_t *dsc, c
 
             circle_mask_tmp += width;
         }
-        get_rounded_area(start_angle, dsc->radius, width, &round_area_1);
-        lv_area_move(&round_area_1, dsc->center.x, dsc->center.y);
-        get_rounded_area(end_angle, dsc->radius, width, &round_area_2);
-        lv_area_move(&round_area_2, dsc->center.x, dsc->center.y);
+        lv_draw_sw_mask_free_param(&circle_mask_param);
 
+        get_rounded_area(start_angle, dsc->radius, width, &ctx.round_area_1);
+        lv_area_move(&ctx.round_area_1, dsc->center.x, dsc->center.y);
+        get_rounded_area(end_angle, dsc->radius, width, &ctx.round_area_2);
+        lv_area_move(&ctx.round_area_2, dsc->center.x, dsc->center.y);
+        ctx.circle_mask = circle_mask;
     }
 
-#ifdef MULTI_LINE_MASK_ENABLE
-    lv_area_t mask_area = clipped_area;
-
-    for (int32_t f = 0; f < blend_h;)
+    /*Big arcs with a big gap are drawn in quarters, a quarter is drawn only if there is arc in it*/
+    int32_t angle_gap = (end_angle >= start_angle) ? 360 - (end_angle - start_angle) : start_angle - end_angle;
+    if (dsc->radius > SPLIT_RADIUS_LIMIT && !dsc->rounded && angle_gap > SPLIT_ANGLE_GAP_LIMIT)
     {
-        int32_t blend_sub_h = LV_MIN(mask_buf_h, blend_h - f);
-        lv_opa_t *mask_buf_sub;
-        lv_draw_mask_res_t mask_res = LV_DRAW_MASK_RES_TRANSP;
+        /*Quarters in the order of angles: bottom right, bottom left, top left, top right*/
+        static const uint8_t quarter_right[4] = {1, 0, 0, 1};
+        static const uint8_t quarter_bottom[4] = {1, 1, 0, 0};
+        lv_area_t quarter;
+        for (uint32_t q = 0; q < 4; q++)
+        {
+            int32_t q_start = q * 90;
+            int32_t q_end = q_start + 90;
+            /*Inclusive, the anti-aliased edge of the arc may reach into the neighbour quarter*/
+            bool in_arc = (start_angle <= end_angle) ? (start_angle <= q_end && end_angle >= q_start)
+                          : (start_angle <= q_end || end_angle >= q_start);
+            if (!in_arc) continue;
+
+            quarter.x1 = quarter_right[q] ? dsc->center.x : area_out.x1;
+            quarter.x2 = quarter_right[q] ? area_out.x2 : dsc->center.x - 1;
+            quarter.y1 = quarter_bottom[q] ? dsc->center.y : area_out.y1;
+            quarter.y2 = quarter_bottom[q] ? area_out.y2 : dsc->center.y - 1;
+            lv_epic_draw_blend_masked(draw_unit, &blend_dsc, &quarter, arc_mask_row, &ctx);
+        }
+    }
+    else
+    {
+        lv_epic_draw_blend_masked(draw_unit, &blend_dsc, &clipped_area, arc_mask_row, &ctx);
+    }
 
+    lv_draw_sw_mask_free_param(&mask_angle_param);
+    lv_draw_sw_mask_free_param(&mask_out_param);
+    if (mask_in_param_valid)
+    {
+        lv_draw_sw_mask_free_param(&mask_in_param);
+    }
 
-        mask_area.y1 = blend_area.y1;
-        mask_area.y2 = blend_area.y1;
+    if (dsc->img_src) lv_image_decoder_close(&decoder_dsc);
+    if (circle_mask) lv_free(circle_mask);
+}
 
-        mask_buf_sub = mask_buf_ping_pong;
-        for (h = 0; h < blend_sub_h; h++)
-        {
-            lv_memset(mask_buf_sub, 0xff, blend_w);
-            lv_draw_mask_res_t mask_res_sub = lv_draw_mask_apply(mask_buf_sub, mask_area.x1, mask_area.y1, blend_w);
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
 
-            if (dsc->rounded)
-            {
-                if (mask_area.y1 >= round_area_1.y1 && mask_area.y1 <= round_area_1.y2)
-                {
-                    if (mask_res_sub == LV_DRAW_MASK_RES_TRANSP)
-                    {
-                        lv_memzero(mask_buf_sub, blend_w);
-                        mask_res_sub = LV_DRAW_MASK_RES_CHANGED;
-                    }
-                    add_circle(circle_mask, &mask_area, &round_area_1, mask_buf_sub, width);
-                }
-                if (mask_area.y1 >= round_area_2.y1 && mask_area.y1 <= round_area_2.y2)
-                {
-                    if (mask_res_sub == LV_DRAW_MASK_RES_TRANSP)
-                    {
-                        lv_memzero(mask_buf_sub, blend_w);
-                        mask_res_sub = LV_DRAW_MASK_RES_CHANGED;
-                    }
-                    add_circle(circle_mask, &mask_area, &round_area_2, mask_buf_sub, width);
-                }
-            }
+static lv_draw_sw_mask_res_t arc_mask_row(void *user_data, lv_opa_t *mask_buf, int32_t x, int32_t y, int32_t len)
+{
+    arc_mask_ctx_t *ctx = user_data;
+    lv_area_t row_area = {x, y, x + len - 1, y};
 
+    lv_memset(mask_buf, 0xff, len);
+    lv_draw_sw_mask_res_t mask_res = lv_draw_sw_mask_apply(ctx->mask_list, mask_buf, x, y, len);
 
-            /*If it was an RGB565A8 image use consider its A8 part on the mask*/
-            if (img_mask && mask_res_sub != LV_DRAW_SW_MASK_RES_TRANSP)
+    if (ctx->circle_mask)
+    {
+        const lv_area_t *round_area[2] = {&ctx->round_area_1, &ctx->round_area_2};
+        for (uint32_t i = 0; i < 2; i++)
+        {
+            if (y >= round_area[i]->y1 && y <= round_area[i]->y2)
             {
-                const uint8_t *img_mask_tmp = img_mask;
-                img_mask_tmp += blend_dsc.src_stride / 2 * (blend_area.y1 - blend_dsc.src_area->y1);
-                img_mask_tmp += blend_area.x1 - blend_dsc.src_area->x1;
-
-                int32_t i;
-                for (i = 0; i < blend_w; i++)
-                {
-                    mask_buf[i] = LV_OPA_MIX2(mask_buf[i], img_mask_tmp[i]);
-                }
-                if (mask_res_sub == LV_DRAW_SW_MASK_RES_FULL_COVER)
+                if (mask_res == LV_DRAW_SW_MASK_RES_TRANSP)
                 {
-                    mask_res_sub = LV_DRAW_SW_MASK_RES_CHANGED;
+                    lv_memzero(mask_buf, len);
+                    mask_res = LV_DRAW_SW_MASK_RES_CHANGED;
                 }
+                add_circle(ctx->circle_mask, &row_area, round_area[i], mask_buf, ctx->width);
             }
-
-            if (mask_res_sub != LV_DRAW_MASK_RES_TRANSP)
-                mask_res = mask_res_sub;
-            else
-                lv_memzero(mask_buf_sub, blend_w);
-
-            mask_area.y1 ++;
-            mask_area.y2 ++;
-            mask_buf_sub += blend_w;
-        }
-
-
-
-        blend_area.y2 =  blend_area.y1 + blend_sub_h - 1;
-        if (mask_res != LV_DRAW_MASK_RES_TRANSP)
-        {
-            _lv_blend_cont_fill(clip_area, &blend_area,
-                                dsc->color, mask_buf_ping_pong, mask_res, dsc->opa, LV_BLEND_MODE_NORMAL);
-
-            if (mask_buf_ping_pong == mask_buf)
-                mask_buf_ping_pong = mask_buf + (blend_w * mask_buf_h);
-            else
-                mask_buf_ping_pong = mask_buf;
         }
-
-        blend_area.y1 += blend_sub_h;
-        blend_area.y2 += blend_sub_h;
-        f += blend_sub_h;
     }
 
-    _lv_blend_cont_fill_reset();
-
-#else
-    blend_area.y2 = blend_area.y1;
-    for (h = 0; h < blend_h; h++)
+    /*If it was an RGB565A8 image use consider its A8 part on the mask*/
+    if (ctx->img_mask && mask_res != LV_DRAW_SW_MASK_RES_TRANSP)
     {
-        lv_memset(mask_buf, 0xff, blend_w);
-        blend_dsc.mask_res = lv_draw_sw_mask_apply(mask_list, mask_buf, blend_area.x1, blend_area.y1, blend_w);
+        const uint8_t *img_mask_tmp = ctx->img_mask;
+        img_mask_tmp += ctx->img_stride * (y - ctx->img_area->y1);
+        img_mask_tmp += x - ctx->img_area->x1;
 
-        if (dsc->rounded)
+        int32_t i;
+        for (i = 0; i < len; i++)
         {
-            if (blend_area.y1 >= round_area_1.y1 && blend_area.y1 <= round_area_1.y2)
-            {
-                if (blend_dsc.mask_res == LV_DRAW_SW_MASK_RES_TRANSP)
-                {
-                    lv_memzero(mask_buf, blend_w);
-                    blend_dsc.mask_res = LV_DRAW_SW_MASK_RES_CHANGED;
-                }
-                add_circle(circle_mask, &blend_area, &round_area_1, mask_buf, width);
-            }
-            if (blend_area.y1 >= round_area_2.y1 && blend_area.y1 <= round_area_2.y2)
-            {
-                if (blend_dsc.mask_res == LV_DRAW_SW_MASK_RES_TRANSP)
-                {
-                    lv_memzero(mask_buf, blend_w);
-                    blend_dsc.mask_res = LV_DRAW_SW_MASK_RES_CHANGED;
-                }
-                add_circle(circle_mask, &blend_area, &round_area_2, mask_buf, width);
-            }
+            mask_buf[i] = LV_OPA_MIX2(mask_buf[i], img_mask_tmp[i]);
         }
-
-        /*If it was an RGB565A8 image use consider its A8 part on the mask*/
-        if (img_mask && blend_dsc.mask_res != LV_DRAW_SW_MASK_RES_TRANSP)
+        if (mask_res == LV_DRAW_SW_MASK_RES_FULL_COVER)
         {
-            const uint8_t *img_mask_tmp = img_mask;
-            img_mask_tmp += blend_dsc.src_stride / 2 * (blend_area.y1 - blend_dsc.src_area->y1);
-            img_mask_tmp += blend_area.x1 - blend_dsc.src_area->x1;
-
-            int32_t i;
-            for (i = 0; i < blend_w; i++)
-            {
-                mask_buf[i] = LV_OPA_MIX2(mask_buf[i], img_mask_tmp[i]);
-            }
-            if (blend_dsc.mask_res == LV_DRAW_SW_MASK_RES_FULL_COVER)
-            {
-                blend_dsc.mask_res = LV_DRAW_SW_MASK_RES_CHANGED;
-            }
+            mask_res = LV_DRAW_SW_MASK_RES_CHANGED;
         }
-
-        lv_epic_draw_blend(draw_unit, &blend_dsc);
-
-        blend_area.y1 ++;
-        blend_area.y2 ++;
     }
-#endif /* MULTI_LINE_MASK_ENABLE */
 
-    lv_draw_sw_mask_free_param(&mask_angle_param);
-    lv_draw_sw_mask_free_param(&mask_out_param);
-    if (mask_in_param_valid)
-    {
-        lv_draw_sw_mask_free_param(&mask_in_param);
-    }
-
-    lv_free(mask_buf);
-    if (dsc->img_src) lv_image_decoder_close(&decoder_dsc);
-    if (circle_mask) lv_free(circle_mask);
+    return mask_res;
 }
 
-/**********************
- *   STATIC FUNCTIONS
- **********************/
-
 static void add_circle(const lv_opa_t *circle_mask, const lv_area_t *blend_area, const lv_area_t *circle_area,
                        lv_opa_t *mask_buf,  int32_t width)
 {
@@ -148,12 +148,9 @@ void draw_border_complex(lv_draw_unit_t *draw_unit, const lv_area_t *outer_area,
      *It is always the same or inside `coords`*/
     lv_area_t draw_area;
     if (!lv_area_intersect(&draw_area, outer_area, draw_unit->clip_area)) return;
-    int32_t draw_area_w = lv_area_get_width(&draw_area);
 
     lv_draw_sw_blend_dsc_t blend_dsc;
     lv_memzero(&blend_dsc, sizeof(blend_dsc));
-    lv_opa_t *mask_buf = lv_malloc(draw_area_w);
-    blend_dsc.mask_buf = mask_buf;
 
 
     void *mask_list[3] = {0};
@@ -172,7 +169,6 @@ void draw_border_complex(lv_draw_unit_t *draw_unit, const lv_area_t *outer_area,
         mask_list[1] = &mask_rout_param;
     }
 
-    int32_t h;
     lv_area_t blend_area;
     blend_dsc.blend_area = &blend_area;
     blend_dsc.mask_area = &blend_area;
@@ -252,115 +248,68 @@ void draw_border_complex(lv_draw_unit_t *draw_unit, const lv_area_t *outer_area,
         }
     }
 
-    /*Draw the corners*/
-    lv_coord_t blend_w;
-
-    /*Left and right corner together if they are close to each other*/
+    /*Draw the corners, every corner block is blended with a multi-line mask*/
+    lv_area_t corner_area;
     if (!split_hor)
     {
-        /*Calculate the top corner and mirror it to the bottom*/
-        blend_area.x1 = draw_area.x1;
-        blend_area.x2 = draw_area.x2;
+        /*Left and right corner together if they are close to each other*/
         lv_coord_t max_h = LV_MAX(rout, inner_area->y1 - outer_area->y1);
-        for (h = 0; h < max_h; h++)
-        {
-            lv_coord_t top_y = outer_area->y1 + h;
-            lv_coord_t bottom_y = outer_area->y2 - h;
-            if (top_y < draw_area.y1 && bottom_y > draw_area.y2) continue;  /*This line is clipped now*/
-
-            lv_memset(mask_buf, 0xff, draw_area_w);
-            blend_dsc.mask_res = lv_draw_sw_mask_apply(mask_list, mask_buf, blend_area.x1, top_y, draw_area_w);
-
-            if (top_y >= draw_area.y1)
-            {
-                blend_area.y1 = top_y;
-                blend_area.y2 = top_y;
-                lv_epic_draw_blend(draw_unit, &blend_dsc);
-            }
-
-            if (bottom_y <= draw_area.y2)
-            {
-                blend_area.y1 = bottom_y;
-                blend_area.y2 = bottom_y;
-                lv_epic_draw_blend(draw_unit, &blend_dsc);
-            }
-        }
+        corner_area.x1 = outer_area->x1;
+        corner_area.x2 = outer_area->x2;
+        corner_area.y1 = outer_area->y1;
+        corner_area.y2 = outer_area->y1 + max_h - 1;
+        lv_epic_draw_blend_masked(draw_unit, &blend_dsc, &corner_area, lv_epic_mask_list_row, mask_list);
+
+        /*Don't blend the rows of the top part again*/
+        corner_area.y1 = LV_MAX(outer_area->y2 - max_h + 1, corner_area.y2 + 1);
+        corner_area.y2 = outer_area->y2;
+        lv_epic_draw_blend_masked(draw_unit, &blend_dsc, &corner_area, lv_epic_mask_list_row, mask_list);
     }
     else
     {
         /*Left corners*/
-        blend_area.x1 = draw_area.x1;
-        blend_area.x2 = LV_MIN(draw_area.x2, core_area.x1 - 1);
-        blend_w = lv_area_get_width(&blend_area);
-        if (blend_w > 0)
+        corner_area.x1 = draw_area.x1;
+        corner_area.x2 = LV_MIN(draw_area.x2, core_area.x1 - 1);
+        if (lv_area_get_width(&corner_area) > 0)
         {
             if (left_side || top_side)
             {
-                for (h = draw_area.y1; h < core_area.y1; h++)
-                {
-                    blend_area.y1 = h;
-                    blend_area.y2 = h;
-
-                    lv_memset(mask_buf, 0xff, blend_w);
-                    blend_dsc.mask_res = lv_draw_sw_mask_apply(mask_list, mask_buf, blend_area.x1, h, blend_w);
-                    lv_epic_draw_blend(draw_unit, &blend_dsc);
-                }
+                corner_area.y1 = draw_area.y1;
+                corner_area.y2 = core_area.y1 - 1;
+                lv_epic_draw_blend_masked(draw_unit, &blend_dsc, &corner_area, lv_epic_mask_list_row, mask_list);
             }
 
             if (left_side || bottom_side)
             {
-                for (h = core_area.y2 + 1; h <= draw_area.y2; h++)
-                {
-                    blend_area.y1 = h;
-                    blend_area.y2 = h;
-
-                    lv_memset(mask_buf, 0xff, blend_w);
-                    blend_dsc.mask_res = lv_draw_sw_mask_apply(mask_list, mask_buf, blend_area.x1, h, blend_w);
-                    lv_epic_draw_blend(draw_unit, &blend_dsc);
-                }
+                corner_area.y1 = core_area.y2 + 1;
+                corner_area.y2 = draw_area.y2;
+                lv_epic_draw_blend_masked(draw_unit, &blend_dsc, &corner_area, lv_epic_mask_list_row, mask_list);
             }
         }
 
-        /*Right corners*/
-        blend_area.x1 = LV_MAX(draw_area.x1, blend_area.x2 + 1);    /*To not overlap with the left side*/
-        blend_area.x1 = LV_MAX(draw_area.x1, core_area.x2 + 1);
-
-        blend_area.x2 = draw_area.x2;
-        blend_w = lv_area_get_width(&blend_area);
-
-        if (blend_w > 0)
+        /*Right corners, not overlapping with the left side*/
+        corner_area.x1 = LV_MAX(draw_area.x1, core_area.x2 + 1);
+        corner_area.x2 = draw_area.x2;
+        if (lv_area_get_width(&corner_area) > 0)
         {
             if (right_side || top_side)
             {
-                for (h = draw_area.y1; h < core_area.y1; h++)
-                {
-                    blend_area.y1 = h;
-                    blend_area.y2 = h;
-
-                    lv_memset(mask_buf, 0xff, blend_w);
-                    blend_dsc.mask_res = lv_draw_sw_mask_apply(mask_list, mask_buf, blend_area.x1, h, blend_w);
-                    lv_epic_draw_blend(draw_unit, &blend_dsc);
-                }
+                corner_area.y1 = draw_area.y1;
+                corner_area.y2 = core_area.y1 - 1;
+                lv_epic_draw_blend_masked(draw_unit, &blend_dsc, &corner_area, lv_epic_mask_list_row, mask_list);
             }
 
             if (right_side || bottom_side)
             {
-                for (h = core_area.y2 + 1; h <= draw_area.y2; h++)
-                {
-                    blend_area.y1 = h;
-                    blend_area.y2 = h;
-
-                    lv_memset(mask_buf, 0xff, blend_w);
-                    blend_dsc.mask_res = lv_draw_sw_mask_apply(mask_list, mask_buf, blend_area.x1, h, blend_w);
-                    lv_epic_draw_blend(draw_unit, &blend_dsc);
-                }
+                corner_area.y1 = core_area.y2 + 1;
+                corner_area.y2 = draw_area.y2;
+                lv_epic_draw_blend_masked(draw_unit, &blend_dsc, &corner_area, lv_epic_mask_list_row, mask_list);
             }
         }
     }
 
     lv_draw_sw_mask_free_param(&mask_rin_param);
     if (rout > 0) lv_draw_sw_mask_free_param(&mask_rout_param);
-    lv_free(mask_buf);
 
 #endif /*LV_DRAW_SW_COMPLEX*/
 }
@@ -73,6 +73,10 @@
 /**********************
  *  STATIC PROTOTYPES
  **********************/
+static void fill_solid(lv_draw_unit_t *draw_unit, const lv_area_t *area, lv_color_t color, lv_opa_t opa);
+static void fill_rounded(lv_draw_unit_t *draw_unit, const lv_draw_fill_dsc_t *dsc, const lv_area_t *coords);
+static void fill_grad(lv_draw_unit_t *draw_unit, const lv_draw_fill_dsc_t *dsc, const lv_area_t *coords,
+                      const lv_area_t *blend_area);
 
 /**********************
  *  STATIC VARIABLES
@@ -101,95 +105,217 @@ void lv_draw_epic_fill(lv_draw_unit_t *draw_unit, const lv_draw_fill_dsc_t *dsc,
     if (!lv_area_intersect(&blend_area, &blend_area, &layer->buf_area))
         return; /*Fully clipped, nothing to do*/
 
-
-    lv_color_format_t dest_cf = layer->color_format;
-    uint8_t *dest_blend_area_buf = lv_draw_layer_go_to_xy(layer, blend_area.x1 - layer->buf_area.x1,
-                                   blend_area.y1 - layer->buf_area.y1);
-
     /*Call epic**/
     lv_grad_dir_t grad_dir = (lv_grad_dir_t) dsc->grad.dir;
 
     if (LV_GRAD_DIR_NONE == grad_dir)
     {
-        EPIC_LayerConfigTypeDef input_layers[1];
-        EPIC_LayerConfigTypeDef output_canvas;
+        if (dsc->radius != 0)
+            fill_rounded(draw_unit, dsc, coords);
+        else
+            fill_solid(draw_unit, coords, dsc->color, dsc->opa);
+    }
+    else
+    {
+        fill_grad(draw_unit, dsc, coords, &blend_area);
+    }
+}
 
-        int ret;
-        if (lv_epic_setup_bg_and_output_layer(&input_layers[0], &output_canvas, draw_unit, coords))
-            return;/*Fully clipped, nothing to do*/
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
 
-        output_canvas.color_r = dsc->color.red;
-        output_canvas.color_g = dsc->color.green;
-        output_canvas.color_b = dsc->color.blue;
-        output_canvas.color_en = true;
+static void fill_solid(lv_draw_unit_t *draw_unit, const lv_area_t *area, lv_color_t color, lv_opa_t opa)
+{
+    EPIC_LayerConfigTypeDef input_layers[1];
+    EPIC_LayerConfigTypeDef output_canvas;
 
-        if (dsc->opa < LV_OPA_MAX)
-        {
-            input_layers[0].alpha = (0 == dsc->opa) ? 255 : (256 - dsc->opa);
+    int ret;
+    if (lv_area_get_width(area) <= 0 || lv_area_get_height(area) <= 0)
+        return;
 
-            ret = drv_epic_fill_ext(input_layers, 1, &output_canvas, NULL);
-        }
-        else
-        {
-            ret = drv_epic_fill_ext(NULL, 0, &output_canvas, NULL);
-        }
-        LV_ASSERT(0 == ret);
+    if (lv_epic_setup_bg_and_output_layer(&input_layers[0], &output_canvas, draw_unit, area))
+        return;/*Fully clipped, nothing to do*/
+
+    output_canvas.color_r = color.red;
+    output_canvas.color_g = color.green;
+    output_canvas.color_b = color.blue;
+    output_canvas.color_en = true;
+
+    if (opa < LV_OPA_MAX)
+    {
+        input_layers[0].alpha = (0 == opa) ? 255 : (256 - opa);
+
+        ret = drv_epic_fill_ext(input_layers, 1, &output_canvas, NULL);
     }
     else
     {
+        ret = drv_epic_fill_ext(NULL, 0, &output_canvas, NULL);
+    }
+    LV_ASSERT(0 == ret);
+}
 
-        EPIC_GradCfgTypeDef param;
-        HAL_EPIC_FillGradDataInit(&param);
+/*
+ * Split a rounded rectangle into 3 solid rectangles (the middle band and the straight
+ * parts between the top and bottom corners) and 4 corner blocks blended with a radius mask.
+ */
+static void fill_rounded(lv_draw_unit_t *draw_unit, const lv_draw_fill_dsc_t *dsc, const lv_area_t *coords)
+{
+    int32_t coords_w = lv_area_get_width(coords);
+    int32_t coords_h = lv_area_get_height(coords);
+    int32_t short_side = LV_MIN(coords_w, coords_h);
+    int32_t rout = dsc->radius;
+    if (rout > short_side >> 1) rout = short_side >> 1;
 
-        param.start = dest_blend_area_buf;
-        param.color_mode = lv_img_2_epic_cf(dest_cf);
-        param.width = lv_area_get_width(&blend_area);
-        param.height = lv_area_get_height(&blend_area);
-        param.total_width = lv_area_get_width(&layer->buf_area);
+    if (rout <= 0)
+    {
+        fill_solid(draw_unit, coords, dsc->color, dsc->opa);
+        return;
+    }
 
-        if (LV_GRAD_DIR_VER == grad_dir)
-        {
-            LV_ASSERT(2 == dsc->grad.stops_count);
-            EPIC_ColorDef epic_color1 = lv_color_to_epic_color(dsc->grad.stops[0].color, LV_OPA_MIX2(dsc->grad.stops[0].opa, dsc->opa));
-            EPIC_ColorDef epic_color2 = lv_color_to_epic_color(dsc->grad.stops[1].color, LV_OPA_MIX2(dsc->grad.stops[1].opa, dsc->opa));
-
-            param.color[0][0] = epic_color1;
-            param.color[0][1] = epic_color1;
-            param.color[1][0] = epic_color2;
-            param.color[1][1] = epic_color2;
-        }
-        else if (LV_GRAD_DIR_HOR == grad_dir)
+    lv_area_t a;
+
+    /*Middle band, full width*/
+    a.x1 = coords->x1;
+    a.x2 = coords->x2;
+    a.y1 = coords->y1 + rout;
+    a.y2 = coords->y2 - rout;
+    fill_solid(draw_unit, &a, dsc->color, dsc->opa);
+
+    /*Top and bottom bands between the corners*/
+    a.x1 = coords->x1 + rout;
+    a.x2 = coords->x2 - rout;
+    a.y1 = coords->y1;
+    a.y2 = coords->y1 + rout - 1;
+    fill_solid(draw_unit, &a, dsc->color, dsc->opa);
+
+    a.y1 = coords->y2 - rout + 1;
+    a.y2 = coords->y2;
+    fill_solid(draw_unit, &a, dsc->color, dsc->opa);
+
+#if LV_DRAW_SW_COMPLEX
+    lv_draw_sw_mask_radius_param_t mask_rout_param;
+    lv_draw_sw_mask_radius_init(&mask_rout_param, coords, rout, false);
+    void *mask_list[2] = {&mask_rout_param, NULL};
+
+    lv_draw_sw_blend_dsc_t blend_dsc;
+    lv_memzero(&blend_dsc, sizeof(blend_dsc));
+    blend_dsc.color = dsc->color;
+    blend_dsc.opa = dsc->opa;
+
+    /*Left and right corner blocks, merged if they touch*/
+    lv_area_t corner;
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        corner.y1 = (0 == i) ? coords->y1 : coords->y2 - rout + 1;
+        corner.y2 = corner.y1 + rout - 1;
+
+        if (coords_w <= rout * 2)
         {
-            LV_ASSERT(2 == dsc->grad.stops_count);
-            EPIC_ColorDef epic_color1 = lv_color_to_epic_color(dsc->grad.stops[0].color, LV_OPA_MIX2(dsc->grad.stops[0].opa, dsc->opa));
-            EPIC_ColorDef epic_color2 = lv_color_to_epic_color(dsc->grad.stops[1].color, LV_OPA_MIX2(dsc->grad.stops[1].opa, dsc->opa));
-
-            param.color[0][0] = epic_color1;
-            param.color[0][1] = epic_color2;
-            param.color[1][0] = epic_color1;
-            param.color[1][1] = epic_color2;
+            corner.x1 = coords->x1;
+            corner.x2 = coords->x2;
+            lv_epic_draw_blend_masked(draw_unit, &blend_dsc, &corner, lv_epic_mask_list_row, mask_list);
         }
         else
         {
-            EPIC_ColorDef epic_color = lv_color_to_epic_color(dsc->color, dsc->opa);
+            corner.x1 = coords->x1;
+            corner.x2 = coords->x1 + rout - 1;
+            lv_epic_draw_blend_masked(draw_unit, &blend_dsc, &corner, lv_epic_mask_list_row, mask_list);
 
-            param.color[0][0] = epic_color;
-            param.color[0][1] = epic_color;
-            param.color[1][0] = epic_color;
-            param.color[1][1] = epic_color;
+            corner.x1 = coords->x2 - rout + 1;
+            corner.x2 = coords->x2;
+            lv_epic_draw_blend_masked(draw_unit, &blend_dsc, &corner, lv_epic_mask_list_row, mask_list);
         }
+    }
+
+    lv_draw_sw_mask_free_param(&mask_rout_param);
+#endif /*LV_DRAW_SW_COMPLEX*/
+}
+
+/*
+ * Horizontal and vertical gradients.
+ * EPIC interpolates between 2 colors only, so every pair of neighbouring stops is drawn as a
+ * separate 2 color segment. The colors at the segment ends are taken from the same stop
+ * calculation as the SW renderer, so clipped segments and segment boundaries match it.
+ */
+static void fill_grad(lv_draw_unit_t *draw_unit, const lv_draw_fill_dsc_t *dsc, const lv_area_t *coords,
+                      const lv_area_t *blend_area)
+{
+    lv_layer_t *layer = draw_unit->target_layer;
+    const lv_grad_dsc_t *grad = &dsc->grad;
+    lv_grad_dir_t grad_dir = (lv_grad_dir_t) grad->dir;
 
+    bool hor = (LV_GRAD_DIR_HOR == grad_dir);
+    int32_t range = hor ? lv_area_get_width(coords) : lv_area_get_height(coords);
+    int32_t coords_start = hor ? coords->x1 : coords->y1;
+    int32_t clip_start = (hor ? blend_area->x1 : blend_area->y1) - coords_start;
+    int32_t clip_end = (hor ? blend_area->x2 : blend_area->y2) - coords_start;
 
+    LV_ASSERT(grad->stops_count >= 1);
 
-        int ret_v = drv_epic_fill_grad(&param, NULL);
-        LV_ASSERT(0 == ret_v);
+    /*Segment i is [seg_start, stop i]; the part before the first stop and after the last one are solid*/
+    int32_t seg_start = 0;
+    for (uint32_t i = 0; i <= grad->stops_count; i++)
+    {
+        int32_t seg_end = (i < grad->stops_count) ? ((grad->stops[i].frac * range) >> 8) : range - 1;
+        if (seg_end > range - 1) seg_end = range - 1;
+
+        int32_t a = LV_MAX(seg_start, clip_start);
+        int32_t b = LV_MIN(seg_end, clip_end);
+        if (a <= b)
+        {
+            lv_grad_color_t c1, c2;
+            lv_opa_t opa1, opa2;
+            lv_gradient_color_calculate(grad, range, a, &c1, &opa1);
+            lv_gradient_color_calculate(grad, range, b, &c2, &opa2);
+
+            EPIC_ColorDef epic_color1 = lv_color_to_epic_color(c1, LV_OPA_MIX2(opa1, dsc->opa));
+            EPIC_ColorDef epic_color2 = lv_color_to_epic_color(c2, LV_OPA_MIX2(opa2, dsc->opa));
+
+            lv_area_t seg_area = *blend_area;
+            if (hor)
+            {
+                seg_area.x1 = coords_start + a;
+                seg_area.x2 = coords_start + b;
+            }
+            else
+            {
+                seg_area.y1 = coords_start + a;
+                seg_area.y2 = coords_start + b;
+            }
+
+            EPIC_GradCfgTypeDef param;
+            HAL_EPIC_FillGradDataInit(&param);
+
+            param.start = lv_draw_layer_go_to_xy(layer, seg_area.x1 - layer->buf_area.x1,
+                                                 seg_area.y1 - layer->buf_area.y1);
+            param.color_mode = lv_img_2_epic_cf(layer->color_format);
+            param.width = lv_area_get_width(&seg_area);
+            param.height = lv_area_get_height(&seg_area);
+            param.total_width = lv_area_get_width(&layer->buf_area);
+
+            if (hor)
+            {
+                param.color[0][0] = epic_color1;
+                param.color[0][1] = epic_color2;
+                param.color[1][0] = epic_color1;
+                param.color[1][1] = epic_color2;
+            }
+            else
+            {
+                param.color[0][0] = epic_color1;
+                param.color[0][1] = epic_color1;
+                param.color[1][0] = epic_color2;
+                param.color[1][1] = epic_color2;
+            }
+
+            int ret_v = drv_epic_fill_grad(&param, NULL);
+            LV_ASSERT(0 == ret_v);
+        }
 
+        seg_start = LV_MAX(seg_start, seg_end + 1);
+        if (seg_start > clip_end) break;
     }
 }
 
-/**********************
- *   STATIC FUNCTIONS
- **********************/
-
-
 #endif /*LV_USE_DRAW_EPIC*/
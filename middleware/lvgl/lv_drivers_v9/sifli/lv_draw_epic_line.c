@@ -0,0 +1,408 @@
+/**
+  ******************************************************************************
+  * @file   lv_draw_epic_line.c
+  * @author Sifli software development team
+  ******************************************************************************
+*/
+/**
+ * @attention
+ * Copyright (c) 2019 - 2022,  Sifli Technology
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Sifli integrated circuit
+ *    in a product or a software update for such product, must reproduce the above
+ *    copyright notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Sifli nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Sifli integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY SIFLI TECHNOLOGY "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL SIFLI TECHNOLOGY OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_draw_epic.h"
+
+#if LV_USE_DRAW_EPIC
+#include "lv_epic_utils.h"
+
+#include "../../misc/lv_area_private.h"
+#include "lv_draw_sw_mask_private.h"
+#include "blend/lv_draw_sw_blend_private.h"
+#include "lv_draw_sw.h"
+
+#include "../../misc/lv_math.h"
+#include "../../stdlib/lv_mem.h"
+#include "../../stdlib/lv_string.h"
+#include "../lv_draw_private.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct
+{
+    const lv_opa_t *pattern;    /*Dash pattern of one row of a horizontal line*/
+} dash_hor_ctx_t;
+
+typedef struct
+{
+    int32_t dash_cnt;           /*Dash counter of the next row of a vertical line*/
+    int32_t dash_width;
+    int32_t dash_gap;
+} dash_ver_ctx_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void draw_line_hor(lv_draw_unit_t *draw_unit, const lv_draw_line_dsc_t *dsc);
+static void draw_line_ver(lv_draw_unit_t *draw_unit, const lv_draw_line_dsc_t *dsc);
+static void draw_line_skew(lv_draw_unit_t *draw_unit, const lv_draw_line_dsc_t *dsc);
+static lv_draw_sw_mask_res_t dash_hor_row(void *user_data, lv_opa_t *mask_buf, int32_t x, int32_t y, int32_t len);
+static lv_draw_sw_mask_res_t dash_ver_row(void *user_data, lv_opa_t *mask_buf, int32_t x, int32_t y, int32_t len);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void lv_draw_epic_line(lv_draw_unit_t *draw_unit, const lv_draw_line_dsc_t *dsc)
+{
+    if (dsc->width == 0) return;
+    if (dsc->opa <= LV_OPA_MIN) return;
+
+    if (dsc->p1.x == dsc->p2.x && dsc->p1.y == dsc->p2.y) return;
+
+    lv_area_t clip_line;
+    clip_line.x1 = (int32_t)LV_MIN(dsc->p1.x, dsc->p2.x) - dsc->width / 2;
+    clip_line.x2 = (int32_t)LV_MAX(dsc->p1.x, dsc->p2.x) + dsc->width / 2;
+    clip_line.y1 = (int32_t)LV_MIN(dsc->p1.y, dsc->p2.y) - dsc->width / 2;
+    clip_line.y2 = (int32_t)LV_MAX(dsc->p1.y, dsc->p2.y) + dsc->width / 2;
+
+    if (!lv_area_intersect(&clip_line, &clip_line, draw_unit->clip_area)) return;
+
+    if (dsc->p1.y == dsc->p2.y) draw_line_hor(draw_unit, dsc);
+    else if (dsc->p1.x == dsc->p2.x) draw_line_ver(draw_unit, dsc);
+    else draw_line_skew(draw_unit, dsc);
+
+    if (dsc->round_end || dsc->round_start)
+    {
+        lv_draw_fill_dsc_t cir_dsc;
+        lv_draw_fill_dsc_init(&cir_dsc);
+        cir_dsc.color = dsc->color;
+        cir_dsc.radius = LV_RADIUS_CIRCLE;
+        cir_dsc.opa = dsc->opa;
+
+        int32_t r = (dsc->width >> 1);
+        int32_t r_corr = (dsc->width & 1) ? 0 : 1;
+        lv_area_t cir_area;
+
+        if (dsc->round_start)
+        {
+            cir_area.x1 = (int32_t)dsc->p1.x - r;
+            cir_area.y1 = (int32_t)dsc->p1.y - r;
+            cir_area.x2 = (int32_t)dsc->p1.x + r - r_corr;
+            cir_area.y2 = (int32_t)dsc->p1.y + r - r_corr ;
+            lv_draw_epic_fill(draw_unit, &cir_dsc, &cir_area);
+        }
+
+        if (dsc->round_end)
+        {
+            cir_area.x1 = (int32_t)dsc->p2.x - r;
+            cir_area.y1 = (int32_t)dsc->p2.y - r;
+            cir_area.x2 = (int32_t)dsc->p2.x + r - r_corr;
+            cir_area.y2 = (int32_t)dsc->p2.y + r - r_corr ;
+            lv_draw_epic_fill(draw_unit, &cir_dsc, &cir_area);
+        }
+    }
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void draw_line_hor(lv_draw_unit_t *draw_unit, const lv_draw_line_dsc_t *dsc)
+{
+    int32_t w = dsc->width - 1;
+    int32_t w_half0 = w >> 1;
+    int32_t w_half1 = w_half0 + (w & 0x1); /*Compensate rounding error*/
+
+    lv_area_t blend_area;
+    blend_area.x1 = (int32_t)LV_MIN(dsc->p1.x, dsc->p2.x);
+    blend_area.x2 = (int32_t)LV_MAX(dsc->p1.x, dsc->p2.x)  - 1;
+    blend_area.y1 = (int32_t)dsc->p1.y - w_half1;
+    blend_area.y2 = (int32_t)dsc->p1.y + w_half0;
+
+    if (!lv_area_intersect(&blend_area, &blend_area, draw_unit->clip_area)) return;
+
+    bool dashed = dsc->dash_gap && dsc->dash_width;
+
+    lv_draw_sw_blend_dsc_t blend_dsc;
+    lv_memzero(&blend_dsc, sizeof(blend_dsc));
+    blend_dsc.blend_area = &blend_area;
+    blend_dsc.color = dsc->color;
+    blend_dsc.opa = dsc->opa;
+
+    /*If there is no mask then simply draw a rectangle*/
+    if (!dashed)
+    {
+        lv_epic_draw_blend(draw_unit, &blend_dsc);
+        return;
+    }
+
+    /*Every row has the same dashes, build one row the same way as the SW renderer
+     *and blend all rows with it*/
+    int32_t blend_area_w = lv_area_get_width(&blend_area);
+    int32_t dash_start = blend_area.x1 % (dsc->dash_gap + dsc->dash_width);
+
+    lv_opa_t *pattern = lv_malloc(blend_area_w);
+    LV_ASSERT_MALLOC(pattern);
+    if (NULL == pattern) return;
+    lv_memset(pattern, 0xff, blend_area_w);
+
+    int32_t dash_cnt = dash_start;
+    int32_t i;
+    for (i = 0; i < blend_area_w; i++, dash_cnt++)
+    {
+        if (dash_cnt <= dsc->dash_width)
+        {
+            int16_t diff = dsc->dash_width - dash_cnt;
+            i += diff;
+            dash_cnt += diff;
+        }
+        else if (dash_cnt > dsc->dash_gap + dsc->dash_width)
+        {
+            dash_cnt = 0;
+        }
+        else
+        {
+            pattern[i] = 0x00;
+        }
+    }
+
+    dash_hor_ctx_t ctx = {pattern};
+    lv_epic_draw_blend_masked(draw_unit, &blend_dsc, &blend_area, dash_hor_row, &ctx);
+
+    lv_free(pattern);
+}
+
+static void draw_line_ver(lv_draw_unit_t *draw_unit, const lv_draw_line_dsc_t *dsc)
+{
+    int32_t w = dsc->width - 1;
+    int32_t w_half0 = w >> 1;
+    int32_t w_half1 = w_half0 + (w & 0x1); /*Compensate rounding error*/
+
+    lv_area_t blend_area;
+    blend_area.x1 = (int32_t)dsc->p1.x - w_half1;
+    blend_area.x2 = (int32_t)dsc->p1.x + w_half0;
+    blend_area.y1 = (int32_t)LV_MIN(dsc->p1.y, dsc->p2.y);
+    blend_area.y2 = (int32_t)LV_MAX(dsc->p1.y, dsc->p2.y) - 1;
+
+    if (!lv_area_intersect(&blend_area, &blend_area, draw_unit->clip_area)) return;
+
+    bool dashed = dsc->dash_gap && dsc->dash_width;
+
+    lv_draw_sw_blend_dsc_t blend_dsc;
+    lv_memzero(&blend_dsc, sizeof(blend_dsc));
+    blend_dsc.blend_area = &blend_area;
+    blend_dsc.color = dsc->color;
+    blend_dsc.opa = dsc->opa;
+
+    /*If there is no mask then simply draw a rectangle*/
+    if (!dashed)
+    {
+        lv_epic_draw_blend(draw_unit, &blend_dsc);
+        return;
+    }
+
+    /*Rows are either fully drawn or skipped, lv_epic_draw_blend_masked merges them into blocks*/
+    dash_ver_ctx_t ctx;
+    ctx.dash_cnt = blend_area.y1 % (dsc->dash_gap + dsc->dash_width);
+    ctx.dash_width = dsc->dash_width;
+    ctx.dash_gap = dsc->dash_gap;
+    lv_epic_draw_blend_masked(draw_unit, &blend_dsc, &blend_area, dash_ver_row, &ctx);
+}
+
+static void draw_line_skew(lv_draw_unit_t *draw_unit, const lv_draw_line_dsc_t *dsc)
+{
+#if LV_DRAW_SW_COMPLEX
+    /*Keep the great y in p1*/
+    lv_point_t p1;
+    lv_point_t p2;
+    if (dsc->p1.y < dsc->p2.y)
+    {
+        p1 = lv_point_from_precise(&dsc->p1);
+        p2 = lv_point_from_precise(&dsc->p2);
+    }
+    else
+    {
+        p1 = lv_point_from_precise(&dsc->p2);
+        p2 = lv_point_from_precise(&dsc->p1);
+    }
+
+    int32_t xdiff = p2.x - p1.x;
+    int32_t ydiff = p2.y - p1.y;
+    bool flat = LV_ABS(xdiff) > LV_ABS(ydiff);
+
+    static const uint8_t wcorr[] =
+    {
+        128, 128, 128, 129, 129, 130, 130, 131,
+        132, 133, 134, 135, 137, 138, 140, 141,
+        143, 145, 147, 149, 151, 153, 155, 158,
+        160, 162, 165, 167, 170, 173, 175, 178,
+        181,
+    };
+
+    int32_t w = dsc->width;
+    int32_t wcorr_i = 0;
+    if (flat) wcorr_i = (LV_ABS(ydiff) << 5) / LV_ABS(xdiff);
+    else wcorr_i = (LV_ABS(xdiff) << 5) / LV_ABS(ydiff);
+
+    w = (w * wcorr[wcorr_i] + 63) >> 7;     /*+ 63 for rounding*/
+    int32_t w_half0 = w >> 1;
+    int32_t w_half1 = w_half0 + (w & 0x1); /*Compensate rounding error*/
+
+    lv_area_t blend_area;
+    blend_area.x1 = LV_MIN(p1.x, p2.x) - w;
+    blend_area.x2 = LV_MAX(p1.x, p2.x) + w;
+    blend_area.y1 = LV_MIN(p1.y, p2.y) - w;
+    blend_area.y2 = LV_MAX(p1.y, p2.y) + w;
+
+    if (!lv_area_intersect(&blend_area, &blend_area, draw_unit->clip_area)) return;
+
+    lv_draw_sw_mask_line_param_t mask_left_param;
+    lv_draw_sw_mask_line_param_t mask_right_param;
+    lv_draw_sw_mask_line_param_t mask_top_param;
+    lv_draw_sw_mask_line_param_t mask_bottom_param;
+
+    void *masks[5] = {&mask_left_param, & mask_right_param, NULL, NULL, NULL};
+
+    if (flat)
+    {
+        if (xdiff > 0)
+        {
+            lv_draw_sw_mask_line_points_init(&mask_left_param, p1.x, p1.y - w_half0, p2.x, p2.y - w_half0,
+                                             LV_DRAW_SW_MASK_LINE_SIDE_LEFT);
+            lv_draw_sw_mask_line_points_init(&mask_right_param, p1.x, p1.y + w_half1, p2.x, p2.y + w_half1,
+                                             LV_DRAW_SW_MASK_LINE_SIDE_RIGHT);
+        }
+        else
+        {
+            lv_draw_sw_mask_line_points_init(&mask_left_param, p1.x, p1.y + w_half1, p2.x, p2.y + w_half1,
+                                             LV_DRAW_SW_MASK_LINE_SIDE_LEFT);
+            lv_draw_sw_mask_line_points_init(&mask_right_param, p1.x, p1.y - w_half0, p2.x, p2.y - w_half0,
+                                             LV_DRAW_SW_MASK_LINE_SIDE_RIGHT);
+        }
+    }
+    else
+    {
+        lv_draw_sw_mask_line_points_init(&mask_left_param, p1.x + w_half1, p1.y, p2.x + w_half1, p2.y,
+                                         LV_DRAW_SW_MASK_LINE_SIDE_LEFT);
+        lv_draw_sw_mask_line_points_init(&mask_right_param, p1.x - w_half0, p1.y, p2.x - w_half0, p2.y,
+                                         LV_DRAW_SW_MASK_LINE_SIDE_RIGHT);
+    }
+
+    /*Use the normal vector for the endings*/
+    if (!dsc->raw_end)
+    {
+        lv_draw_sw_mask_line_points_init(&mask_top_param, p1.x, p1.y, p1.x - ydiff, p1.y + xdiff,
+                                         LV_DRAW_SW_MASK_LINE_SIDE_BOTTOM);
+        lv_draw_sw_mask_line_points_init(&mask_bottom_param, p2.x, p2.y, p2.x - ydiff, p2.y + xdiff,
+                                         LV_DRAW_SW_MASK_LINE_SIDE_TOP);
+        masks[2] = &mask_top_param;
+        masks[3] = &mask_bottom_param;
+    }
+
+    lv_draw_sw_blend_dsc_t blend_dsc;
+    lv_memzero(&blend_dsc, sizeof(blend_dsc));
+    blend_dsc.color = dsc->color;
+    blend_dsc.opa = dsc->opa;
+    lv_epic_draw_blend_masked(draw_unit, &blend_dsc, &blend_area, lv_epic_mask_list_row, masks);
+
+    lv_draw_sw_mask_free_param(&mask_left_param);
+    lv_draw_sw_mask_free_param(&mask_right_param);
+    if (!dsc->raw_end)
+    {
+        lv_draw_sw_mask_free_param(&mask_top_param);
+        lv_draw_sw_mask_free_param(&mask_bottom_param);
+    }
+#else
+    LV_UNUSED(draw_unit);
+    LV_UNUSED(dsc);
+    LV_LOG_WARN("Can't draw skewed line with LV_DRAW_SW_COMPLEX == 0");
+#endif /*LV_DRAW_SW_COMPLEX*/
+}
+
+static lv_draw_sw_mask_res_t dash_hor_row(void *user_data, lv_opa_t *mask_buf, int32_t x, int32_t y, int32_t len)
+{
+    dash_hor_ctx_t *ctx = user_data;
+    LV_UNUSED(x);
+    LV_UNUSED(y);
+
+    lv_memcpy(mask_buf, ctx->pattern, len);
+    return LV_DRAW_SW_MASK_RES_CHANGED;
+}
+
+/*Rows are requested from top to bottom, one by one, so the counter runs like in the SW renderer*/
+static lv_draw_sw_mask_res_t dash_ver_row(void *user_data, lv_opa_t *mask_buf, int32_t x, int32_t y, int32_t len)
+{
+    dash_ver_ctx_t *ctx = user_data;
+    lv_draw_sw_mask_res_t res;
+    LV_UNUSED(x);
+    LV_UNUSED(y);
+
+    if (ctx->dash_cnt > ctx->dash_width)
+    {
+        res = LV_DRAW_SW_MASK_RES_TRANSP;
+    }
+    else
+    {
+        lv_memset(mask_buf, 0xff, len);
+        res = LV_DRAW_SW_MASK_RES_FULL_COVER;
+    }
+
+    if (ctx->dash_cnt >= ctx->dash_gap + ctx->dash_width)
+    {
+        ctx->dash_cnt = 0;
+    }
+    ctx->dash_cnt++;
+
+    return res;
+}
+
+#endif /*LV_USE_DRAW_EPIC*/
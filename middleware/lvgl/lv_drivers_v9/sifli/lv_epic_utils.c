@@ -56,6 +56,7 @@
 #include "../../misc/lv_area_private.h"
 #include "lv_draw_sw_mask_private.h"
 #include "blend/lv_draw_sw_blend_private.h"
+#include "../../stdlib/lv_mem.h"
 #include "string.h"
 
 /*********************
@@ -293,6 +294,86 @@ void lv_epic_draw_blend(lv_draw_unit_t *draw_unit, const lv_draw_sw_blend_dsc_t
     }
 }
 
+void lv_epic_draw_blend_masked(lv_draw_unit_t *draw_unit, const lv_draw_sw_blend_dsc_t *blend_dsc,
+                               const lv_area_t *area, lv_epic_mask_row_cb_t row_cb, void *user_data)
+{
+    if (blend_dsc->opa <= LV_OPA_MIN) return;
+
+    lv_area_t draw_area;
+    if (!lv_area_intersect(&draw_area, area, draw_unit->clip_area)) return;
+
+    int32_t draw_w = lv_area_get_width(&draw_area);
+    int32_t draw_h = lv_area_get_height(&draw_area);
+    int32_t chunk_h = (LV_EPIC_MASK_BUF_SIZE / 2) / draw_w;
+    if (chunk_h < 1) chunk_h = 1;
+    if (chunk_h > draw_h) chunk_h = draw_h;
+
+    /*A single chunk needs no ping-pong half*/
+    uint32_t half_size = draw_w * chunk_h;
+    lv_opa_t *mask_buf = lv_malloc((chunk_h < draw_h) ? half_size * 2 : half_size);
+    LV_ASSERT_MALLOC(mask_buf);
+    if (NULL == mask_buf) return;
+
+    lv_opa_t *mask_half = mask_buf;
+    lv_area_t chunk_area = draw_area;
+    lv_draw_sw_blend_dsc_t dsc = *blend_dsc;
+    dsc.blend_area = &chunk_area;
+    dsc.mask_area = &chunk_area;
+
+    for (int32_t y = draw_area.y1; y <= draw_area.y2; y = chunk_area.y2 + 1)
+    {
+        chunk_area.y1 = y;
+        chunk_area.y2 = LV_MIN(y + chunk_h - 1, draw_area.y2);
+
+        bool all_cover = true;
+        bool all_transp = true;
+        lv_opa_t *row = mask_half;
+        for (int32_t h = chunk_area.y1; h <= chunk_area.y2; h++)
+        {
+            lv_draw_sw_mask_res_t res = row_cb(user_data, row, draw_area.x1, h, draw_w);
+            if (LV_DRAW_SW_MASK_RES_TRANSP == res)
+            {
+                lv_memzero(row, draw_w);
+                all_cover = false;
+            }
+            else
+            {
+                all_transp = false;
+                if (LV_DRAW_SW_MASK_RES_FULL_COVER != res) all_cover = false;
+            }
+            row += draw_w;
+        }
+
+        if (all_transp) continue;
+
+        if (all_cover)
+        {
+            dsc.mask_buf = NULL;
+            dsc.mask_res = LV_DRAW_SW_MASK_RES_FULL_COVER;
+            lv_epic_draw_blend(draw_unit, &dsc);
+        }
+        else
+        {
+            dsc.mask_buf = mask_half;
+            dsc.mask_res = LV_DRAW_SW_MASK_RES_CHANGED;
+            lv_epic_draw_blend(draw_unit, &dsc);
+
+            /*EPIC is still reading this half, prepare the next chunk in the other one*/
+            mask_half = (mask_half == mask_buf) ? mask_buf + half_size : mask_buf;
+        }
+    }
+
+    drv_epic_wait_done();
+    lv_free(mask_buf);
+}
+
+lv_draw_sw_mask_res_t lv_epic_mask_list_row(void *user_data, lv_opa_t *mask_buf,
+                                            int32_t x, int32_t y, int32_t len)
+{
+    lv_memset(mask_buf, 0xff, len);
+    return lv_draw_sw_mask_apply((void **)user_data, mask_buf, x, y, len);
+}
+
 void lv_epic_print_area_info(const char *prefix, const lv_area_t *p_area)
 {
     LV_EPIC_LOG("%s[%d,%d,%d,%d]", prefix, p_area->x1, p_area->y1, p_area->x2, p_area->y2);
@@ -67,11 +67,25 @@ extern "C" {
 /*********************
  *      DEFINES
  *********************/
+#ifndef LV_EPIC_MASK_BUF_SIZE
+    /*Mask buffer of lv_epic_draw_blend_masked, split into 2 halves so the
+     *CPU can prepare one chunk while EPIC blends the other.*/
+    #define LV_EPIC_MASK_BUF_SIZE   (4 * 1024)
+#endif
+
 typedef  int32_t lv_coord_t;
 /**********************
  *      TYPEDEFS
  **********************/
 
+/**
+ * Generate one row of mask for lv_epic_draw_blend_masked.
+ * The callback should fill `len` bytes of `mask_buf` for pixels [x, x + len - 1] of row y,
+ * rows reported as LV_DRAW_SW_MASK_RES_FULL_COVER must be filled with 0xff.
+ */
+typedef lv_draw_sw_mask_res_t (*lv_epic_mask_row_cb_t)(void *user_data, lv_opa_t *mask_buf,
+                                                       int32_t x, int32_t y, int32_t len);
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -83,6 +97,21 @@ uint32_t lv_epic_setup_bg_and_output_layer(EPIC_LayerConfigTypeDef *epic_bg_laye
 void lv_epic_print_area_info(const char *prefix, const lv_area_t *p_area);
 void lv_epic_print_layer_info(lv_draw_unit_t *draw_unit);
 void lv_epic_draw_blend(lv_draw_unit_t *draw_unit, const lv_draw_sw_blend_dsc_t *blend_dsc);
+
+/**
+ * Blend `area` with a mask generated row by row.
+ * Rows are collected into multi-line A8 masks so EPIC blends a block of rows per operation,
+ * fully covered blocks are filled without mask and transparent blocks are skipped.
+ * color/opa/src_* of blend_dsc are used, blend_area/mask_* are set internally.
+ */
+void lv_epic_draw_blend_masked(lv_draw_unit_t *draw_unit, const lv_draw_sw_blend_dsc_t *blend_dsc,
+                               const lv_area_t *area, lv_epic_mask_row_cb_t row_cb, void *user_data);
+
+/**
+ * lv_epic_mask_row_cb_t applying a NULL terminated list of SW masks, user_data is the `void *masks[]`.
+ */
+lv_draw_sw_mask_res_t lv_epic_mask_list_row(void *user_data, lv_opa_t *mask_buf,
+                                            int32_t x, int32_t y, int32_t len);
 /**********************
  *      MACROS
  **********************/
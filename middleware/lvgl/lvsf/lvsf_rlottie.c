@@ -10,6 +10,7 @@
 #include "lvgl.h"
 #if PKG_USING_RLOTTIE != 0
 
+#include <rtthread.h>
 #include "lvsf_rlottie.h"
 #include <rlottie_capi.h>
 #include "app_mem.h"
@@ -30,6 +31,25 @@
 // rlottie internal is using ARGB
 #define ARGB888_PIXEL_SIZE 4
 
+#ifdef RLOTTIE_RENDER_THREAD
+    #define RLOTTIE_RING_NUM    RLOTTIE_FRAME_RING_NUM
+    /* Shown slot may be drawn while the worker renders */
+    #define RLOTTIE_RING_SHOWN  1
+#else
+    /* GUI thread renders into the shown slot in place */
+    #define RLOTTIE_RING_NUM    1
+    #define RLOTTIE_RING_SHOWN  0
+#endif
+/* LVGL format is not bigger than ARGB32, the only slot is converted in the render buffer */
+#if !defined(RLOTTIE_RENDER_THREAD) && LV_COLOR_DEPTH == 16
+    #define RLOTTIE_IN_PLACE    1
+#else
+    #define RLOTTIE_IN_PLACE    0
+#endif
+#ifndef RLOTTIE_LOOP_CACHE_SIZE
+    #define RLOTTIE_LOOP_CACHE_SIZE 0
+#endif
+
 /*********************
  *      DEFINES
  *********************/
@@ -47,18 +67,50 @@ typedef struct
     size_t total_frames;
     size_t current_frame;
     size_t framerate;
-    uint32_t *allocated_buf;
+    uint32_t *allocated_buf;        /* ARGB32 render target, NULL if slots are rendered directly,
+                                       also the only slot if RLOTTIE_IN_PLACE */
     size_t allocated_buffer_size;
     size_t scanline_width;
     void *file_data;
+
+    /* Frame ring, slot rd - 1 is shown, ready slots from rd wait to be shown,
+       the rest may be rendered. Loop cache replaces the ring when all frames fit. */
+    rt_slist_t node;
+    uint8_t *slot[RLOTTIE_RING_NUM];
+    size_t slot_frame[RLOTTIE_RING_NUM];
+    uint8_t rd;
+    uint8_t ready;
+    uint8_t *cache;
+    size_t cached;                  /* frames in cache, rendered in order */
+    size_t render_frame;            /* next frame to render into the ring */
+    lv_rlottie_stats_t stats;
+    rt_tick_t render_ticks;
 } lvsf_rlottie_t;
 
+typedef struct
+{
+    struct rt_mutex lock;
+    struct rt_semaphore sem;
+    struct rt_semaphore done;       /* the frame detach waits for is rendered */
+    rt_slist_t list;                /* playing animations */
+    lvsf_rlottie_t *rendering;
+    uint8_t detach_wait;
+    rt_thread_t thread;
+} lvsf_rlottie_worker_t;
+
 /**********************
  *  STATIC PROTOTYPES
  **********************/
 static void lv_rlottie_constructor(const lv_obj_class_t *class_p, lv_obj_t *obj);
 static void lv_rlottie_destructor(const lv_obj_class_t *class_p, lv_obj_t *obj);
 static void next_frame_task_cb(lv_timer_t *t);
+static void rlottie_release(lvsf_rlottie_t *ext);
+static void rlottie_reset(lvsf_rlottie_t *ext);
+static void rlottie_render(lvsf_rlottie_t *ext, uint8_t *buf, size_t frame);
+static void rlottie_lock(void);
+static void rlottie_unlock(void);
+static void rlottie_worker_attach(lvsf_rlottie_t *ext);
+static void rlottie_worker_detach(lvsf_rlottie_t *ext);
 
 /**********************
  *  STATIC VARIABLES
@@ -71,6 +123,8 @@ const lv_obj_class_t lv_rlottie_class =
     .base_class = &lv_img_class
 };
 
+static lvsf_rlottie_worker_t g_rlottie_worker;
+
 /**********************
  *      MACROS
  **********************/
@@ -79,8 +133,10 @@ const lv_obj_class_t lv_rlottie_class =
  *   GLOBAL FUNCTIONS
  **********************/
 
-static void common_rlottie_setup(lvsf_rlottie_t *ext, lv_obj_t *parent)
+static int common_rlottie_setup(lvsf_rlottie_t *ext, lv_obj_t *parent)
 {
+    size_t i;
+
     lv_obj_update_layout((const lv_obj_t *) ext);
     ext->total_frames = lottie_animation_get_totalframe(ext->animation);
     ext->framerate = lottie_animation_get_framerate(ext->animation);
@@ -89,25 +145,56 @@ static void common_rlottie_setup(lvsf_rlottie_t *ext, lv_obj_t *parent)
     lv_coord_t obj_width = lv_obj_get_width(parent);
     lv_coord_t obj_height = lv_obj_get_height(parent);
 
+    ext->imgdsc.header.always_zero = 0;
+    ext->imgdsc.header.cf = LV_IMG_CF_TRUE_COLOR_ALPHA;
+    ext->imgdsc.header.h = obj_height;
+    ext->imgdsc.header.w = obj_width;
+    ext->imgdsc.data_size = lv_img_buf_get_img_size(ext->imgdsc.header.w, ext->imgdsc.header.h, ext->imgdsc.header.cf);
     ext->scanline_width = obj_width * ARGB888_PIXEL_SIZE;
+
+#if LV_COLOR_DEPTH == 16
     size_t allocaled_buf_size = (obj_width * obj_height * ARGB888_PIXEL_SIZE);
     ext->allocated_buf = app_cache_alloc(allocaled_buf_size, IMAGE_CACHE_PSRAM);
-    if (ext->allocated_buf != NULL)
+    if (ext->allocated_buf == NULL)
+        return -RT_ENOMEM;
+    ext->allocated_buffer_size = allocaled_buf_size;
+#endif
+
+    /* Short loops are kept fully rendered after the first pass */
+    if (ext->total_frames > 0 && RLOTTIE_LOOP_CACHE_SIZE > 0
+            && ext->total_frames * ext->imgdsc.data_size <= RLOTTIE_LOOP_CACHE_SIZE * 1024)
+        ext->cache = app_cache_alloc(ext->total_frames * ext->imgdsc.data_size, IMAGE_CACHE_PSRAM);
+    for (i = 0; !ext->cache && i < RLOTTIE_RING_NUM; i++)
     {
-        ext->allocated_buffer_size = allocaled_buf_size;
-        memset(ext->allocated_buf, 0, allocaled_buf_size);
+        if (RLOTTIE_IN_PLACE)
+            ext->slot[i] = (uint8_t *)ext->allocated_buf;
+        else
+            ext->slot[i] = app_cache_alloc(ext->imgdsc.data_size, IMAGE_CACHE_PSRAM);
+        if (ext->slot[i] == NULL)
+        {
+            rlottie_release(ext);
+            return -RT_ENOMEM;
+        }
     }
 
-    ext->imgdsc.header.always_zero = 0;
-    ext->imgdsc.header.cf = LV_IMG_CF_TRUE_COLOR_ALPHA;
-    ext->imgdsc.header.h = obj_height;
-    ext->imgdsc.header.w = obj_width;
-    ext->imgdsc.data = (const uint8_t *)ext->allocated_buf;
-    ext->imgdsc.data_size = lv_img_buf_get_img_size(ext->imgdsc.header.w, ext->imgdsc.header.h, ext->imgdsc.header.cf);
+    /* First frame is rendered now so nothing half drawn is shown */
+    if (ext->cache)
+    {
+        rlottie_render(ext, ext->cache, 0);
+        ext->cached = 1;
+        ext->imgdsc.data = ext->cache;
+    }
+    else
+    {
+        rlottie_render(ext, ext->slot[0], 0);
+        ext->slot_frame[0] = 0;
+        ext->rd = 1 % RLOTTIE_RING_NUM;
+        ext->render_frame = 1;
+        ext->imgdsc.data = ext->slot[0];
+    }
 
     lv_img_set_src((lv_obj_t *)ext, &ext->imgdsc);
-
-    int period = (int)1000.0 / ext->framerate;
+    return RT_EOK;
 }
 
 lv_obj_t *lv_rlottie_create(lv_obj_t *parent)
@@ -131,6 +218,7 @@ int lv_rlottie_file(lv_obj_t *lottie, const char *path)
         {
             struct stat stat;
             dfs_file_stat(path, &stat);
+            rlottie_reset(ext);
             if (ext->file_data)
                 app_cache_free(ext->file_data);
             ext->file_data = app_cache_alloc(stat.st_size, IMAGE_CACHE_PSRAM);
@@ -156,14 +244,18 @@ int lv_rlottie_raw(lv_obj_t *lottie, const char *rlottie_desc)
 {
     lvsf_rlottie_t *ext = (lvsf_rlottie_t *)lottie;
 
-
+    rlottie_reset(ext);
 #ifdef LOTTIE_JSON_SUPPORT
     ext->animation = lottie_animation_from_rodata(rlottie_desc, strlen(rlottie_desc), "");
 #else
     ext->animation = lottie_animation_from_data(rlottie_desc, rlottie_desc, "");
 #endif
     if (ext->animation == NULL) return -RT_ERROR;
-    common_rlottie_setup(ext,  lottie);
+    if (common_rlottie_setup(ext,  lottie) != RT_EOK)
+    {
+        rlottie_reset(ext);
+        return -RT_ENOMEM;
+    }
     return RT_EOK;
 }
 
@@ -171,13 +263,15 @@ int lv_rlottie_play(lv_obj_t *lottie, int enable)
 {
     lvsf_rlottie_t *ext = (lvsf_rlottie_t *)lottie;
 
-    if (enable && ext->task == NULL && ext->animation)
+    if (enable && ext->task == NULL && ext->animation && ext->total_frames)
     {
         int period = (int)1000.0 / ext->framerate;
         ext->task = lv_timer_create(next_frame_task_cb, period, ext);
+        rlottie_worker_attach(ext);
     }
     else if (enable == 0 && ext->task)
     {
+        rlottie_worker_detach(ext);
         lv_timer_del(ext->task);
         ext->task = NULL;
     }
@@ -186,6 +280,20 @@ int lv_rlottie_play(lv_obj_t *lottie, int enable)
     return RT_EOK;
 }
 
+int lv_rlottie_get_stats(lv_obj_t *lottie, lv_rlottie_stats_t *stats)
+{
+    lvsf_rlottie_t *ext = (lvsf_rlottie_t *)lottie;
+
+    if (!ext->animation || !stats)
+        return -RT_ERROR;
+    rlottie_lock();
+    *stats = ext->stats;
+    if (ext->stats.rendered)
+        stats->render_ms_avg = ext->render_ticks / ext->stats.rendered * 1000 / RT_TICK_PER_SECOND;
+    rlottie_unlock();
+    return RT_EOK;
+}
+
 
 /**********************
  *   STATIC FUNCTIONS
@@ -201,90 +309,326 @@ static void lv_rlottie_destructor(const lv_obj_class_t *class_p, lv_obj_t *obj)
     LV_UNUSED(class_p);
     lvsf_rlottie_t *ext = (lvsf_rlottie_t *)obj;
 
+    rlottie_reset(ext);
+    if (ext->file_data)
+        app_cache_free(ext->file_data);
+}
+
+/* Stop playing and free everything made from the current animation */
+static void rlottie_reset(lvsf_rlottie_t *ext)
+{
     if (ext->task)
+    {
+        rlottie_worker_detach(ext);
         lv_timer_del(ext->task);
+        ext->task = NULL;
+    }
     if (ext->animation)
+    {
         lottie_animation_destroy(ext->animation);
-    lv_img_cache_invalidate_src(&ext->imgdsc);
+        ext->animation = NULL;
+    }
+    rlottie_release(ext);
+}
+
+static void rlottie_release(lvsf_rlottie_t *ext)
+{
+    size_t i;
+
+    if (ext->imgdsc.data)
+    {
+        lv_img_cache_invalidate_src(&ext->imgdsc);
+        ext->imgdsc.data = NULL;
+    }
+    for (i = 0; i < RLOTTIE_RING_NUM; i++)
+    {
+        if (ext->slot[i] && ext->slot[i] != (uint8_t *)ext->allocated_buf)
+            app_cache_free(ext->slot[i]);
+        ext->slot[i] = NULL;
+    }
     if (ext->allocated_buf)
         app_cache_free(ext->allocated_buf);
-    if (ext->file_data)
-        app_cache_free(ext->file_data);
+    ext->allocated_buf = NULL;
+    ext->allocated_buffer_size = 0;
+    if (ext->cache)
+        app_cache_free(ext->cache);
+    ext->cache = NULL;
+    ext->cached = 0;
+    ext->rd = 0;
+    ext->ready = 0;
+    memset(&ext->stats, 0, sizeof(ext->stats));
+    ext->render_ticks = 0;
 }
 
 
 #if LV_COLOR_DEPTH == 16
-static void convert_to_rgba5658(uint32_t *pix, const size_t width, const size_t height)
+static inline uint32_t argb_to_rgb565(uint32_t in)
+{
+#if LV_COLOR_16_SWAP == 0
+    return ((in & 0xF80000) >> 8) | ((in & 0xFC00) >> 5) | ((in & 0xFF) >> 3);
+#else
+    /* We want: rrrr rrrr GGGg gggg bbbb bbbb => gggb bbbb rrrr rGGG */
+    return ((in & 0xF80000) >> 16) | ((in & 0xFC00) >> 13) | ((in & 0x1C00) << 3) | ((in & 0xF8) << 5);
+#endif
+}
+
+static void convert_to_rgba5658(uint8_t *dest, const uint32_t *src, size_t count)
 {
     /* rlottie draws in ARGB32 format, but LVGL only deal with RGB565 format with (optional 8 bit alpha channel)
-       so convert in place here the received buffer to LVGL format. */
-    uint8_t *dest = (uint8_t *)pix;
-    uint32_t *src = pix;
-    for (size_t y = 0; y < height; y++)
+       so convert the received buffer to LVGL format.
+       4 pixels give 12 bytes, packed and stored as 3 words when dest is word aligned.
+       dest may be src, each step reads its pixels before writing fewer bytes. */
+    if (((uintptr_t)dest & 3) == 0)
     {
-        /* Convert a 4 bytes per pixel in format ARGB to R5G6B5A8 format
-            naive way:
-                        r = ((c & 0xFF0000) >> 19)
-                        g = ((c & 0xFF00) >> 10)
-                        b = ((c & 0xFF) >> 3)
-                        rgb565 = (r << 11) | (g << 5) | b
-                        a = c >> 24;
-            That's 3 mask, 6 bitshift and 2 or operations
-
-            A bit better:
-                        r = ((c & 0xF80000) >> 8)
-                        g = ((c & 0xFC00) >> 5)
-                        b = ((c & 0xFF) >> 3)
-                        rgb565 = r | g | b
-                        a = c >> 24;
-            That's 3 mask, 3 bitshifts and 2 or operations */
-        for (size_t x = 0; x < width; x++)
+        uint32_t *d = (uint32_t *)dest;
+
+        for (; count >= 4; count -= 4)
         {
-            uint32_t in = src[x];
-#if LV_COLOR_16_SWAP == 0
-            uint16_t r = (uint16_t)(((in & 0xF80000) >> 8) | ((in & 0xFC00) >> 5) | ((in & 0xFF) >> 3));
+            uint32_t p0 = src[0], p1 = src[1], p2 = src[2], p3 = src[3];
+            uint32_t c0 = argb_to_rgb565(p0), c1 = argb_to_rgb565(p1);
+            uint32_t c2 = argb_to_rgb565(p2), c3 = argb_to_rgb565(p3);
+
+            d[0] = c0 | ((p0 >> 24) << 16) | (c1 << 24);
+            d[1] = (c1 >> 8) | ((p1 >> 24) << 8) | (c2 << 16);
+            d[2] = (p2 >> 24) | (c3 << 8) | ((p3 >> 24) << 24);
+            d += 3;
+            src += 4;
+        }
+        dest = (uint8_t *)d;
+    }
+    for (; count > 0; count--)
+    {
+        uint32_t in = *src++;
+        uint16_t r = (uint16_t)argb_to_rgb565(in);
+
+        memcpy(dest, &r, sizeof(r));
+        dest[sizeof(r)] = (uint8_t)(in >> 24);
+        dest += LV_IMG_PX_SIZE_ALPHA_BYTE;
+    }
+}
+#endif
+
+/* Render frame into buf in LVGL format, called without lock */
+static void rlottie_render(lvsf_rlottie_t *ext, uint8_t *buf, size_t frame)
+{
+#if LV_COLOR_DEPTH == 16
+    lottie_animation_render(ext->animation, frame, ext->allocated_buf,
+                            ext->imgdsc.header.w, ext->imgdsc.header.h, ext->scanline_width);
+    convert_to_rgba5658(buf, ext->allocated_buf, ext->imgdsc.header.w * ext->imgdsc.header.h);
 #else
-            /* We want: rrrr rrrr GGGg gggg bbbb bbbb => gggb bbbb rrrr rGGG */
-            uint16_t r = (uint16_t)(((in & 0xF80000) >> 16) | ((in & 0xFC00) >> 13) | ((in & 0x1C00) << 3) | ((in & 0xF8) << 5));
+    lottie_animation_render(ext->animation, frame, (uint32_t *)buf,
+                            ext->imgdsc.header.w, ext->imgdsc.header.h, ext->scanline_width);
+#endif
+}
+
+#ifdef RLOTTIE_RENDER_THREAD
+/* Lock is used by lv_rlottie_get_stats() even before any animation plays */
+static int rlottie_worker_init(void)
+{
+    lvsf_rlottie_worker_t *w = &g_rlottie_worker;
+
+    rt_mutex_init(&w->lock, "rlottie", RT_IPC_FLAG_PRIO);
+    rt_sem_init(&w->sem, "rlottie", 0, RT_IPC_FLAG_FIFO);
+    rt_sem_init(&w->done, "rlottie", 0, RT_IPC_FLAG_FIFO);
+    rt_slist_init(&w->list);
+    return 0;
+}
+INIT_PREV_EXPORT(rlottie_worker_init);
+#endif
+
+static void rlottie_lock(void)
+{
+#ifdef RLOTTIE_RENDER_THREAD
+    rt_mutex_take(&g_rlottie_worker.lock, RT_WAITING_FOREVER);
 #endif
+}
+
+static void rlottie_unlock(void)
+{
+#ifdef RLOTTIE_RENDER_THREAD
+    rt_mutex_release(&g_rlottie_worker.lock);
+#endif
+}
 
-            memcpy(dest, &r, sizeof(r));
-            dest[sizeof(r)] = (uint8_t)(in >> 24);
-            dest += LV_IMG_PX_SIZE_ALPHA_BYTE;
+/* Pick next frame to render and the buffer for it, with lock held */
+static uint8_t *rlottie_next_job(lvsf_rlottie_t *ext, size_t *frame)
+{
+    if (ext->cache)
+    {
+        if (ext->cached >= ext->total_frames)
+            return NULL;
+        *frame = ext->cached;
+        return ext->cache + ext->cached * ext->imgdsc.data_size;
+    }
+    if (ext->ready + RLOTTIE_RING_SHOWN >= RLOTTIE_RING_NUM)
+        return NULL;
+    *frame = ext->render_frame;
+    return ext->slot[(ext->rd + ext->ready) % RLOTTIE_RING_NUM];
+}
+
+/* Publish the frame rendered by the last job, with lock held */
+static void rlottie_job_done(lvsf_rlottie_t *ext, size_t frame, rt_tick_t ticks)
+{
+    ext->stats.rendered++;
+    ext->stats.render_ms_last = ticks * 1000 / RT_TICK_PER_SECOND;
+    if (ext->stats.render_ms_last > ext->stats.render_ms_max)
+        ext->stats.render_ms_max = ext->stats.render_ms_last;
+    ext->render_ticks += ticks;
+    if (ext->cache)
+    {
+        ext->cached++;
+        return;
+    }
+    ext->slot_frame[(ext->rd + ext->ready) % RLOTTIE_RING_NUM] = frame;
+    ext->ready++;
+    ext->render_frame = (frame + 1) % ext->total_frames;
+}
+
+#ifndef RLOTTIE_RENDER_THREAD
+static void rlottie_work(lvsf_rlottie_t *ext)
+{
+    rt_tick_t start;
+    size_t frame;
+    uint8_t *buf;
+
+    buf = rlottie_next_job(ext, &frame);
+    if (!buf)
+        return;
+    start = rt_tick_get();
+    rlottie_render(ext, buf, frame);
+    rlottie_job_done(ext, frame, rt_tick_get() - start);
+}
+#else
+static void rlottie_worker_entry(void *parameter)
+{
+    lvsf_rlottie_worker_t *w = (lvsf_rlottie_worker_t *)parameter;
+
+    while (1)
+    {
+        rt_sem_take(&w->sem, RT_WAITING_FOREVER);
+        while (1)
+        {
+            lvsf_rlottie_t *ext = NULL;
+            rt_slist_t *node;
+            rt_tick_t start;
+            size_t frame;
+            uint8_t *buf = NULL;
+
+            rt_mutex_take(&w->lock, RT_WAITING_FOREVER);
+            rt_slist_for_each(node, &w->list)
+            {
+                ext = rt_slist_entry(node, lvsf_rlottie_t, node);
+                buf = rlottie_next_job(ext, &frame);
+                if (buf)
+                    break;
+            }
+            if (buf)
+            {
+                /* Round robin between animations */
+                rt_slist_remove(&w->list, &ext->node);
+                rt_slist_append(&w->list, &ext->node);
+                w->rendering = ext;
+            }
+            rt_mutex_release(&w->lock);
+            if (!buf)
+                break;
+
+            start = rt_tick_get();
+            rlottie_render(ext, buf, frame);
+
+            rt_mutex_take(&w->lock, RT_WAITING_FOREVER);
+            rlottie_job_done(ext, frame, rt_tick_get() - start);
+            w->rendering = NULL;
+            if (w->detach_wait)
+            {
+                w->detach_wait = 0;
+                rt_sem_release(&w->done);
+            }
+            rt_mutex_release(&w->lock);
         }
-        src += width;
     }
 }
 #endif
 
-static void next_frame_task_cb(lv_timer_t *t)
+static void rlottie_worker_attach(lvsf_rlottie_t *ext)
 {
-    static uint32_t counter = 0;
-    if (counter > 0)
+#ifdef RLOTTIE_RENDER_THREAD
+    lvsf_rlottie_worker_t *w = &g_rlottie_worker;
+
+    if (w->thread == NULL)
     {
-        counter--;
-        return;
+        w->thread = rt_thread_create("rlottie", rlottie_worker_entry, w, RLOTTIE_RENDER_THREAD_STACK_SIZE,
+                                     RLOTTIE_RENDER_THREAD_PRIORITY, RT_THREAD_TICK_DEFAULT);
+        RT_ASSERT(w->thread);
+        rt_thread_startup(w->thread);
     }
+    rt_mutex_take(&w->lock, RT_WAITING_FOREVER);
+    rt_slist_append(&w->list, &ext->node);
+    rt_mutex_release(&w->lock);
+    rt_sem_release(&w->sem);
+#endif
+}
 
+static void rlottie_worker_detach(lvsf_rlottie_t *ext)
+{
+#ifdef RLOTTIE_RENDER_THREAD
+    lvsf_rlottie_worker_t *w = &g_rlottie_worker;
+    uint8_t wait;
+
+    rt_mutex_take(&w->lock, RT_WAITING_FOREVER);
+    rt_slist_remove(&w->list, &ext->node);
+    /* Buffers may be freed after return, wait for the frame being rendered */
+    wait = (w->rendering == ext);
+    if (wait)
+        w->detach_wait = 1;
+    rt_mutex_release(&w->lock);
+    if (wait)
+        rt_sem_take(&w->done, RT_WAITING_FOREVER);
+#endif
+}
+
+static void next_frame_task_cb(lv_timer_t *t)
+{
     lvsf_rlottie_t *ext = (lvsf_rlottie_t *)t->user_data;
-    if (ext->current_frame == ext->total_frames)
-        ext->current_frame = 0;
-    else
-        ++ext->current_frame;
+    const uint8_t *data = NULL;
 
-    lottie_animation_render(
-        ext->animation,
-        ext->current_frame,
-        ext->allocated_buf,
-        ext->imgdsc.header.w,
-        ext->imgdsc.header.h,
-        ext->scanline_width
-    );
+#ifndef RLOTTIE_RENDER_THREAD
+    rlottie_work(ext);
+#endif
 
-#if LV_COLOR_DEPTH == 16
-    convert_to_rgba5658(ext->allocated_buf, ext->imgdsc.header.w, ext->imgdsc.header.h);
+    rlottie_lock();
+    if (ext->cache)
+    {
+        size_t next = (ext->current_frame + 1) % ext->total_frames;
+
+        if (next < ext->cached)
+        {
+            ext->current_frame = next;
+            data = ext->cache + next * ext->imgdsc.data_size;
+        }
+    }
+    else if (ext->ready > 0)
+    {
+        /* Previous shown slot is free from now on */
+        ext->current_frame = ext->slot_frame[ext->rd];
+        data = ext->slot[ext->rd];
+        ext->rd = (ext->rd + 1) % RLOTTIE_RING_NUM;
+        ext->ready--;
+    }
+    if (data)
+        ext->stats.shown++;
+    else
+        ext->stats.dropped++;
+    rlottie_unlock();
+
+#ifdef RLOTTIE_RENDER_THREAD
+    rt_sem_release(&g_rlottie_worker.sem);
 #endif
+    if (!data)
+        return;
 
+    ext->imgdsc.data = data;
+    lv_img_cache_invalidate_src(&ext->imgdsc);
 #ifdef DISABLE_LVGL_V9
     lv_event_send((lv_obj_t *)ext, LV_EVENT_LEAVE, NULL);
 #else
@@ -313,5 +657,10 @@ int lv_rlottie_play(lv_obj_t *lottie, int enable)
 {
     return -RT_ERROR;
 }
+
+int lv_rlottie_get_stats(lv_obj_t *lottie, lv_rlottie_stats_t *stats)
+{
+    return -RT_ERROR;
+}
 #endif
 
@@ -22,6 +22,15 @@ extern const lv_obj_class_t lv_rlottie_class;
 /**********************
  *      TYPEDEFS
  **********************/
+typedef struct
+{
+    uint32_t rendered;          /* frames rendered, by worker thread if enabled */
+    uint32_t shown;
+    uint32_t dropped;           /* frame period passed with no new frame ready */
+    uint32_t render_ms_last;    /* render and format conversion time */
+    uint32_t render_ms_avg;
+    uint32_t render_ms_max;
+} lv_rlottie_stats_t;
 
 /**********************
  * GLOBAL PROTOTYPES
@@ -35,6 +44,9 @@ int lv_rlottie_raw(lv_obj_t *lottie, const char *rlottie_desc);
 
 int lv_rlottie_play(lv_obj_t *lottie, int enable);
 
+/* Counters since the animation was loaded */
+int lv_rlottie_get_stats(lv_obj_t *lottie, lv_rlottie_stats_t *stats);
+
 /**********************
  *      MACROS
  **********************/
@@ -0,0 +1,310 @@
+/**
+  ******************************************************************************
+  * @file   lvsf_draw_sched.c
+  * @author Sifli software development team
+  * @brief  Split large software draw tasks to tiles for parallel SW draw units.
+  ******************************************************************************
+*/
+/**
+ * @attention
+ * Copyright (c) 2019 - 2022,  Sifli Technology
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Sifli integrated circuit
+ *    in a product or a software update for such product, must reproduce the above
+ *    copyright notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Sifli nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Sifli integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY SIFLI TECHNOLOGY "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL SIFLI TECHNOLOGY OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+/*
+ * LVGL runs one thread per SW draw unit (LV_DRAW_SW_DRAW_UNIT_CNT) and lets
+ * them take independent draw tasks, but a single big task, e.g. a screen
+ * sized gradient or a rotated image, still keeps only one thread busy while
+ * the others wait for it as everything above depends on it.
+ *
+ * The scheduler is a draw unit without dispatching. It sits between the GPU
+ * units and the SW units in the unit list, so when it evaluates a task the
+ * GPU units (EPIC) have already claimed the tasks they can do. A task left
+ * to SW is cut to horizontal bands by its estimated cost, the number of
+ * bands is limited by the number of SW units. Each band is a copy of the task
+ * with clip_area and _real_area limited to the band, and is queued right
+ * after the original one. The bands don't overlap so SW units draw them in
+ * parallel, while later tasks overlapping a band still wait for it through
+ * the usual _real_area dependency check.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "lvsf_draw_sched.h"
+
+#if LV_USE_DRAW_SW_TILE
+
+#include "lv_draw_private.h"
+#include "lv_draw_image_private.h"
+#include "lv_draw_rect_private.h"
+#include "lv_draw_arc.h"
+#include "lv_area_private.h"
+#include "rtthread.h"
+#include <string.h>
+
+#if LV_DRAW_SW_DRAW_UNIT_CNT < 2
+    #error "LV_USE_DRAW_SW_TILE needs LV_DRAW_SW_DRAW_UNIT_CNT > 1"
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+
+#define DRAW_UNIT_ID_SW     1   /*Same as lv_draw_sw.c*/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+
+static int32_t dispatch(lv_draw_unit_t *draw_unit, lv_layer_t *layer);
+static int32_t evaluate(lv_draw_unit_t *draw_unit, lv_draw_task_t *t);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+static lvsf_draw_sched_stat_t sched_stat;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void lvsf_draw_sched_init(void)
+{
+    lv_draw_unit_t *draw_unit = lv_draw_create_unit(sizeof(lv_draw_unit_t));
+    draw_unit->dispatch_cb = dispatch;
+    draw_unit->evaluate_cb = evaluate;
+}
+
+const lvsf_draw_sched_stat_t *lvsf_draw_sched_get_stat(void)
+{
+    return &sched_stat;
+}
+
+void lvsf_draw_sched_reset_stat(void)
+{
+    lv_memzero(&sched_stat, sizeof(sched_stat));
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Relative cost of one pixel and the descriptor size of a task,
+ * weight is 0 if the task can't be split.
+ */
+static uint32_t task_weight(const lv_draw_task_t *t, size_t *dsc_size)
+{
+    switch (t->type)
+    {
+    case LV_DRAW_TASK_TYPE_FILL:
+    {
+        const lv_draw_fill_dsc_t *dsc = t->draw_dsc;
+        uint32_t weight = 1;
+
+        if (dsc->radius)
+            weight++;
+        if (dsc->grad.dir != LV_GRAD_DIR_NONE)
+            weight++;
+
+        *dsc_size = sizeof(lv_draw_fill_dsc_t);
+        return weight;
+    }
+    case LV_DRAW_TASK_TYPE_ARC:
+        *dsc_size = sizeof(lv_draw_arc_dsc_t);
+        return 3;
+
+    case LV_DRAW_TASK_TYPE_IMAGE:
+    {
+        const lv_draw_image_dsc_t *dsc = t->draw_dsc;
+
+        /*Rejected by SW unit*/
+        if (dsc->skew_x || dsc->skew_y || dsc->bitmap_mask_src)
+            return 0;
+
+        /*Every tile opens the image again, only split images which need no decoding*/
+        if (lv_image_src_get_type(dsc->src) != LV_IMAGE_SRC_VARIABLE)
+            return 0;
+        if (dsc->header.flags & LV_IMAGE_FLAGS_COMPRESSED)
+            return 0;
+#ifdef LV_IMAGE_FLAGS_EZIP
+        if (dsc->header.flags & LV_IMAGE_FLAGS_EZIP)
+            return 0;
+#endif
+
+        *dsc_size = sizeof(lv_draw_image_dsc_t);
+        if (dsc->rotation || dsc->scale_x != LV_SCALE_NONE || dsc->scale_y != LV_SCALE_NONE)
+            return 4;
+        return 1;
+    }
+    /*
+     * LAYER frees its source layer when ready and LABEL may own its text,
+     * the cost of BORDER and BOX_SHADOW is at the edges and the shadow blur
+     * would be computed again for every tile.
+     */
+    default:
+        return 0;
+    }
+}
+
+static int32_t dispatch(lv_draw_unit_t *draw_unit, lv_layer_t *layer)
+{
+    LV_UNUSED(draw_unit);
+    LV_UNUSED(layer);
+
+    /*Tiles are drawn by the SW units*/
+    return LV_DRAW_UNIT_IDLE;
+}
+
+static int32_t evaluate(lv_draw_unit_t *draw_unit, lv_draw_task_t *t)
+{
+    size_t dsc_size = 0;
+    lv_area_t draw_area;
+
+    /*Already taken by a GPU unit*/
+    if ((t->preferred_draw_unit_id != LV_DRAW_UNIT_NONE) && (t->preferred_draw_unit_id != DRAW_UNIT_ID_SW))
+        return 0;
+
+    uint32_t weight = task_weight(t, &dsc_size);
+    if (0 == weight)
+        return 0;
+
+    if (!lv_area_intersect(&draw_area, &t->_real_area, &t->clip_area))
+        return 0;
+
+    uint64_t cost = (uint64_t)lv_area_get_size(&draw_area) * weight;
+    sched_stat.tasks++;
+    sched_stat.cost += cost;
+
+    int32_t h = lv_area_get_height(&draw_area);
+    uint32_t n = (uint32_t)(cost / LV_DRAW_SW_TILE_MIN_COST);
+    if (n > LV_DRAW_SW_DRAW_UNIT_CNT)
+        n = LV_DRAW_SW_DRAW_UNIT_CNT;
+    if (n > (uint32_t)(h / LV_DRAW_SW_TILE_MIN_HEIGHT))
+        n = h / LV_DRAW_SW_TILE_MIN_HEIGHT;
+    if (n < 2)
+        return 0;
+
+    sched_stat.split_tasks++;
+    sched_stat.split_cost += cost;
+
+    /*Equal cost per row is assumed, so equal height bands get equal cost*/
+    lv_draw_task_t *last = t;
+    for (uint32_t i = 1; i < n; i++)
+    {
+        int32_t y1 = draw_area.y1 + (int32_t)(h * i / n);
+        int32_t y2 = draw_area.y1 + (int32_t)(h * (i + 1) / n) - 1;
+
+        lv_draw_task_t *tile = lv_malloc(sizeof(lv_draw_task_t));
+        void *dsc = lv_malloc(dsc_size);
+        if ((NULL == tile) || (NULL == dsc))
+        {
+            if (tile)
+                lv_free(tile);
+            if (dsc)
+                lv_free(dsc);
+
+            /*Let the last tile cover the rest*/
+            last->clip_area.y2 = draw_area.y2;
+            last->_real_area.y2 = draw_area.y2;
+            sched_stat.alloc_fail += n - i;
+            break;
+        }
+
+        lv_memcpy(tile, t, sizeof(lv_draw_task_t));
+        lv_memcpy(dsc, t->draw_dsc, dsc_size);
+        tile->draw_dsc = dsc;
+        tile->clip_area.y1 = y1;
+        tile->clip_area.y2 = y2;
+        tile->_real_area.y1 = y1;
+        tile->_real_area.y2 = y2;
+
+        /*The original task becomes the first band*/
+        if (last == t)
+        {
+            t->clip_area.y1 = draw_area.y1;
+            t->clip_area.y2 = y1 - 1;
+            t->_real_area.y1 = draw_area.y1;
+            t->_real_area.y2 = y1 - 1;
+        }
+
+        tile->next = last->next;
+        last->next = tile;
+        last = tile;
+        sched_stat.tiles++;
+
+        /*Units after the scheduler haven't seen the task yet, let them evaluate the tile*/
+        lv_draw_unit_t *u = draw_unit->next;
+        while (u)
+        {
+            if (u->evaluate_cb)
+                u->evaluate_cb(u, tile);
+            u = u->next;
+        }
+    }
+    sched_stat.tiles++;
+
+    return 0;
+}
+
+#ifdef RT_USING_FINSH
+static rt_err_t draw_sched(int argc, char **argv)
+{
+    if ((argc > 1) && (0 == strcmp(argv[1], "reset")))
+    {
+        lvsf_draw_sched_reset_stat();
+        return RT_EOK;
+    }
+
+    rt_kprintf("sw units %d, min cost %d\n", LV_DRAW_SW_DRAW_UNIT_CNT, LV_DRAW_SW_TILE_MIN_COST);
+    rt_kprintf("tasks %d, split %d, tiles %d, alloc_fail %d\n", sched_stat.tasks, sched_stat.split_tasks,
+               sched_stat.tiles, sched_stat.alloc_fail);
+    rt_kprintf("cost %dK, split cost %dK\n", (uint32_t)(sched_stat.cost / 1000),
+               (uint32_t)(sched_stat.split_cost / 1000));
+    return RT_EOK;
+}
+MSH_CMD_EXPORT(draw_sched, SW draw tile scheduler statistics: draw_sched [reset]);
+#endif /* RT_USING_FINSH */
+
+#endif /*LV_USE_DRAW_SW_TILE*/
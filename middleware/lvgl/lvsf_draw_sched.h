@@ -0,0 +1,112 @@
+/**
+  ******************************************************************************
+  * @file   lvsf_draw_sched.h
+  * @author Sifli software development team
+  * @brief  Split large software draw tasks to tiles for parallel SW draw units.
+  ******************************************************************************
+*/
+/**
+ * @attention
+ * Copyright (c) 2019 - 2022,  Sifli Technology
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Sifli integrated circuit
+ *    in a product or a software update for such product, must reproduce the above
+ *    copyright notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Sifli nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Sifli integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY SIFLI TECHNOLOGY "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL SIFLI TECHNOLOGY OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#ifndef LVSF_DRAW_SCHED_H
+#define LVSF_DRAW_SCHED_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "lv_conf_internal.h"
+
+#if LV_USE_DRAW_SW_TILE
+
+#include <stdint.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+
+#ifndef LV_DRAW_SW_TILE_MIN_COST
+    #define LV_DRAW_SW_TILE_MIN_COST    16384
+#endif
+
+/*Bands thinner than this are not worth a thread switch*/
+#define LV_DRAW_SW_TILE_MIN_HEIGHT      8
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/** Tile scheduler accounting, counted since init or the last reset */
+typedef struct
+{
+    uint32_t tasks;         /*Splittable tasks seen, EPIC tasks are not counted*/
+    uint32_t split_tasks;   /*Tasks split to tiles*/
+    uint32_t tiles;         /*Tiles queued for the split tasks, including the original task*/
+    uint32_t alloc_fail;    /*Tiles dropped as no memory, the previous tile covers them*/
+    uint64_t cost;          /*Estimated cost of all tasks seen*/
+    uint64_t split_cost;    /*Estimated cost of the split tasks*/
+} lvsf_draw_sched_stat_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Create the tile scheduler unit. Must be called after the SW draw units are
+ * created and before any GPU unit, so GPU units evaluate a task first and the
+ * SW units evaluate the tiles.
+ */
+void lvsf_draw_sched_init(void);
+
+const lvsf_draw_sched_stat_t *lvsf_draw_sched_get_stat(void);
+
+void lvsf_draw_sched_reset_stat(void);
+
+#endif /*LV_USE_DRAW_SW_TILE*/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LVSF_DRAW_SCHED_H*/
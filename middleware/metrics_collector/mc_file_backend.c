@@ -56,7 +56,11 @@
 
 void *mc_backend_init(const char *name, uint32_t max_size)
 {
+#ifdef MC_BACKEND_FILE_USING_LZ4
+    return file_logger_init_ex(name, max_size, FL_FLAG_LZ4);
+#else
     return file_logger_init(name, max_size);
+#endif
 }
 
 mc_err_t mc_backend_write(void *db, void *data, uint32_t data_len)
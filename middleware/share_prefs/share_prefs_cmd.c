@@ -6,6 +6,75 @@
 
 
 static share_prefs_t *pref;
+
+static void share_prefs_bench_report(const char *name, rt_tick_t tick, int ops)
+{
+    uint32_t us = (rt_tick_get() - tick) * (1000000 / RT_TICK_PER_SECOND);
+
+    rt_kprintf("%-10s %6d ops %8d us %6d us/op\n", name, ops, us, ops ? (us / ops) : 0);
+}
+
+static rt_err_t share_prefs_bench(share_prefs_t *prfs, int count)
+{
+    char key[16];
+    rt_tick_t tick;
+    rt_err_t res;
+    int i;
+
+    res = RT_EOK;
+    tick = rt_tick_get();
+    for (i = 0; (i < count) && (RT_EOK == res); i++)
+    {
+        rt_snprintf(key, sizeof(key), "bench%d", i);
+        res = share_prefs_set_int(prfs, key, i);
+    }
+    share_prefs_bench_report("set", tick, count);
+
+    tick = rt_tick_get();
+    if (RT_EOK == res)
+    {
+        res = share_prefs_begin(prfs);
+    }
+    if (RT_EOK == res)
+    {
+        for (i = 0; (i < count) && (RT_EOK == res); i++)
+        {
+            rt_snprintf(key, sizeof(key), "bench%d", i);
+            res = share_prefs_set_int(prfs, key, i + 1);
+        }
+        if (RT_EOK == res)
+        {
+            res = share_prefs_commit(prfs);
+        }
+        if (RT_EOK != res)
+        {
+            share_prefs_rollback(prfs);
+        }
+    }
+    share_prefs_bench_report("txn set", tick, count);
+
+    tick = rt_tick_get();
+    for (i = 0; (i < count * 10) && (RT_EOK == res); i++)
+    {
+        rt_snprintf(key, sizeof(key), "bench%d", i % count);
+        if (share_prefs_get_int(prfs, key, -1) != ((i % count) + 1))
+        {
+            res = RT_ERROR;
+        }
+    }
+    share_prefs_bench_report("get", tick, count * 10);
+
+    share_prefs_begin(prfs);
+    for (i = 0; i < count; i++)
+    {
+        rt_snprintf(key, sizeof(key), "bench%d", i);
+        share_prefs_remove(prfs, key);
+    }
+    share_prefs_commit(prfs);
+
+    return res;
+}
+
 static rt_err_t share_prefs(int argc, char **argv)
 {
     char cmd_buf[32];
@@ -23,6 +92,7 @@ static rt_err_t share_prefs(int argc, char **argv)
         rt_kprintf("\t-ri <key>\n");
         rt_kprintf("\t-ws <key> <string value>\n");
         rt_kprintf("\t-rs <key>\n");
+        rt_kprintf("\t-bench [count]\n");
         return -RT_ERROR;
     }
 
@@ -74,6 +144,10 @@ static rt_err_t share_prefs(int argc, char **argv)
         int32_t v = atoi(argv[3]);
         res = share_prefs_set_int(pref, argv[2], v);
     }
+    else if (strcmp(argv[1], "-bench") == 0)
+    {
+        res = share_prefs_bench(pref, (argc > 2) ? atoi(argv[2]) : 32);
+    }
 
     if (res != RT_EOK)
         rt_kprintf("ERROR %d\n", res);
@@ -177,5 +177,19 @@ rt_err_t share_prefs_set_block(share_prefs_t *prfs, const char *key, const void
     return (EF_NO_ERR == ef_err) ? RT_EOK : ef_err;
 
 }
+
+//transaction, values are written immediately
+rt_err_t share_prefs_begin(share_prefs_t *prfs)
+{
+    return RT_EOK;
+}
+rt_err_t share_prefs_commit(share_prefs_t *prfs)
+{
+    return RT_EOK;
+}
+rt_err_t share_prefs_rollback(share_prefs_t *prfs)
+{
+    return RT_ENOSYS; //NOT support yet
+}
 #endif
 
@@ -13,13 +13,73 @@
 #ifdef PKG_USING_FLASHDB
 #include "flashdb.h"
 
+/** buffer size of kvdb key, kvdb key is "prfs_nm.key" */
+#define SHARE_PREFS_KVDB_KEY_LEN      (FDB_KV_NAME_MAX + 1)
+
+#ifndef SHARE_PREFS_TXN_BUF_SIZE
+    #define SHARE_PREFS_TXN_BUF_SIZE  (512)
+#endif
+
+/** kv number written by one fdb_kv_set_batch */
+#define SHARE_PREFS_TXN_BATCH_NUM     (16)
+
+/** item is removed */
+#define SHARE_PREFS_TXN_FLAG_REMOVED      (1 << 0)
+/** item is overwritten by a later item of the same transaction */
+#define SHARE_PREFS_TXN_FLAG_OVERWRITTEN  (1 << 1)
+
+#ifndef SHARE_PREFS_CACHE_NUM
+    #define SHARE_PREFS_CACHE_NUM     (0)
+#endif
+
+#define SHARE_PREFS_CACHE_KEY_LEN     (32)
+#define SHARE_PREFS_CACHE_VALUE_LEN   (16)
+
+/** Pending item of transaction, followed by kvdb key and value, 4 bytes aligned */
+typedef struct
+{
+    /** kvdb key length including '\0' */
+    uint16_t key_len;
+    /** SHARE_PREFS_TXN_FLAG_XXX */
+    uint16_t flags;
+    /** value length, 0 if removed */
+    uint32_t value_len;
+} share_prefs_txn_item_t;
+
+#define SHARE_PREFS_TXN_ITEM_SIZE(key_len, value_len) \
+    RT_ALIGN(sizeof(share_prefs_txn_item_t) + (key_len) + (value_len), 4)
+#define SHARE_PREFS_TXN_ITEM_KEY(item)    ((char *)((item) + 1))
+#define SHARE_PREFS_TXN_ITEM_VALUE(item)  ((uint8_t *)((item) + 1) + (item)->key_len)
+#define SHARE_PREFS_TXN_NEXT_ITEM(item)   \
+    ((share_prefs_txn_item_t *)((uint8_t *)(item) + SHARE_PREFS_TXN_ITEM_SIZE((item)->key_len, (item)->value_len)))
 
 typedef struct
 {
     share_prefs_t prefs;
     struct fdb_kvdb db;
+    /** pending items of transaction, NULL if not in transaction */
+    uint8_t *txn_buf;
+    uint32_t txn_used;
 } flshdb_share_prefs_t;
 
+#if SHARE_PREFS_CACHE_NUM > 0
+/** Cached value of a kvdb key, shared by all handles as they use the same kvdb */
+typedef struct
+{
+    /** kvdb key, empty if entry is unused */
+    char key[SHARE_PREFS_CACHE_KEY_LEN];
+    uint8_t value[SHARE_PREFS_CACHE_VALUE_LEN];
+    /** value length, 0 if key is not found */
+    uint32_t len;
+    uint32_t last_used;
+} share_prefs_cache_t;
+
+static share_prefs_cache_t share_prefs_cache[SHARE_PREFS_CACHE_NUM];
+static uint32_t share_prefs_cache_clock;
+/** increased by every write, a value read from kvdb is cached only if no write happened meanwhile */
+static uint32_t share_prefs_cache_gen;
+#endif /* SHARE_PREFS_CACHE_NUM > 0 */
+
 share_prefs_t *share_prefs_open(const char *prefs_name, uint32_t mode)
 {
     uint32_t name_len;
@@ -33,9 +93,11 @@ share_prefs_t *share_prefs_open(const char *prefs_name, uint32_t mode)
     if (NULL == p_flshdb_prefs) return NULL;
     p_prefs = &p_flshdb_prefs->prefs;
     p_db    = &p_flshdb_prefs->db;
+    p_flshdb_prefs->txn_buf = NULL;
+    p_flshdb_prefs->txn_used = 0;
 
     name_len = strlen(prefs_name);
-    name_len = MAX((SHARE_PREFS_MAX_NAME_LEN - 1), name_len);
+    name_len = MIN((SHARE_PREFS_MAX_NAME_LEN - 1), name_len);
 
     memcpy(p_prefs->prfs_name, prefs_name, name_len);
     p_prefs->prfs_name[name_len] = '\0';
@@ -75,7 +137,18 @@ rt_err_t share_prefs_close(share_prefs_t *prfs)
     flshdb_share_prefs_t *p_flshdb_prefs = (flshdb_share_prefs_t *) prfs;
 
     if (p_flshdb_prefs != NULL)
+    {
+        /* pending writes are not dropped silently */
+        if (p_flshdb_prefs->txn_buf)
+        {
+            if (RT_EOK != share_prefs_commit(prfs))
+            {
+                rt_kprintf("share_prefs_close: %s commit failed, pending writes lost\n", prfs->prfs_name);
+                rt_free(p_flshdb_prefs->txn_buf);
+            }
+        }
         rt_free(p_flshdb_prefs);
+    }
 
     return RT_EOK;
 }
@@ -86,97 +159,451 @@ rt_err_t share_prefs_clear(share_prefs_t *prfs)
 }
 
 //combine prfs_nm and key to form kvdb_key
-static char *_init_kvdb_key(const char *prfs_nm, const char *key)
+static const char *_init_kvdb_key(char *kvdb_key, const char *prfs_nm, const char *key)
 {
-    char *kvdb_key;
-    uint32_t kvdb_key_len;
+    uint32_t nm_len;
+    uint32_t key_len;
 
-    //combine prfs_nm and key to form kvdb_key
-    kvdb_key_len = strlen(prfs_nm) + 1 + strlen(key);
-    kvdb_key = rt_malloc(kvdb_key_len + 1);
-    if (NULL == kvdb_key) return NULL;
-    sprintf(kvdb_key, "%s.%s", prfs_nm, key);
-    kvdb_key[kvdb_key_len] = '\0';
+    nm_len = strlen(prfs_nm);
+    key_len = strlen(key);
+    if ((nm_len + 1 + key_len) >= SHARE_PREFS_KVDB_KEY_LEN)
+    {
+        /* too long for kvdb */
+        return NULL;
+    }
+    memcpy(kvdb_key, prfs_nm, nm_len);
+    kvdb_key[nm_len] = '.';
+    memcpy(kvdb_key + nm_len + 1, key, key_len + 1);
 
     return kvdb_key;
 }
 
-rt_inline void _deinit_kvdb_key(const char *kvdb_key)
+#if SHARE_PREFS_CACHE_NUM > 0
+static share_prefs_cache_t *_cache_find(const char *kvdb_key)
 {
-    rt_free((void *)kvdb_key);
+    uint32_t i;
+
+    for (i = 0; i < SHARE_PREFS_CACHE_NUM; i++)
+    {
+        if (0 == strcmp(share_prefs_cache[i].key, kvdb_key))
+        {
+            return &share_prefs_cache[i];
+        }
+    }
+
+    return NULL;
 }
 
+static bool _cache_get(const char *kvdb_key, void *buf, size_t buf_len, size_t *read_len, size_t *saved_value_len)
+{
+    share_prefs_cache_t *entry;
+
+    rt_enter_critical();
+    entry = _cache_find(kvdb_key);
+    if (entry)
+    {
+        entry->last_used = ++share_prefs_cache_clock;
+        *saved_value_len = entry->len;
+        *read_len = MIN(buf_len, entry->len);
+        memcpy(buf, entry->value, *read_len);
+    }
+    rt_exit_critical();
+
+    return (NULL != entry);
+}
+
+static uint32_t _cache_gen(void)
+{
+    uint32_t gen;
+
+    rt_enter_critical();
+    gen = share_prefs_cache_gen;
+    rt_exit_critical();
+
+    return gen;
+}
+
+/* value is NULL if the key is not found, gen is got by _cache_gen() before the value is read */
+static void _cache_put(const char *kvdb_key, const void *value, size_t value_len, uint32_t gen)
+{
+    share_prefs_cache_t *entry;
+    uint32_t i;
+
+    if ((strlen(kvdb_key) >= SHARE_PREFS_CACHE_KEY_LEN) || (value_len > SHARE_PREFS_CACHE_VALUE_LEN))
+    {
+        return;
+    }
+
+    rt_enter_critical();
+    if (gen != share_prefs_cache_gen)
+    {
+        /* written after the value is read, it may be stale */
+        rt_exit_critical();
+        return;
+    }
+    entry = _cache_find(kvdb_key);
+    if (!entry)
+    {
+        /* replace the least recently used */
+        entry = &share_prefs_cache[0];
+        for (i = 1; i < SHARE_PREFS_CACHE_NUM; i++)
+        {
+            if (share_prefs_cache[i].last_used < entry->last_used)
+            {
+                entry = &share_prefs_cache[i];
+            }
+        }
+        strcpy(entry->key, kvdb_key);
+    }
+    entry->len = value ? value_len : 0;
+    if (value)
+    {
+        memcpy(entry->value, value, value_len);
+    }
+    entry->last_used = ++share_prefs_cache_clock;
+    rt_exit_critical();
+}
+
+static void _cache_remove(const char *kvdb_key)
+{
+    share_prefs_cache_t *entry;
+
+    rt_enter_critical();
+    share_prefs_cache_gen++;
+    entry = _cache_find(kvdb_key);
+    if (entry)
+    {
+        entry->key[0] = '\0';
+        entry->last_used = 0;
+    }
+    rt_exit_critical();
+}
+
+/* keep cache consistent with value written to kvdb */
+static void _cache_update(const char *kvdb_key, const void *value, size_t value_len)
+{
+    rt_enter_critical();
+    share_prefs_cache_gen++;
+    if (value_len <= SHARE_PREFS_CACHE_VALUE_LEN)
+    {
+        _cache_put(kvdb_key, value, value_len, share_prefs_cache_gen);
+    }
+    else
+    {
+        _cache_remove(kvdb_key);
+    }
+    rt_exit_critical();
+}
+#else
+#define _cache_get(kvdb_key, buf, buf_len, read_len, saved_value_len)  (false)
+#define _cache_gen()                                                   (0)
+#define _cache_put(kvdb_key, value, value_len, gen)                    ((void)(gen))
+#define _cache_remove(kvdb_key)
+#define _cache_update(kvdb_key, value, value_len)
+#endif /* SHARE_PREFS_CACHE_NUM > 0 */
+
+static share_prefs_txn_item_t *_txn_find(flshdb_share_prefs_t *p_flshdb_prefs, const char *kvdb_key)
+{
+    share_prefs_txn_item_t *item;
+    share_prefs_txn_item_t *end;
+
+    item = (share_prefs_txn_item_t *)p_flshdb_prefs->txn_buf;
+    end = (share_prefs_txn_item_t *)(p_flshdb_prefs->txn_buf + p_flshdb_prefs->txn_used);
+    for (; item < end; item = SHARE_PREFS_TXN_NEXT_ITEM(item))
+    {
+        if (!(item->flags & SHARE_PREFS_TXN_FLAG_OVERWRITTEN)
+                && (0 == strcmp(SHARE_PREFS_TXN_ITEM_KEY(item), kvdb_key)))
+        {
+            return item;
+        }
+    }
+
+    return NULL;
+}
+
+static rt_err_t _write_batch(flshdb_share_prefs_t *p_flshdb_prefs, struct fdb_kv_batch *batch, size_t num)
+{
+    fdb_err_t err;
+    size_t i;
+
+    err = fdb_kv_set_batch(&p_flshdb_prefs->db, batch, num);
+    if (FDB_NO_ERR != err)
+    {
+        /* some items may be written already */
+        for (i = 0; i < num; i++)
+        {
+            _cache_remove(batch[i].key);
+        }
+        return err;
+    }
+    for (i = 0; i < num; i++)
+    {
+        _cache_update(batch[i].key, batch[i].value, batch[i].len);
+    }
+
+    return RT_EOK;
+}
+
+/* write all pending items to kvdb, they are kept for retry if failed */
+static rt_err_t _txn_flush(flshdb_share_prefs_t *p_flshdb_prefs)
+{
+    struct fdb_kv_batch batch[SHARE_PREFS_TXN_BATCH_NUM];
+    share_prefs_txn_item_t *item;
+    share_prefs_txn_item_t *end;
+    size_t num;
+    rt_err_t ret_v;
+
+    ret_v = RT_EOK;
+    num = 0;
+    item = (share_prefs_txn_item_t *)p_flshdb_prefs->txn_buf;
+    end = (share_prefs_txn_item_t *)(p_flshdb_prefs->txn_buf + p_flshdb_prefs->txn_used);
+    for (; (item < end) && (RT_EOK == ret_v); item = SHARE_PREFS_TXN_NEXT_ITEM(item))
+    {
+        if (item->flags & SHARE_PREFS_TXN_FLAG_OVERWRITTEN)
+        {
+            continue;
+        }
+        batch[num].key = SHARE_PREFS_TXN_ITEM_KEY(item);
+        batch[num].value = (item->flags & SHARE_PREFS_TXN_FLAG_REMOVED) ? NULL : SHARE_PREFS_TXN_ITEM_VALUE(item);
+        batch[num].len = item->value_len;
+        num++;
+        if (SHARE_PREFS_TXN_BATCH_NUM == num)
+        {
+            ret_v = _write_batch(p_flshdb_prefs, batch, num);
+            num = 0;
+        }
+    }
+    if ((num > 0) && (RT_EOK == ret_v))
+    {
+        ret_v = _write_batch(p_flshdb_prefs, batch, num);
+    }
+    if (RT_EOK == ret_v)
+    {
+        p_flshdb_prefs->txn_used = 0;
+    }
+
+    return ret_v;
+}
+
+/* value is NULL for remove */
+static rt_err_t _txn_add(flshdb_share_prefs_t *p_flshdb_prefs, const char *kvdb_key, const void *value, int32_t value_len)
+{
+    share_prefs_txn_item_t *item;
+    uint32_t key_len;
+    uint32_t item_size;
+    rt_err_t ret_v;
+
+    if (!value)
+    {
+        value_len = 0;
+    }
+    key_len = strlen(kvdb_key) + 1;
+    item_size = SHARE_PREFS_TXN_ITEM_SIZE(key_len, value_len);
+    if (item_size > SHARE_PREFS_TXN_BUF_SIZE)
+    {
+        /* too big to be pending, write it after pending items to keep the order */
+        ret_v = _txn_flush(p_flshdb_prefs);
+        if (RT_EOK == ret_v)
+        {
+            struct fdb_kv_batch batch = {kvdb_key, value, value_len};
+            ret_v = _write_batch(p_flshdb_prefs, &batch, 1);
+        }
+        return ret_v;
+    }
+
+    if ((p_flshdb_prefs->txn_used + item_size) > SHARE_PREFS_TXN_BUF_SIZE)
+    {
+        /* buffer is full, write pending items in advance */
+        ret_v = _txn_flush(p_flshdb_prefs);
+        if (RT_EOK != ret_v)
+        {
+            return ret_v;
+        }
+    }
+
+    item = _txn_find(p_flshdb_prefs, kvdb_key);
+    if (item)
+    {
+        item->flags |= SHARE_PREFS_TXN_FLAG_OVERWRITTEN;
+    }
+
+    item = (share_prefs_txn_item_t *)(p_flshdb_prefs->txn_buf + p_flshdb_prefs->txn_used);
+    item->key_len = key_len;
+    item->flags = value ? 0 : SHARE_PREFS_TXN_FLAG_REMOVED;
+    item->value_len = value_len;
+    memcpy(SHARE_PREFS_TXN_ITEM_KEY(item), kvdb_key, key_len);
+    if (value)
+    {
+        memcpy(SHARE_PREFS_TXN_ITEM_VALUE(item), value, value_len);
+    }
+    p_flshdb_prefs->txn_used += item_size;
+
+    return RT_EOK;
+}
 
 static size_t _get_block(share_prefs_t *prfs, const char *key, void *buf, size_t buf_len, size_t *saved_value_len)
 {
     flshdb_share_prefs_t *p_flshdb_prefs = (flshdb_share_prefs_t *) prfs;
     const char *prfs_nm = prfs->prfs_name;
-    char *kvdb_key;
+    char kvdb_key_buf[SHARE_PREFS_KVDB_KEY_LEN];
+    const char *kvdb_key;
     size_t ret_v;
 
-    kvdb_key = _init_kvdb_key(prfs_nm, key);
+    kvdb_key = _init_kvdb_key(kvdb_key_buf, prfs_nm, key);
     if (NULL == kvdb_key)
     {
-        return -1;
+        *saved_value_len = 0;
+        return 0;
     }
-    else
+
+    if (p_flshdb_prefs->txn_buf)
+    {
+        share_prefs_txn_item_t *item;
+
+        /* read pending value of transaction */
+        item = _txn_find(p_flshdb_prefs, kvdb_key);
+        if (item)
+        {
+            *saved_value_len = item->value_len;
+            ret_v = MIN(buf_len, *saved_value_len);
+            memcpy(buf, SHARE_PREFS_TXN_ITEM_VALUE(item), ret_v);
+            return ret_v;
+        }
+    }
+
+    if (_cache_get(kvdb_key, buf, buf_len, &ret_v, saved_value_len))
+    {
+        return ret_v;
+    }
+
     {
         struct fdb_blob blob;
+        uint32_t gen = _cache_gen();
+
         ret_v = fdb_kv_get_blob(&p_flshdb_prefs->db, kvdb_key, fdb_blob_make(&blob, buf, buf_len));
         *saved_value_len = blob.saved.len;
-        _deinit_kvdb_key(kvdb_key);
+        if (0 == blob.saved.len)
+        {
+            /* remember missing key as well */
+            _cache_put(kvdb_key, NULL, 0, gen);
+        }
+        else if (ret_v == blob.saved.len)
+        {
+            _cache_put(kvdb_key, buf, ret_v, gen);
+        }
         return ret_v;
     }
 }
 
+/* value is NULL for remove */
 static rt_err_t _set_block(share_prefs_t *prfs, const char *key, const void *value, int32_t value_len)
 {
     flshdb_share_prefs_t *p_flshdb_prefs = (flshdb_share_prefs_t *) prfs;
     const char *prfs_nm = prfs->prfs_name;
-
-    char *kvdb_key;
+    char kvdb_key_buf[SHARE_PREFS_KVDB_KEY_LEN];
+    const char *kvdb_key;
     rt_err_t ret_v;
+    fdb_err_t err;
 
-    kvdb_key = _init_kvdb_key(prfs_nm, key);
+    kvdb_key = _init_kvdb_key(kvdb_key_buf, prfs_nm, key);
     if (NULL == kvdb_key)
     {
-        return RT_ENOMEM;
+        return RT_EINVAL;
     }
-    else
+
+    if (p_flshdb_prefs->txn_buf)
     {
+        return _txn_add(p_flshdb_prefs, kvdb_key, value, value_len);
+    }
 
+    if (value)
+    {
         struct fdb_blob  blob;
-        fdb_err_t err;
         err = fdb_kv_set_blob(&p_flshdb_prefs->db, kvdb_key, fdb_blob_make(&blob, value, value_len));
-        ret_v = (err == FDB_NO_ERR) ? RT_EOK : err;
-        _deinit_kvdb_key(kvdb_key);
-        return ret_v;
     }
+    else
+    {
+        err = fdb_kv_del(&p_flshdb_prefs->db, kvdb_key);
+    }
+    ret_v = (err == FDB_NO_ERR) ? RT_EOK : err;
+    if (RT_EOK == ret_v)
+    {
+        _cache_update(kvdb_key, value, value ? value_len : 0);
+    }
+    else
+    {
+        _cache_remove(kvdb_key);
+    }
+
+    return ret_v;
 }
 
 
-//anytype
-rt_err_t share_prefs_remove(share_prefs_t *prfs, const char *key)
+//transaction
+rt_err_t share_prefs_begin(share_prefs_t *prfs)
 {
     flshdb_share_prefs_t *p_flshdb_prefs = (flshdb_share_prefs_t *) prfs;
 
-    char *kvdb_key;
-    rt_err_t ret_v;
+    if (NULL == p_flshdb_prefs)
+    {
+        return RT_EINVAL;
+    }
+    if (p_flshdb_prefs->txn_buf)
+    {
+        return RT_EBUSY;
+    }
 
-    kvdb_key = _init_kvdb_key(prfs->prfs_name, key);
-    if (NULL == kvdb_key)
+    p_flshdb_prefs->txn_buf = rt_malloc(SHARE_PREFS_TXN_BUF_SIZE);
+    if (NULL == p_flshdb_prefs->txn_buf)
     {
         return RT_ENOMEM;
     }
-    else
+    p_flshdb_prefs->txn_used = 0;
+
+    return RT_EOK;
+}
+
+rt_err_t share_prefs_commit(share_prefs_t *prfs)
+{
+    flshdb_share_prefs_t *p_flshdb_prefs = (flshdb_share_prefs_t *) prfs;
+    rt_err_t ret_v;
+
+    if ((NULL == p_flshdb_prefs) || (NULL == p_flshdb_prefs->txn_buf))
     {
-        fdb_err_t err;
+        return RT_EINVAL;
+    }
 
-        err = fdb_kv_del(&p_flshdb_prefs->db, kvdb_key);
-        ret_v = (err == FDB_NO_ERR) ? RT_EOK : err;
-        _deinit_kvdb_key(kvdb_key);
-        return ret_v;
+    ret_v = _txn_flush(p_flshdb_prefs);
+    if (RT_EOK == ret_v)
+    {
+        rt_free(p_flshdb_prefs->txn_buf);
+        p_flshdb_prefs->txn_buf = NULL;
     }
+
+    return ret_v;
+}
+
+rt_err_t share_prefs_rollback(share_prefs_t *prfs)
+{
+    flshdb_share_prefs_t *p_flshdb_prefs = (flshdb_share_prefs_t *) prfs;
+
+    if ((NULL == p_flshdb_prefs) || (NULL == p_flshdb_prefs->txn_buf))
+    {
+        return RT_EINVAL;
+    }
+
+    rt_free(p_flshdb_prefs->txn_buf);
+    p_flshdb_prefs->txn_buf = NULL;
+    p_flshdb_prefs->txn_used = 0;
+
+    return RT_EOK;
+}
+
+
+//anytype
+rt_err_t share_prefs_remove(share_prefs_t *prfs, const char *key)
+{
+    return _set_block(prfs, key, NULL, 0);
 }
 
 
@@ -227,4 +654,3 @@ rt_err_t share_prefs_set_block(share_prefs_t *prfs, const char *key, const void
     return _set_block(prfs, key, buf, buf_len);
 }
 #endif
-
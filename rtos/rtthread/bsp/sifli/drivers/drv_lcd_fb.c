@@ -71,6 +71,28 @@
 
 #define FB_COPY_EXP_MS   (1000)
 #define FB_FLUSH_EXP_MS   (5000)
+
+/*
+    Dirty rects of one frame. Written areas are merged when the merged rect wastes
+    less than the cost of one more LCD transfer, so a second hand and a few digits
+    far away from each other are sent as separated small windows instead of one
+    large bounding window.
+*/
+#ifndef LCD_FB_DIRTY_RECT_NUM
+    #if defined(BSP_USING_RAMLESS_LCD) || defined(BSP_LCDC_USING_DPI)
+        #define LCD_FB_DIRTY_RECT_NUM       1   /*Panel is refreshed from FB as a whole*/
+    #else
+        #define LCD_FB_DIRTY_RECT_NUM       4
+    #endif
+#endif /* LCD_FB_DIRTY_RECT_NUM */
+/*Cost of one more LCD transfer(command and window setting) in pixels*/
+#ifndef LCD_FB_RECT_OVERHEAD_PIXELS
+    #define LCD_FB_RECT_OVERHEAD_PIXELS     (1024)
+#endif
+/*Flush the bounding window if dirty rects cover more than this percent of it*/
+#ifndef LCD_FB_FULL_REFRESH_PERCENT
+    #define LCD_FB_FULL_REFRESH_PERCENT     (70)
+#endif
 #define AreaString "x0y0x1y1=[%d,%d,%d,%d]"
 #define AreaParams(area) (area)->x0,(area)->y0,(area)->x1,(area)->y1
 #ifdef ENABLE_GP_DMA_COPY
@@ -101,7 +123,14 @@ typedef struct
     struct rt_device_graphic_info lcd_info;
 
     lcd_fb_desc_t  fb;     /*Framebuffer description*/
-    LCD_AreaDef window;    /*LCD recieve area, origin is LCD's TL*/
+    LCD_AreaDef window;    /*LCD recieve area, origin is LCD's TL. Bounding box of 'dirty'*/
+
+    LCD_AreaDef dirty[LCD_FB_DIRTY_RECT_NUM]; /*Written areas not sent yet, origin is LCD's TL*/
+    uint8_t dirty_num;
+
+    LCD_AreaDef flush[LCD_FB_DIRTY_RECT_NUM]; /*Windows of the flushing frame, sorted by y0*/
+    uint8_t flush_num;
+    uint8_t flush_idx;     /*Next window to flush*/
 
     uint8_t  flushing_lcd;
 
@@ -109,6 +138,8 @@ typedef struct
     int32_t scheme6_valid_y1;
     //Set windows's y0
     int32_t scheme6_y0;
+    //Lines after it belong to windows not flushed yet
+    int32_t scheme6_limit_y1;
 
 
     struct rt_event  event;
@@ -143,6 +174,14 @@ typedef struct
 
     uint8_t dma_faster_than_lcdc;
 
+    /*Bytes of pixels sent to LCD*/
+    uint32_t stat_frames;
+    uint32_t stat_partial_frames;  /*Frames sent as several windows*/
+    uint32_t stat_rects;
+    uint64_t stat_bytes;
+    uint64_t stat_window_bytes;    /*Bytes if the bounding window was sent*/
+    uint32_t stat_last_bytes;
+
 #ifdef ENABLE_GP_DMA_COPY
     DMA_HandleTypeDef testdma;
     uint32_t src;
@@ -192,6 +231,28 @@ static bool is_area_valid(const LCD_AreaDef *a0_p)
     return ((a0_p->x0 <= a0_p->x1) && (a0_p->y0 <= a0_p->y1));
 }
 
+static void area_join(LCD_AreaDef *res_p, const LCD_AreaDef *a0_p, const LCD_AreaDef *a1_p)
+{
+    res_p->x0 = HAL_MIN(a0_p->x0, a1_p->x0);
+    res_p->y0 = HAL_MIN(a0_p->y0, a1_p->y0);
+    res_p->x1 = HAL_MAX(a0_p->x1, a1_p->x1);
+    res_p->y1 = HAL_MAX(a0_p->y1, a1_p->y1);
+}
+
+static int32_t area_size(const LCD_AreaDef *a0_p)
+{
+    return (a0_p->x1 - a0_p->x0 + 1) * (a0_p->y1 - a0_p->y0 + 1);
+}
+
+/*Pixels merging 'a1_p' into 'a0_p' would send more*/
+static int32_t area_join_waste(const LCD_AreaDef *a0_p, const LCD_AreaDef *a1_p)
+{
+    LCD_AreaDef join;
+
+    area_join(&join, a0_p, a1_p);
+    return area_size(&join) - area_size(a0_p) - area_size(a1_p);
+}
+
 static void LCD_area_to_EPIC_area(const LCD_AreaDef *lcd_a, EPIC_AreaTypeDef *epic_a)
 {
     epic_a->x0 = (int16_t)lcd_a->x0;
@@ -262,7 +323,7 @@ void HAL_LCDC_SendLineCpltCbk(LCDC_HandleTypeDef *lcdc, uint32_t line)
     {
         RT_ASSERT(drv_lcd_fb.scheme6_y0 != INT32_MIN);
         LOG_D("SendLineCpltCbk %d \r\n", drv_lcd_fb.scheme6_y0 + line);
-        set_valid_y(drv_lcd_fb.scheme6_y0 + line);
+        set_valid_y(MIN(drv_lcd_fb.scheme6_y0 + line, drv_lcd_fb.scheme6_limit_y1));
     }
 
 }
@@ -288,6 +349,8 @@ static void SystemView_mark_stop(uint32_t id)
 }
 #endif
 
+static rt_err_t fb_flush_next(void);
+
 static rt_err_t fb_flush_done(rt_device_t dev, void *buffer)
 {
     rt_err_t err;
@@ -301,8 +364,15 @@ static rt_err_t fb_flush_done(rt_device_t dev, void *buffer)
 
     if (drv_lcd_fb.fb.p_data == buffer)
     {
+        if (drv_lcd_fb.flush_idx < drv_lcd_fb.flush_num)
+        {
+            //More windows of this frame
+            return fb_flush_next();
+        }
+
         drv_lcd_fb.flushing_lcd = 0;
         drv_lcd_fb.scheme6_y0 = INT32_MIN;
+        drv_lcd_fb.scheme6_limit_y1 = drv_lcd_fb.fb.area.y1;
         set_valid_y(drv_lcd_fb.fb.area.y1);
     }
     err = rt_event_send(&drv_lcd_fb.event, EVENT_FLUSH_FB_DONE);
@@ -310,21 +380,44 @@ static rt_err_t fb_flush_done(rt_device_t dev, void *buffer)
     return err;
 }
 
-static rt_err_t fb_flush_start(void)
+/**
+ * @brief Flush next window in 'flush', complete the frame if no window left.
+ */
+static rt_err_t fb_flush_next(void)
 {
-    rt_err_t err;
+    rt_err_t err = RT_EOK;
     rt_device_t p_lcd_dev = drv_lcd_fb.p_lcd_dev;
-    LCD_AreaDef *p_win_area = &drv_lcd_fb.window;
     LCD_AreaDef *p_fb_area = &drv_lcd_fb.fb.area;
     LCD_AreaDef common_area;/*Relative area of FB will be flushed*/
 
-
-    if (area_intersect(&common_area, p_win_area, p_fb_area))
+    while (drv_lcd_fb.flush_idx < drv_lcd_fb.flush_num)
     {
+        LCD_AreaDef *p_win_area = &drv_lcd_fb.flush[drv_lcd_fb.flush_idx++];
+
+        if (!area_intersect(&common_area, p_win_area, p_fb_area))
+        {
+            LOG_D("NoIntersect window:"AreaString" fb:"AreaString" p_data=%p",
+                  AreaParams(p_win_area), AreaParams(p_fb_area), drv_lcd_fb.fb.p_data);
+            continue;
+        }
+
         lcd_flush_info_t flush_info;
+
+        //Lines of the following windows are not sent yet
+        if (drv_lcd_fb.flush_idx < drv_lcd_fb.flush_num)
+            drv_lcd_fb.scheme6_limit_y1 = drv_lcd_fb.flush[drv_lcd_fb.flush_idx].y0 - p_fb_area->y0 - 1;
+        else
+            drv_lcd_fb.scheme6_limit_y1 = p_fb_area->y1;
+
         set_valid_y(common_area.y0 - p_fb_area->y0 - 1);
         drv_lcd_fb.scheme6_y0 = common_area.y0 - p_fb_area->y0;
 
+        //Only the first window of a frame waits TE
+        if (drv_lcd_fb.flushing_lcd)
+        {
+            uint8_t te_on = 0;
+            rt_device_control(p_lcd_dev, RTGRAPHIC_CTRL_SET_NEXT_TE, &te_on);
+        }
 
         drv_lcd_fb.flushing_lcd = 1;
         drv_lcd_fb.flush_start_tick = rt_tick_get();
@@ -336,7 +429,7 @@ static rt_err_t fb_flush_start(void)
         flush_info.cmpr_rate = drv_lcd_fb.fb.cmpr_rate;
         flush_info.pixel      = drv_lcd_fb.fb.p_data;
         flush_info.color_format    = drv_lcd_fb.fb.format;
-        memcpy(&flush_info.window, &drv_lcd_fb.window, sizeof(flush_info.window));
+        memcpy(&flush_info.window, p_win_area, sizeof(flush_info.window));
         memcpy(&flush_info.pixel_area, &drv_lcd_fb.fb.area, sizeof(flush_info.pixel_area));
 
 #ifdef PKG_USING_SYSTEMVIEW
@@ -350,19 +443,125 @@ static rt_err_t fb_flush_start(void)
 
         if (RT_EOK != err)  LOG_E("fb_flush_start err=%d", err);
 
+        return err;
+    }
+
+    //Nothing left to flush
+    return fb_flush_done(drv_lcd_fb.p_lcd_dev, drv_lcd_fb.fb.p_data);
+}
+
+static rt_err_t fb_flush_start(void)
+{
+    LCD_AreaDef *p_win_area = &drv_lcd_fb.window;
+    LCD_AreaDef common_area;
+    int32_t dirty_pixels = 0;
+    uint32_t bytes_per_pixel = (RTGRAPHIC_PIXEL_FORMAT_RGB565 == drv_lcd_fb.fb.format) ? 2 : 3;
+    uint32_t i, j;
+
+    for (i = 0; i < drv_lcd_fb.dirty_num; i++)
+        dirty_pixels += area_size(&drv_lcd_fb.dirty[i]);
+
+    /*
+        Send the bounding window if the dirty rects are close to it,
+        or one transfer of the bounding window costs less.
+    */
+    if ((drv_lcd_fb.dirty_num <= 1)
+            || (dirty_pixels * 100 >= area_size(p_win_area) * LCD_FB_FULL_REFRESH_PERCENT)
+            || (dirty_pixels + (drv_lcd_fb.dirty_num - 1) * LCD_FB_RECT_OVERHEAD_PIXELS >= area_size(p_win_area)))
+    {
+        memcpy(&drv_lcd_fb.flush[0], p_win_area, sizeof(LCD_AreaDef));
+        drv_lcd_fb.flush_num = 1;
     }
     else
     {
-        LOG_D("NoIntersect window:"AreaString" fb:"AreaString" p_data=%p",
-              AreaParams(p_fb_area), AreaParams(p_win_area), drv_lcd_fb.fb.p_data);
-        fb_flush_done(drv_lcd_fb.p_lcd_dev, drv_lcd_fb.fb.p_data);
+        //Sort by y0, so the lines before current window are writable
+        for (i = 0; i < drv_lcd_fb.dirty_num; i++)
+        {
+            for (j = i; (j > 0) && (drv_lcd_fb.flush[j - 1].y0 > drv_lcd_fb.dirty[i].y0); j--)
+                drv_lcd_fb.flush[j] = drv_lcd_fb.flush[j - 1];
+            drv_lcd_fb.flush[j] = drv_lcd_fb.dirty[i];
+        }
+        drv_lcd_fb.flush_num = drv_lcd_fb.dirty_num;
+        drv_lcd_fb.stat_partial_frames++;
     }
+    drv_lcd_fb.flush_idx = 0;
 
+    drv_lcd_fb.stat_last_bytes = 0;
+    for (i = 0; i < drv_lcd_fb.flush_num; i++)
+    {
+        if (area_intersect(&common_area, &drv_lcd_fb.flush[i], &drv_lcd_fb.fb.area))
+            drv_lcd_fb.stat_last_bytes += area_size(&common_area) * bytes_per_pixel;
+    }
+    if (area_intersect(&common_area, p_win_area, &drv_lcd_fb.fb.area))
+        drv_lcd_fb.stat_window_bytes += area_size(&common_area) * bytes_per_pixel;
+    drv_lcd_fb.stat_bytes += drv_lcd_fb.stat_last_bytes;
+    drv_lcd_fb.stat_rects += drv_lcd_fb.flush_num;
+    drv_lcd_fb.stat_frames++;
 
     //Mark current window is flushed.
     memcpy(&drv_lcd_fb.window, &invalid_area, sizeof(LCD_AreaDef));
+    drv_lcd_fb.dirty_num = 0;
 
-    return err;
+    return fb_flush_next();
+}
+
+/**
+ * @brief Add a written area to dirty rects of current frame.
+ */
+static void dirty_add(const LCD_AreaDef *area)
+{
+    LCD_AreaDef r;
+    uint32_t align = drv_lcd_fb.lcd_info.draw_align;
+    uint32_t i;
+
+    memcpy(&r, area, sizeof(LCD_AreaDef));
+    //Writers other than GUI may not be rounded to panel
+    if (align > 1)
+    {
+        r.x0 = RT_ALIGN_DOWN(r.x0, align);
+        r.x1 = RT_ALIGN(r.x1 + 1, align) - 1;
+        r.y0 = RT_ALIGN_DOWN(r.y0, align);
+        r.y1 = RT_ALIGN(r.y1 + 1, align) - 1;
+    }
+
+    while (1)
+    {
+        //Merge with the rects cheaper to send together
+        for (i = 0; i < drv_lcd_fb.dirty_num;)
+        {
+            if (area_join_waste(&drv_lcd_fb.dirty[i], &r) <= LCD_FB_RECT_OVERHEAD_PIXELS)
+            {
+                area_join(&r, &drv_lcd_fb.dirty[i], &r);
+                drv_lcd_fb.dirty[i] = drv_lcd_fb.dirty[--drv_lcd_fb.dirty_num];
+                i = 0; //The bigger one may be merged with others now
+            }
+            else
+            {
+                i++;
+            }
+        }
+
+        if (drv_lcd_fb.dirty_num < LCD_FB_DIRTY_RECT_NUM)
+            break;
+
+        //No free slot, merge with the one wasting least
+        uint32_t best = 0;
+        for (i = 1; i < drv_lcd_fb.dirty_num; i++)
+        {
+            if (area_join_waste(&drv_lcd_fb.dirty[i], &r) < area_join_waste(&drv_lcd_fb.dirty[best], &r))
+                best = i;
+        }
+        area_join(&r, &drv_lcd_fb.dirty[best], &r);
+        drv_lcd_fb.dirty[best] = drv_lcd_fb.dirty[--drv_lcd_fb.dirty_num];
+    }
+
+    drv_lcd_fb.dirty[drv_lcd_fb.dirty_num++] = r;
+
+    //Bounding window
+    if (is_area_valid(&drv_lcd_fb.window))
+        area_join(&drv_lcd_fb.window, &drv_lcd_fb.window, &r);
+    else
+        memcpy(&drv_lcd_fb.window, &r, sizeof(LCD_AreaDef));
 }
 
 
@@ -849,8 +1048,12 @@ uint32_t drv_lcd_fb_set(lcd_fb_desc_t *fb_desc)
     {
         memcpy(&drv_lcd_fb.fb, fb_desc, sizeof(lcd_fb_desc_t));
         memcpy(&drv_lcd_fb.window, &invalid_area, sizeof(LCD_AreaDef));
+        drv_lcd_fb.dirty_num = 0;
+        drv_lcd_fb.flush_num = 0;
+        drv_lcd_fb.flush_idx = 0;
         drv_lcd_fb.scheme6_y0 = INT32_MIN;
         drv_lcd_fb.scheme6_valid_y1 = drv_lcd_fb.fb.area.y1;
+        drv_lcd_fb.scheme6_limit_y1 = drv_lcd_fb.fb.area.y1;
         drv_lcd_fb.flushing_lcd = 0;
         new_fb = true;
     }
@@ -933,20 +1136,9 @@ rt_err_t drv_lcd_fb_write_send(LCD_AreaDef *write_area, LCD_AreaDef *src_area, c
 
         wait_line_valid(&common_area, FB_COPY_EXP_MS);
 
-        //Join to window
-        if (is_area_valid(&drv_lcd_fb.window))
-        {
-            drv_lcd_fb.window.x0 = MIN(drv_lcd_fb.window.x0, write_area->x0);
-            drv_lcd_fb.window.y0 = MIN(drv_lcd_fb.window.y0, write_area->y0);
-            drv_lcd_fb.window.x1 = MAX(drv_lcd_fb.window.x1, write_area->x1);
-            drv_lcd_fb.window.y1 = MAX(drv_lcd_fb.window.y1, write_area->y1);
-        }
-        else
-        {
-            //First time
-            memcpy(&drv_lcd_fb.window, write_area, sizeof(LCD_AreaDef));
-        }
-        LOG_D("Total window:"AreaString, AreaParams(&drv_lcd_fb.window));
+        //Join to dirty rects and window
+        dirty_add(write_area);
+        LOG_D("Total window:"AreaString" %d rects", AreaParams(&drv_lcd_fb.window), drv_lcd_fb.dirty_num);
 
 
         if (send)
@@ -984,4 +1176,32 @@ rt_err_t drv_lcd_fb_write_send(LCD_AreaDef *write_area, LCD_AreaDef *src_area, c
     return RT_EOK;
 }
 
+#ifdef RT_USING_FINSH
+static rt_err_t lcd_fb_stat(int argc, char **argv)
+{
+    if ((argc > 1) && (0 == strcmp(argv[1], "reset")))
+    {
+        rt_base_t level = rt_hw_interrupt_disable();
+        drv_lcd_fb.stat_frames = 0;
+        drv_lcd_fb.stat_partial_frames = 0;
+        drv_lcd_fb.stat_rects = 0;
+        drv_lcd_fb.stat_bytes = 0;
+        drv_lcd_fb.stat_window_bytes = 0;
+        rt_hw_interrupt_enable(level);
+        return RT_EOK;
+    }
+
+    uint32_t frames = drv_lcd_fb.stat_frames ? drv_lcd_fb.stat_frames : 1;
+
+    rt_kprintf("frames %d, partial %d, windows %d, max rects %d\n", drv_lcd_fb.stat_frames,
+               drv_lcd_fb.stat_partial_frames, drv_lcd_fb.stat_rects, LCD_FB_DIRTY_RECT_NUM);
+    rt_kprintf("bytes/frame %d, bounding window bytes/frame %d, last frame %d\n",
+               (uint32_t)(drv_lcd_fb.stat_bytes / frames),
+               (uint32_t)(drv_lcd_fb.stat_window_bytes / frames),
+               drv_lcd_fb.stat_last_bytes);
+    return RT_EOK;
+}
+MSH_CMD_EXPORT(lcd_fb_stat, LCD framebuffer flush statistics: lcd_fb_stat [reset]);
+#endif /* RT_USING_FINSH */
+
 #endif /* BSP_USING_LCD_FRAMEBUFFER */
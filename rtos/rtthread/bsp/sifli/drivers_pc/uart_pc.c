@@ -66,6 +66,15 @@ struct console_uart
 } _console_uart;
 static struct rt_serial_device _serial;
 
+/* TX DMA statistics, to measure the serial framework TX path */
+static struct
+{
+    rt_uint32_t bytes;
+    rt_uint32_t transfers;
+    rt_uint32_t write_ms;       /* time spent in WriteFile */
+    rt_tick_t   start;
+} _uart_pc_tx_stat;
+
 #define SAVEKEY(key)  do { char ch = key; rt_ringbuffer_put_force(&(_console_uart.rb), &ch, 1); } while (0)
 
 
@@ -492,9 +501,11 @@ static rt_err_t pc_control(struct rt_serial_device *serial, int cmd, void *arg)
 static rt_size_t pc_dma(struct rt_serial_device *serial, rt_uint8_t *buf, rt_size_t size, int direction)
 {
     DWORD  dNoOfBytesWritten = 0;
+    DWORD  dStart;
 
     if (direction == RT_SERIAL_DMA_TX)
     {
+        dStart = GetTickCount();
         if (!WriteFile(hComm,               // Handle to the Serialport
                        buf,            // Data to be written to the port
                        size,   // No of bytes to write into the port
@@ -517,6 +528,9 @@ static rt_size_t pc_dma(struct rt_serial_device *serial, rt_uint8_t *buf, rt_siz
                 }
             }
         }
+        _uart_pc_tx_stat.bytes += size;
+        _uart_pc_tx_stat.transfers++;
+        _uart_pc_tx_stat.write_ms += GetTickCount() - dStart;
 #ifdef FTS_DEBUG
         extern int liveimport_loghci(int dir, int size, char *data);
         liveimport_loghci(1, size, buf);
@@ -601,6 +615,49 @@ static const struct rt_uart_ops console_uart_ops =
     pc_dma,
 };
 
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+/**
+  * @brief  Show the TX throughput since the last reset, and with the serial
+  *         DMA TX ring how many writes each transfer carried.
+  * @param[in] argc: "reset" to restart the measure.
+  * @retval 0.
+  */
+static int uart_pc_stat(int argc, char **argv)
+{
+    rt_uint32_t ms;
+#ifdef RT_SERIAL_USING_DMA_TX_RING
+    struct rt_serial_tx_stat tx;
+#endif
+
+    if (argc > 1 && strcmp(argv[1], "reset") == 0)
+    {
+        memset(&_uart_pc_tx_stat, 0, sizeof(_uart_pc_tx_stat));
+        _uart_pc_tx_stat.start = rt_tick_get();
+        return 0;
+    }
+
+    ms = (rt_tick_get() - _uart_pc_tx_stat.start) * 1000 / RT_TICK_PER_SECOND;
+    if (ms == 0)
+        ms = 1;
+    rt_kprintf("tx %d bytes in %d transfers, %d bytes/s, %d ms in WriteFile\n",
+               _uart_pc_tx_stat.bytes, _uart_pc_tx_stat.transfers,
+               (rt_uint32_t)((rt_uint64_t)_uart_pc_tx_stat.bytes * 1000 / ms),
+               _uart_pc_tx_stat.write_ms);
+#ifdef RT_SERIAL_USING_DMA_TX_RING
+    if (rt_device_control(&_serial.parent, RT_SERIAL_CTRL_TX_STAT, &tx) == RT_EOK && tx.writes)
+    {
+        rt_kprintf("%d writes, %d.%02d transfers per write, ring full %d, used max %d\n",
+                   tx.writes, tx.transfers / tx.writes, tx.transfers * 100 / tx.writes % 100,
+                   tx.full, tx.used_max);
+    }
+#endif
+    return 0;
+}
+MSH_CMD_EXPORT(uart_pc_stat, show simulator uart tx throughput: uart_pc_stat [reset]);
+#endif /* RT_USING_FINSH */
+
 int uart_pc_available()
 {
     return (hComm == INVALID_HANDLE_VALUE) ? 0 : 1;
@@ -625,6 +682,7 @@ int uart_pc_init()
     serial->config.baud_rate = RT_SERIAL_DEFAULT_BAUDRATE;
     /* initialize ring buffer */
     rt_ringbuffer_init(&uart->rb, uart->rx_buffer, sizeof(uart->rx_buffer));
+    _uart_pc_tx_stat.start = rt_tick_get();
 
 
 #ifdef UART_PORT0_PORT
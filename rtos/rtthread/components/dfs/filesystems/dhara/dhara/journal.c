@@ -157,6 +157,80 @@ static int choose_ppc(int log2_page_size, int max)
     return ppc;
 }
 
+/************************************************************************
+ * Metadata cache
+ */
+
+static void meta_cache_drop(struct dhara_journal *j, dhara_block_t blk)
+{
+    int i;
+
+    for (i = 0; i < j->meta_cache_num; i++)
+    {
+        struct dhara_meta_slot *s = &j->meta_cache[i];
+
+        if ((s->page != DHARA_PAGE_NONE) &&
+                ((s->page >> j->nand->log2_ppb) == blk))
+            s->page = DHARA_PAGE_NONE;
+    }
+}
+
+static void meta_cache_flush(struct dhara_journal *j)
+{
+    int i;
+
+    for (i = 0; i < j->meta_cache_num; i++)
+        j->meta_cache[i].page = DHARA_PAGE_NONE;
+}
+
+static const uint8_t *meta_cache_find(struct dhara_journal *j,
+                                      dhara_page_t p)
+{
+    int i;
+
+    for (i = 0; i < j->meta_cache_num; i++)
+    {
+        struct dhara_meta_slot *s = &j->meta_cache[i];
+
+        if (s->page == p)
+        {
+            s->stamp = ++j->meta_clock;
+            return s->meta;
+        }
+    }
+
+    return NULL;
+}
+
+static void meta_cache_add(struct dhara_journal *j, dhara_page_t p,
+                           const uint8_t *meta)
+{
+    struct dhara_meta_slot *victim = NULL;
+    int i;
+
+    /* Prefer a free slot, otherwise evict the least recently used */
+    for (i = 0; i < j->meta_cache_num; i++)
+    {
+        struct dhara_meta_slot *s = &j->meta_cache[i];
+
+        if (s->page == DHARA_PAGE_NONE)
+        {
+            victim = s;
+            break;
+        }
+
+        if (!victim || ((int32_t)(s->stamp - victim->stamp) < 0))
+            victim = s;
+    }
+
+    if (!victim)
+        return;
+
+    victim->page = p;
+    victim->stamp = ++j->meta_clock;
+    memcpy(victim->meta, meta, DHARA_META_SIZE);
+}
+
 /************************************************************************
  * Journal setup/resume
  */
@@ -199,6 +273,8 @@ static void reset_journal(struct dhara_journal *j)
 
     /* Empty metadata buffer */
     memset(j->page_buf, 0xff, 1 << j->nand->log2_page_size);
+
+    meta_cache_flush(j);
 }
 
 static void roll_stats(struct dhara_journal *j)
@@ -217,9 +293,24 @@ void dhara_journal_init(struct dhara_journal *j,
     j->page_buf = page_buf;
     j->log2_ppc = choose_ppc(n->log2_page_size, n->log2_ppb);
 
+    j->meta_cache = NULL;
+    j->meta_cache_num = 0;
+    j->meta_clock = 0;
+    j->meta_reads = 0;
+    j->meta_hits = 0;
+
     reset_journal(j);
 }
 
+void dhara_journal_set_meta_cache(struct dhara_journal *j,
+                                  struct dhara_meta_slot *slots,
+                                  uint16_t num)
+{
+    j->meta_cache = num ? slots : NULL;
+    j->meta_cache_num = slots ? num : 0;
+    meta_cache_flush(j);
+}
+
 /* Find the first checkpoint-containing block. If a block contains any
  * checkpoints at all, then it must contain one in the first checkpoint
  * location -- otherwise, we would have considered the block eraseable.
@@ -447,6 +538,9 @@ int dhara_journal_resume(struct dhara_journal *j, dhara_error_t *err)
     dhara_block_t first, last;
     dhara_page_t last_group;
 
+    /* Anything cached belongs to whatever state we had before */
+    meta_cache_flush(j);
+
     /* Find the first checkpoint-containing block */
     if (find_checkblock(j, 0, &first, err) < 0)
     {
@@ -536,6 +630,7 @@ int dhara_journal_read_meta(struct dhara_journal *j, dhara_page_t p,
     /* Offset of metadata within the metadata page */
     const dhara_page_t ppc_mask = (1 << j->log2_ppc) - 1;
     const size_t offset = hdr_user_offset(p & ppc_mask);
+    const uint8_t *cached;
 
     /* Special case: buffered metadata */
     if (align_eq(p, j->head, j->log2_ppc))
@@ -553,10 +648,25 @@ int dhara_journal_read_meta(struct dhara_journal *j, dhara_page_t p,
                                offset, DHARA_META_SIZE,
                                buf, err);
 
-    /* General case: fetch from metadata page for checkpoint group */
-    return dhara_nand_read(j->nand, p | ppc_mask,
-                           offset, DHARA_META_SIZE,
-                           buf, err);
+    /* General case: fetch from metadata page for checkpoint group.
+     * Once programmed, this doesn't change until the block is erased.
+     */
+    cached = meta_cache_find(j, p);
+    if (cached)
+    {
+        j->meta_hits++;
+        memcpy(buf, cached, DHARA_META_SIZE);
+        return 0;
+    }
+
+    j->meta_reads++;
+    if (dhara_nand_read(j->nand, p | ppc_mask,
+                        offset, DHARA_META_SIZE,
+                        buf, err) < 0)
+        return -1;
+
+    meta_cache_add(j, p, buf);
+    return 0;
 }
 
 dhara_page_t dhara_journal_peek(struct dhara_journal *j)
@@ -670,7 +780,10 @@ static int prepare_head(struct dhara_journal *j, dhara_error_t *err)
         const dhara_block_t blk = j->head >> j->nand->log2_ppb;
 
         if (!dhara_nand_is_bad(j->nand, blk))
+        {
+            meta_cache_drop(j, blk);
             return dhara_nand_erase(j->nand, blk, err);
+        }
 
         j->bb_current++;
         if (skip_block(j, err) < 0)
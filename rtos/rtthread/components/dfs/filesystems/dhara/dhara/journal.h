@@ -51,6 +51,19 @@
 #define DHARA_JOURNAL_F_RECOVERY    0x04
 #define DHARA_JOURNAL_F_ENUM_DONE   0x08
 
+/* One slot of the optional user page metadata cache. The radix map
+ * reads the metadata of every node on the path to a sector, and the
+ * nodes near the top of the tree are shared by nearly every lookup.
+ * Keeping the most recently read slices in RAM saves a NAND read per
+ * hit.
+ */
+struct dhara_meta_slot
+{
+    dhara_page_t        page;
+    uint32_t            stamp;
+    uint8_t             meta[DHARA_META_SIZE];
+};
+
 /* The journal layer presents the NAND pages as a double-ended queue.
  * Pages, with associated metadata may be pushed onto the end of the
  * queue, and pages may be popped from the end.
@@ -117,6 +130,16 @@ struct dhara_journal
     dhara_page_t            recover_next;
     dhara_page_t            recover_root;
     dhara_page_t            recover_meta;
+
+    /* Metadata cache (see dhara_journal_set_meta_cache()). The
+     * counters record how many metadata reads were served by the
+     * NAND and how many by the cache.
+     */
+    struct dhara_meta_slot      *meta_cache;
+    uint16_t            meta_cache_num;
+    uint32_t            meta_clock;
+    uint32_t            meta_reads;
+    uint32_t            meta_hits;
 };
 
 /* Initialize a journal. You must supply a pointer to a NAND chip
@@ -130,6 +153,19 @@ void dhara_journal_init(struct dhara_journal *j,
                         const struct dhara_nand *n,
                         uint8_t *page_buf);
 
+/* Attach an LRU cache of user page metadata. The slots are owned by
+ * the caller, like the page buffer, and must stay valid while the
+ * journal is in use. Call this after dhara_journal_init(), which
+ * detaches any previous cache. Passing num == 0 disables caching.
+ *
+ * Only metadata which has reached the NAND is cached. Slots are
+ * invalidated when their block is erased, so the cache never needs
+ * to be flushed by the caller.
+ */
+void dhara_journal_set_meta_cache(struct dhara_journal *j,
+                                  struct dhara_meta_slot *slots,
+                                  uint16_t num);
+
 /* Start up the journal -- search the NAND for the journal head, or
  * initialize a blank journal if one isn't found. Returns 0 on success
  * or -1 if a (fatal) error occurs.
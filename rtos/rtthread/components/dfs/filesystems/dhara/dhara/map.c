@@ -78,6 +78,8 @@ void dhara_map_init(struct dhara_map *m, const struct dhara_nand *n,
 
     dhara_journal_init(&m->journal, n, page_buf);
     m->gc_ratio = gc_ratio;
+    m->sector_reads = 0;
+    m->page_reads = 0;
 
     cap = dhara_journal_capacity(&m->journal);
     reserve = cap / (m->gc_ratio + 1);
@@ -228,6 +230,8 @@ int dhara_map_read(struct dhara_map *m, dhara_sector_t s,
     dhara_error_t my_err;
     dhara_page_t p;
 
+    m->sector_reads++;
+
     if (dhara_map_find(m, s, &p, &my_err) < 0)
     {
         if (my_err == DHARA_E_NOT_FOUND)
@@ -240,9 +244,130 @@ int dhara_map_read(struct dhara_map *m, dhara_sector_t s,
         return -1;
     }
 
+    m->page_reads++;
     return dhara_nand_read(n, p, 0, 1 << n->log2_page_size, data, err);
 }
 
+/* Resume a lookup at the given depth, starting from the node recorded
+ * in path[depth], and record the node visited at each deeper level.
+ * Two sectors take identical branches above the depth of the highest
+ * bit in which they differ, so a lookup of a neighbouring sector only
+ * needs to walk the levels below that point.
+ *
+ * Returns the depth at which the search stopped (DHARA_RADIX_DEPTH if
+ * the sector was found), or -1 on error.
+ */
+static int trace_from(struct dhara_map *m, dhara_sector_t target,
+                      int depth, dhara_page_t *path,
+                      dhara_error_t *err)
+{
+    uint8_t meta[DHARA_META_SIZE];
+    dhara_page_t p = path[depth];
+
+    if (p == DHARA_PAGE_NONE)
+        return depth;
+
+    if (dhara_journal_read_meta(&m->journal, p, meta, err) < 0)
+        return -1;
+
+    while (depth < DHARA_RADIX_DEPTH)
+    {
+        const dhara_sector_t id = meta_get_id(meta);
+
+        path[depth] = p;
+
+        if (id == DHARA_SECTOR_NONE)
+            return depth;
+
+        if ((target ^ id) & d_bit(depth))
+        {
+            p = meta_get_alt(meta, depth);
+            if (p == DHARA_PAGE_NONE)
+                return depth;
+
+            if (dhara_journal_read_meta(&m->journal, p,
+                                        meta, err) < 0)
+                return -1;
+        }
+
+        depth++;
+    }
+
+    path[DHARA_RADIX_DEPTH] = p;
+    return depth;
+}
+
+/* Depth of the highest bit in which two sectors differ */
+static int split_depth(dhara_sector_t a, dhara_sector_t b)
+{
+    int depth = 0;
+
+    while (!((a ^ b) & d_bit(depth)))
+        depth++;
+
+    return depth;
+}
+
+int dhara_map_read_multi(struct dhara_map *m, dhara_sector_t s,
+                         dhara_sector_t count, uint8_t *data,
+                         dhara_error_t *err)
+{
+    const struct dhara_nand *n = m->journal.nand;
+    const size_t page_size = 1 << n->log2_page_size;
+    dhara_page_t path[DHARA_RADIX_DEPTH + 1];
+    int reach = 0;
+    dhara_sector_t i;
+
+    path[0] = dhara_journal_root(&m->journal);
+
+    for (i = 0; i < count; i++, s++, data += page_size)
+    {
+        const int start = i ? split_depth(s - 1, s) : 0;
+
+        m->sector_reads++;
+
+        /* If the previous search stopped above the split, this one
+         * would have stopped at the same place.
+         */
+        if (start <= reach)
+        {
+            reach = trace_from(m, s, start, path, err);
+            if (reach < 0)
+                return -1;
+        }
+
+        if (reach < DHARA_RADIX_DEPTH)
+        {
+            memset(data, 0xff, page_size);
+            continue;
+        }
+
+        m->page_reads++;
+        if (dhara_nand_read(n, path[DHARA_RADIX_DEPTH], 0, page_size,
+                            data, err) < 0)
+            return -1;
+    }
+
+    return 0;
+}
+
+void dhara_map_get_stats(const struct dhara_map *m,
+                         struct dhara_map_stats *st)
+{
+    st->sector_reads = m->sector_reads;
+    st->page_reads = m->page_reads;
+    st->meta_reads = m->journal.meta_reads;
+    st->meta_hits = m->journal.meta_hits;
+}
+
+void dhara_map_reset_stats(struct dhara_map *m)
+{
+    m->sector_reads = 0;
+    m->page_reads = 0;
+    m->journal.meta_reads = 0;
+    m->journal.meta_hits = 0;
+}
+
 /* Check the given page. If it's garbage, do nothing. Otherwise, rewrite
  * it at the front of the map. Return raw errors from the journal (do
  * not perform recovery).
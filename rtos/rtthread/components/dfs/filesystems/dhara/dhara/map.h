@@ -34,6 +34,23 @@ struct dhara_map
     uint8_t         gc_ratio;
     dhara_sector_t  count;
     uint16_t        gc_cnt;
+
+    /* Read counters, see dhara_map_get_stats() */
+    uint32_t        sector_reads;
+    uint32_t        page_reads;
+};
+
+/* Read amplification counters. Every sector read costs one data page
+ * read (unless unmapped) plus one metadata read per radix tree hop
+ * that isn't served by the metadata cache or the journal head buffer.
+ * Metadata counters include lookups done by writes and GC.
+ */
+struct dhara_map_stats
+{
+    uint32_t        sector_reads;   /* sectors requested by the user */
+    uint32_t        page_reads;     /* data pages read from NAND */
+    uint32_t        meta_reads;     /* metadata slices read from NAND */
+    uint32_t        meta_hits;      /* metadata slices found in cache */
 };
 
 /* Initialize a map. You need to supply a buffer for page metadata, and
@@ -77,6 +94,16 @@ int dhara_map_find(struct dhara_map *m, dhara_sector_t s,
 int dhara_map_read(struct dhara_map *m, dhara_sector_t s,
                    uint8_t *data, dhara_error_t *err);
 
+/* Read count consecutive logical sectors into data, which must hold
+ * count full pages. Unmapped sectors read as blank pages. The result
+ * is the same as calling dhara_map_read() for each sector, but the
+ * part of the radix path shared by neighbouring sectors is only walked
+ * once.
+ */
+int dhara_map_read_multi(struct dhara_map *m, dhara_sector_t s,
+                         dhara_sector_t count, uint8_t *data,
+                         dhara_error_t *err);
+
 /* Write data to a logical sector. */
 int dhara_map_write(struct dhara_map *m, dhara_sector_t s,
                     const uint8_t *data, dhara_error_t *err);
@@ -115,6 +142,22 @@ int dhara_map_gc(struct dhara_map *m, dhara_error_t *err);
 
 int dhara_map_gc_all(struct dhara_map *m, dhara_error_t *err);
 
+/* Attach an LRU cache of radix tree metadata. Must be called after
+ * dhara_map_init(). See dhara_journal_set_meta_cache().
+ */
+static inline void dhara_map_set_meta_cache(struct dhara_map *m,
+        struct dhara_meta_slot *slots,
+        uint16_t num)
+{
+    dhara_journal_set_meta_cache(&m->journal, slots, num);
+}
+
+/* Obtain/reset the read amplification counters. */
+void dhara_map_get_stats(const struct dhara_map *m,
+                         struct dhara_map_stats *st);
+
+void dhara_map_reset_stats(struct dhara_map *m);
+
 int dhara_map_get_type(struct dhara_map *m, dhara_page_t p);
 
 
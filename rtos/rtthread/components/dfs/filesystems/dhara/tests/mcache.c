@@ -0,0 +1,234 @@
+/* Dhara - NAND flash management layer
+ * Copyright (C) 2013 Daniel Beer <dlbeer@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include "dhara/map.h"
+#include "util.h"
+#include "sim.h"
+
+#define NUM_SECTORS		160
+#define NUM_ROUNDS		6
+#define GC_RATIO		4
+#define CACHE_SLOTS		8
+#define MAX_RUN			16
+
+static struct dhara_meta_slot cache[CACHE_SLOTS];
+
+/* Sector contents: every fifth sector is never written, and the rest
+ * carry a seed which depends on the round in which they were last
+ * written.
+ */
+static int is_hole(dhara_sector_t s)
+{
+	return !(s % 5);
+}
+
+static int seed_of(dhara_sector_t s, int round)
+{
+	return s + round * NUM_SECTORS;
+}
+
+static void assert_blank(const uint8_t *buf, size_t len)
+{
+	size_t i;
+
+	for (i = 0; i < len; i++)
+		assert(buf[i] == 0xff);
+}
+
+static void assert_sector(dhara_sector_t s, int round,
+			  const uint8_t *buf, size_t len)
+{
+	if (is_hole(s))
+		assert_blank(buf, len);
+	else
+		seq_assert(seed_of(s, round), buf, len);
+}
+
+static void write_round(struct dhara_map *m, int round)
+{
+	const size_t page_size = 1 << m->journal.nand->log2_page_size;
+	uint8_t buf[page_size];
+	dhara_sector_t s;
+
+	for (s = 0; s < NUM_SECTORS; s++) {
+		dhara_error_t err;
+
+		if (is_hole(s))
+			continue;
+
+		seq_gen(seed_of(s, round), buf, sizeof(buf));
+		if (dhara_map_write(m, s, buf, &err) < 0)
+			dabort("map_write", err);
+	}
+}
+
+static void check_single(struct dhara_map *m, int round)
+{
+	const size_t page_size = 1 << m->journal.nand->log2_page_size;
+	uint8_t buf[page_size];
+	dhara_sector_t s;
+
+	for (s = 0; s < NUM_SECTORS + 8; s++) {
+		dhara_error_t err;
+
+		if (dhara_map_read(m, s, buf, &err) < 0)
+			dabort("map_read", err);
+
+		if (s >= NUM_SECTORS)
+			assert_blank(buf, sizeof(buf));
+		else
+			assert_sector(s, round, buf, sizeof(buf));
+	}
+}
+
+static void check_runs(struct dhara_map *m, int round)
+{
+	const size_t page_size = 1 << m->journal.nand->log2_page_size;
+	uint8_t buf[page_size * MAX_RUN];
+	int i;
+
+	for (i = 0; i < 64; i++) {
+		const dhara_sector_t start = random() % (NUM_SECTORS + 4);
+		const dhara_sector_t count = random() % MAX_RUN + 1;
+		dhara_error_t err;
+		dhara_sector_t j;
+
+		if (dhara_map_read_multi(m, start, count, buf, &err) < 0)
+			dabort("map_read_multi", err);
+
+		for (j = 0; j < count; j++) {
+			const uint8_t *p = buf + j * page_size;
+
+			if (start + j >= NUM_SECTORS)
+				assert_blank(p, page_size);
+			else
+				assert_sector(start + j, round, p, page_size);
+		}
+	}
+}
+
+static void measure(struct dhara_map *m, const char *name, int multi,
+		    struct dhara_map_stats *st)
+{
+	const size_t page_size = 1 << m->journal.nand->log2_page_size;
+	uint8_t buf[page_size * MAX_RUN];
+	dhara_sector_t s;
+
+	dhara_map_reset_stats(m);
+	for (s = 0; s < NUM_SECTORS; s += MAX_RUN) {
+		dhara_error_t err;
+		dhara_sector_t i;
+
+		if (multi) {
+			if (dhara_map_read_multi(m, s, MAX_RUN,
+						 buf, &err) < 0)
+				dabort("map_read_multi", err);
+			continue;
+		}
+
+		for (i = 0; i < MAX_RUN; i++)
+			if (dhara_map_read(m, s + i, buf, &err) < 0)
+				dabort("map_read", err);
+	}
+
+	dhara_map_get_stats(m, st);
+	printf("  %-16s sectors: %4d, pages: %4d, "
+	       "meta: %5d, hits: %5d\n", name,
+	       st->sector_reads, st->page_reads,
+	       st->meta_reads, st->meta_hits);
+}
+
+static void test(void)
+{
+	const size_t page_size = 1 << sim_nand.log2_page_size;
+	uint8_t page_buf[page_size];
+	struct dhara_map map;
+	struct dhara_map_stats plain, multi, cached;
+	dhara_error_t err;
+	int round;
+
+	sim_reset();
+	sim_inject_bad(5);
+	sim_inject_timebombs(10, 20);
+
+	dhara_map_init(&map, &sim_nand, page_buf, GC_RATIO);
+	dhara_map_resume(&map, NULL);
+	dhara_map_set_meta_cache(&map, cache, CACHE_SLOTS);
+
+	/* Rewrite everything a few times, so that the journal wraps and
+	 * blocks holding cached metadata get erased and reused.
+	 */
+	for (round = 0; round < NUM_ROUNDS; round++) {
+		write_round(&map, round);
+		check_single(&map, round);
+		check_runs(&map, round);
+	}
+
+	round--;
+
+	if (dhara_map_sync(&map, &err) < 0)
+		dabort("map_sync", err);
+
+	dhara_map_init(&map, &sim_nand, page_buf, GC_RATIO);
+	if (dhara_map_resume(&map, &err) < 0)
+		dabort("map_resume", err);
+
+	measure(&map, "single", 0, &plain);
+	measure(&map, "multi", 1, &multi);
+
+	dhara_map_set_meta_cache(&map, cache, CACHE_SLOTS);
+	check_single(&map, round);
+	check_runs(&map, round);
+	measure(&map, "multi+cache", 1, &cached);
+
+	/* Identical work, less metadata traffic */
+	assert(plain.sector_reads == multi.sector_reads);
+	assert(plain.page_reads == multi.page_reads);
+	assert(plain.page_reads == cached.page_reads);
+	assert(!plain.meta_hits && !multi.meta_hits);
+	assert(multi.meta_reads < plain.meta_reads);
+	assert(cached.meta_reads <= multi.meta_reads);
+
+	/* Trimming must be reflected in subsequent cached lookups */
+	if (dhara_map_trim(&map, 1, &err) < 0)
+		dabort("map_trim", err);
+
+	{
+		uint8_t buf[page_size];
+
+		if (dhara_map_read(&map, 1, buf, &err) < 0)
+			dabort("map_read", err);
+		assert_blank(buf, sizeof(buf));
+	}
+}
+
+int main(void)
+{
+	int i;
+
+	for (i = 0; i < 50; i++) {
+		printf("Seed: %d\n", i);
+		srandom(i);
+		test();
+	}
+
+	sim_dump();
+	return 0;
+}
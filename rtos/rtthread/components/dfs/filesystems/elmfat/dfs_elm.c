@@ -925,6 +925,10 @@ INIT_COMPONENT_EXPORT(elm_init);
     #define DHARA_DEV9_GC_RATIO (4)
 #endif
 
+#ifndef RT_DHARA_META_CACHE_NUM
+    #define RT_DHARA_META_CACHE_NUM (0)
+#endif
+
 
 typedef struct
 {
@@ -932,6 +936,7 @@ typedef struct
     bool is_nand;
     struct dhara_map map;
     uint8_t *page_buffer;
+    struct dhara_meta_slot *meta_cache;
     struct dhara_nand nand;
 } dhara_dev_t;
 
@@ -1107,6 +1112,16 @@ DSTATUS disk_initialize(BYTE drv)
         dhara_dev->nand.user_data = disk[drv];
         // init flash translation layer
         dhara_map_init(&dhara_dev->map, &dhara_dev->nand, dhara_dev->page_buffer, dhara_devs_gc_ratio[drv]);
+#if RT_DHARA_META_CACHE_NUM > 0
+        if (!dhara_dev->meta_cache)
+        {
+            dhara_dev->meta_cache = rt_malloc(sizeof(struct dhara_meta_slot) * RT_DHARA_META_CACHE_NUM);
+        }
+        if (dhara_dev->meta_cache)
+        {
+            dhara_map_set_meta_cache(&dhara_dev->map, dhara_dev->meta_cache, RT_DHARA_META_CACHE_NUM);
+        }
+#endif /* RT_DHARA_META_CACHE_NUM */
         dhara_error_t err = DHARA_E_NONE;
         ret = dhara_map_resume(&dhara_dev->map, &err);
 
@@ -1148,23 +1163,16 @@ DSTATUS disk_status(BYTE drv)
 DRESULT disk_read(BYTE drv, BYTE *buff, DWORD sector, UINT count)
 {
     dhara_error_t err;
-    rt_uint32_t sector_size;
 
     RT_ASSERT(drv < _VOLUMES);
 
     // rt_kprintf("dr:%d,%d\n", sector, count);
-    // read *count* consecutive sectors
-    sector_size = (1 << dhara_devs[drv].nand.log2_page_size);
-    for (int i = 0; i < count; i++)
+    // read *count* consecutive sectors, sector size == page size
+    int ret = dhara_map_read_multi(&dhara_devs[drv].map, sector, count, buff, &err);
+    if (ret)
     {
-        int ret = dhara_map_read(&dhara_devs[drv].map, sector, buff, &err);
-        if (ret)
-        {
-            rt_kprintf("dhara read failed: %d, error: %d\n", ret, err);
-            return RES_ERROR;
-        }
-        buff += sector_size; // sector size == page size
-        sector++;
+        rt_kprintf("dhara read failed: %d, error: %d\n", ret, err);
+        return RES_ERROR;
     }
 
     //rt_kprintf("read:%d,%d\n", sector, count);
@@ -1433,6 +1441,35 @@ rt_err_t dhara_nand_register_device(const char *name, rt_device_t dev, int drv)
     return rt_device_register(dev, name, RT_DEVICE_FLAG_RDWR | RT_DEVICE_FLAG_STANDALONE);
 }
 
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+static int dhara_stat(int argc, char **argv)
+{
+    struct dhara_map_stats st;
+    bool reset = (argc > 1) && (0 == strcmp(argv[1], "reset"));
+
+    for (int drv = 0; drv < _VOLUMES; drv++)
+    {
+        if (!dhara_devs[drv].initialized)
+        {
+            continue;
+        }
+        if (reset)
+        {
+            dhara_map_reset_stats(&dhara_devs[drv].map);
+            continue;
+        }
+        dhara_map_get_stats(&dhara_devs[drv].map, &st);
+        rt_kprintf("dhara%d: sectors %d, data pages %d, meta reads %d, meta hits %d\n",
+                   drv, st.sector_reads, st.page_reads, st.meta_reads, st.meta_hits);
+    }
+
+    return 0;
+}
+MSH_CMD_EXPORT(dhara_stat, dhara read amplification statistics: dhara_stat [reset]);
+#endif /* RT_USING_FINSH */
+
 
 #else
 
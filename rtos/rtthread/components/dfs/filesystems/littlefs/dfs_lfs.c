@@ -138,10 +138,15 @@ int _lfs_unlock(const struct lfs_config *c)
     #define DHARA_DEV9_GC_RATIO (4)
 #endif
 
+#ifndef RT_DHARA_META_CACHE_NUM
+    #define RT_DHARA_META_CACHE_NUM (0)
+#endif
+
 typedef struct
 {
     struct dhara_map map;
     uint8_t *page_buffer;
+    struct dhara_meta_slot *meta_cache;
     struct dhara_nand nand;
 } dhara_dev_t;
 
@@ -313,6 +318,13 @@ static void _lfs_load_config(struct lfs_config *lfs_cfg, struct rt_device *mtd_d
         RT_ASSERT(dhara_dev->nand.meta_buf);
 
         dhara_map_init(&dhara_dev->map, &dhara_dev->nand, dhara_dev->page_buffer, dhara_devs_gc_ratio[i]);
+#if RT_DHARA_META_CACHE_NUM > 0
+        dhara_dev->meta_cache = rt_malloc(sizeof(struct dhara_meta_slot) * RT_DHARA_META_CACHE_NUM);
+        if (dhara_dev->meta_cache)
+        {
+            dhara_map_set_meta_cache(&dhara_dev->map, dhara_dev->meta_cache, RT_DHARA_META_CACHE_NUM);
+        }
+#endif /* RT_DHARA_META_CACHE_NUM */
 
         ret = dhara_map_resume(&dhara_dev->map, &err);
         rt_kprintf("map_resume:%d,%d\n", ret, err);
@@ -365,6 +377,11 @@ static void _lfs_load_deconfig(struct lfs_config *lfs_cfg)
         rt_free(dhara_dev->nand.meta_buf);
         dhara_dev->nand.meta_buf = RT_NULL;
     }
+    if (dhara_dev->meta_cache)
+    {
+        rt_free(dhara_dev->meta_cache);
+        dhara_dev->meta_cache = RT_NULL;
+    }
     lfs_cfg->context = NULL;
 }
 
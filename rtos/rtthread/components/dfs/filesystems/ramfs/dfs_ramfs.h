@@ -18,6 +18,73 @@
 #define RAMFS_NAME_MAX  64
 #define RAMFS_MAGIC     0x0A0A0A0A
 
+#ifdef RT_DFS_RAMFS_EXTENT
+
+#ifndef RT_DFS_RAMFS_HASH_SIZE
+    #define RT_DFS_RAMFS_HASH_SIZE      32
+#endif
+
+#ifndef RT_DFS_RAMFS_EXTENT_MAX
+    #define RT_DFS_RAMFS_EXTENT_MAX     16384
+#endif
+
+#define RAMFS_EXTENT_MIN    256
+
+#define RAMFS_TYPE_FILE     0
+#define RAMFS_TYPE_DIR      1
+
+/* dirent has been unlinked while still open */
+#define RAMFS_F_REMOVED     0x01
+
+/* a piece of file data, files are chains of extents */
+struct ramfs_extent
+{
+    struct ramfs_extent *next;
+    rt_size_t capacity;         /* bytes available in data[] */
+    rt_size_t used;             /* bytes of file data in data[] */
+    rt_uint8_t data[];
+};
+
+struct ramfs_dirent
+{
+    rt_list_t list;             /* node in the parent's children list */
+    struct ramfs_dirent *hnext; /* hash chain */
+    struct ramfs_dirent *parent;
+    struct dfs_ramfs *fs;       /* file system ref */
+
+    rt_uint8_t type;            /* RAMFS_TYPE_FILE or RAMFS_TYPE_DIR */
+    rt_uint8_t flags;
+    rt_uint16_t ref;            /* open count */
+    rt_uint32_t hash;
+    char name[RAMFS_NAME_MAX];  /* dirent name */
+
+    rt_size_t size;             /* file size, or children count */
+
+    /* file data */
+    struct ramfs_extent *head;
+    struct ramfs_extent *tail;
+    /* last accessed extent and the file offset it starts at */
+    struct ramfs_extent *cur;
+    rt_size_t cur_off;
+
+    /* directory entries */
+    rt_list_t children;
+};
+
+/**
+ * DFS ramfs object
+ */
+struct dfs_ramfs
+{
+    rt_uint32_t magic;
+
+    struct rt_memheap memheap;
+    struct ramfs_dirent root;
+    struct ramfs_dirent *hash[RT_DFS_RAMFS_HASH_SIZE];
+};
+
+#else
+
 struct ramfs_dirent
 {
     rt_list_t list;
@@ -40,6 +107,8 @@ struct dfs_ramfs
     struct ramfs_dirent root;
 };
 
+#endif /* RT_DFS_RAMFS_EXTENT */
+
 int dfs_ramfs_init(void);
 struct dfs_ramfs *dfs_ramfs_create(rt_uint8_t *pool, rt_size_t size);
 
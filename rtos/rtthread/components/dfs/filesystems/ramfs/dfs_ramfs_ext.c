@@ -0,0 +1,829 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     SiFli        extent based ramfs with directories
+ */
+
+#include <rtthread.h>
+#include <dfs.h>
+#include <dfs_fs.h>
+#include <dfs_file.h>
+
+#include "dfs_ramfs.h"
+
+/*
+ * Files are chains of extents allocated from the ramfs memheap, so appending
+ * never moves existing data. New extents grow with the file up to
+ * RT_DFS_RAMFS_EXTENT_MAX, and the unused tail of the last extent is handed
+ * back to the memheap when the file is closed.
+ *
+ * Every dirent is also kept in a hash table keyed by its parent and name,
+ * which makes each path component a single hash lookup.
+ */
+
+static rt_uint32_t ramfs_hash(const struct ramfs_dirent *parent,
+                              const char *name, rt_size_t len)
+{
+    /* FNV-1a over the name, seeded with the parent */
+    rt_uint32_t hash = 2166136261u ^ (rt_uint32_t)(rt_ubase_t)parent;
+
+    while (len--)
+    {
+        hash ^= (rt_uint8_t) * name++;
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+static struct ramfs_dirent *ramfs_child(struct dfs_ramfs *ramfs,
+                                        struct ramfs_dirent *parent,
+                                        const char *name, rt_size_t len)
+{
+    rt_uint32_t hash = ramfs_hash(parent, name, len);
+    struct ramfs_dirent *dirent;
+
+    for (dirent = ramfs->hash[hash % RT_DFS_RAMFS_HASH_SIZE]; dirent; dirent = dirent->hnext)
+    {
+        if (dirent->hash == hash && dirent->parent == parent &&
+                rt_strncmp(dirent->name, name, len) == 0 && dirent->name[len] == '\0')
+            return dirent;
+    }
+
+    return NULL;
+}
+
+/*
+ * Resolve a path below the mount point. Returns the dirent or NULL. *parent
+ * is set to the directory holding the last path component and *name, *len
+ * to that component, or *parent is NULL if some directory on the way is
+ * missing.
+ */
+static struct ramfs_dirent *ramfs_walk(struct dfs_ramfs *ramfs, const char *path,
+                                       struct ramfs_dirent **parent,
+                                       const char **name, rt_size_t *len)
+{
+    struct ramfs_dirent *dirent = &(ramfs->root);
+    const char *comp;
+
+    *parent = NULL;
+    *name = NULL;
+    *len = 0;
+
+    while (1)
+    {
+        while (*path == '/')
+            path ++;
+        if (!*path)
+            return dirent;
+
+        comp = path;
+        while (*path && *path != '/')
+            path ++;
+
+        if (dirent->type != RAMFS_TYPE_DIR)
+        {
+            *parent = NULL;
+            return NULL;
+        }
+
+        *parent = dirent;
+        *name = comp;
+        *len = path - comp;
+
+        dirent = ramfs_child(ramfs, *parent, comp, *len);
+        if (dirent == NULL)
+        {
+            /* only the last component may be missing */
+            while (*path == '/')
+                path ++;
+            if (*path)
+                *parent = NULL;
+
+            return NULL;
+        }
+    }
+}
+
+static void ramfs_attach(struct dfs_ramfs *ramfs, struct ramfs_dirent *parent,
+                         struct ramfs_dirent *dirent)
+{
+    rt_uint32_t slot;
+
+    dirent->parent = parent;
+    dirent->hash = ramfs_hash(parent, dirent->name, rt_strlen(dirent->name));
+
+    slot = dirent->hash % RT_DFS_RAMFS_HASH_SIZE;
+    dirent->hnext = ramfs->hash[slot];
+    ramfs->hash[slot] = dirent;
+
+    rt_list_insert_before(&(parent->children), &(dirent->list));
+    parent->size ++;
+}
+
+static void ramfs_detach(struct dfs_ramfs *ramfs, struct ramfs_dirent *dirent)
+{
+    struct ramfs_dirent **link;
+
+    link = &(ramfs->hash[dirent->hash % RT_DFS_RAMFS_HASH_SIZE]);
+    while (*link != dirent)
+        link = &((*link)->hnext);
+    *link = dirent->hnext;
+    dirent->hnext = NULL;
+
+    rt_list_remove(&(dirent->list));
+    dirent->parent->size --;
+    dirent->parent = NULL;
+}
+
+static struct ramfs_dirent *ramfs_dirent_create(struct dfs_ramfs *ramfs,
+        struct ramfs_dirent *parent,
+        const char *name, rt_size_t len,
+        rt_uint8_t type)
+{
+    struct ramfs_dirent *dirent;
+
+    dirent = (struct ramfs_dirent *)rt_memheap_alloc(&(ramfs->memheap),
+             sizeof(struct ramfs_dirent));
+    if (dirent == NULL)
+        return NULL;
+
+    memset(dirent, 0, sizeof(struct ramfs_dirent));
+    memcpy(dirent->name, name, len);
+    dirent->name[len] = '\0';
+    dirent->type = type;
+    dirent->fs = ramfs;
+    rt_list_init(&(dirent->list));
+    rt_list_init(&(dirent->children));
+
+    ramfs_attach(ramfs, parent, dirent);
+
+    return dirent;
+}
+
+static void ramfs_truncate(struct ramfs_dirent *dirent)
+{
+    struct ramfs_extent *extent, *next;
+
+    for (extent = dirent->head; extent; extent = next)
+    {
+        next = extent->next;
+        rt_memheap_free(extent);
+    }
+
+    dirent->head = NULL;
+    dirent->tail = NULL;
+    dirent->cur = NULL;
+    dirent->cur_off = 0;
+    dirent->size = 0;
+}
+
+static void ramfs_dirent_free(struct ramfs_dirent *dirent)
+{
+    if (dirent->type == RAMFS_TYPE_FILE)
+        ramfs_truncate(dirent);
+    rt_memheap_free(dirent);
+}
+
+static struct ramfs_extent *ramfs_extent_alloc(struct dfs_ramfs *ramfs,
+        rt_size_t file_size,
+        rt_size_t need)
+{
+    struct ramfs_extent *extent;
+    rt_size_t capacity;
+
+    /* grow with the file, but keep a large write in one piece */
+    capacity = file_size;
+    if (capacity < RAMFS_EXTENT_MIN)
+        capacity = RAMFS_EXTENT_MIN;
+    if (capacity > RT_DFS_RAMFS_EXTENT_MAX)
+        capacity = RT_DFS_RAMFS_EXTENT_MAX;
+    if (capacity < need)
+        capacity = need;
+    capacity = RT_ALIGN(capacity, RT_ALIGN_SIZE);
+
+    extent = rt_memheap_alloc(&(ramfs->memheap), sizeof(struct ramfs_extent) + capacity);
+    if (extent == NULL && capacity > RT_DFS_RAMFS_EXTENT_MAX)
+    {
+        /* fragmented, fall back to regular pieces */
+        capacity = RT_DFS_RAMFS_EXTENT_MAX;
+        extent = rt_memheap_alloc(&(ramfs->memheap), sizeof(struct ramfs_extent) + capacity);
+    }
+    if (extent == NULL)
+        return NULL;
+
+    extent->next = NULL;
+    extent->capacity = capacity;
+    extent->used = 0;
+
+    return extent;
+}
+
+/* find the extent holding pos, *start is the file offset of its first byte */
+static struct ramfs_extent *ramfs_extent_find(struct ramfs_dirent *dirent,
+        rt_size_t pos, rt_size_t *start)
+{
+    struct ramfs_extent *extent;
+    rt_size_t offset;
+
+    if (dirent->cur && pos >= dirent->cur_off)
+    {
+        extent = dirent->cur;
+        offset = dirent->cur_off;
+    }
+    else
+    {
+        extent = dirent->head;
+        offset = 0;
+    }
+
+    while (extent && pos >= offset + extent->used)
+    {
+        offset += extent->used;
+        extent = extent->next;
+    }
+
+    if (extent)
+    {
+        dirent->cur = extent;
+        dirent->cur_off = offset;
+    }
+    *start = offset;
+
+    return extent;
+}
+
+/* give the unused tail of the last extent back to the memheap */
+static void ramfs_trim_tail(struct ramfs_dirent *dirent)
+{
+    struct ramfs_extent *tail = dirent->tail;
+    rt_size_t capacity;
+
+    if (tail == NULL)
+        return;
+
+    capacity = RT_ALIGN(tail->used, RT_ALIGN_SIZE);
+    if (capacity < tail->capacity)
+    {
+        /* shrinking a memheap block never moves it */
+        if (rt_memheap_realloc(&(dirent->fs->memheap), tail,
+                               sizeof(struct ramfs_extent) + capacity) == tail)
+            tail->capacity = capacity;
+    }
+}
+
+/*
+ * Move the file into a single extent of at least capacity bytes, for users
+ * which need the data contiguous in memory.
+ */
+static int ramfs_make_contiguous(struct ramfs_dirent *dirent, rt_size_t capacity)
+{
+    struct ramfs_extent *extent, *old;
+    rt_size_t copied = 0;
+
+    if (dirent->head && dirent->head == dirent->tail &&
+            dirent->head->capacity >= capacity)
+        return 0;
+
+    capacity = RT_ALIGN(capacity ? capacity : 1, RT_ALIGN_SIZE);
+    extent = rt_memheap_alloc(&(dirent->fs->memheap), sizeof(struct ramfs_extent) + capacity);
+    if (extent == NULL)
+        return -ENOMEM;
+
+    for (old = dirent->head; old && copied < capacity; old = old->next)
+    {
+        rt_size_t length = old->used;
+
+        if (length > capacity - copied)
+            length = capacity - copied;
+        memcpy(extent->data + copied, old->data, length);
+        copied += length;
+    }
+
+    ramfs_truncate(dirent);
+
+    extent->next = NULL;
+    extent->capacity = capacity;
+    extent->used = copied;
+    dirent->head = extent;
+    dirent->tail = extent;
+    dirent->size = copied;
+
+    return 0;
+}
+
+int dfs_ramfs_mount(struct dfs_filesystem *fs,
+                    unsigned long          rwflag,
+                    const void            *data)
+{
+    struct dfs_ramfs *ramfs;
+
+    if (data == NULL)
+        return -EIO;
+
+    ramfs = (struct dfs_ramfs *)data;
+    fs->data = ramfs;
+
+    return RT_EOK;
+}
+
+int dfs_ramfs_unmount(struct dfs_filesystem *fs)
+{
+    fs->data = NULL;
+
+    return RT_EOK;
+}
+
+int dfs_ramfs_statfs(struct dfs_filesystem *fs, struct statfs *buf)
+{
+    struct dfs_ramfs *ramfs;
+
+    ramfs = (struct dfs_ramfs *)fs->data;
+    RT_ASSERT(ramfs != NULL);
+    RT_ASSERT(buf != NULL);
+
+    /* no realloc slack and no need for contiguous space: every free byte of
+     * the memheap can take file data, less the block headers */
+    buf->f_bsize  = 512;
+    buf->f_blocks = ramfs->memheap.pool_size / 512;
+    buf->f_bfree  = ramfs->memheap.available_size / 512;
+
+    return RT_EOK;
+}
+
+int dfs_ramfs_ioctl(struct dfs_fd *file, int cmd, void *args)
+{
+    struct ramfs_dirent *dirent;
+
+    dirent = (struct ramfs_dirent *)file->data;
+    RT_ASSERT(dirent != NULL);
+
+    if (dirent->type != RAMFS_TYPE_FILE)
+        return -EIO;
+
+    if (F_GET_PHY_ADDR == cmd)
+    {
+        if (args)
+        {
+            if (dirent->head == NULL)
+                return -EIO;
+            if (ramfs_make_contiguous(dirent, dirent->size) < 0)
+                return -ENOMEM;
+
+            *((uint32_t *)args) = (uint32_t)(&(dirent->head->data[file->pos]));
+            return 0;
+        }
+    }
+    else if (F_RESERVE_CONT_SPACE == cmd)
+    {
+        rt_uint32_t size = (rt_uint32_t)(rt_ubase_t)args;
+
+        if (ramfs_make_contiguous(dirent, size) < 0)
+        {
+            rt_set_errno(-ENOMEM);
+            return -ENOMEM;
+        }
+
+        dirent->head->used = size;
+        dirent->size = size;
+        file->size = dirent->size;
+        return 0;
+    }
+    return -EIO;
+}
+
+int dfs_ramfs_read(struct dfs_fd *file, void *buf, size_t count)
+{
+    struct ramfs_dirent *dirent;
+    struct ramfs_extent *extent;
+    rt_size_t length, copied, start, offset, n;
+
+    dirent = (struct ramfs_dirent *)file->data;
+    RT_ASSERT(dirent != NULL);
+
+    if (dirent->type != RAMFS_TYPE_FILE)
+        return -EISDIR;
+
+    file->size = dirent->size;
+    if ((rt_size_t)file->pos >= dirent->size)
+        return 0;
+
+    length = dirent->size - file->pos;
+    if (count < length)
+        length = count;
+
+    for (copied = 0; copied < length; copied += n)
+    {
+        offset = file->pos + copied;
+        extent = ramfs_extent_find(dirent, offset, &start);
+        RT_ASSERT(extent != NULL);
+
+        n = extent->used - (offset - start);
+        if (n > length - copied)
+            n = length - copied;
+        memcpy((rt_uint8_t *)buf + copied, extent->data + (offset - start), n);
+    }
+
+    /* update file current position */
+    file->pos += length;
+
+    return length;
+}
+
+int dfs_ramfs_write(struct dfs_fd *fd, const void *buf, size_t count)
+{
+    struct ramfs_dirent *dirent;
+    struct ramfs_extent *extent;
+    rt_size_t done = 0, start, offset, n;
+    const rt_uint8_t *src = buf;
+
+    dirent = (struct ramfs_dirent *)fd->data;
+    RT_ASSERT(dirent != NULL);
+
+    if (dirent->type != RAMFS_TYPE_FILE)
+        return -EISDIR;
+
+    /* overwrite existing data */
+    while (done < count && (rt_size_t)fd->pos + done < dirent->size)
+    {
+        offset = fd->pos + done;
+        extent = ramfs_extent_find(dirent, offset, &start);
+        RT_ASSERT(extent != NULL);
+
+        n = extent->used - (offset - start);
+        if (n > count - done)
+            n = count - done;
+        memcpy(extent->data + (offset - start), src + done, n);
+        done += n;
+    }
+
+    /* append, first into the room left in the last extent */
+    extent = dirent->tail;
+    while (done < count)
+    {
+        if (extent == NULL || extent->used == extent->capacity)
+        {
+            extent = ramfs_extent_alloc(dirent->fs, dirent->size, count - done);
+            if (extent == NULL)
+                break;
+
+            if (dirent->tail)
+                dirent->tail->next = extent;
+            else
+                dirent->head = extent;
+            dirent->tail = extent;
+        }
+
+        n = extent->capacity - extent->used;
+        if (n > count - done)
+            n = count - done;
+        memcpy(extent->data + extent->used, src + done, n);
+        extent->used += n;
+        dirent->size += n;
+        done += n;
+    }
+
+    fd->size = dirent->size;
+    if (done == 0 && count > 0)
+        return -ENOMEM;
+
+    /* update file current position */
+    fd->pos += done;
+
+    return done;
+}
+
+int dfs_ramfs_lseek(struct dfs_fd *file, off_t offset)
+{
+    if (offset <= (off_t)file->size)
+    {
+        file->pos = offset;
+
+        return file->pos;
+    }
+
+    return -EIO;
+}
+
+int dfs_ramfs_close(struct dfs_fd *file)
+{
+    struct ramfs_dirent *dirent;
+
+    dirent = (struct ramfs_dirent *)file->data;
+    RT_ASSERT(dirent != NULL);
+
+    if (dirent->type == RAMFS_TYPE_FILE && (file->flags & O_ACCMODE) != O_RDONLY)
+        ramfs_trim_tail(dirent);
+
+    dirent->ref --;
+    if (dirent->ref == 0 && (dirent->flags & RAMFS_F_REMOVED))
+        ramfs_dirent_free(dirent);
+
+    file->data = NULL;
+
+    return RT_EOK;
+}
+
+int dfs_ramfs_open(struct dfs_fd *file)
+{
+    struct dfs_ramfs *ramfs;
+    struct ramfs_dirent *dirent, *parent;
+    struct dfs_filesystem *fs;
+    const char *name;
+    rt_size_t len;
+
+    fs = (struct dfs_filesystem *)file->data;
+
+    ramfs = (struct dfs_ramfs *)fs->data;
+    RT_ASSERT(ramfs != NULL);
+
+    dirent = ramfs_walk(ramfs, file->path, &parent, &name, &len);
+
+    if (file->flags & O_DIRECTORY)
+    {
+        if (file->flags & O_CREAT)
+        {
+            /* mkdir */
+            if (dirent != NULL)
+                return -EEXIST;
+            if (parent == NULL)
+                return -ENOENT;
+            if (len >= RAMFS_NAME_MAX)
+                return -ENAMETOOLONG;
+
+            dirent = ramfs_dirent_create(ramfs, parent, name, len, RAMFS_TYPE_DIR);
+            if (dirent == NULL)
+                return -ENOMEM;
+        }
+
+        if (dirent == NULL)
+            return -ENOENT;
+        if (dirent->type != RAMFS_TYPE_DIR)
+            return -ENOTDIR;
+    }
+    else
+    {
+        if (dirent == NULL)
+        {
+            if (!(file->flags & O_CREAT || file->flags & O_WRONLY))
+                return -ENOENT;
+            if (parent == NULL)
+                return -ENOENT;
+            if (len >= RAMFS_NAME_MAX)
+                return -ENAMETOOLONG;
+
+            /* create a file entry */
+            dirent = ramfs_dirent_create(ramfs, parent, name, len, RAMFS_TYPE_FILE);
+            if (dirent == NULL)
+                return -ENOMEM;
+        }
+        else if (dirent->type == RAMFS_TYPE_DIR)
+        {
+            return -EISDIR;
+        }
+
+        /* Creates a new file.
+         * If the file is existing, it is truncated and overwritten.
+         */
+        if (file->flags & O_TRUNC)
+            ramfs_truncate(dirent);
+    }
+
+    dirent->ref ++;
+    file->data = dirent;
+    file->size = dirent->size;
+    if (file->flags & O_APPEND)
+        file->pos = file->size;
+    else
+        file->pos = 0;
+
+    return 0;
+}
+
+int dfs_ramfs_flush(struct dfs_fd *file)
+{
+    return 0;
+}
+
+int dfs_ramfs_stat(struct dfs_filesystem *fs,
+                   const char            *path,
+                   struct stat           *st)
+{
+    struct ramfs_dirent *dirent, *parent;
+    struct dfs_ramfs *ramfs;
+    const char *name;
+    rt_size_t len;
+
+    ramfs = (struct dfs_ramfs *)fs->data;
+    dirent = ramfs_walk(ramfs, path, &parent, &name, &len);
+
+    if (dirent == NULL)
+        return -ENOENT;
+
+    st->st_dev = 0;
+    st->st_mode = S_IRUSR | S_IRGRP | S_IROTH |
+                  S_IWUSR | S_IWGRP | S_IWOTH;
+    if (dirent->type == RAMFS_TYPE_DIR)
+    {
+        st->st_mode |= S_IFDIR | S_IXUSR | S_IXGRP | S_IXOTH;
+        st->st_size = 0;
+    }
+    else
+    {
+        st->st_mode |= S_IFREG;
+        st->st_size = dirent->size;
+    }
+    st->st_mtime = 0;
+
+    return RT_EOK;
+}
+
+int dfs_ramfs_getdents(struct dfs_fd *file,
+                       struct dirent *dirp,
+                       uint32_t    count)
+{
+    rt_size_t index, end;
+    struct dirent *d;
+    struct ramfs_dirent *dir, *dirent;
+    rt_list_t *node;
+
+    dir = (struct ramfs_dirent *)file->data;
+    RT_ASSERT(dir != RT_NULL);
+
+    if (dir->type != RAMFS_TYPE_DIR)
+        return -EINVAL;
+
+    /* make integer count */
+    count = (count / sizeof(struct dirent));
+    if (count == 0)
+        return -EINVAL;
+
+    end = file->pos + count;
+    index = 0;
+    count = 0;
+    for (node = dir->children.next; node != &(dir->children) && index < end; node = node->next)
+    {
+        if (index >= (rt_size_t)file->pos)
+        {
+            dirent = rt_list_entry(node, struct ramfs_dirent, list);
+
+            d = dirp + count;
+            d->d_type = (dirent->type == RAMFS_TYPE_DIR) ? DT_DIR : DT_REG;
+            d->d_namlen = rt_strlen(dirent->name);
+            d->d_reclen = (rt_uint16_t)sizeof(struct dirent);
+            rt_strncpy(d->d_name, dirent->name, RAMFS_NAME_MAX);
+
+            count += 1;
+            file->pos += 1;
+        }
+        index += 1;
+    }
+
+    return count * sizeof(struct dirent);
+}
+
+int dfs_ramfs_unlink(struct dfs_filesystem *fs, const char *path)
+{
+    struct dfs_ramfs *ramfs;
+    struct ramfs_dirent *dirent, *parent;
+    const char *name;
+    rt_size_t len;
+
+    ramfs = (struct dfs_ramfs *)fs->data;
+    RT_ASSERT(ramfs != NULL);
+
+    dirent = ramfs_walk(ramfs, path, &parent, &name, &len);
+    if (dirent == NULL)
+        return -ENOENT;
+    if (dirent == &(ramfs->root))
+        return -EBUSY;
+    if (dirent->type == RAMFS_TYPE_DIR && dirent->size > 0)
+        return -ENOTEMPTY;
+
+    ramfs_detach(ramfs, dirent);
+
+    /* an open file keeps its data until the last close */
+    if (dirent->ref > 0)
+        dirent->flags |= RAMFS_F_REMOVED;
+    else
+        ramfs_dirent_free(dirent);
+
+    return RT_EOK;
+}
+
+int dfs_ramfs_rename(struct dfs_filesystem *fs,
+                     const char            *oldpath,
+                     const char            *newpath)
+{
+    struct ramfs_dirent *dirent, *parent, *dir;
+    struct dfs_ramfs *ramfs;
+    const char *name, *old_name;
+    rt_size_t len, old_len;
+
+    ramfs = (struct dfs_ramfs *)fs->data;
+    RT_ASSERT(ramfs != NULL);
+
+    dirent = ramfs_walk(ramfs, newpath, &parent, &name, &len);
+    if (dirent != NULL)
+        return -EEXIST;
+    if (parent == NULL)
+        return -ENOENT;
+    if (len >= RAMFS_NAME_MAX)
+        return -ENAMETOOLONG;
+
+    dirent = ramfs_walk(ramfs, oldpath, &dir, &old_name, &old_len);
+    if (dirent == NULL)
+        return -ENOENT;
+    if (dirent == &(ramfs->root))
+        return -EBUSY;
+
+    /* a directory can't be moved below itself */
+    for (dir = parent; dir; dir = dir->parent)
+    {
+        if (dir == dirent)
+            return -EINVAL;
+    }
+
+    ramfs_detach(ramfs, dirent);
+    memcpy(dirent->name, name, len);
+    dirent->name[len] = '\0';
+    ramfs_attach(ramfs, parent, dirent);
+
+    return RT_EOK;
+}
+
+static const struct dfs_file_ops _ram_fops =
+{
+    dfs_ramfs_open,
+    dfs_ramfs_close,
+    dfs_ramfs_ioctl,
+    dfs_ramfs_read,
+    dfs_ramfs_write,
+    dfs_ramfs_flush, /* flush */
+    dfs_ramfs_lseek,
+    dfs_ramfs_getdents,
+};
+
+static const struct dfs_filesystem_ops _ramfs =
+{
+    "ram",
+    DFS_FS_FLAG_DEFAULT,
+    &_ram_fops,
+
+    dfs_ramfs_mount,
+    dfs_ramfs_unmount,
+    NULL, /* mkfs */
+    dfs_ramfs_statfs,
+
+    dfs_ramfs_unlink,
+    dfs_ramfs_stat,
+    dfs_ramfs_rename,
+};
+
+int dfs_ramfs_init(void)
+{
+    /* register ram file system */
+    dfs_register(&_ramfs);
+
+    return 0;
+}
+INIT_COMPONENT_EXPORT(dfs_ramfs_init);
+
+struct dfs_ramfs *dfs_ramfs_create(rt_uint8_t *pool, rt_size_t size)
+{
+    struct dfs_ramfs *ramfs;
+    rt_uint8_t *data_ptr;
+    rt_err_t result;
+
+    size  = RT_ALIGN_DOWN(size, RT_ALIGN_SIZE);
+    ramfs = (struct dfs_ramfs *)pool;
+
+    data_ptr = (rt_uint8_t *)(ramfs + 1);
+    size = size - sizeof(struct dfs_ramfs);
+    size = RT_ALIGN_DOWN(size, RT_ALIGN_SIZE);
+
+    result = rt_memheap_init(&ramfs->memheap, "ramfs", data_ptr, size);
+    if (result != RT_EOK)
+        return NULL;
+    /* detach this memheap object from the system */
+    rt_object_detach((rt_object_t) & (ramfs->memheap));
+
+    /* initialize ramfs object */
+    ramfs->magic = RAMFS_MAGIC;
+    ramfs->memheap.parent.type = RT_Object_Class_MemHeap | RT_Object_Class_Static;
+    memset(ramfs->hash, 0, sizeof(ramfs->hash));
+
+    /* initialize root directory */
+    memset(&(ramfs->root), 0x00, sizeof(ramfs->root));
+    rt_list_init(&(ramfs->root.list));
+    rt_list_init(&(ramfs->root.children));
+    ramfs->root.type = RAMFS_TYPE_DIR;
+    strcpy(ramfs->root.name, ".");
+    ramfs->root.fs = ramfs;
+
+    return ramfs;
+}
@@ -5,6 +5,7 @@
  *
  * Change Logs:
  * Date           Author       Notes
+ * 2026-10-19     SiFli        use the directory index generated by mkromfs
  */
 
 #include <rtthread.h>
@@ -16,7 +17,8 @@
 
 rt_inline int check_dirent(struct romfs_dirent *dirent)
 {
-    if ((dirent->type != ROMFS_DIRENT_FILE && dirent->type != ROMFS_DIRENT_DIR)
+    if ((ROMFS_DIRENT_TYPE(dirent->type) != ROMFS_DIRENT_FILE &&
+            ROMFS_DIRENT_TYPE(dirent->type) != ROMFS_DIRENT_DIR)
             || dirent->size == ~0)
         return -1;
     return 0;
@@ -83,24 +85,113 @@ __EXIT:
 }
 
 
+/* FNV-1a, must match name_hash() in tools/build/mkromfs.py */
+rt_uint32_t romfs_name_hash(const char *name, rt_size_t len)
+{
+    rt_uint32_t hash = 2166136261u;
+
+    while (len--)
+    {
+        hash ^= (rt_uint8_t)*name++;
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+/* compare a stored name against a path component, in unsigned byte order */
+static int romfs_name_cmp(const char *name, const char *key, rt_size_t len)
+{
+    const rt_uint8_t *a = (const rt_uint8_t *)name;
+    const rt_uint8_t *b = (const rt_uint8_t *)key;
+
+    for (; len > 0; len --, a ++, b ++)
+    {
+        if (*a != *b)
+            return (int)*a - (int)*b;
+    }
+
+    return *a;
+}
+
+/* find the entry "name" of "len" bytes in directory "dir" */
+static struct romfs_dirent *romfs_find(rt_uint32_t base_addr, struct romfs_dirent *dir,
+                                       const char *name, rt_size_t len)
+{
+    struct romfs_dirent *dirent;
+    struct romfs_dirent *hash;
+    const rt_uint16_t *slot;
+    rt_size_t index, low, high, mask;
+    int cmp;
+
+    dirent = (struct romfs_dirent *)(base_addr + (rt_uint32_t)dir->data);
+
+    if (dir->type & ROMFS_DIRENT_HASHED)
+    {
+        hash = &dirent[dir->size];
+        if (hash->type != ROMFS_DIRENT_HASH || hash->size == 0)
+            return NULL;
+
+        slot = (const rt_uint16_t *)(base_addr + (rt_uint32_t)hash->data);
+        mask = hash->size - 1;
+        index = romfs_name_hash(name, len) & mask;
+        /* the table is never full, an empty slot ends the probe */
+        while (slot[index] != 0)
+        {
+            if (slot[index] <= dir->size &&
+                    romfs_name_cmp((const char *)(base_addr + dirent[slot[index] - 1].name), name, len) == 0)
+            {
+                dirent = &dirent[slot[index] - 1];
+                return check_dirent(dirent) == 0 ? dirent : NULL;
+            }
+            index = (index + 1) & mask;
+        }
+
+        return NULL;
+    }
+
+    if (dir->type & ROMFS_DIRENT_SORTED)
+    {
+        low = 0;
+        high = dir->size;
+        while (low < high)
+        {
+            index = low + (high - low) / 2;
+            cmp = romfs_name_cmp((const char *)(base_addr + dirent[index].name), name, len);
+            if (cmp == 0)
+                return check_dirent(&dirent[index]) == 0 ? &dirent[index] : NULL;
+            if (cmp < 0)
+                low = index + 1;
+            else
+                high = index;
+        }
+
+        return NULL;
+    }
+
+    /* search in folder */
+    for (index = 0; index < dir->size; index ++)
+    {
+        if (check_dirent(&dirent[index]) != 0)
+            return NULL;
+        if (rt_strlen(base_addr + dirent[index].name) == len &&
+                rt_strncmp(base_addr + dirent[index].name, name, len) == 0)
+            return &dirent[index];
+    }
+
+    return NULL;
+}
+
 struct romfs_dirent *dfs_romfs_lookup(struct romfs_dirent *root_dirent, const char *path, rt_size_t *size)
 {
-    rt_size_t index, found;
     const char *subpath, *subpath_end;
     struct romfs_dirent *dirent;
-    rt_size_t dirent_size;
     rt_uint32_t base_addr;
 
     /* Check the root_dirent. */
     if (check_dirent(root_dirent) != 0)
         return NULL;
 
-    if (path[0] == '/' && path[1] == '\0')
-    {
-        *size = root_dirent->size;
-        return root_dirent;
-    }
-
     if ((rt_size_t)root_dirent->name == sizeof(*root_dirent))
     {
         base_addr = (rt_uint32_t)root_dirent;
@@ -109,70 +200,33 @@ struct romfs_dirent *dfs_romfs_lookup(struct romfs_dirent *root_dirent, const ch
     {
         base_addr = 0;
     }
-    /* goto root directy entries */
-    dirent = (struct romfs_dirent *)(base_addr + (rt_uint32_t)(root_dirent->data));
-    dirent_size = root_dirent->size;
 
-    /* get the end position of this subpath */
+    dirent = root_dirent;
     subpath_end = path;
-    /* skip /// */
-    while (*subpath_end && *subpath_end == '/')
-        subpath_end ++;
-    subpath = subpath_end;
-    while ((*subpath_end != '/') && *subpath_end)
-        subpath_end ++;
-
-    while (dirent != NULL)
+    while (1)
     {
-        found = 0;
-
-        /* search in folder */
-        for (index = 0; index < dirent_size; index ++)
-        {
-            if (check_dirent(&dirent[index]) != 0)
-                return NULL;
-            if (rt_strlen(base_addr + dirent[index].name) == (subpath_end - subpath) &&
-                    rt_strncmp(base_addr + dirent[index].name, subpath, (subpath_end - subpath)) == 0)
-            {
-                dirent_size = dirent[index].size;
-
-                /* skip /// */
-                while (*subpath_end && *subpath_end == '/')
-                    subpath_end ++;
-                subpath = subpath_end;
-                while ((*subpath_end != '/') && *subpath_end)
-                    subpath_end ++;
-
-                if (!(*subpath))
-                {
-                    *size = dirent_size;
-                    return &dirent[index];
-                }
-
-                if (dirent[index].type == ROMFS_DIRENT_DIR)
-                {
-                    /* enter directory */
-                    dirent = (struct romfs_dirent *)(base_addr + dirent[index].data);
-                    found = 1;
-                    break;
-                }
-                else
-                {
-                    /* return file dirent */
-                    if (subpath != NULL)
-                        break; /* not the end of path */
-
-                    return &dirent[index];
-                }
-            }
-        }
-
-        if (!found)
-            break; /* not found */
+        /* skip /// */
+        while (*subpath_end && *subpath_end == '/')
+            subpath_end ++;
+        subpath = subpath_end;
+        if (!(*subpath))
+            break;
+
+        /* get the end position of this subpath */
+        while ((*subpath_end != '/') && *subpath_end)
+            subpath_end ++;
+
+        /* a file has no entries */
+        if (ROMFS_DIRENT_TYPE(dirent->type) != ROMFS_DIRENT_DIR)
+            return NULL;
+
+        dirent = romfs_find(base_addr, dirent, subpath, subpath_end - subpath);
+        if (dirent == NULL)
+            return NULL;
     }
 
-    /* not found */
-    return NULL;
+    *size = dirent->size;
+    return dirent;
 }
 
 int dfs_romfs_read(struct dfs_fd *file, void *buf, size_t count)
@@ -252,7 +306,7 @@ int dfs_romfs_open(struct dfs_fd *file)
         return -ENOENT;
 
     /* entry is a directory file type */
-    if (dirent->type == ROMFS_DIRENT_DIR)
+    if (ROMFS_DIRENT_TYPE(dirent->type) == ROMFS_DIRENT_DIR)
     {
         if (!(file->flags & O_DIRECTORY))
             return -ENOENT;
@@ -287,7 +341,7 @@ int dfs_romfs_stat(struct dfs_filesystem *fs, const char *path, struct stat *st)
     st->st_mode = S_IFREG | S_IRUSR | S_IRGRP | S_IROTH |
                   S_IWUSR | S_IWGRP | S_IWOTH;
 
-    if (dirent->type == ROMFS_DIRENT_DIR)
+    if (ROMFS_DIRENT_TYPE(dirent->type) == ROMFS_DIRENT_DIR)
     {
         st->st_mode &= ~S_IFREG;
         st->st_mode |= S_IFDIR | S_IXUSR | S_IXGRP | S_IXOTH;
@@ -321,7 +375,7 @@ int dfs_romfs_getdents(struct dfs_fd *file, struct dirent *dirp, uint32_t count)
     dirent = (struct romfs_dirent *)file->data;
     if (check_dirent(dirent) != 0)
         return -EIO;
-    RT_ASSERT(dirent->type == ROMFS_DIRENT_DIR);
+    RT_ASSERT(ROMFS_DIRENT_TYPE(dirent->type) == ROMFS_DIRENT_DIR);
 
     /* enter directory */
     dirent = (struct romfs_dirent *)(base_addr + (rt_uint32_t)dirent->data);
@@ -340,7 +394,7 @@ int dfs_romfs_getdents(struct dfs_fd *file, struct dirent *dirp, uint32_t count)
         name = base_addr + sub_dirent->name;
 
         /* fill dirent */
-        if (sub_dirent->type == ROMFS_DIRENT_DIR)
+        if (ROMFS_DIRENT_TYPE(sub_dirent->type) == ROMFS_DIRENT_DIR)
             d->d_type = DT_DIR;
         else
             d->d_type = DT_REG;
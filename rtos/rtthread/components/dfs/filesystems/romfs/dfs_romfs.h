@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2019/01/13     Bernard      code cleanup
+ * 2026-10-19     SiFli        add sorted and hashed directory index
  */
 
 #ifndef __DFS_ROMFS_H__
@@ -15,6 +16,23 @@
 
 #define ROMFS_DIRENT_FILE   0x00
 #define ROMFS_DIRENT_DIR    0x01
+#define ROMFS_DIRENT_HASH   0x02    /* hash table of a directory, see below */
+#define ROMFS_DIRENT_TYPE(t)    ((t) & 0x0f)
+
+/*
+ * Directory index flags, or'ed into the type of a directory dirent by
+ * "mkromfs.py --index". Images without them are searched linearly.
+ *
+ * ROMFS_DIRENT_SORTED: the entries are sorted by name (byte order), so
+ *     they can be binary searched.
+ * ROMFS_DIRENT_HASHED: the entry following the last one (at index "size")
+ *     is a ROMFS_DIRENT_HASH dirent. Its data is an open addressing table
+ *     of "size" rt_uint16_t slots (a power of 2), indexed by
+ *     romfs_name_hash() and probed linearly. A slot holds the entry index
+ *     plus 1, or 0 when it is empty.
+ */
+#define ROMFS_DIRENT_SORTED 0x10
+#define ROMFS_DIRENT_HASHED 0x20
 
 struct romfs_dirent
 {
@@ -26,6 +44,7 @@ struct romfs_dirent
 };
 
 int dfs_romfs_init(void);
+rt_uint32_t romfs_name_hash(const char *name, rt_size_t len);
 extern const struct romfs_dirent romfs_root;
 
 #endif
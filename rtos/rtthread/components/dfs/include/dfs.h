@@ -87,6 +87,7 @@ struct dfs_fdtable
 {
     uint32_t maxfd;
     struct dfs_fd **fds;
+    uint32_t used[(DFS_FD_MAX + 31) / 32];  /* bitmap of allocated fd entries */
 };
 
 /* Initialization of dfs */
@@ -106,6 +107,9 @@ int fd_is_open(const char *pathname);
 
 struct dfs_fdtable *dfs_fdtable_get(void);
 
+char *dfs_normalize_path_buf(const char *directory, const char *filename,
+                             char *buf, size_t size);
+
 #ifdef __cplusplus
 }
 #endif
@@ -42,7 +42,9 @@ struct dfs_fd
     uint16_t type;               /* Type (regular or socket) */
 
     char *path;                  /* Name (below mount point) */
+    uint32_t path_hash;          /* Hash of path, see dfs_path_hash() */
     int ref_count;               /* Descriptor reference count */
+    int index;                   /* Entry in the fd table */
 
     struct dfs_filesystem *fs;
     const struct dfs_file_ops *fops;
@@ -25,4 +25,30 @@ extern const struct dfs_mount_tbl mount_table[];
 
 extern char working_directory[];
 
+uint32_t dfs_path_hash(const char *path);
+
+#ifdef DFS_USING_LOOKUP_CACHE
+/* normalize path into a DFS_PATH_MAX buffer on the caller stack, no heap is used */
+#define DFS_PATH_BUF(name)              char name[DFS_PATH_MAX]
+#define DFS_PATH_NORMALIZE(name, path)  dfs_normalize_path_buf(NULL, path, name, sizeof(name))
+#define DFS_PATH_FREE(fullpath)
+#define DFS_PATH_DUP(fullpath)          rt_strdup(fullpath)
+
+struct stat;
+struct dfs_filesystem;
+
+int  dfs_lookup_cache_get(struct dfs_filesystem *fs, const char *path, struct stat *buf);
+void dfs_lookup_cache_put(struct dfs_filesystem *fs, const char *path, const struct stat *buf);
+void dfs_lookup_cache_invalidate(struct dfs_filesystem *fs, const char *path);
+#else
+#define DFS_PATH_BUF(name)
+#define DFS_PATH_NORMALIZE(name, path)  dfs_normalize_path(NULL, path)
+#define DFS_PATH_FREE(fullpath)         rt_free(fullpath)
+#define DFS_PATH_DUP(fullpath)          (fullpath)
+
+#define dfs_lookup_cache_get(fs, path, buf)         (-1)
+#define dfs_lookup_cache_put(fs, path, buf)         ((void)0)
+#define dfs_lookup_cache_invalidate(fs, path)       ((void)0)
+#endif /* DFS_USING_LOOKUP_CACHE */
+
 #endif
@@ -8,6 +8,7 @@
  * 2005-02-22     Bernard      The first version.
  * 2017-12-11     Bernard      Use rt_free to instead of free in fd_is_open().
  * 2018-03-20     Heyuanjie    dynamic allocation FD
+ * 2026-10-19     SiFli        bitmap fd allocation, normalize path into buffer
  */
 
 #include <dfs.h>
@@ -121,27 +122,46 @@ void dfs_unlock(void)
     rt_mutex_release(&fslock);
 }
 
+/* find the first free fd entry from startfd, DFS_FD_MAX if the table is full */
+static int fd_bitmap_find(struct dfs_fdtable *fdt, int startfd)
+{
+    int word;
+
+    for (word = startfd / 32; word < (DFS_FD_MAX + 31) / 32; word++)
+    {
+        uint32_t avail = ~fdt->used[word];
+
+        if (word == startfd / 32)
+            avail &= ~((1UL << (startfd % 32)) - 1);
+
+        if (avail)
+        {
+            int idx = word * 32 + __rt_ffs((int)avail) - 1;
+
+            return idx < DFS_FD_MAX ? idx : DFS_FD_MAX;
+        }
+    }
+
+    return DFS_FD_MAX;
+}
+
 static int fd_alloc(struct dfs_fdtable *fdt, int startfd)
 {
     int idx;
 
     /* find an empty fd entry */
-    for (idx = startfd; idx < (int)fdt->maxfd; idx++)
-    {
-        if (fdt->fds[idx] == RT_NULL)
-            break;
-        if (fdt->fds[idx]->ref_count == 0)
-            break;
-    }
+    idx = fd_bitmap_find(fdt, startfd);
+    if (idx == DFS_FD_MAX)
+        return fdt->maxfd;
 
     /* allocate a larger FD container */
-    if (idx == fdt->maxfd && fdt->maxfd < DFS_FD_MAX)
+    if (idx >= (int)fdt->maxfd)
     {
         int cnt, index;
         struct dfs_fd **fds;
 
         /* increase the number of FD with 4 step length */
-        cnt = fdt->maxfd + 4;
+        cnt = idx + 4;
         cnt = cnt > DFS_FD_MAX ? DFS_FD_MAX : cnt;
 
         fds = rt_realloc(fdt->fds, cnt * sizeof(struct dfs_fd *));
@@ -158,15 +178,20 @@ static int fd_alloc(struct dfs_fdtable *fdt, int startfd)
     }
 
     /* allocate  'struct dfs_fd' */
-    if (idx < (int)fdt->maxfd && fdt->fds[idx] == RT_NULL)
+    if (fdt->fds[idx] == RT_NULL)
     {
         fdt->fds[idx] = rt_calloc(1, sizeof(struct dfs_fd));
         if (fdt->fds[idx] == RT_NULL)
-            idx = fdt->maxfd;
+            return fdt->maxfd;
     }
+    fdt->fds[idx]->index = idx;
+
+    fdt->used[idx / 32] |= 1UL << (idx % 32);
 
-__exit:
     return idx;
+
+__exit:
+    return fdt->maxfd;
 }
 
 /**
@@ -262,23 +287,44 @@ void fd_put(struct dfs_fd *fd)
     /* clear this fd entry */
     if (fd->ref_count == 0)
     {
-        int index;
+        int index = fd->index;
         struct dfs_fdtable *fdt;
 
         fdt = dfs_fdtable_get();
-        for (index = 0; index < (int)fdt->maxfd; index ++)
+        if (index < (int)fdt->maxfd && fdt->fds[index] == fd)
         {
-            if (fdt->fds[index] == fd)
-            {
-                rt_free(fd);
-                fdt->fds[index] = 0;
-                break;
-            }
+            rt_free(fd);
+            fdt->fds[index] = 0;
+            fdt->used[index / 32] &= ~(1UL << (index % 32));
         }
     }
     dfs_unlock();
 }
 
+/**
+ * @ingroup Fd
+ *
+ * This function will return the hash of a path below mount point, the open
+ * files are told apart by it before their paths are compared.
+ *
+ * @param path the path below mount point.
+ *
+ * @return the hash of path.
+ */
+uint32_t dfs_path_hash(const char *path)
+{
+    /* FNV-1a */
+    uint32_t hash = 2166136261UL;
+
+    while (*path)
+    {
+        hash ^= (uint8_t) * path++;
+        hash *= 16777619UL;
+    }
+
+    return hash;
+}
+
 /**
  * @ingroup Fd
  *
@@ -292,12 +338,14 @@ int fd_is_open(const char *pathname)
 {
     char *fullpath;
     unsigned int index;
+    uint32_t hash;
     struct dfs_filesystem *fs;
     struct dfs_fd *fd;
     struct dfs_fdtable *fdt;
+    DFS_PATH_BUF(pathbuf);
 
     fdt = dfs_fdtable_get();
-    fullpath = dfs_normalize_path(NULL, pathname);
+    fullpath = DFS_PATH_NORMALIZE(pathbuf, pathname);
     if (fullpath != NULL)
     {
         char *mountpath;
@@ -305,7 +353,7 @@ int fd_is_open(const char *pathname)
         if (fs == NULL)
         {
             /* can't find mounted file system */
-            rt_free(fullpath);
+            DFS_PATH_FREE(fullpath);
 
             return -1;
         }
@@ -315,6 +363,7 @@ int fd_is_open(const char *pathname)
             mountpath = fullpath;
         else
             mountpath = fullpath + strlen(fs->path);
+        hash = dfs_path_hash(mountpath);
 
         dfs_lock();
 
@@ -323,10 +372,10 @@ int fd_is_open(const char *pathname)
             fd = fdt->fds[index];
             if (fd == NULL || fd->fops == NULL || fd->path == NULL) continue;
 
-            if (fd->fs == fs && strcmp(fd->path, mountpath) == 0)
+            if (fd->fs == fs && fd->path_hash == hash && strcmp(fd->path, mountpath) == 0)
             {
                 /* found file in file descriptor table */
-                rt_free(fullpath);
+                DFS_PATH_FREE(fullpath);
                 dfs_unlock();
 
                 return 0;
@@ -334,7 +383,7 @@ int fd_is_open(const char *pathname)
         }
         dfs_unlock();
 
-        rt_free(fullpath);
+        DFS_PATH_FREE(fullpath);
     }
 
     return -1;
@@ -365,22 +414,11 @@ const char *dfs_subdir(const char *directory, const char *filename)
 }
 RTM_EXPORT(dfs_subdir);
 
-/**
- * this function will normalize a path according to specified parent directory
- * and file name.
- *
- * @param directory the parent path
- * @param filename the file name
- *
- * @return the built full file path (absolute path)
- */
-char *dfs_normalize_path(const char *directory, const char *filename)
+/* join directory and filename into buf, NULL if it does not fit */
+static char *dfs_join_path(const char *directory, const char *filename,
+                           char *buf, size_t size)
 {
-    char *fullpath;
-    char *dst0, *dst, *src;
-
-    /* check parameters */
-    RT_ASSERT(filename != NULL);
+    size_t dirlen, namelen;
 
 #ifdef DFS_USING_WORKDIR
     if (directory == NULL) /* shall use working directory */
@@ -394,25 +432,34 @@ char *dfs_normalize_path(const char *directory, const char *filename)
     }
 #endif
 
+    namelen = strlen(filename);
     if (filename[0] != '/') /* it's a absolute path, use it directly */
     {
-        fullpath = rt_malloc(strlen(directory) + strlen(filename) + 2);
-
-        if (fullpath == NULL)
+        dirlen = strlen(directory);
+        if (dirlen + namelen + 2 > size)
             return NULL;
 
         /* join path and file name */
-        rt_snprintf(fullpath, strlen(directory) + strlen(filename) + 2,
-                    "%s/%s", directory, filename);
+        memcpy(buf, directory, dirlen);
+        buf[dirlen] = '/';
+        memcpy(buf + dirlen + 1, filename, namelen + 1);
     }
     else
     {
-        fullpath = rt_strdup(filename); /* copy string */
-
-        if (fullpath == NULL)
+        if (namelen + 1 > size)
             return NULL;
+
+        memcpy(buf, filename, namelen + 1); /* copy string */
     }
 
+    return buf;
+}
+
+/* remove '.', '..' and duplicated '/' in place, -1 if the path goes above root */
+static int dfs_normalize_inplace(char *fullpath)
+{
+    char *dst0, *dst, *src;
+
     src = fullpath;
     dst = fullpath;
 
@@ -474,8 +521,7 @@ up_one:
         dst --;
         if (dst < dst0)
         {
-            rt_free(fullpath);
-            return NULL;
+            return -1;
         }
         while (dst0 < dst && dst[-1] != '/')
             dst --;
@@ -484,9 +530,8 @@ up_one:
     *dst = '\0';
 
     /* remove '/' in the end of path if exist */
-    dst --;
-    if ((dst != fullpath) && (*dst == '/'))
-        *dst = '\0';
+    if ((dst > fullpath + 1) && (dst[-1] == '/'))
+        dst[-1] = '\0';
 
     /* final check fullpath is not empty, for the special path of lwext "/.." */
     if ('\0' == fullpath[0])
@@ -495,6 +540,73 @@ up_one:
         fullpath[1] = '\0';
     }
 
+    return 0;
+}
+
+/**
+ * this function will normalize a path into a caller supplied buffer, no
+ * memory is allocated.
+ *
+ * @param directory the parent path
+ * @param filename the file name
+ * @param buf the buffer to save the full path
+ * @param size the size of buffer, DFS_PATH_MAX is enough for any valid path
+ *
+ * @return buf on successful, NULL if the path is invalid or too long.
+ */
+char *dfs_normalize_path_buf(const char *directory, const char *filename,
+                             char *buf, size_t size)
+{
+    /* check parameters */
+    RT_ASSERT(filename != NULL);
+    RT_ASSERT(buf != NULL);
+
+    if (dfs_join_path(directory, filename, buf, size) == NULL)
+        return NULL;
+
+    if (dfs_normalize_inplace(buf) < 0)
+        return NULL;
+
+    return buf;
+}
+RTM_EXPORT(dfs_normalize_path_buf);
+
+/**
+ * this function will normalize a path according to specified parent directory
+ * and file name.
+ *
+ * @param directory the parent path
+ * @param filename the file name
+ *
+ * @return the built full file path (absolute path)
+ */
+char *dfs_normalize_path(const char *directory, const char *filename)
+{
+    char *fullpath;
+    size_t size;
+
+    /* check parameters */
+    RT_ASSERT(filename != NULL);
+
+#ifdef DFS_USING_WORKDIR
+    if (directory == NULL) /* shall use working directory */
+        directory = &working_directory[0];
+#endif
+
+    size = strlen(filename) + 2;
+    if (filename[0] != '/' && directory != NULL)
+        size += strlen(directory);
+
+    fullpath = rt_malloc(size);
+    if (fullpath == NULL)
+        return NULL;
+
+    if (dfs_normalize_path_buf(directory, filename, fullpath, size) == NULL)
+    {
+        rt_free(fullpath);
+        return NULL;
+    }
+
     return fullpath;
 }
 RTM_EXPORT(dfs_normalize_path);
@@ -9,6 +9,7 @@
  * 2011-12-08     Bernard      Merges rename patch from iamcacy.
  * 2015-05-27     Bernard      Fix the fd clear issue.
  * 2019-01-24     Bernard      Remove file repeatedly open check.
+ * 2026-10-19     SiFli        Normalize path on stack and use lookup cache.
  */
 
 #include <dfs.h>
@@ -35,13 +36,14 @@ int dfs_file_open(struct dfs_fd *fd, const char *path, int flags)
     struct dfs_filesystem *fs;
     char *fullpath;
     int result;
+    DFS_PATH_BUF(pathbuf);
 
     /* parameter check */
     if (fd == NULL)
         return -EINVAL;
 
     /* make sure we have an absolute path */
-    fullpath = dfs_normalize_path(NULL, path);
+    fullpath = DFS_PATH_NORMALIZE(pathbuf, path);
     if (fullpath == NULL)
     {
         return -ENOMEM;
@@ -53,7 +55,7 @@ int dfs_file_open(struct dfs_fd *fd, const char *path, int flags)
     fs = dfs_filesystem_lookup(fullpath);
     if (fs == NULL)
     {
-        rt_free(fullpath); /* release path */
+        DFS_PATH_FREE(fullpath); /* release path */
 
         return -ENOENT;
     }
@@ -75,14 +77,21 @@ int dfs_file_open(struct dfs_fd *fd, const char *path, int flags)
             fd->path = rt_strdup("/");
         else
             fd->path = rt_strdup(dfs_subdir(fs->path, fullpath));
-        rt_free(fullpath);
+        DFS_PATH_FREE(fullpath);
         LOG_D("Actual file path: %s", fd->path);
     }
     else
     {
-        fd->path = fullpath;
+        fd->path = DFS_PATH_DUP(fullpath);
     }
 
+    if (fd->path != NULL)
+        fd->path_hash = dfs_path_hash(fd->path);
+
+    /* the file may be created, truncated or written */
+    if ((flags & (O_ACCMODE | O_CREAT | O_TRUNC)) != O_RDONLY)
+        dfs_lookup_cache_invalidate(fs, fd->path);
+
     /* specific file system open routine */
     if (fd->fops->open == NULL)
     {
@@ -136,6 +145,10 @@ int dfs_file_close(struct dfs_fd *fd)
     if (result < 0)
         return result;
 
+    /* size and time of the file may have been changed */
+    if ((fd->flags & O_ACCMODE) != O_RDONLY)
+        dfs_lookup_cache_invalidate(fd->fs, fd->path);
+
     rt_free(fd->path);
     fd->path = NULL;
 
@@ -241,9 +254,10 @@ int dfs_file_unlink(const char *path)
     int result;
     char *fullpath;
     struct dfs_filesystem *fs;
+    DFS_PATH_BUF(pathbuf);
 
     /* Make sure we have an absolute path */
-    fullpath = dfs_normalize_path(NULL, path);
+    fullpath = DFS_PATH_NORMALIZE(pathbuf, path);
     if (fullpath == NULL)
     {
         return -EINVAL;
@@ -268,17 +282,26 @@ int dfs_file_unlink(const char *path)
         if (!(fs->ops->flags & DFS_FS_FLAG_FULLPATH))
         {
             if (dfs_subdir(fs->path, fullpath) == NULL)
+            {
+                dfs_lookup_cache_invalidate(fs, NULL);
                 result = fs->ops->unlink(fs, "/");
+            }
             else
+            {
+                dfs_lookup_cache_invalidate(fs, dfs_subdir(fs->path, fullpath));
                 result = fs->ops->unlink(fs, dfs_subdir(fs->path, fullpath));
+            }
         }
         else
+        {
+            dfs_lookup_cache_invalidate(fs, fullpath);
             result = fs->ops->unlink(fs, fullpath);
+        }
     }
     else result = -ENOSYS;
 
 __exit:
-    rt_free(fullpath);
+    DFS_PATH_FREE(fullpath);
     return result;
 }
 
@@ -359,9 +382,11 @@ int dfs_file_stat(const char *path, struct stat *buf)
 {
     int result;
     char *fullpath;
+    const char *subpath;
     struct dfs_filesystem *fs;
+    DFS_PATH_BUF(pathbuf);
 
-    fullpath = dfs_normalize_path(NULL, path);
+    fullpath = DFS_PATH_NORMALIZE(pathbuf, path);
     if (fullpath == NULL)
     {
         return -1;
@@ -371,7 +396,7 @@ int dfs_file_stat(const char *path, struct stat *buf)
     {
         LOG_E(
             "can't find mounted filesystem on this path:%s", fullpath);
-        rt_free(fullpath);
+        DFS_PATH_FREE(fullpath);
 
         return -ENOENT;
     }
@@ -390,7 +415,7 @@ int dfs_file_stat(const char *path, struct stat *buf)
         buf->st_mtime   = 0;
 
         /* release full path */
-        rt_free(fullpath);
+        DFS_PATH_FREE(fullpath);
 
         return RT_EOK;
     }
@@ -398,7 +423,7 @@ int dfs_file_stat(const char *path, struct stat *buf)
     {
         if (fs->ops->stat == NULL)
         {
-            rt_free(fullpath);
+            DFS_PATH_FREE(fullpath);
             LOG_E(
                 "the filesystem didn't implement this function");
 
@@ -407,12 +432,20 @@ int dfs_file_stat(const char *path, struct stat *buf)
 
         /* get the real file path and get file stat */
         if (fs->ops->flags & DFS_FS_FLAG_FULLPATH)
-            result = fs->ops->stat(fs, fullpath, buf);
+            subpath = fullpath;
         else
-            result = fs->ops->stat(fs, dfs_subdir(fs->path, fullpath), buf);
+            subpath = dfs_subdir(fs->path, fullpath);
+
+        result = dfs_lookup_cache_get(fs, subpath, buf);
+        if (result != 0)
+        {
+            result = fs->ops->stat(fs, subpath, buf);
+            if (result == 0)
+                dfs_lookup_cache_put(fs, subpath, buf);
+        }
     }
 
-    rt_free(fullpath);
+    DFS_PATH_FREE(fullpath);
 
     return result;
 }
@@ -461,12 +494,20 @@ int dfs_file_rename(const char *oldpath, const char *newpath)
         else
         {
             if (oldfs->ops->flags & DFS_FS_FLAG_FULLPATH)
+            {
+                dfs_lookup_cache_invalidate(oldfs, oldfullpath);
+                dfs_lookup_cache_invalidate(oldfs, newfullpath);
                 result = oldfs->ops->rename(oldfs, oldfullpath, newfullpath);
+            }
             else
+            {
+                dfs_lookup_cache_invalidate(oldfs, dfs_subdir(oldfs->path, oldfullpath));
+                dfs_lookup_cache_invalidate(oldfs, dfs_subdir(newfs->path, newfullpath));
                 /* use sub directory to rename in file system */
                 result = oldfs->ops->rename(oldfs,
                                             dfs_subdir(oldfs->path, oldfullpath),
                                             dfs_subdir(newfs->path, newfullpath));
+            }
         }
     }
     else
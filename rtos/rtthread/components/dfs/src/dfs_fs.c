@@ -410,6 +410,8 @@ int dfs_unmount(const char *specialfile)
         goto err1;
     }
 
+    dfs_lookup_cache_invalidate(fs, NULL);
+
     /* close device, but do not check the status of device */
     if (fs->dev_id != NULL)
         rt_device_close(fs->dev_id);
@@ -478,6 +480,9 @@ int dfs_mkfs(const char *fs_name, const char *device_name)
             return -1;
         }
 
+        /* the device may be mounted, all cached entries become stale */
+        dfs_lookup_cache_invalidate(NULL, NULL);
+
         return ops->mkfs(dev_id);
     }
 
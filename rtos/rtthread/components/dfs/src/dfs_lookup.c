@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     SiFli        The first version.
+ */
+
+#include <dfs.h>
+#include <dfs_fs.h>
+#include <dfs_file.h>
+#include "dfs_private.h"
+
+#ifdef DFS_USING_LOOKUP_CACHE
+
+/*
+ * Path lookup cache.
+ *
+ * The stat result of recently looked up paths is kept in a small 2-way set
+ * associative table keyed by (file system, path below mount point). The path
+ * string is interned once on insertion so a hit costs one hash and one
+ * strcmp. Entries are dropped on unlink/rename, when the file is opened for
+ * writing and when a writable descriptor of the file is closed.
+ */
+
+#ifndef DFS_LOOKUP_CACHE_SIZE
+    #define DFS_LOOKUP_CACHE_SIZE   32
+#endif
+
+#define DFS_LOOKUP_CACHE_WAYS       2
+#define DFS_LOOKUP_CACHE_SETS       (DFS_LOOKUP_CACHE_SIZE / DFS_LOOKUP_CACHE_WAYS)
+/* odd DFS_LOOKUP_CACHE_SIZE is rounded down */
+#define DFS_LOOKUP_CACHE_ENTRIES    (DFS_LOOKUP_CACHE_SETS * DFS_LOOKUP_CACHE_WAYS)
+
+struct dfs_lookup_entry
+{
+    struct dfs_filesystem *fs;
+    char *path;                  /* interned path below mount point */
+    uint32_t hash;
+    uint32_t stamp;              /* last access, the older way is replaced */
+    struct stat st;
+};
+
+static struct dfs_lookup_entry lookup_cache[DFS_LOOKUP_CACHE_SETS][DFS_LOOKUP_CACHE_WAYS];
+static uint32_t lookup_stamp;
+static uint32_t lookup_hit;
+static uint32_t lookup_miss;
+
+static uint32_t dfs_lookup_hash(struct dfs_filesystem *fs, const char *path)
+{
+    /* FNV-1a */
+    uint32_t hash = 2166136261UL ^ (uint32_t)(rt_ubase_t)fs;
+
+    while (*path)
+    {
+        hash ^= (uint8_t) * path++;
+        hash *= 16777619UL;
+    }
+
+    return hash;
+}
+
+static void dfs_lookup_entry_free(struct dfs_lookup_entry *entry)
+{
+    rt_free(entry->path);
+    entry->path = NULL;
+    entry->fs = NULL;
+}
+
+/* whether the file is opened for writing, its stat may change at any time */
+static int dfs_lookup_is_writing(struct dfs_filesystem *fs, const char *path)
+{
+    struct dfs_fdtable *fdt = dfs_fdtable_get();
+    uint32_t index;
+    uint32_t hash = dfs_path_hash(path);
+
+    for (index = 0; index < fdt->maxfd; index++)
+    {
+        struct dfs_fd *fd = fdt->fds[index];
+
+        if (fd == NULL || fd->fs != fs || fd->path == NULL || fd->path_hash != hash)
+            continue;
+
+        if ((fd->flags & O_ACCMODE) != O_RDONLY && strcmp(fd->path, path) == 0)
+            return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * this function will get the cached stat of a path.
+ *
+ * @param fs the file system of path.
+ * @param path the path below mount point.
+ * @param buf the buffer to save stat.
+ *
+ * @return 0 on cache hit, -1 on miss.
+ */
+int dfs_lookup_cache_get(struct dfs_filesystem *fs, const char *path, struct stat *buf)
+{
+    uint32_t hash = dfs_lookup_hash(fs, path);
+    struct dfs_lookup_entry *set = lookup_cache[hash % DFS_LOOKUP_CACHE_SETS];
+    int way, result = -1;
+
+    dfs_lock();
+    for (way = 0; way < DFS_LOOKUP_CACHE_WAYS; way++)
+    {
+        struct dfs_lookup_entry *entry = &set[way];
+
+        if (entry->path && entry->fs == fs && entry->hash == hash &&
+                strcmp(entry->path, path) == 0)
+        {
+            memcpy(buf, &entry->st, sizeof(struct stat));
+            entry->stamp = ++lookup_stamp;
+            result = 0;
+            break;
+        }
+    }
+
+    if (result == 0)
+        lookup_hit++;
+    else
+        lookup_miss++;
+    dfs_unlock();
+
+    return result;
+}
+
+/**
+ * this function will save the stat of a path into lookup cache.
+ *
+ * @param fs the file system of path.
+ * @param path the path below mount point.
+ * @param buf the stat got from file system.
+ */
+void dfs_lookup_cache_put(struct dfs_filesystem *fs, const char *path, const struct stat *buf)
+{
+    uint32_t hash = dfs_lookup_hash(fs, path);
+    struct dfs_lookup_entry *set = lookup_cache[hash % DFS_LOOKUP_CACHE_SETS];
+    struct dfs_lookup_entry *victim = &set[0];
+    int way;
+
+    dfs_lock();
+
+    if (dfs_lookup_is_writing(fs, path))
+        goto __exit;
+
+    for (way = 0; way < DFS_LOOKUP_CACHE_WAYS; way++)
+    {
+        struct dfs_lookup_entry *entry = &set[way];
+
+        if (entry->path == NULL)
+        {
+            victim = entry;
+            break;
+        }
+
+        if (entry->fs == fs && entry->hash == hash && strcmp(entry->path, path) == 0)
+        {
+            /* refresh it in place */
+            memcpy(&entry->st, buf, sizeof(struct stat));
+            entry->stamp = ++lookup_stamp;
+            goto __exit;
+        }
+
+        if ((lookup_stamp - entry->stamp) > (lookup_stamp - victim->stamp))
+            victim = entry;
+    }
+
+    if (victim->path)
+        dfs_lookup_entry_free(victim);
+
+    victim->path = rt_strdup(path);
+    if (victim->path != NULL)
+    {
+        victim->fs = fs;
+        victim->hash = hash;
+        victim->stamp = ++lookup_stamp;
+        memcpy(&victim->st, buf, sizeof(struct stat));
+    }
+
+__exit:
+    dfs_unlock();
+}
+
+/**
+ * this function will drop a path and everything below it from lookup cache.
+ *
+ * @param fs the file system of path, NULL to drop all entries.
+ * @param path the path below mount point, NULL to drop all entries of fs.
+ */
+void dfs_lookup_cache_invalidate(struct dfs_filesystem *fs, const char *path)
+{
+    struct dfs_lookup_entry *entry;
+    size_t len = path ? strlen(path) : 0;
+
+    dfs_lock();
+    for (entry = &lookup_cache[0][0];
+            entry < &lookup_cache[0][0] + DFS_LOOKUP_CACHE_ENTRIES; entry++)
+    {
+        if (entry->path == NULL)
+            continue;
+
+        if (fs != NULL && entry->fs != fs)
+            continue;
+
+        if (path != NULL && (strncmp(entry->path, path, len) != 0 ||
+                             (entry->path[len] != '\0' && entry->path[len] != '/' &&
+                              !(len == 1 && path[0] == '/'))))
+            continue;
+
+        dfs_lookup_entry_free(entry);
+    }
+    dfs_unlock();
+}
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+static int list_lookup(void)
+{
+    struct dfs_lookup_entry *entry;
+
+    dfs_lock();
+    rt_kprintf("lookup cache hit %d miss %d\n", lookup_hit, lookup_miss);
+    for (entry = &lookup_cache[0][0];
+            entry < &lookup_cache[0][0] + DFS_LOOKUP_CACHE_ENTRIES; entry++)
+    {
+        if (entry->path)
+            rt_kprintf("%-8.8s %s\n", entry->fs->path, entry->path);
+    }
+    dfs_unlock();
+
+    return 0;
+}
+MSH_CMD_EXPORT(list_lookup, list dfs path lookup cache);
+#endif
+
+#endif /* DFS_USING_LOOKUP_CACHE */
@@ -78,6 +78,17 @@
 #define RT_SERIAL_TX_DATAQUEUE_SIZE     2048
 #define RT_SERIAL_TX_DATAQUEUE_LWM      30
 
+#define RT_SERIAL_CTRL_TX_NONBLOCK      0x30    /* DMA TX ring: write returns when the ring is full */
+#define RT_SERIAL_CTRL_TX_STAT          0x31    /* DMA TX ring: get struct rt_serial_tx_stat */
+
+#ifndef RT_SERIAL_DMA_TX_RING_SIZE
+    #define RT_SERIAL_DMA_TX_RING_SIZE      2048
+#endif
+
+#ifndef RT_SERIAL_DMA_TX_RING_WRITES
+    #define RT_SERIAL_DMA_TX_RING_WRITES    16
+#endif
+
 #define RT_SERIAL_HWFC_NONE             0x00000000U                                    /*!< No hardware control       */
 #define RT_SERIAL_HWFC_RTS              1                                              /*!< Request To Send           */
 #define RT_SERIAL_HWFC_CTS              2                                              /*!< Clear To Send             */
@@ -149,6 +160,50 @@ struct rt_serial_tx_dma
     struct rt_data_queue data_queue;
 };
 
+/*
+ * Serial DMA TX ring mode, the writes are copied into a staging ring and
+ * whatever is pending when a transfer completes goes out in the next one.
+ */
+struct rt_serial_tx_stat
+{
+    rt_uint32_t writes;
+    rt_uint32_t bytes;
+    rt_uint32_t transfers;
+    rt_uint32_t full;           /* times a write found the ring full */
+    rt_uint32_t used_max;
+};
+
+struct rt_serial_tx_write
+{
+    const void *data;           /* for tx_complete, RT_NULL if not the last part */
+    rt_uint32_t left;           /* bytes not yet sent */
+};
+
+struct rt_serial_tx_ring
+{
+    struct rt_serial_tx_dma dma;    /* activated only, data_queue is not used */
+
+    rt_uint8_t *buf;
+    rt_uint32_t size;
+    rt_uint32_t get;            /* oldest byte not yet sent */
+    rt_uint32_t put;            /* next byte to reserve */
+    rt_uint32_t used;           /* reserved bytes, including the ones being sent */
+    rt_uint32_t ready;          /* bytes from get which are copied in */
+    rt_uint32_t inflight;       /* bytes of the running transfer */
+    rt_uint16_t reserving;      /* writers copying in */
+    rt_bool_t   nonblock;
+    rt_bool_t   waiting;
+
+    struct rt_serial_tx_write *writes;
+    rt_uint16_t write_num;
+    rt_uint16_t write_get;
+    rt_uint16_t write_cnt;
+
+    struct rt_semaphore lock;   /* one thread writing at a time */
+    struct rt_completion space;
+    struct rt_serial_tx_stat stat;
+};
+
 struct rt_serial_device
 {
     struct rt_device          parent;
@@ -158,6 +213,12 @@ struct rt_serial_device
 
     void *serial_rx;
     void *serial_tx;
+
+#ifdef RT_SERIAL_USING_DMA_TX_RING
+    /* DMA TX ring mode and statistics, kept over a standby suspend */
+    rt_bool_t tx_nonblock;
+    struct rt_serial_tx_stat tx_stat;
+#endif
 };
 typedef struct rt_serial_device rt_serial_t;
 
@@ -88,6 +88,71 @@ void rt_delayed_work_init(struct rt_delayed_work *work, void (*work_func)(struct
 struct rt_workqueue *rt_workqueue_init(struct rt_workqueue *queue);
 struct rt_workqueue *rt_workqueue_start(struct rt_workqueue *queue, const char *name, void *stack_start, rt_uint16_t stack_size, rt_uint8_t priority);
 
+#ifdef RT_USING_WORKQUEUE_POOL
+/**
+ * WorkQueue pool: several worker threads share prioritised lanes, so one
+ * slow work does not hold back the others.
+ */
+enum
+{
+    RT_WORK_LANE_HIGH = 0,
+    RT_WORK_LANE_NORMAL,
+    RT_WORK_LANE_LOW,
+    RT_WORK_LANE_NUM,
+};
+
+/* latency is from submit to start of work_func, all times in ticks */
+struct rt_work_stat
+{
+    rt_uint32_t count;
+    rt_uint32_t latency_sum;
+    rt_uint32_t latency_max;
+    rt_uint32_t exec_max;
+};
+
+struct rt_pool_work
+{
+    struct rt_work work;        /* work_func gets &pool_work->work */
+    rt_uint8_t lane;
+    /* works with the same non-zero key never run concurrently and run in
+       submit order, as long as they also use the same lane */
+    rt_uint32_t key;
+    rt_tick_t submit_tick;
+    struct rt_work_stat stat;
+};
+
+struct rt_workqueue_pool
+{
+    rt_list_t list;             /* in the list of all pools */
+    const char *name;
+    rt_list_t lane[RT_WORK_LANE_NUM];
+    struct rt_semaphore sem;    /* released once per submit */
+
+    rt_uint8_t worker_num;
+    rt_thread_t *worker;
+    struct rt_pool_work **worker_current;
+
+    rt_uint16_t pending;
+    rt_uint16_t pending_max;
+    struct rt_work_stat stat[RT_WORK_LANE_NUM];
+};
+
+struct rt_workqueue_pool *rt_workqueue_pool_create(const char *name, rt_uint8_t worker_num,
+        rt_uint16_t stack_size, rt_uint8_t priority);
+rt_err_t rt_workqueue_pool_destroy(struct rt_workqueue_pool *pool);
+rt_err_t rt_workqueue_pool_submit(struct rt_workqueue_pool *pool, struct rt_pool_work *work);
+rt_err_t rt_workqueue_pool_cancel(struct rt_workqueue_pool *pool, struct rt_pool_work *work);
+void rt_workqueue_pool_reset_stat(struct rt_workqueue_pool *pool);
+void rt_pool_work_init(struct rt_pool_work *work, void (*work_func)(struct rt_work *work, void *work_data),
+                       void *work_data, rt_uint8_t lane, rt_uint32_t key);
+
+#ifdef RT_USING_SYSTEM_WORKQUEUE_POOL
+    struct rt_workqueue_pool *rt_workqueue_pool_sys(void);
+    rt_err_t rt_pool_work_submit(struct rt_pool_work *work);
+    rt_err_t rt_pool_work_cancel(struct rt_pool_work *work);
+#endif
+#endif /* RT_USING_WORKQUEUE_POOL */
+
 
 #endif
 
@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2019-01-31     flybreak     first version
+ * 2026-10-19     SiFli        add batched streaming mode
  */
 
 #include "sensor.h"
@@ -51,6 +52,14 @@ static void rt_sensor_cb(rt_sensor_t sen)
         sen->irq_handle(sen);
     }
 
+#ifdef RT_SENSOR_USING_STREAM
+    /* irq_handle pushes the frames, rx_indicate is called on commit */
+    if (sen->stream != RT_NULL)
+    {
+        return;
+    }
+#endif
+
     /* The buffer is not empty. Read the data in the buffer first */
     if (sen->data_len > 0)
     {
@@ -232,6 +241,10 @@ static rt_err_t  rt_sensor_close(rt_device_t dev)
         rt_mutex_take(sensor->module->lock, RT_WAITING_FOREVER);
     }
 
+#ifdef RT_SENSOR_USING_STREAM
+    rt_sensor_stream_stop(sensor);
+#endif
+
     /* Configure power mode to power down mode */
     if (sensor->ops->control(sensor, RT_SENSOR_CTRL_SET_POWER, (void *)RT_SENSOR_POWER_DOWN) == RT_EOK)
     {
@@ -372,6 +385,22 @@ static rt_err_t rt_sensor_control(rt_device_t dev, int cmd, void *args)
         /* Device self-test */
         result = sensor->ops->control(sensor, RT_SENSOR_CTRL_SELF_TEST, args);
         break;
+#ifdef RT_SENSOR_USING_STREAM
+    case RT_SENSOR_CTRL_STREAM_START:
+
+        /* Allocate the frame ring and let the driver push frames to it */
+        result = rt_sensor_stream_start(sensor, (struct rt_sensor_stream_config *)args);
+        break;
+    case RT_SENSOR_CTRL_STREAM_STOP:
+        rt_sensor_stream_stop(sensor);
+        break;
+    case RT_SENSOR_CTRL_STREAM_STAT:
+        if (args)
+        {
+            rt_sensor_stream_get_stat(sensor, (struct rt_sensor_stream_stat *)args);
+        }
+        break;
+#endif
     default:
         result = -RT_ERROR;
     }
@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2019-01-31     flybreak     first version
+ * 2026-10-19     SiFli        add batched streaming mode
  */
 
 #ifndef __SENSOR_H__
@@ -109,6 +110,9 @@ extern "C" {
 #define  RT_SENSOR_CTRL_SET_MODE       (0x20 + 4)  /* Set sensor's work mode. ex. RT_SENSOR_MODE_POLLING,RT_SENSOR_MODE_INT */
 #define  RT_SENSOR_CTRL_SET_POWER      (0x20 + 5)  /* Set power mode. args type of sensor power mode. ex. RT_SENSOR_POWER_DOWN,RT_SENSOR_POWER_NORMAL */
 #define  RT_SENSOR_CTRL_SELF_TEST      (0x20 + 6)  /* Take a self test */
+#define  RT_SENSOR_CTRL_STREAM_START   (0x20 + 7)  /* Start batched streaming. args: struct rt_sensor_stream_config * */
+#define  RT_SENSOR_CTRL_STREAM_STOP    (0x20 + 8)  /* Stop batched streaming */
+#define  RT_SENSOR_CTRL_STREAM_STAT    (0x20 + 9)  /* Get streaming statistics. args: struct rt_sensor_stream_stat * */
 
 struct rt_sensor_info
 {
@@ -157,6 +161,10 @@ struct rt_sensor_device
     struct rt_sensor_module     *module;    /* The sensor module */
 
     rt_err_t (*irq_handle)(rt_sensor_t sensor);             /* Called when an interrupt is generated, registered by the driver */
+
+#ifdef RT_SENSOR_USING_STREAM
+    struct rt_sensor_stream     *stream;    /* The frame ring, while streaming */
+#endif
 };
 
 struct rt_sensor_module
@@ -211,6 +219,59 @@ struct rt_sensor_ops
     rt_err_t (*control)(struct rt_sensor_device *sensor, int cmd, void *arg);
 };
 
+#ifdef RT_SENSOR_USING_STREAM
+/*
+ * Batched streaming
+ *
+ * The driver copies a whole hardware FIFO read straight into a frame of
+ * the stream ring (rt_sensor_stream_reserve/commit) and the consumer
+ * handles the frames in place (rt_sensor_stream_peek/release). Samples
+ * are in the unit of the matching member of rt_sensor_data.data, e.g.
+ * struct sensor_3_axis for an accelerometer. rx_indicate is called with
+ * the number of new samples once "batch" samples are queued, or once the
+ * queued samples span "latency" microseconds, or when the ring is too full
+ * to take the next frame.
+ */
+struct rt_sensor_stream_config
+{
+    rt_uint32_t buf_size;       /* bytes of the frame ring, at least a frame of "batch" samples */
+    rt_uint16_t batch;          /* samples per indication */
+    rt_uint16_t sample_size;    /* bytes of a sample */
+    rt_uint32_t latency;        /* max. time span of queued samples before an indication, us. 0 = no limit */
+};
+
+struct rt_sensor_stream_stat
+{
+    rt_uint32_t frames;         /* frames committed */
+    rt_uint32_t samples;        /* samples committed */
+    rt_uint32_t dropped;        /* samples dropped because the ring was full */
+    rt_uint32_t indications;    /* rx_indicate calls */
+    rt_uint32_t used_max;       /* max. bytes used in the ring */
+};
+
+struct rt_sensor_frame
+{
+    rt_uint32_t timestamp;      /* time of the first sample, us, see rt_sensor_stream_ts() */
+    rt_uint32_t delta;          /* time between two samples, us */
+    rt_uint16_t count;          /* number of samples */
+    rt_uint16_t size;           /* bytes of a sample */
+};
+#define RT_SENSOR_FRAME_DATA(frame)     ((void *)((struct rt_sensor_frame *)(frame) + 1))
+
+rt_uint32_t rt_sensor_stream_ts(void);
+rt_err_t rt_sensor_stream_start(rt_sensor_t sensor, struct rt_sensor_stream_config *cfg);
+void rt_sensor_stream_stop(rt_sensor_t sensor);
+void rt_sensor_stream_get_stat(rt_sensor_t sensor, struct rt_sensor_stream_stat *stat);
+
+/* for drivers, one reservation at a time */
+void *rt_sensor_stream_reserve(rt_sensor_t sensor, rt_uint16_t count, rt_uint16_t size);
+void rt_sensor_stream_commit(rt_sensor_t sensor, rt_uint16_t count, rt_uint32_t timestamp, rt_uint32_t delta);
+
+/* for consumers */
+struct rt_sensor_frame *rt_sensor_stream_peek(rt_sensor_t sensor);
+void rt_sensor_stream_release(rt_sensor_t sensor, struct rt_sensor_frame *frame);
+#endif /* RT_SENSOR_USING_STREAM */
+
 int rt_hw_sensor_register(rt_sensor_t sensor,
                           const char              *name,
                           rt_uint32_t              flag,
@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     SiFli        the first version
+ */
+
+/*
+ * Simulated accelerometer "acce_sim" with a hardware FIFO, to test and
+ * measure the batched streaming mode without a real sensor, e.g. on the
+ * simulator. A hard timer plays the FIFO watermark interrupt. Sample n
+ * is {n, -n, 1000} mG, so a consumer can check for gaps.
+ */
+
+#include "sensor.h"
+
+#define DBG_TAG  "sensor.sim"
+#define DBG_LVL DBG_INFO
+#include <rtdbg.h>
+
+#define SIM_SENSOR_ID           0x5a
+#define SIM_SENSOR_FIFO_MAX     32
+#define SIM_SENSOR_ODR_MAX      8000
+
+struct sim_sensor
+{
+    struct rt_sensor_device sensor;
+    struct rt_timer timer;          /* the watermark interrupt */
+    rt_uint32_t seq;                /* value of the next sample */
+    rt_uint32_t next_ts;            /* timestamp of the next sample, us */
+    rt_uint32_t overrun;            /* samples lost in the hardware FIFO */
+};
+
+static struct sim_sensor sim_acce;
+
+static void sim_sensor_fill(struct sensor_3_axis *buf, rt_uint32_t seq, rt_uint32_t count)
+{
+    rt_uint32_t i;
+
+    for (i = 0; i < count; i++)
+    {
+        buf[i].x = seq + i;
+        buf[i].y = -(rt_int32_t)(seq + i);
+        buf[i].z = 1000;
+    }
+}
+
+static void sim_sensor_timeout(void *parameter)
+{
+    struct sim_sensor *sim = (struct sim_sensor *)parameter;
+    rt_uint32_t delta = 1000000 / sim->sensor.config.odr;
+    rt_uint32_t now = rt_sensor_stream_ts();
+    struct sensor_3_axis *buf;
+    rt_uint32_t count;
+
+    if ((rt_int32_t)(now - sim->next_ts) < 0)
+        return;
+
+    /* the samples the FIFO has collected since the last read */
+    count = (now - sim->next_ts) / delta + 1;
+    if (count > SIM_SENSOR_FIFO_MAX)
+    {
+        /* FIFO overrun, the oldest samples are gone */
+        sim->overrun += count - SIM_SENSOR_FIFO_MAX;
+        sim->seq += count - SIM_SENSOR_FIFO_MAX;
+        sim->next_ts += (count - SIM_SENSOR_FIFO_MAX) * delta;
+        count = SIM_SENSOR_FIFO_MAX;
+    }
+
+    buf = rt_sensor_stream_reserve(&sim->sensor, count, sizeof(struct sensor_3_axis));
+    if (buf)
+    {
+        sim_sensor_fill(buf, sim->seq, count);
+        rt_sensor_stream_commit(&sim->sensor, count, sim->next_ts, delta);
+    }
+
+    sim->seq += count;
+    sim->next_ts += count * delta;
+}
+
+static rt_size_t sim_sensor_fetch_data(struct rt_sensor_device *sensor, void *buf, rt_size_t len)
+{
+    struct sim_sensor *sim = (struct sim_sensor *)sensor;
+    struct rt_sensor_data *data = (struct rt_sensor_data *)buf;
+
+    data->type = RT_SENSOR_CLASS_ACCE;
+    data->timestamp = rt_sensor_get_ts();
+    sim_sensor_fill(&data->data.acce, sim->seq++, 1);
+
+    return 1;
+}
+
+static rt_err_t sim_sensor_control(struct rt_sensor_device *sensor, int cmd, void *args)
+{
+    struct sim_sensor *sim = (struct sim_sensor *)sensor;
+    struct rt_sensor_stream_config *cfg;
+    rt_uint32_t watermark, odr;
+    rt_tick_t period;
+    rt_err_t result = RT_EOK;
+
+    switch (cmd)
+    {
+    case RT_SENSOR_CTRL_GET_ID:
+        *(rt_uint8_t *)args = SIM_SENSOR_ID;
+        break;
+    case RT_SENSOR_CTRL_SET_ODR:
+        odr = (rt_uint32_t)args & 0xFFFF;
+        if (odr == 0 || odr > SIM_SENSOR_ODR_MAX || sensor->stream)
+            result = -RT_EINVAL;
+        break;
+    case RT_SENSOR_CTRL_SET_MODE:
+        if ((rt_uint32_t)args == RT_SENSOR_MODE_INT)
+            result = -RT_ERROR;
+        break;
+    case RT_SENSOR_CTRL_SET_RANGE:
+    case RT_SENSOR_CTRL_SET_POWER:
+    case RT_SENSOR_CTRL_SELF_TEST:
+        break;
+    case RT_SENSOR_CTRL_STREAM_START:
+        cfg = (struct rt_sensor_stream_config *)args;
+        odr = sensor->config.odr;
+
+        /* raise the watermark interrupt often enough for batch and latency */
+        watermark = cfg->batch < SIM_SENSOR_FIFO_MAX ? cfg->batch : SIM_SENSOR_FIFO_MAX;
+        if (cfg->latency && (rt_uint64_t)cfg->latency * odr / 1000000 < watermark)
+            watermark = (rt_uint64_t)cfg->latency * odr / 1000000;
+        if (watermark == 0)
+            watermark = 1;
+
+        period = rt_tick_from_millisecond(watermark * 1000 / odr);
+        if (period == 0)
+            period = 1;
+
+        sim->next_ts = rt_sensor_stream_ts();
+        sim->overrun = 0;
+        rt_timer_control(&sim->timer, RT_TIMER_CTRL_SET_TIME, &period);
+        rt_timer_start(&sim->timer);
+        LOG_D("stream odr %d, watermark %d, period %d ticks", odr, watermark, period);
+        break;
+    case RT_SENSOR_CTRL_STREAM_STOP:
+        rt_timer_stop(&sim->timer);
+        if (sim->overrun)
+            LOG_W("%d samples lost in FIFO", sim->overrun);
+        break;
+    default:
+        result = -RT_ERROR;
+        break;
+    }
+
+    return result;
+}
+
+static const struct rt_sensor_ops sim_sensor_ops =
+{
+    sim_sensor_fetch_data,
+    sim_sensor_control
+};
+
+int rt_hw_sim_sensor_init(void)
+{
+    struct sim_sensor *sim = &sim_acce;
+    rt_tick_t period = 1;
+
+    sim->sensor.info.type       = RT_SENSOR_CLASS_ACCE;
+    sim->sensor.info.vendor     = RT_SENSOR_VENDOR_UNKNOWN;
+    sim->sensor.info.model      = "sim";
+    sim->sensor.info.unit       = RT_SENSOR_UNIT_MG;
+    sim->sensor.info.intf_type  = 0;
+    sim->sensor.info.range_max  = 16000;
+    sim->sensor.info.range_min  = -16000;
+    sim->sensor.info.period_min = 1;
+    sim->sensor.info.fifo_max   = SIM_SENSOR_FIFO_MAX;
+
+    sim->sensor.config.irq_pin.pin = RT_PIN_NONE;
+    sim->sensor.config.odr = 100;
+    sim->sensor.ops = &sim_sensor_ops;
+
+    rt_timer_init(&sim->timer, "sim_acce", sim_sensor_timeout, sim, period,
+                  RT_TIMER_FLAG_PERIODIC | RT_TIMER_FLAG_HARD_TIMER);
+
+    return rt_hw_sensor_register(&sim->sensor, "sim",
+                                 RT_DEVICE_FLAG_RDONLY | RT_DEVICE_FLAG_FIFO_RX, RT_NULL);
+}
+INIT_DEVICE_EXPORT(rt_hw_sim_sensor_init);
@@ -0,0 +1,296 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     SiFli        the first version
+ */
+
+#include <rthw.h>
+#include "sensor.h"
+
+#define DBG_TAG  "sensor.stream"
+#define DBG_LVL DBG_INFO
+#include <rtdbg.h>
+
+/*
+ * Frames are never split: when a frame does not fit at the end of the ring
+ * the writer wraps to 0 and "end" marks where the data before the wrap
+ * stops. Data is in [tail, head), or in [tail, end) and [0, head) once the
+ * writer has wrapped.
+ */
+struct rt_sensor_stream
+{
+    rt_uint8_t  *buf;
+    rt_uint32_t  size;
+    rt_uint32_t  head;
+    rt_uint32_t  tail;
+    rt_uint32_t  end;
+    rt_uint32_t  used;
+    rt_bool_t    wrapped;
+
+    rt_uint32_t  resv;          /* offset of the reserved frame */
+    rt_bool_t    resv_wrap;     /* the reserved frame wraps the writer */
+    rt_uint16_t  resv_count;
+
+    rt_uint16_t  batch;
+    rt_uint32_t  latency;
+    rt_uint32_t  pending;       /* samples committed but not indicated */
+    rt_uint32_t  pending_ts;    /* timestamp of the first of them */
+
+    struct rt_sensor_stream_stat stat;
+};
+
+#define FRAME_LEN(count, size)  RT_ALIGN(sizeof(struct rt_sensor_frame) + (rt_uint32_t)(count) * (size), 4)
+
+RT_WEAK rt_uint32_t rt_sensor_stream_ts(void)
+{
+    return rt_tick_get() * (1000000 / RT_TICK_PER_SECOND);
+}
+
+rt_err_t rt_sensor_stream_start(rt_sensor_t sensor, struct rt_sensor_stream_config *cfg)
+{
+    struct rt_sensor_stream *stream;
+    rt_uint32_t size;
+    rt_base_t level;
+    rt_err_t result;
+
+    RT_ASSERT(sensor != RT_NULL);
+
+    if (cfg == RT_NULL || cfg->batch == 0 || cfg->sample_size == 0)
+        return -RT_EINVAL;
+    if (sensor->stream != RT_NULL)
+        return -RT_EBUSY;
+
+    size = RT_ALIGN_DOWN(cfg->buf_size, 4);
+    if (size < FRAME_LEN(cfg->batch, cfg->sample_size))
+        return -RT_EINVAL;
+
+    stream = (struct rt_sensor_stream *)rt_malloc(sizeof(struct rt_sensor_stream) + size);
+    if (stream == RT_NULL)
+        return -RT_ENOMEM;
+
+    rt_memset(stream, 0, sizeof(struct rt_sensor_stream));
+    stream->buf = (rt_uint8_t *)(stream + 1);
+    stream->size = size;
+    stream->end = size;
+    stream->batch = cfg->batch;
+    stream->latency = cfg->latency;
+
+    level = rt_hw_interrupt_disable();
+    sensor->stream = stream;
+    rt_hw_interrupt_enable(level);
+
+    /* let the driver set up its hardware FIFO watermark */
+    result = sensor->ops->control(sensor, RT_SENSOR_CTRL_STREAM_START, cfg);
+    if (result != RT_EOK)
+    {
+        level = rt_hw_interrupt_disable();
+        sensor->stream = RT_NULL;
+        rt_hw_interrupt_enable(level);
+        rt_free(stream);
+        return result;
+    }
+
+    LOG_D("%s stream %d bytes, batch %d, latency %d us", sensor->parent.parent.name,
+          size, cfg->batch, cfg->latency);
+
+    return RT_EOK;
+}
+
+void rt_sensor_stream_stop(rt_sensor_t sensor)
+{
+    struct rt_sensor_stream *stream;
+    rt_base_t level;
+
+    RT_ASSERT(sensor != RT_NULL);
+
+    if (sensor->stream == RT_NULL)
+        return;
+
+    sensor->ops->control(sensor, RT_SENSOR_CTRL_STREAM_STOP, RT_NULL);
+
+    level = rt_hw_interrupt_disable();
+    stream = sensor->stream;
+    sensor->stream = RT_NULL;
+    rt_hw_interrupt_enable(level);
+
+    rt_free(stream);
+}
+
+void rt_sensor_stream_get_stat(rt_sensor_t sensor, struct rt_sensor_stream_stat *stat)
+{
+    rt_base_t level;
+
+    RT_ASSERT(sensor != RT_NULL);
+    RT_ASSERT(stat != RT_NULL);
+
+    level = rt_hw_interrupt_disable();
+    if (sensor->stream)
+        rt_memcpy(stat, &sensor->stream->stat, sizeof(*stat));
+    else
+        rt_memset(stat, 0, sizeof(*stat));
+    rt_hw_interrupt_enable(level);
+}
+
+void *rt_sensor_stream_reserve(rt_sensor_t sensor, rt_uint16_t count, rt_uint16_t size)
+{
+    struct rt_sensor_stream *stream = sensor->stream;
+    struct rt_sensor_frame *frame;
+    rt_uint32_t need, indicate;
+    rt_base_t level;
+
+    if (stream == RT_NULL || count == 0)
+        return RT_NULL;
+
+    need = FRAME_LEN(count, size);
+
+    level = rt_hw_interrupt_disable();
+    if (stream->used == 0)
+    {
+        /* empty, start over to have the largest room */
+        stream->head = stream->tail = 0;
+        stream->end = stream->size;
+        stream->wrapped = RT_FALSE;
+    }
+
+    stream->resv_wrap = RT_FALSE;
+    if (!stream->wrapped && stream->size - stream->head >= need)
+    {
+        stream->resv = stream->head;
+    }
+    else if (!stream->wrapped && stream->tail >= need)
+    {
+        stream->resv = 0;
+        stream->resv_wrap = RT_TRUE;
+    }
+    else if (stream->wrapped && stream->tail - stream->head >= need)
+    {
+        stream->resv = stream->head;
+    }
+    else
+    {
+        stream->stat.dropped += count;
+        /* the ring may fill up before "batch" samples are queued, e.g. with
+           small frames, wake the consumer anyway or nothing is ever released */
+        indicate = stream->pending;
+        if (indicate)
+        {
+            stream->pending = 0;
+            stream->stat.indications ++;
+        }
+        rt_hw_interrupt_enable(level);
+
+        if (indicate && sensor->parent.rx_indicate)
+            sensor->parent.rx_indicate(&sensor->parent, indicate);
+        return RT_NULL;
+    }
+    stream->resv_count = count;
+    rt_hw_interrupt_enable(level);
+
+    frame = (struct rt_sensor_frame *)(stream->buf + stream->resv);
+    frame->size = size;
+
+    return RT_SENSOR_FRAME_DATA(frame);
+}
+
+void rt_sensor_stream_commit(rt_sensor_t sensor, rt_uint16_t count, rt_uint32_t timestamp, rt_uint32_t delta)
+{
+    struct rt_sensor_stream *stream = sensor->stream;
+    struct rt_sensor_frame *frame;
+    rt_uint32_t len, indicate = 0;
+    rt_base_t level;
+
+    if (stream == RT_NULL || stream->resv_count == 0)
+        return;
+
+    RT_ASSERT(count <= stream->resv_count);
+    stream->resv_count = 0;
+    if (count == 0)
+        return;
+
+    frame = (struct rt_sensor_frame *)(stream->buf + stream->resv);
+    frame->timestamp = timestamp;
+    frame->delta = delta;
+    frame->count = count;
+    len = FRAME_LEN(count, frame->size);
+
+    level = rt_hw_interrupt_disable();
+    if (stream->resv_wrap)
+    {
+        stream->end = stream->head;
+        stream->wrapped = RT_TRUE;
+    }
+    stream->head = stream->resv + len;
+    stream->used += len;
+    if (stream->used > stream->stat.used_max)
+        stream->stat.used_max = stream->used;
+    stream->stat.frames ++;
+    stream->stat.samples += count;
+
+    if (stream->pending == 0)
+        stream->pending_ts = timestamp;
+    stream->pending += count;
+    if (stream->pending >= stream->batch ||
+            (stream->latency && timestamp + (count - 1) * delta - stream->pending_ts >= stream->latency))
+    {
+        indicate = stream->pending;
+        stream->pending = 0;
+        stream->stat.indications ++;
+    }
+    rt_hw_interrupt_enable(level);
+
+    if (indicate && sensor->parent.rx_indicate)
+        sensor->parent.rx_indicate(&sensor->parent, indicate);
+}
+
+struct rt_sensor_frame *rt_sensor_stream_peek(rt_sensor_t sensor)
+{
+    struct rt_sensor_stream *stream = sensor->stream;
+    struct rt_sensor_frame *frame = RT_NULL;
+    rt_base_t level;
+
+    if (stream == RT_NULL)
+        return RT_NULL;
+
+    level = rt_hw_interrupt_disable();
+    if (stream->used > 0)
+    {
+        if (stream->wrapped && stream->tail == stream->end)
+        {
+            stream->tail = 0;
+            stream->end = stream->size;
+            stream->wrapped = RT_FALSE;
+        }
+        frame = (struct rt_sensor_frame *)(stream->buf + stream->tail);
+    }
+    rt_hw_interrupt_enable(level);
+
+    return frame;
+}
+
+void rt_sensor_stream_release(rt_sensor_t sensor, struct rt_sensor_frame *frame)
+{
+    struct rt_sensor_stream *stream = sensor->stream;
+    rt_uint32_t len;
+    rt_base_t level;
+
+    if (stream == RT_NULL || frame == RT_NULL)
+        return;
+
+    RT_ASSERT((rt_uint8_t *)frame == stream->buf + stream->tail);
+    len = FRAME_LEN(frame->count, frame->size);
+
+    level = rt_hw_interrupt_disable();
+    stream->tail += len;
+    stream->used -= len;
+    if (stream->wrapped && stream->tail == stream->end)
+    {
+        stream->tail = 0;
+        stream->end = stream->size;
+        stream->wrapped = RT_FALSE;
+    }
+    rt_hw_interrupt_enable(level);
+}
@@ -547,6 +547,193 @@ rt_inline int _serial_dma_tx(struct rt_serial_device *serial, const rt_uint8_t *
         return 0;
     }
 }
+
+#ifdef RT_SERIAL_USING_DMA_TX_RING
+/*
+ * Take the bytes ready from "get" up to the end of the ring for the next
+ * transfer, if none is running. Interrupt is disabled.
+ */
+static rt_uint32_t _serial_tx_ring_next(struct rt_serial_tx_ring *ring, rt_uint32_t *start)
+{
+    rt_uint32_t len;
+
+    if (ring->dma.activated || ring->ready == 0)
+        return 0;
+
+    len = ring->size - ring->get;
+    if (len > ring->ready)
+        len = ring->ready;
+
+    *start = ring->get;
+    ring->inflight = len;
+    ring->dma.activated = RT_TRUE;
+    ring->stat.transfers ++;
+
+    return len;
+}
+
+/*
+ * Writes are split only when the ring is full. A thread waits for room
+ * unless the ring is set non blocking; a write from interrupt never waits.
+ * The bytes of a write are reserved first and copied in with interrupt
+ * enabled, they are handed to DMA once no writer is copying any more.
+ */
+static int _serial_dma_tx_ring(struct rt_serial_device *serial, const rt_uint8_t *data, int length)
+{
+    struct rt_serial_tx_ring *ring;
+    struct rt_serial_tx_write *write;
+    rt_uint32_t pos, len, first, start = 0;
+    rt_bool_t nonblock, in_isr;
+    rt_base_t level;
+    int sent = 0;
+
+    ring = (struct rt_serial_tx_ring *)(serial->serial_tx);
+    RT_ASSERT(ring != RT_NULL);
+
+    if (length <= 0)
+        return 0;
+
+    in_isr = rt_interrupt_get_nest() != 0;
+    nonblock = ring->nonblock || in_isr;
+    if (!in_isr)
+        rt_sem_take(&(ring->lock), RT_WAITING_FOREVER);
+
+    while (sent < length)
+    {
+        level = rt_hw_interrupt_disable();
+        if (ring->used == 0)
+        {
+            /* empty, start over for the longest transfer */
+            ring->get = ring->put = 0;
+        }
+
+        len = ring->size - ring->used;
+        if (len > (rt_uint32_t)(length - sent))
+            len = length - sent;
+        if (len == 0 || ring->write_cnt == ring->write_num)
+        {
+            ring->stat.full ++;
+            if (nonblock)
+            {
+                rt_hw_interrupt_enable(level);
+                break;
+            }
+
+            ring->waiting = RT_TRUE;
+            rt_completion_init(&(ring->space));
+            rt_hw_interrupt_enable(level);
+
+            rt_completion_wait(&(ring->space), RT_WAITING_FOREVER);
+            continue;
+        }
+
+        pos = ring->put;
+        ring->put = pos + len >= ring->size ? pos + len - ring->size : pos + len;
+        ring->used += len;
+        if (ring->used > ring->stat.used_max)
+            ring->stat.used_max = ring->used;
+        ring->reserving ++;
+
+        /* tx_complete is invoked with the last part of the write */
+        write = &(ring->writes[(ring->write_get + ring->write_cnt) % ring->write_num]);
+        write->data = (sent + len == (rt_uint32_t)length) ? data : RT_NULL;
+        write->left = len;
+        ring->write_cnt ++;
+        rt_hw_interrupt_enable(level);
+
+        first = ring->size - pos;
+        if (first > len)
+            first = len;
+        rt_memcpy(ring->buf + pos, data + sent, first);
+        rt_memcpy(ring->buf, data + sent + first, len - first);
+        sent += len;
+
+        level = rt_hw_interrupt_disable();
+        if (--ring->reserving == 0)
+            ring->ready = ring->used;
+        len = _serial_tx_ring_next(ring, &start);
+        rt_hw_interrupt_enable(level);
+
+        if (len)
+            serial->ops->dma_transmit(serial, ring->buf + start, len, RT_SERIAL_DMA_TX);
+    }
+
+    level = rt_hw_interrupt_disable();
+    ring->stat.writes ++;
+    ring->stat.bytes += sent;
+    rt_hw_interrupt_enable(level);
+
+    if (!in_isr)
+        rt_sem_release(&(ring->lock));
+
+    if (sent == 0)
+        rt_set_errno(-RT_EFULL);
+
+    return sent;
+}
+
+static void _serial_dma_tx_ring_done(struct rt_serial_device *serial)
+{
+    struct rt_serial_tx_ring *ring;
+    struct rt_serial_tx_write *write;
+    rt_uint32_t done, start = 0, len, i, idx;
+    const void *data;
+    rt_bool_t wakeup;
+    rt_base_t level;
+
+    ring = (struct rt_serial_tx_ring *)(serial->serial_tx);
+    RT_ASSERT(ring != RT_NULL);
+
+    level = rt_hw_interrupt_disable();
+    done = ring->inflight;
+    ring->inflight = 0;
+    ring->get = ring->get + done >= ring->size ? ring->get + done - ring->size : ring->get + done;
+    ring->used -= done;
+    ring->ready -= done;
+    ring->dma.activated = RT_FALSE;
+
+    /* hand the sent bytes to the writes they belong to */
+    idx = ring->write_get;
+    for (i = 0; done && i < ring->write_cnt; i++)
+    {
+        write = &(ring->writes[idx]);
+        len = write->left < done ? write->left : done;
+        write->left -= len;
+        done -= len;
+        idx = idx + 1 == ring->write_num ? 0 : idx + 1;
+    }
+
+    /* keep DMA busy with what was written meanwhile */
+    len = _serial_tx_ring_next(ring, &start);
+    rt_hw_interrupt_enable(level);
+
+    if (len)
+        serial->ops->dma_transmit(serial, ring->buf + start, len, RT_SERIAL_DMA_TX);
+
+    /* the finished writes, in order, a nested completion may take some first */
+    while (1)
+    {
+        level = rt_hw_interrupt_disable();
+        if (ring->write_cnt == 0 || ring->writes[ring->write_get].left)
+        {
+            wakeup = ring->waiting;
+            ring->waiting = RT_FALSE;
+            rt_hw_interrupt_enable(level);
+            break;
+        }
+        data = ring->writes[ring->write_get].data;
+        ring->write_get = ring->write_get + 1 == ring->write_num ? 0 : ring->write_get + 1;
+        ring->write_cnt --;
+        rt_hw_interrupt_enable(level);
+
+        if (data && serial->parent.tx_complete != RT_NULL)
+            serial->parent.tx_complete(&serial->parent, (void *)data);
+    }
+
+    if (wakeup)
+        rt_completion_done(&(ring->space));
+}
+#endif /* RT_SERIAL_USING_DMA_TX_RING */
 #endif /* RT_SERIAL_USING_DMA */
 
 /* RT-Thread Device Interface */
@@ -564,6 +751,10 @@ static rt_err_t rt_serial_init(struct rt_device *dev)
     /* initialize rx/tx */
     serial->serial_rx = RT_NULL;
     serial->serial_tx = RT_NULL;
+#ifdef RT_SERIAL_USING_DMA_TX_RING
+    serial->tx_nonblock = RT_FALSE;
+    rt_memset(&(serial->tx_stat), 0, sizeof(serial->tx_stat));
+#endif
 
     /* apply configuration */
     if (serial->ops->configure)
@@ -686,6 +877,26 @@ static rt_err_t rt_serial_open(struct rt_device *dev, rt_uint16_t oflag)
 #ifdef RT_SERIAL_USING_DMA
         else if (oflag & RT_DEVICE_FLAG_DMA_TX)
         {
+#ifdef RT_SERIAL_USING_DMA_TX_RING
+            struct rt_serial_tx_ring *ring;
+
+            ring = (struct rt_serial_tx_ring *) rt_malloc(sizeof(struct rt_serial_tx_ring) +
+                    RT_SERIAL_DMA_TX_RING_WRITES * sizeof(struct rt_serial_tx_write) +
+                    RT_SERIAL_DMA_TX_RING_SIZE);
+            RT_ASSERT(ring != RT_NULL);
+            rt_memset(ring, 0, sizeof(struct rt_serial_tx_ring));
+            ring->dma.activated = RT_FALSE;
+            ring->writes = (struct rt_serial_tx_write *)(ring + 1);
+            ring->write_num = RT_SERIAL_DMA_TX_RING_WRITES;
+            ring->buf = (rt_uint8_t *)(ring->writes + RT_SERIAL_DMA_TX_RING_WRITES);
+            ring->size = RT_SERIAL_DMA_TX_RING_SIZE;
+            rt_sem_init(&(ring->lock), "serial_tx", 1, RT_IPC_FLAG_FIFO);
+            rt_completion_init(&(ring->space));
+            /* as before a standby suspend, cleared on close */
+            ring->nonblock = serial->tx_nonblock;
+            ring->stat = serial->tx_stat;
+            serial->serial_tx = ring;
+#else
             struct rt_serial_tx_dma *tx_dma;
 
             tx_dma = (struct rt_serial_tx_dma *) rt_malloc(sizeof(struct rt_serial_tx_dma));
@@ -694,6 +905,7 @@ static rt_err_t rt_serial_open(struct rt_device *dev, rt_uint16_t oflag)
 
             rt_data_queue_init(&(tx_dma->data_queue), 8, 4, RT_NULL);
             serial->serial_tx = tx_dma;
+#endif /* RT_SERIAL_USING_DMA_TX_RING */
 
             dev->open_flag |= RT_DEVICE_FLAG_DMA_TX;
             /* configure low level device */
@@ -773,6 +985,11 @@ static rt_err_t rt_serial_close(struct rt_device *dev)
         RT_ASSERT(tx_dma != RT_NULL);
 
         //TODO: Free all data in tx_dma->data_queue, see RT-Thread 4.x
+#ifdef RT_SERIAL_USING_DMA_TX_RING
+        rt_sem_detach(&(((struct rt_serial_tx_ring *)tx_dma)->lock));
+        serial->tx_nonblock = RT_FALSE;
+        rt_memset(&(serial->tx_stat), 0, sizeof(serial->tx_stat));
+#endif
         rt_free(tx_dma);
         serial->serial_tx = RT_NULL;
 
@@ -827,7 +1044,11 @@ static rt_size_t rt_serial_write(struct rt_device *dev,
 #ifdef RT_SERIAL_USING_DMA
     else if (dev->open_flag & RT_DEVICE_FLAG_DMA_TX)
     {
+#ifdef RT_SERIAL_USING_DMA_TX_RING
+        return _serial_dma_tx_ring(serial, buffer, size);
+#else
         return _serial_dma_tx(serial, buffer, size);
+#endif
     }
 #endif /* RT_SERIAL_USING_DMA */
     else
@@ -963,10 +1184,19 @@ static rt_err_t rt_serial_control(struct rt_device *dev,
                 if (dev->open_flag & RT_DEVICE_FLAG_DMA_TX)
                 {
                     struct rt_serial_tx_dma *tx_dma = serial->serial_tx;
+#ifdef RT_SERIAL_USING_DMA_TX_RING
+                    struct rt_serial_tx_ring *ring = (struct rt_serial_tx_ring *)tx_dma;
+
+                    /* the ring is allocated again on resume */
+                    serial->tx_nonblock = ring->nonblock;
+                    serial->tx_stat = ring->stat;
+                    rt_sem_detach(&(ring->lock));
+#else
                     if (tx_dma && tx_dma->data_queue.queue)
                     {
                         rt_free(tx_dma->data_queue.queue);
                     }
+#endif
                 }
 #endif /* RT_SERIAL_USING_DMA */
                 rt_free(serial->serial_tx);
@@ -1125,6 +1355,29 @@ static rt_err_t rt_serial_control(struct rt_device *dev,
         *(rt_size_t *)args = recved;
     }
     break;
+#endif
+#ifdef RT_SERIAL_USING_DMA_TX_RING
+    case RT_SERIAL_CTRL_TX_NONBLOCK:
+    case RT_SERIAL_CTRL_TX_STAT:
+    {
+        struct rt_serial_tx_ring *ring = (struct rt_serial_tx_ring *)serial->serial_tx;
+        rt_base_t level;
+
+        if (!(dev->open_flag & RT_DEVICE_FLAG_DMA_TX) || ring == RT_NULL)
+            return -RT_ENOSYS;
+
+        if (cmd == RT_SERIAL_CTRL_TX_NONBLOCK)
+        {
+            ring->nonblock = args ? RT_TRUE : RT_FALSE;
+        }
+        else if (args)
+        {
+            level = rt_hw_interrupt_disable();
+            rt_memcpy(args, &(ring->stat), sizeof(struct rt_serial_tx_stat));
+            rt_hw_interrupt_enable(level);
+        }
+    }
+    break;
 #endif
     default :
         /* control device */
@@ -1257,6 +1510,9 @@ __ROM_USED void rt_hw_serial_isr(struct rt_serial_device *serial, int event)
 #ifdef RT_SERIAL_USING_DMA
     case RT_SERIAL_EVENT_TX_DMADONE:
     {
+#ifdef RT_SERIAL_USING_DMA_TX_RING
+        _serial_dma_tx_ring_done(serial);
+#else
         const void *data_ptr;
         rt_size_t data_size;
         const void *last_data_ptr;
@@ -1281,6 +1537,7 @@ __ROM_USED void rt_hw_serial_isr(struct rt_serial_device *serial, int event)
         {
             serial->parent.tx_complete(&serial->parent, (void *)last_data_ptr);
         }
+#endif /* RT_SERIAL_USING_DMA_TX_RING */
         break;
     }
     case RT_SERIAL_EVENT_RX_DMADONE:
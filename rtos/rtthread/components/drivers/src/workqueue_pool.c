@@ -0,0 +1,344 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     SiFli        the first version
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+#include <rtdevice.h>
+
+#if defined(RT_USING_WORKQUEUE_POOL) && defined(RT_USING_HEAP)
+
+static rt_list_t _pool_list = RT_LIST_OBJECT_INIT(_pool_list);
+
+rt_inline void _work_stat_add(struct rt_work_stat *stat, rt_uint32_t latency, rt_uint32_t exec)
+{
+    stat->count ++;
+    stat->latency_sum += latency;
+    if (latency > stat->latency_max)
+        stat->latency_max = latency;
+    if (exec > stat->exec_max)
+        stat->exec_max = exec;
+}
+
+static rt_bool_t _pool_key_busy(struct rt_workqueue_pool *pool, rt_uint32_t key)
+{
+    rt_uint8_t i;
+
+    if (key == 0)
+        return RT_FALSE;
+
+    for (i = 0; i < pool->worker_num; i++)
+    {
+        if (pool->worker_current[i] && pool->worker_current[i]->key == key)
+            return RT_TRUE;
+    }
+
+    return RT_FALSE;
+}
+
+/* first work of the highest lane which may run now, interrupt is disabled */
+static struct rt_pool_work *_pool_pick(struct rt_workqueue_pool *pool)
+{
+    struct rt_pool_work *work;
+    int lane;
+
+    for (lane = 0; lane < RT_WORK_LANE_NUM; lane++)
+    {
+        rt_list_for_each_entry(work, &(pool->lane[lane]), work.list)
+        {
+            /* a resubmitted work must not run twice at the same time */
+            if (work->work.flags & RT_WORK_STATE_RUNNING)
+                continue;
+            if (_pool_key_busy(pool, work->key))
+                continue;
+
+            return work;
+        }
+    }
+
+    return RT_NULL;
+}
+
+static void _pool_worker_entry(void *parameter)
+{
+    struct rt_workqueue_pool *pool;
+    struct rt_pool_work *work;
+    rt_tick_t start, latency, exec;
+    rt_base_t level;
+    rt_uint8_t id, lane;
+
+    pool = (struct rt_workqueue_pool *)parameter;
+    RT_ASSERT(pool != RT_NULL);
+
+    for (id = 0; pool->worker[id] != rt_thread_self(); id++);
+
+    while (1)
+    {
+        rt_sem_take(&(pool->sem), RT_WAITING_FOREVER);
+
+        /* keep on picking until nothing is runnable, the statistics of a
+           finished work are updated in the same critical section */
+        level = rt_hw_interrupt_disable();
+        while ((work = _pool_pick(pool)) != RT_NULL)
+        {
+            rt_list_remove(&(work->work.list));
+            work->work.flags &= ~RT_WORK_STATE_PENDING;
+            work->work.flags |= RT_WORK_STATE_RUNNING;
+            pool->worker_current[id] = work;
+            pool->pending --;
+            lane = work->lane;
+            start = rt_tick_get();
+            latency = start - work->submit_tick;
+            rt_hw_interrupt_enable(level);
+
+            /* do work */
+            work->work.work_func(&(work->work), work->work.work_data);
+
+            exec = rt_tick_get() - start;
+            level = rt_hw_interrupt_disable();
+            work->work.flags &= ~RT_WORK_STATE_RUNNING;
+            pool->worker_current[id] = RT_NULL;
+            _work_stat_add(&(work->stat), latency, exec);
+            _work_stat_add(&(pool->stat[lane]), latency, exec);
+        }
+        rt_hw_interrupt_enable(level);
+    }
+}
+
+void rt_pool_work_init(struct rt_pool_work *work, void (*work_func)(struct rt_work *work, void *work_data),
+                       void *work_data, rt_uint8_t lane, rt_uint32_t key)
+{
+    RT_ASSERT(work != RT_NULL);
+    RT_ASSERT(lane < RT_WORK_LANE_NUM);
+
+    rt_work_init(&(work->work), work_func, work_data);
+    work->lane = lane;
+    work->key = key;
+    work->submit_tick = 0;
+    rt_memset(&(work->stat), 0, sizeof(work->stat));
+}
+
+struct rt_workqueue_pool *rt_workqueue_pool_create(const char *name, rt_uint8_t worker_num,
+        rt_uint16_t stack_size, rt_uint8_t priority)
+{
+    struct rt_workqueue_pool *pool;
+    char thread_name[RT_NAME_MAX + 4];
+    rt_uint8_t i;
+    int lane;
+
+    RT_ASSERT(worker_num > 0);
+
+    pool = (struct rt_workqueue_pool *)RT_KERNEL_MALLOC(sizeof(struct rt_workqueue_pool) +
+            worker_num * (sizeof(rt_thread_t) + sizeof(struct rt_pool_work *)));
+    if (pool == RT_NULL)
+        return RT_NULL;
+
+    rt_memset(pool, 0, sizeof(struct rt_workqueue_pool));
+    pool->name = name;
+    for (lane = 0; lane < RT_WORK_LANE_NUM; lane++)
+        rt_list_init(&(pool->lane[lane]));
+    rt_sem_init(&(pool->sem), "wqpool", 0, RT_IPC_FLAG_FIFO);
+    pool->worker_num = worker_num;
+    pool->worker = (rt_thread_t *)(pool + 1);
+    pool->worker_current = (struct rt_pool_work **)(pool->worker + worker_num);
+
+    for (i = 0; i < worker_num; i++)
+    {
+        rt_snprintf(thread_name, sizeof(thread_name), "%s%d", name, i);
+        pool->worker[i] = rt_thread_create(thread_name, _pool_worker_entry, pool,
+                                           stack_size, priority, 10);
+        pool->worker_current[i] = RT_NULL;
+        if (pool->worker[i] == RT_NULL)
+        {
+            while (i--)
+                rt_thread_delete(pool->worker[i]);
+            rt_sem_detach(&(pool->sem));
+            RT_KERNEL_FREE(pool);
+            return RT_NULL;
+        }
+    }
+
+    rt_enter_critical();
+    rt_list_insert_before(&_pool_list, &(pool->list));
+    rt_exit_critical();
+
+    for (i = 0; i < worker_num; i++)
+        rt_thread_startup(pool->worker[i]);
+
+    return pool;
+}
+
+rt_err_t rt_workqueue_pool_destroy(struct rt_workqueue_pool *pool)
+{
+    rt_uint8_t i;
+    int lane;
+
+    RT_ASSERT(pool != RT_NULL);
+
+    rt_enter_critical();
+    rt_list_remove(&(pool->list));
+    for (lane = 0; lane < RT_WORK_LANE_NUM; lane++)
+    {
+        while (!rt_list_isempty(&(pool->lane[lane])))
+        {
+            struct rt_work *work = rt_list_entry(pool->lane[lane].next, struct rt_work, list);
+
+            rt_list_remove(&(work->list));
+            work->flags &= ~RT_WORK_STATE_PENDING;
+        }
+    }
+    rt_exit_critical();
+
+    for (i = 0; i < pool->worker_num; i++)
+        rt_thread_delete(pool->worker[i]);
+    rt_sem_detach(&(pool->sem));
+    RT_KERNEL_FREE(pool);
+
+    return RT_EOK;
+}
+
+rt_err_t rt_workqueue_pool_submit(struct rt_workqueue_pool *pool, struct rt_pool_work *work)
+{
+    rt_base_t level;
+    rt_bool_t wakeup;
+
+    RT_ASSERT(pool != RT_NULL);
+    RT_ASSERT(work != RT_NULL);
+    RT_ASSERT(work->lane < RT_WORK_LANE_NUM);
+
+    level = rt_hw_interrupt_disable();
+    if (work->work.flags & RT_WORK_STATE_PENDING)
+    {
+        rt_hw_interrupt_enable(level);
+        return -RT_EBUSY;
+    }
+
+    /* NOTE: the work MUST be initialized firstly */
+    rt_list_remove(&(work->work.list));
+    rt_list_insert_before(&(pool->lane[work->lane]), &(work->work.list));
+    work->work.flags |= RT_WORK_STATE_PENDING;
+    work->submit_tick = rt_tick_get();
+    if (++pool->pending > pool->pending_max)
+        pool->pending_max = pool->pending;
+
+    /* a worker keeps on picking works after every wakeup, so it is
+       enough to have one wakeup queued per worker */
+    wakeup = pool->sem.value < pool->worker_num;
+    rt_hw_interrupt_enable(level);
+
+    if (wakeup)
+        rt_sem_release(&(pool->sem));
+
+    return RT_EOK;
+}
+
+rt_err_t rt_workqueue_pool_cancel(struct rt_workqueue_pool *pool, struct rt_pool_work *work)
+{
+    rt_base_t level;
+    rt_err_t result = RT_EOK;
+
+    RT_ASSERT(pool != RT_NULL);
+    RT_ASSERT(work != RT_NULL);
+
+    level = rt_hw_interrupt_disable();
+    if (work->work.flags & RT_WORK_STATE_PENDING)
+    {
+        rt_list_remove(&(work->work.list));
+        work->work.flags &= ~RT_WORK_STATE_PENDING;
+        pool->pending --;
+    }
+    else if (work->work.flags & RT_WORK_STATE_RUNNING)
+    {
+        result = -RT_EBUSY;
+    }
+    rt_hw_interrupt_enable(level);
+
+    return result;
+}
+
+void rt_workqueue_pool_reset_stat(struct rt_workqueue_pool *pool)
+{
+    rt_base_t level;
+
+    RT_ASSERT(pool != RT_NULL);
+
+    level = rt_hw_interrupt_disable();
+    pool->pending_max = pool->pending;
+    rt_memset(pool->stat, 0, sizeof(pool->stat));
+    rt_hw_interrupt_enable(level);
+}
+
+#ifdef RT_USING_SYSTEM_WORKQUEUE_POOL
+static struct rt_workqueue_pool *sys_workq_pool;
+
+struct rt_workqueue_pool *rt_workqueue_pool_sys(void)
+{
+    return sys_workq_pool;
+}
+
+rt_err_t rt_pool_work_submit(struct rt_pool_work *work)
+{
+    return rt_workqueue_pool_submit(sys_workq_pool, work);
+}
+
+rt_err_t rt_pool_work_cancel(struct rt_pool_work *work)
+{
+    return rt_workqueue_pool_cancel(sys_workq_pool, work);
+}
+
+static int rt_work_sys_workqueue_pool_init(void)
+{
+    sys_workq_pool = rt_workqueue_pool_create("sys_wp", RT_SYSTEM_WORKQUEUE_POOL_WORKERS,
+                     RT_SYSTEM_WORKQUEUE_POOL_STACKSIZE,
+                     RT_SYSTEM_WORKQUEUE_POOL_PRIORITY);
+
+    return RT_EOK;
+}
+INIT_DEVICE_EXPORT(rt_work_sys_workqueue_pool_init);
+#endif
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+static void wqpool(int argc, char **argv)
+{
+    static const char *const lane_name[RT_WORK_LANE_NUM] = {"high", "normal", "low"};
+    struct rt_workqueue_pool *pool;
+    struct rt_work_stat *stat;
+    rt_bool_t reset;
+    int lane;
+
+    reset = argc > 1 && rt_strcmp(argv[1], "reset") == 0;
+
+    rt_enter_critical();
+    rt_list_for_each_entry(pool, &_pool_list, list)
+    {
+        if (reset)
+        {
+            rt_workqueue_pool_reset_stat(pool);
+            continue;
+        }
+
+        rt_kprintf("%s: %d workers, pending %d, max %d\n", pool->name,
+                   pool->worker_num, pool->pending, pool->pending_max);
+        for (lane = 0; lane < RT_WORK_LANE_NUM; lane++)
+        {
+            stat = &(pool->stat[lane]);
+            rt_kprintf("  %-6s count %8d latency avg %6d max %6d exec max %6d ticks\n",
+                       lane_name[lane], stat->count,
+                       stat->count ? stat->latency_sum / stat->count : 0,
+                       stat->latency_max, stat->exec_max);
+        }
+    }
+    rt_exit_critical();
+}
+MSH_CMD_EXPORT(wqpool, show workqueue pool statistics: wqpool [reset]);
+#endif
+
+#endif /* RT_USING_WORKQUEUE_POOL && RT_USING_HEAP */
@@ -0,0 +1,23 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     SiFli        the first version
+ */
+
+#include <rtthread.h>
+#include "bench_report.h"
+
+void bench_report(const char *name, rt_tick_t tick, rt_uint32_t ops, rt_uint32_t bytes)
+{
+    rt_uint32_t us = tick * (1000000 / RT_TICK_PER_SECOND);
+
+    rt_kprintf("%-12s %8d ops %8d ticks %6d.%03d us/op", name, ops, tick,
+               ops ? us / ops : 0, ops ? (us % ops) * 1000 / ops : 0);
+    if (bytes)
+        rt_kprintf(" %6d KB/s", us ? (rt_uint32_t)((rt_uint64_t)bytes * 1000 / 1024 * 1000 / us) : 0);
+    rt_kprintf("\n");
+}
@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     SiFli        the first version
+ */
+
+#ifndef BENCH_REPORT_H__
+#define BENCH_REPORT_H__
+
+#include <rtthread.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * print one line of a benchmark result: the operations done in "tick",
+ * the time per operation and, if "bytes" is not 0, the throughput.
+ */
+void bench_report(const char *name, rt_tick_t tick, rt_uint32_t ops, rt_uint32_t bytes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
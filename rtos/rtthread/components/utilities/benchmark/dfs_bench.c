@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     SiFli        the first version
+ */
+
+#include <rtthread.h>
+#include <stdlib.h>
+
+#if defined(RT_BENCHMARK_DFS) && defined(RT_USING_FINSH)
+#include <finsh.h>
+#include "bench_report.h"
+#include <dfs_posix.h>
+
+/*
+ * dfs_bench [dir] [count] [rounds]
+ *
+ * Create "count" small files below "dir", then stat and open/close them
+ * "rounds" times in random order, like a resource manager loading images and
+ * fonts on app launch. The files are removed at last.
+ */
+static int dfs_bench(int argc, char **argv)
+{
+    const char *dir = "/bench";
+    rt_uint32_t count = 200, rounds = 5;
+    rt_uint32_t i, r, fail = 0;
+    rt_tick_t start, tick;
+    char path[64];
+    struct stat st;
+    int fd;
+
+    if (argc > 1)
+        dir = argv[1];
+    if (argc > 2)
+        count = atoi(argv[2]);
+    if (argc > 3)
+        rounds = atoi(argv[3]);
+
+    mkdir(dir, 0);
+
+    start = rt_tick_get();
+    for (i = 0; i < count; i++)
+    {
+        rt_snprintf(path, sizeof(path), "%s/res/../img_%04d.bin", dir, i);
+        fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0);
+        if (fd < 0)
+        {
+            fail++;
+            continue;
+        }
+        write(fd, path, 16);
+        close(fd);
+    }
+    tick = rt_tick_get() - start;
+    bench_report("create", tick, count, 0);
+
+    srand(rt_tick_get());
+    start = rt_tick_get();
+    for (r = 0; r < rounds * count; r++)
+    {
+        rt_snprintf(path, sizeof(path), "%s/img_%04d.bin", dir, rand() % count);
+        if (stat(path, &st) < 0 || st.st_size != 16)
+            fail++;
+    }
+    tick = rt_tick_get() - start;
+    bench_report("stat", tick, rounds * count, 0);
+
+    start = rt_tick_get();
+    for (r = 0; r < rounds * count; r++)
+    {
+        rt_snprintf(path, sizeof(path), "./%s/img_%04d.bin", dir, rand() % count);
+        fd = open(path, O_RDONLY, 0);
+        if (fd < 0)
+        {
+            fail++;
+            continue;
+        }
+        close(fd);
+    }
+    tick = rt_tick_get() - start;
+    bench_report("open/close", tick, rounds * count, 0);
+
+    start = rt_tick_get();
+    for (i = 0; i < count; i++)
+    {
+        rt_snprintf(path, sizeof(path), "%s/img_%04d.bin", dir, i);
+        unlink(path);
+        /* the removed file must not be found any more */
+        if (stat(path, &st) == 0)
+            fail++;
+    }
+    tick = rt_tick_get() - start;
+    bench_report("unlink", tick, count, 0);
+
+    rt_kprintf("failed %d\n", fail);
+
+    return 0;
+}
+MSH_CMD_EXPORT(dfs_bench, dfs open/stat benchmark: dfs_bench [dir] [count] [rounds]);
+
+#endif /* RT_BENCHMARK_DFS && RT_USING_FINSH */
@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     SiFli        the first version
+ */
+
+#include <rtthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(RT_BENCHMARK_MEDIA_LIB) && defined(RT_USING_FINSH)
+#include <finsh.h>
+#include "bench_report.h"
+#include <dfs_posix.h>
+#include "media_lib.h"
+
+#define SONGS_PER_ALBUM     20
+#define PAGE_SIZE           20
+#define FRAME_LEN           417     /* MPEG1 layer 3, 128kbps, 44.1kHz */
+
+static int id3_text_frame(rt_uint8_t *p, const char *id, const char *text)
+{
+    int len = strlen(text) + 1;
+
+    memcpy(p, id, 4);
+    p[4] = 0;
+    p[5] = 0;
+    p[6] = len >> 8;
+    p[7] = len;
+    p[8] = 0;
+    p[9] = 0;
+    p[10] = 0;              /* ISO-8859-1 */
+    memcpy(p + 11, text, len - 1);
+    return 10 + len;
+}
+
+/* ID3v2.3 tag with title/artist/album and "frames" silent mp3 frames */
+static int write_song(const char *path, int i, int frames, rt_uint8_t *buf)
+{
+    char text[32];
+    int len, fd, ret = 0;
+
+    len = 10;
+    rt_snprintf(text, sizeof(text), "Song %d", (i * 7919) % 1000);
+    len += id3_text_frame(buf + len, "TIT2", text);
+    rt_snprintf(text, sizeof(text), "Artist %d", i % 17);
+    len += id3_text_frame(buf + len, "TPE1", text);
+    rt_snprintf(text, sizeof(text), "Album %d", i / SONGS_PER_ALBUM);
+    len += id3_text_frame(buf + len, "TALB", text);
+    memcpy(buf, "ID3\x03\x00\x00", 6);
+    buf[6] = 0;
+    buf[7] = 0;
+    buf[8] = (len - 10) >> 7;
+    buf[9] = (len - 10) & 0x7F;
+
+    fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0);
+    if (fd < 0)
+        return -1;
+    if (write(fd, buf, len) != len)
+        ret = -1;
+    memset(buf, 0, FRAME_LEN);
+    buf[0] = 0xFF;
+    buf[1] = 0xFB;
+    buf[2] = 0x90;
+    buf[3] = 0x00;
+    while (ret == 0 && frames-- > 0)
+    {
+        if (write(fd, buf, FRAME_LEN) != FRAME_LEN)
+            ret = -1;
+    }
+    close(fd);
+    return ret;
+}
+
+/*
+ * media_lib_bench [dir] [count]
+ *
+ * Create "count" mp3 files with ID3 tags below "dir", grouped in album
+ * folders, then time a full index build, a rescan of the unchanged library,
+ * a rescan after 10% of the files changed, paging through every sort order
+ * and lookups by path. The files are removed at last.
+ */
+static int media_lib_bench(int argc, char **argv)
+{
+    const char *dir = argc > 1 ? argv[1] : "/mlib_bench";
+    int count = argc > 2 ? atoi(argv[2]) : 200;
+    char path[64], index[64];
+    media_lib_stats_t stats;
+    media_lib_entry_t *entries;
+    media_lib_t lib;
+    rt_uint8_t *buf;
+    rt_tick_t start, tick;
+    int i, sort, pages = 0, fail = 0;
+
+    if (count <= 0)
+        return 0;
+    buf = rt_malloc(FRAME_LEN + 256);
+    entries = rt_malloc(PAGE_SIZE * sizeof(media_lib_entry_t));
+    if (!buf || !entries)
+        goto exit;
+    rt_snprintf(index, sizeof(index), "%s.mlib", dir);
+    unlink(index);
+    mkdir(dir, 0);
+
+    start = rt_tick_get();
+    for (i = 0; i < count; i++)
+    {
+        if (i % SONGS_PER_ALBUM == 0)
+        {
+            rt_snprintf(path, sizeof(path), "%s/album_%02d", dir, i / SONGS_PER_ALBUM);
+            mkdir(path, 0);
+        }
+        rt_snprintf(path, sizeof(path), "%s/album_%02d/track_%04d.mp3", dir, i / SONGS_PER_ALBUM, i);
+        if (write_song(path, i, 8, buf) != 0)
+            fail++;
+    }
+    tick = rt_tick_get() - start;
+    bench_report("create", tick, count, 0);
+
+    start = rt_tick_get();
+    if (media_lib_update(dir, index, &stats) != RT_EOK || stats.parsed != count)
+        fail++;
+    tick = rt_tick_get() - start;
+    bench_report("build", tick, count, 0);
+
+    start = rt_tick_get();
+    if (media_lib_update(dir, index, &stats) != RT_EOK || stats.parsed != 0 || stats.reused != count)
+        fail++;
+    tick = rt_tick_get() - start;
+    bench_report("rescan", tick, count, 0);
+
+    /* one more frame, so the size changes even if mtime resolution is coarse */
+    for (i = 0; i < count; i += 10)
+    {
+        rt_snprintf(path, sizeof(path), "%s/album_%02d/track_%04d.mp3", dir, i / SONGS_PER_ALBUM, i);
+        write_song(path, i, 9, buf);
+    }
+    start = rt_tick_get();
+    if (media_lib_update(dir, index, &stats) != RT_EOK || stats.parsed != (count + 9) / 10)
+        fail++;
+    tick = rt_tick_get() - start;
+    bench_report("update 10%", tick, count, 0);
+
+    lib = media_lib_open(index);
+    if (!lib)
+    {
+        fail++;
+        goto cleanup;
+    }
+    start = rt_tick_get();
+    for (sort = 0; sort < MEDIA_LIB_SORT_NUM; sort++)
+    {
+        for (i = 0; i < count; i += PAGE_SIZE)
+        {
+            if (media_lib_query(lib, sort, i, entries, PAGE_SIZE) <= 0)
+                fail++;
+            pages++;
+        }
+    }
+    tick = rt_tick_get() - start;
+    bench_report("page", tick, pages, 0);
+
+    srand(rt_tick_get());
+    start = rt_tick_get();
+    for (i = 0; i < 100; i++)
+    {
+        int n = rand() % count;
+
+        rt_snprintf(path, sizeof(path), "%s/album_%02d/track_%04d.mp3", dir, n / SONGS_PER_ALBUM, n);
+        if (media_lib_find(lib, path, entries) < 0 || strcmp(entries->path, path) != 0)
+            fail++;
+    }
+    tick = rt_tick_get() - start;
+    bench_report("find", tick, 100, 0);
+    media_lib_close(lib);
+
+cleanup:
+    for (i = 0; i < count; i++)
+    {
+        rt_snprintf(path, sizeof(path), "%s/album_%02d/track_%04d.mp3", dir, i / SONGS_PER_ALBUM, i);
+        unlink(path);
+        if (i % SONGS_PER_ALBUM == SONGS_PER_ALBUM - 1 || i == count - 1)
+        {
+            rt_snprintf(path, sizeof(path), "%s/album_%02d", dir, i / SONGS_PER_ALBUM);
+            rmdir(path);
+        }
+    }
+    rmdir(dir);
+    unlink(index);
+
+    rt_kprintf("failed %d\n", fail);
+
+exit:
+    if (buf)
+        rt_free(buf);
+    if (entries)
+        rt_free(entries);
+    return 0;
+}
+MSH_CMD_EXPORT(media_lib_bench, media library index benchmark: media_lib_bench [dir] [count]);
+
+#endif /* RT_BENCHMARK_MEDIA_LIB && RT_USING_FINSH */
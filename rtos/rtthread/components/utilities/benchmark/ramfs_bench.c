@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     SiFli        the first version
+ */
+
+#include <rtthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(RT_BENCHMARK_RAMFS) && defined(RT_USING_FINSH)
+#include <finsh.h>
+#include "bench_report.h"
+#include <dfs_posix.h>
+#include <dfs_fs.h>
+#include "dfs_ramfs.h"
+
+#define CHUNK_SIZE      512
+
+static void ramfs_bench_statfs(const char *dir, const char *when)
+{
+    struct statfs buf;
+
+    if (statfs(dir, &buf) == 0)
+        rt_kprintf("%-12s %d/%d blocks of %d bytes free\n", when,
+                   buf.f_bfree, buf.f_blocks, buf.f_bsize);
+}
+
+/*
+ * ramfs_bench [dir] [pool_kb] [files]
+ *
+ * Mount a ramfs of "pool_kb" on "dir", stream a file of half the pool size
+ * into it in small appends like a download or a recorder would, read it back,
+ * then create "files" files in a nested directory and stat them in random
+ * order. Everything is removed and unmounted at last.
+ */
+static int ramfs_bench(int argc, char **argv)
+{
+    const char *dir = "/ram_bench";
+    rt_uint32_t pool_kb = 256, files = 100;
+    rt_uint32_t i, total, done, fail = 0;
+    struct dfs_ramfs *ramfs;
+    rt_uint8_t *pool, *chunk;
+    rt_tick_t start, tick;
+    char path[64];
+    struct stat st;
+    int fd;
+
+    if (argc > 1)
+        dir = argv[1];
+    if (argc > 2)
+        pool_kb = atoi(argv[2]);
+    if (argc > 3)
+        files = atoi(argv[3]);
+
+    pool = rt_malloc(pool_kb * 1024);
+    chunk = rt_malloc(CHUNK_SIZE);
+    if (pool == RT_NULL || chunk == RT_NULL)
+    {
+        rt_kprintf("no memory\n");
+        goto __exit;
+    }
+
+    ramfs = dfs_ramfs_create(pool, pool_kb * 1024);
+    mkdir(dir, 0);
+    if (ramfs == RT_NULL || dfs_mount(RT_NULL, dir, "ram", 0, ramfs) != 0)
+    {
+        rt_kprintf("mount %s failed\n", dir);
+        goto __exit;
+    }
+    ramfs_bench_statfs(dir, "empty");
+
+    /* streaming append */
+    total = pool_kb * 1024 / 2;
+    rt_snprintf(path, sizeof(path), "%s/stream.bin", dir);
+    start = rt_tick_get();
+    fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0);
+    for (done = 0; fd >= 0 && done < total; done += CHUNK_SIZE)
+    {
+        memset(chunk, (rt_uint8_t)(done / CHUNK_SIZE), CHUNK_SIZE);
+        if (write(fd, chunk, CHUNK_SIZE) != CHUNK_SIZE)
+        {
+            fail++;
+            break;
+        }
+    }
+    if (fd >= 0)
+        close(fd);
+    tick = rt_tick_get() - start;
+    bench_report("append", tick, done / CHUNK_SIZE, done);
+    ramfs_bench_statfs(dir, "written");
+
+    /* sequential read back */
+    start = rt_tick_get();
+    fd = open(path, O_RDONLY, 0);
+    for (i = 0; fd >= 0 && i < done; i += CHUNK_SIZE)
+    {
+        if (read(fd, chunk, CHUNK_SIZE) != CHUNK_SIZE ||
+                chunk[0] != (rt_uint8_t)(i / CHUNK_SIZE) ||
+                chunk[CHUNK_SIZE - 1] != (rt_uint8_t)(i / CHUNK_SIZE))
+        {
+            fail++;
+            break;
+        }
+    }
+    if (fd >= 0)
+        close(fd);
+    tick = rt_tick_get() - start;
+    bench_report("read", tick, i / CHUNK_SIZE, i);
+    unlink(path);
+
+    /* lookup in a nested directory */
+    rt_snprintf(path, sizeof(path), "%s/assets", dir);
+    mkdir(path, 0);
+    rt_snprintf(path, sizeof(path), "%s/assets/img", dir);
+    mkdir(path, 0);
+    for (i = 0; i < files; i++)
+    {
+        rt_snprintf(path, sizeof(path), "%s/assets/img/%04d.bin", dir, i);
+        fd = open(path, O_WRONLY | O_CREAT, 0);
+        if (fd < 0)
+        {
+            fail++;
+            continue;
+        }
+        write(fd, path, 16);
+        close(fd);
+    }
+
+    srand(rt_tick_get());
+    start = rt_tick_get();
+    for (i = 0; i < files * 10; i++)
+    {
+        rt_snprintf(path, sizeof(path), "%s/assets/img/%04d.bin", dir, rand() % files);
+        if (stat(path, &st) < 0 || st.st_size != 16)
+            fail++;
+    }
+    tick = rt_tick_get() - start;
+    bench_report("stat", tick, files * 10, 0);
+
+    for (i = 0; i < files; i++)
+    {
+        rt_snprintf(path, sizeof(path), "%s/assets/img/%04d.bin", dir, i);
+        unlink(path);
+    }
+    rt_snprintf(path, sizeof(path), "%s/assets/img", dir);
+    unlink(path);
+    rt_snprintf(path, sizeof(path), "%s/assets", dir);
+    unlink(path);
+    ramfs_bench_statfs(dir, "removed");
+
+    dfs_unmount(dir);
+    rt_kprintf("failed %d\n", fail);
+
+__exit:
+    rt_free(chunk);
+    rt_free(pool);
+
+    return 0;
+}
+MSH_CMD_EXPORT(ramfs_bench, ramfs write/read/lookup benchmark: ramfs_bench [dir] [pool_kb] [files]);
+
+#endif /* RT_BENCHMARK_RAMFS && RT_USING_FINSH */
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     SiFli        the first version
+ */
+
+#include <rtthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(RT_BENCHMARK_ROMFS) && defined(RT_USING_FINSH)
+#include <finsh.h>
+#include "bench_report.h"
+#include <dfs_posix.h>
+#include <dfs_fs.h>
+#include "dfs_romfs.h"
+
+#define NAME_SIZE       12
+
+static const rt_uint8_t romfs_bench_data[] = "romfs";
+
+static rt_uint32_t romfs_bench_stat(const char *dir, rt_uint32_t files, rt_uint32_t ops)
+{
+    char path[64];
+    struct stat st;
+    rt_uint32_t i, fail = 0;
+
+    srand(0);
+    for (i = 0; i < ops; i++)
+    {
+        rt_snprintf(path, sizeof(path), "%s/d/f%05d.bin", dir, rand() % files);
+        if (stat(path, &st) < 0 || st.st_size != sizeof(romfs_bench_data))
+            fail++;
+    }
+
+    return fail;
+}
+
+/*
+ * romfs_bench [dir] [files]
+ *
+ * Build a romfs image in RAM with "files" entries in one directory, the way
+ * mkromfs lays it out, and time stat() of random names in it without an
+ * index, with ROMFS_DIRENT_SORTED and with ROMFS_DIRENT_HASHED.
+ */
+static int romfs_bench(int argc, char **argv)
+{
+    static const struct
+    {
+        const char *name;
+        rt_uint32_t flags;
+    } modes[] =
+    {
+        {"linear", 0},
+        {"sorted", ROMFS_DIRENT_SORTED},
+        {"hashed", ROMFS_DIRENT_SORTED | ROMFS_DIRENT_HASHED},
+    };
+    const char *dir = "/rom_bench";
+    rt_uint32_t files = 1000, ops, slots, i, j, m, fail = 0;
+    struct romfs_dirent root, sub, *dirents = RT_NULL;
+    rt_uint16_t *table = RT_NULL;
+    char *names = RT_NULL;
+    rt_tick_t start;
+
+    if (argc > 1)
+        dir = argv[1];
+    if (argc > 2)
+        files = atoi(argv[2]);
+    if (files == 0 || files >= 0xffff)
+    {
+        rt_kprintf("files should be 1..65534\n");
+        return -1;
+    }
+    ops = files * 10;
+
+    for (slots = 1; slots < files * 2; slots <<= 1);
+    names = rt_malloc(files * NAME_SIZE);
+    dirents = rt_malloc((files + 1) * sizeof(struct romfs_dirent));
+    table = rt_calloc(slots, sizeof(rt_uint16_t));
+    if (names == RT_NULL || dirents == RT_NULL || table == RT_NULL)
+    {
+        rt_kprintf("no memory\n");
+        goto __exit;
+    }
+
+    /* zero padded names are generated in sorted order */
+    for (i = 0; i < files; i++)
+    {
+        rt_snprintf(&names[i * NAME_SIZE], NAME_SIZE, "f%05d.bin", i);
+        dirents[i].type = ROMFS_DIRENT_FILE;
+        dirents[i].name = &names[i * NAME_SIZE];
+        dirents[i].data = romfs_bench_data;
+        dirents[i].size = sizeof(romfs_bench_data);
+
+        j = romfs_name_hash(dirents[i].name, rt_strlen(dirents[i].name)) & (slots - 1);
+        while (table[j] != 0)
+            j = (j + 1) & (slots - 1);
+        table[j] = i + 1;
+    }
+    dirents[files].type = ROMFS_DIRENT_HASH;
+    dirents[files].name = RT_NULL;
+    dirents[files].data = (const rt_uint8_t *)table;
+    dirents[files].size = slots;
+
+    sub.name = "d";
+    sub.data = (const rt_uint8_t *)dirents;
+    sub.size = files;
+    root.type = ROMFS_DIRENT_DIR;
+    root.name = "/";
+    root.data = (const rt_uint8_t *)&sub;
+    root.size = 1;
+
+    mkdir(dir, 0);
+    for (m = 0; m < sizeof(modes) / sizeof(modes[0]); m++)
+    {
+        sub.type = ROMFS_DIRENT_DIR | modes[m].flags;
+        if (dfs_mount(RT_NULL, dir, "rom", 0, &root) != 0)
+        {
+            rt_kprintf("mount %s failed\n", dir);
+            break;
+        }
+
+        start = rt_tick_get();
+        fail += romfs_bench_stat(dir, files, ops);
+        bench_report(modes[m].name, rt_tick_get() - start, ops, 0);
+
+        dfs_unmount(dir);
+    }
+    rt_kprintf("failed %d\n", fail);
+
+__exit:
+    rt_free(table);
+    rt_free(dirents);
+    rt_free(names);
+
+    return 0;
+}
+MSH_CMD_EXPORT(romfs_bench, romfs lookup benchmark: romfs_bench [dir] [files]);
+
+#endif /* RT_BENCHMARK_ROMFS && RT_USING_FINSH */
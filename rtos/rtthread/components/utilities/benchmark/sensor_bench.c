@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     SiFli        the first version
+ */
+
+#include <rtthread.h>
+#include <rtdevice.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(RT_BENCHMARK_SENSOR_STREAM) && defined(RT_USING_FINSH)
+#include <finsh.h>
+#include "sensor.h"
+
+static struct rt_semaphore sensor_bench_sem;
+
+static rt_err_t sensor_bench_rx(rt_device_t dev, rt_size_t size)
+{
+    rt_sem_release(&sensor_bench_sem);
+    return RT_EOK;
+}
+
+/*
+ * sensor_bench [odr] [batch] [latency_ms] [seconds]
+ *
+ * Stream the simulated accelerometer acce_sim at "odr" Hz, handle the
+ * frames in place and report the throughput, the wakeups per second and
+ * any sample lost or out of order.
+ */
+static int sensor_bench(int argc, char **argv)
+{
+    struct rt_sensor_stream_config cfg;
+    struct rt_sensor_stream_stat stat;
+    struct rt_sensor_frame *frame;
+    struct sensor_3_axis *sample;
+    rt_uint32_t odr = 400, seconds = 5;
+    rt_uint32_t samples = 0, wakeups = 0, gaps = 0, bad_ts = 0;
+    rt_uint32_t next_seq = 0, next_ts = 0;
+    rt_bool_t first = RT_TRUE;
+    rt_tick_t start, deadline;
+    rt_device_t dev;
+    int i;
+
+    cfg.batch = 32;
+    cfg.sample_size = sizeof(struct sensor_3_axis);
+    cfg.latency = 100 * 1000;
+    if (argc > 1)
+        odr = atoi(argv[1]);
+    if (argc > 2)
+        cfg.batch = atoi(argv[2]);
+    if (argc > 3)
+        cfg.latency = atoi(argv[3]) * 1000;
+    if (argc > 4)
+        seconds = atoi(argv[4]);
+    /* room for a few batches */
+    cfg.buf_size = 4 * (cfg.batch * sizeof(struct sensor_3_axis) + 64);
+
+    dev = rt_device_find("acce_sim");
+    if (dev == RT_NULL || rt_device_open(dev, RT_DEVICE_FLAG_FIFO_RX) != RT_EOK)
+    {
+        rt_kprintf("open acce_sim failed\n");
+        return -1;
+    }
+
+    rt_sem_init(&sensor_bench_sem, "snsbench", 0, RT_IPC_FLAG_FIFO);
+    rt_device_set_rx_indicate(dev, sensor_bench_rx);
+    if (rt_device_control(dev, RT_SENSOR_CTRL_SET_ODR, (void *)odr) != RT_EOK ||
+            rt_device_control(dev, RT_SENSOR_CTRL_STREAM_START, &cfg) != RT_EOK)
+    {
+        rt_kprintf("start stream failed\n");
+        goto __exit;
+    }
+
+    start = rt_tick_get();
+    deadline = start + rt_tick_from_millisecond(seconds * 1000);
+    while ((rt_int32_t)(rt_tick_get() - deadline) < 0)
+    {
+        if (rt_sem_take(&sensor_bench_sem, rt_tick_from_millisecond(100)) != RT_EOK)
+            continue;
+        wakeups++;
+
+        while ((frame = rt_sensor_stream_peek((rt_sensor_t)dev)) != RT_NULL)
+        {
+            sample = (struct sensor_3_axis *)RT_SENSOR_FRAME_DATA(frame);
+            if (!first && sample[0].x != next_seq)
+                gaps++;
+            if (!first && frame->timestamp != next_ts && sample[0].x == next_seq)
+                bad_ts++;
+            for (i = 1; i < frame->count; i++)
+            {
+                if (sample[i].x != sample[i - 1].x + 1)
+                    gaps++;
+            }
+
+            first = RT_FALSE;
+            next_seq = sample[frame->count - 1].x + 1;
+            next_ts = frame->timestamp + frame->count * frame->delta;
+            samples += frame->count;
+            rt_sensor_stream_release((rt_sensor_t)dev, frame);
+        }
+    }
+
+    rt_device_control(dev, RT_SENSOR_CTRL_STREAM_STAT, &stat);
+    rt_device_control(dev, RT_SENSOR_CTRL_STREAM_STOP, RT_NULL);
+
+    rt_kprintf("odr %d Hz, batch %d, latency %d us, %d s\n", odr, cfg.batch, cfg.latency, seconds);
+    rt_kprintf("samples %8d (%d/s), frames %d, wakeups %d (%d/s), %d samples/wakeup\n",
+               samples, samples / seconds, stat.frames, wakeups, wakeups / seconds,
+               wakeups ? samples / wakeups : 0);
+    rt_kprintf("dropped %d, gaps %d, bad timestamps %d, ring used max %d/%d bytes\n",
+               stat.dropped, gaps, bad_ts, stat.used_max, cfg.buf_size);
+
+__exit:
+    rt_device_set_rx_indicate(dev, RT_NULL);
+    rt_device_close(dev);
+    rt_sem_detach(&sensor_bench_sem);
+
+    return 0;
+}
+MSH_CMD_EXPORT(sensor_bench, sensor streaming benchmark: sensor_bench [odr] [batch] [latency_ms] [seconds]);
+
+#endif /* RT_BENCHMARK_SENSOR_STREAM && RT_USING_FINSH */
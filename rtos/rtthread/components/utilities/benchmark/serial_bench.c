@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     SiFli        the first version
+ */
+
+#include <rtthread.h>
+#include <rtdevice.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(RT_BENCHMARK_SERIAL_TX) && defined(RT_USING_FINSH)
+#include <finsh.h>
+
+static struct rt_semaphore serial_bench_sem;
+static rt_err_t (*serial_bench_old_tx)(rt_device_t dev, void *buffer);
+
+static rt_err_t serial_bench_tx_done(rt_device_t dev, void *buffer)
+{
+    rt_sem_release(&serial_bench_sem);
+    if (serial_bench_old_tx)
+        serial_bench_old_tx(dev, buffer);
+
+    return RT_EOK;
+}
+
+static void serial_bench_report(const char *name, rt_uint32_t writes, rt_uint32_t bytes, rt_tick_t tick,
+                                struct rt_serial_tx_stat *before, struct rt_serial_tx_stat *after)
+{
+    rt_uint32_t ms = tick * 1000 / RT_TICK_PER_SECOND;
+
+    rt_kprintf("%-8s %6d writes %8d bytes in %6d ms, %8d bytes/s", name, writes, bytes, ms,
+               ms ? (rt_uint32_t)((rt_uint64_t)bytes * 1000 / ms) : 0);
+    if (after->writes != before->writes)
+    {
+        rt_kprintf(", %d transfers, ring full %d",
+                   after->transfers - before->transfers, after->full - before->full);
+    }
+    rt_kprintf("\n");
+}
+
+/*
+ * serial_bench [device] [write_size] [count]
+ *
+ * Write "count" lines of "write_size" bytes to a DMA TX serial, the way log
+ * output does, wait for the last tx_complete and report the throughput and
+ * how many DMA transfers the writes took. Then do it again with the ring in
+ * non blocking mode and count the bytes it refused.
+ */
+static int serial_bench(int argc, char **argv)
+{
+    struct rt_serial_tx_stat before, after;
+    const char *name = "uart1";
+    rt_uint32_t size = 32, count = 1000, i, done, bytes, writes;
+    rt_device_t dev;
+    rt_tick_t start;
+    char *line;
+    rt_size_t n;
+
+#ifdef RT_CONSOLE_DEVICE_NAME
+    name = RT_CONSOLE_DEVICE_NAME;
+#endif
+    if (argc > 1)
+        name = argv[1];
+    if (argc > 2)
+        size = atoi(argv[2]);
+    if (argc > 3)
+        count = atoi(argv[3]);
+    if (size < 2)
+        size = 2;
+
+    dev = rt_device_find(name);
+    if (dev == RT_NULL || rt_device_open(dev, RT_DEVICE_OFLAG_RDWR | RT_DEVICE_FLAG_DMA_TX) != RT_EOK)
+    {
+        rt_kprintf("open %s failed\n", name);
+        return -1;
+    }
+    if (!(dev->open_flag & RT_DEVICE_FLAG_DMA_TX))
+    {
+        rt_kprintf("%s is not in DMA TX mode\n", name);
+        rt_device_close(dev);
+        return -1;
+    }
+
+    line = rt_malloc(size);
+    if (line == RT_NULL)
+    {
+        rt_kprintf("no memory\n");
+        rt_device_close(dev);
+        return -1;
+    }
+    rt_memset(line, '.', size);
+    line[size - 1] = '\n';
+
+    rt_sem_init(&serial_bench_sem, "sbench", 0, RT_IPC_FLAG_FIFO);
+    serial_bench_old_tx = dev->tx_complete;
+    rt_device_set_tx_complete(dev, serial_bench_tx_done);
+
+    rt_memset(&before, 0, sizeof(before));
+    rt_memset(&after, 0, sizeof(after));
+    rt_device_control(dev, RT_SERIAL_CTRL_TX_STAT, &before);
+
+    /* blocking, every write waits for room */
+    start = rt_tick_get();
+    for (i = 0; i < count; i++)
+    {
+        line[0] = '0' + i % 10;
+        rt_device_write(dev, 0, line, size);
+    }
+    for (i = 0; i < count; i++)
+        rt_sem_take(&serial_bench_sem, RT_WAITING_FOREVER);
+    rt_device_control(dev, RT_SERIAL_CTRL_TX_STAT, &after);
+    serial_bench_report("blocking", count, count * size, rt_tick_get() - start, &before, &after);
+
+    /* non blocking, short writes have no tx_complete */
+    if (rt_device_control(dev, RT_SERIAL_CTRL_TX_NONBLOCK, (void *)1) == RT_EOK)
+    {
+        before = after;
+        done = bytes = writes = 0;
+        start = rt_tick_get();
+        for (i = 0; i < count; i++)
+        {
+            n = rt_device_write(dev, 0, line, size);
+            bytes += n;
+            if (n == size)
+                done ++;
+            if (n > 0)
+                writes ++;
+        }
+        for (i = 0; i < done; i++)
+            rt_sem_take(&serial_bench_sem, RT_WAITING_FOREVER);
+        rt_device_control(dev, RT_SERIAL_CTRL_TX_NONBLOCK, (void *)0);
+        rt_device_control(dev, RT_SERIAL_CTRL_TX_STAT, &after);
+        serial_bench_report("nonblock", writes, bytes, rt_tick_get() - start, &before, &after);
+        rt_kprintf("nonblock refused %d bytes, %d writes cut short\n",
+                   count * size - bytes, count - done);
+    }
+
+    rt_device_set_tx_complete(dev, serial_bench_old_tx);
+    rt_sem_detach(&serial_bench_sem);
+    rt_free(line);
+    rt_device_close(dev);
+
+    return 0;
+}
+MSH_CMD_EXPORT(serial_bench, serial DMA TX benchmark: serial_bench [device] [write_size] [count]);
+
+#endif /* RT_BENCHMARK_SERIAL_TX && RT_USING_FINSH */
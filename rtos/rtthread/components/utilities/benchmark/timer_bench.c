@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     SiFli        the first version
+ */
+
+#include <rtthread.h>
+#include <stdlib.h>
+
+#if defined(RT_BENCHMARK_TIMER) && defined(RT_USING_FINSH)
+#include <finsh.h>
+#include "bench_report.h"
+
+static void timer_bench_timeout(void *parameter)
+{
+    (*(rt_uint32_t *)parameter)++;
+}
+
+/*
+ * timer_bench [count] [rounds] [soft]
+ *
+ * Start and stop "count" timers with random timeout, the time spent in
+ * rt_timer_start/rt_timer_stop and rt_timer_next_timeout_tick is reported.
+ * Run it with and without RT_USING_TIMER_WHEEL to compare both lists.
+ */
+static int timer_bench(int argc, char **argv)
+{
+    struct rt_timer *timers;
+    rt_uint32_t count = 2000, rounds = 10;
+    rt_uint32_t fired = 0;
+    rt_uint8_t flag = RT_TIMER_FLAG_ONE_SHOT;
+    rt_uint32_t i, r;
+    rt_tick_t start, tick;
+    volatile rt_tick_t next = 0;
+
+    if (argc > 1)
+        count = atoi(argv[1]);
+    if (argc > 2)
+        rounds = atoi(argv[2]);
+    if (argc > 3 && argv[3][0] == 's')
+        flag |= RT_TIMER_FLAG_SOFT_TIMER;
+
+    timers = rt_malloc(sizeof(struct rt_timer) * count);
+    if (timers == RT_NULL)
+    {
+        rt_kprintf("no memory for %d timers\n", count);
+        return -RT_ENOMEM;
+    }
+
+    srand(rt_tick_get());
+    for (i = 0; i < count; i++)
+    {
+        /* long enough not to fire while measuring */
+        rt_timer_init(&timers[i], "bench", timer_bench_timeout, (void *)&fired,
+                      RT_TICK_PER_SECOND * 60 + rand() % (RT_TICK_PER_SECOND * 3600), flag);
+    }
+
+    start = rt_tick_get();
+    for (r = 0; r < rounds; r++)
+    {
+        for (i = 0; i < count; i++)
+            rt_timer_start(&timers[i]);
+    }
+    tick = rt_tick_get() - start;
+    bench_report("start", tick, count * rounds, 0);
+
+    start = rt_tick_get();
+    for (r = 0; r < rounds; r++)
+    {
+        /* restart a random subset while all others stay active */
+        for (i = 0; i < count; i++)
+            rt_timer_start(&timers[rand() % count]);
+    }
+    tick = rt_tick_get() - start;
+    bench_report("restart", tick, count * rounds, 0);
+
+    start = rt_tick_get();
+    for (r = 0; r < rounds * count; r++)
+    {
+        next = rt_timer_next_timeout_tick();
+        /* stopping the earliest timer invalidates the next timeout */
+        if ((r & 0xFF) == 0)
+            rt_timer_stop(&timers[r % count]);
+    }
+    tick = rt_tick_get() - start;
+    bench_report("next_timeout", tick, count * rounds, 0);
+
+    start = rt_tick_get();
+    for (i = 0; i < count; i++)
+        rt_timer_stop(&timers[i]);
+    tick = rt_tick_get() - start;
+    bench_report("stop", tick, count, 0);
+
+    for (i = 0; i < count; i++)
+        rt_timer_detach(&timers[i]);
+    rt_free(timers);
+
+    rt_kprintf("next timeout %d, fired %d\n", next, fired);
+
+    return 0;
+}
+MSH_CMD_EXPORT(timer_bench, timer start/stop benchmark: timer_bench [count] [rounds] [soft]);
+
+#endif /* RT_BENCHMARK_TIMER && RT_USING_FINSH */
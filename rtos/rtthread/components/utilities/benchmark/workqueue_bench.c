@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     SiFli        the first version
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+#include <rtdevice.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(RT_BENCHMARK_WORKQUEUE) && defined(RT_USING_FINSH)
+#include <finsh.h>
+
+#define WQ_BENCH_STACK_SIZE     2048
+#define WQ_BENCH_PRIORITY       15
+
+struct wq_bench_item
+{
+    struct rt_pool_work work;   /* only work.work is used by rt_workqueue */
+    rt_tick_t submit_tick;
+    rt_uint32_t slow_ms;        /* 0 for a short work whose latency is measured */
+};
+
+static struct
+{
+    rt_uint32_t count;
+    rt_uint32_t latency_sum;
+    rt_uint32_t latency_max;
+    struct rt_semaphore done;
+} wq_bench_stat;
+
+static void wq_bench_func(struct rt_work *work, void *work_data)
+{
+    struct wq_bench_item *item = (struct wq_bench_item *)work_data;
+    rt_uint32_t latency;
+    rt_base_t level;
+
+    if (item->slow_ms)
+    {
+        /* like a file flush or a blocking bus transfer */
+        rt_thread_mdelay(item->slow_ms);
+    }
+    else
+    {
+        latency = rt_tick_get() - item->submit_tick;
+        level = rt_hw_interrupt_disable();
+        wq_bench_stat.count ++;
+        wq_bench_stat.latency_sum += latency;
+        if (latency > wq_bench_stat.latency_max)
+            wq_bench_stat.latency_max = latency;
+        rt_hw_interrupt_enable(level);
+    }
+
+    rt_sem_release(&wq_bench_stat.done);
+}
+
+static void wq_bench_report(const char *name, rt_tick_t tick)
+{
+    rt_kprintf("%-8s short work latency avg %4d max %4d ticks, all done in %6d ticks\n", name,
+               wq_bench_stat.count ? wq_bench_stat.latency_sum / wq_bench_stat.count : 0,
+               wq_bench_stat.latency_max, tick);
+}
+
+/* submit the slow works at once, then one short work per tick */
+static rt_tick_t wq_bench_run(struct wq_bench_item *items, rt_uint32_t slow, rt_uint32_t fast,
+                              struct rt_workqueue *queue, struct rt_workqueue_pool *pool)
+{
+    rt_tick_t start;
+    rt_uint32_t i;
+
+    wq_bench_stat.count = 0;
+    wq_bench_stat.latency_sum = 0;
+    wq_bench_stat.latency_max = 0;
+
+    start = rt_tick_get();
+    for (i = 0; i < slow + fast; i++)
+    {
+        if (i >= slow)
+            rt_thread_delay(1);
+
+        items[i].submit_tick = rt_tick_get();
+        if (queue)
+            rt_workqueue_dowork(queue, &(items[i].work.work));
+        else
+            rt_workqueue_pool_submit(pool, &(items[i].work));
+    }
+
+    for (i = 0; i < slow + fast; i++)
+        rt_sem_take(&wq_bench_stat.done, RT_WAITING_FOREVER);
+
+    return rt_tick_get() - start;
+}
+
+/*
+ * wq_bench [workers] [slow] [slow_ms] [short]
+ *
+ * Queue "slow" works blocking for "slow_ms" each, then "short" works one per
+ * tick, and measure how long the short works wait before they are run: first
+ * on a single threaded rt_workqueue, then on a pool of "workers" threads
+ * with the short works in the high lane.
+ */
+static int wq_bench(int argc, char **argv)
+{
+    rt_uint32_t workers = 3, slow = 8, slow_ms = 20, fast = 50, i;
+    struct rt_workqueue_pool *pool;
+    struct rt_workqueue *queue;
+    struct wq_bench_item *items;
+    rt_tick_t tick;
+
+    if (argc > 1)
+        workers = atoi(argv[1]);
+    if (argc > 2)
+        slow = atoi(argv[2]);
+    if (argc > 3)
+        slow_ms = atoi(argv[3]);
+    if (argc > 4)
+        fast = atoi(argv[4]);
+    if (workers == 0)
+        workers = 1;
+
+    items = rt_calloc(slow + fast, sizeof(struct wq_bench_item));
+    if (items == RT_NULL)
+    {
+        rt_kprintf("no memory\n");
+        return -1;
+    }
+    rt_sem_init(&wq_bench_stat.done, "wqbench", 0, RT_IPC_FLAG_FIFO);
+
+    queue = rt_workqueue_create("wqbench", WQ_BENCH_STACK_SIZE, WQ_BENCH_PRIORITY);
+    if (queue)
+    {
+        for (i = 0; i < slow + fast; i++)
+        {
+            rt_work_init(&(items[i].work.work), wq_bench_func, &items[i]);
+            items[i].slow_ms = i < slow ? slow_ms : 0;
+        }
+        tick = wq_bench_run(items, slow, fast, queue, RT_NULL);
+        wq_bench_report("queue", tick);
+        rt_workqueue_destroy(queue);
+    }
+
+    pool = rt_workqueue_pool_create("wqb", workers, WQ_BENCH_STACK_SIZE, WQ_BENCH_PRIORITY);
+    if (pool)
+    {
+        for (i = 0; i < slow + fast; i++)
+        {
+            rt_pool_work_init(&(items[i].work), wq_bench_func, &items[i],
+                              i < slow ? RT_WORK_LANE_LOW : RT_WORK_LANE_HIGH, 0);
+            items[i].slow_ms = i < slow ? slow_ms : 0;
+        }
+        tick = wq_bench_run(items, slow, fast, RT_NULL, pool);
+        wq_bench_report("pool", tick);
+        rt_workqueue_pool_destroy(pool);
+    }
+
+    rt_sem_detach(&wq_bench_stat.done);
+    rt_free(items);
+
+    return 0;
+}
+MSH_CMD_EXPORT(wq_bench, workqueue latency benchmark: wq_bench [workers] [slow] [slow_ms] [short]);
+
+#endif /* RT_BENCHMARK_WORKQUEUE && RT_USING_FINSH */
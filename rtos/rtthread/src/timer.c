@@ -16,6 +16,7 @@
  * 2012-12-15     Bernard      fix the next timeout issue in soft timer
  * 2014-07-12     Bernard      does not lock scheduler when invoking soft-timer
  *                             timeout function.
+ * 2026-10-19     SiFli        add optional hierarchical timing wheel
  */
 
 #include <rtthread.h>
@@ -49,6 +50,72 @@ __ROM_USED rt_list_t rt_timer_list[RT_TIMER_SKIP_LIST_LEVEL];
     L1_NON_RET_BSS_SECT_END
 #endif
 
+#ifdef RT_USING_TIMER_WHEEL
+
+#ifdef ROM_ENABLED
+/* rt_timer_start/stop/check in ROM would win the link and keep using the list */
+#error "RT_USING_TIMER_WHEEL can't be used with ROM_ENABLED"
+#endif
+
+/*
+ * Hierarchical timing wheel.
+ *
+ * Level 0 has one slot per tick, level n has one slot per 2^(n * BITS) ticks.
+ * A timer lives in the lowest level able to hold its remaining delta and is
+ * cascaded into a lower level when the wheel reaches the slot boundary, so
+ * start/stop are O(1). A per level occupancy bitmap lets the wheel skip idle
+ * periods (e.g. after tickless sleep) and find the next timeout quickly.
+ */
+#define RT_TIMER_WHEEL_BITS             5
+#define RT_TIMER_WHEEL_SIZE             (1UL << RT_TIMER_WHEEL_BITS)
+#define RT_TIMER_WHEEL_MASK             (RT_TIMER_WHEEL_SIZE - 1)
+
+#ifndef RT_TIMER_WHEEL_LEVEL
+    #define RT_TIMER_WHEEL_LEVEL        4
+#endif
+
+#if (RT_TIMER_WHEEL_LEVEL < 2) || (RT_TIMER_WHEEL_LEVEL > 6)
+    #error "RT_TIMER_WHEEL_LEVEL must be in range 2~6"
+#endif
+
+/* the largest delta the wheel can hold, longer timers are parked in the top level */
+#define RT_TIMER_WHEEL_RANGE            ((rt_tick_t)1 << (RT_TIMER_WHEEL_BITS * RT_TIMER_WHEEL_LEVEL))
+
+#define RT_TIMER_NODE(timer)            (&(timer)->row[RT_TIMER_SKIP_LIST_LEVEL - 1])
+
+/* a is not earlier than b */
+#define RT_TICK_AFTER_EQ(a, b)          ((rt_tick_t)((a) - (b)) < RT_TICK_MAX / 2)
+
+struct rt_timer_wheel
+{
+    rt_tick_t        clk;                                   /**< next tick to be processed */
+    rt_uint32_t      bitmap[RT_TIMER_WHEEL_LEVEL];          /**< non-empty slots of each level */
+    rt_list_t        slot[RT_TIMER_WHEEL_LEVEL][RT_TIMER_WHEEL_SIZE];
+    struct rt_timer *next_timer;                            /**< cached earliest timer */
+    rt_uint8_t       next_valid;                            /**< next_timer is up to date */
+};
+
+typedef struct rt_timer_wheel *rt_timer_queue_t;
+
+static struct rt_timer_wheel timer_wheel;
+#define RT_HARD_TIMER_QUEUE             (&timer_wheel)
+
+#ifdef RT_USING_TIMER_SOFT
+    static struct rt_timer_wheel soft_timer_wheel;
+    #define RT_SOFT_TIMER_QUEUE         (&soft_timer_wheel)
+#endif
+
+#else
+
+typedef rt_list_t *rt_timer_queue_t;
+
+#define RT_HARD_TIMER_QUEUE             rt_timer_list
+#ifdef RT_USING_TIMER_SOFT
+    #define RT_SOFT_TIMER_QUEUE         rt_soft_timer_list
+#endif
+
+#endif /* RT_USING_TIMER_WHEEL */
+
 #ifdef RT_USING_HOOK
 extern void (*rt_object_take_hook)(struct rt_object *object);
 extern void (*rt_object_put_hook)(struct rt_object *object);
@@ -119,6 +186,275 @@ static void _rt_timer_init(rt_timer_t timer,
     }
 }
 
+#ifdef RT_USING_TIMER_WHEEL
+
+static void _rt_timer_wheel_init(struct rt_timer_wheel *wheel)
+{
+    int lvl, idx;
+
+    for (lvl = 0; lvl < RT_TIMER_WHEEL_LEVEL; lvl++)
+    {
+        wheel->bitmap[lvl] = 0;
+        for (idx = 0; idx < RT_TIMER_WHEEL_SIZE; idx++)
+        {
+            rt_list_init(&wheel->slot[lvl][idx]);
+        }
+    }
+    wheel->clk = rt_tick_get();
+    wheel->next_timer = RT_NULL;
+    wheel->next_valid = 1;
+}
+
+/* index of the first set bit at or after start, wrapping around */
+rt_inline int _rt_timer_wheel_find(rt_uint32_t bitmap, int start)
+{
+    rt_uint32_t rot;
+
+    rot = start ? ((bitmap >> start) | (bitmap << (RT_TIMER_WHEEL_SIZE - start))) : bitmap;
+
+    return (start + __rt_ffs((int)rot) - 1) & RT_TIMER_WHEEL_MASK;
+}
+
+static void _rt_timer_wheel_insert(struct rt_timer_wheel *wheel, struct rt_timer *timer)
+{
+    rt_tick_t expires = timer->timeout_tick;
+    rt_tick_t delta = expires - wheel->clk;
+    int lvl, idx;
+
+    if (delta >= RT_TICK_MAX / 2)
+    {
+        /* already expired, fire it on the next processed tick */
+        expires = wheel->clk;
+        delta = 0;
+    }
+    else if (delta >= RT_TIMER_WHEEL_RANGE)
+    {
+        /* park it in the top level, it is re-inserted when cascaded */
+        delta = RT_TIMER_WHEEL_RANGE - 1;
+        expires = wheel->clk + delta;
+    }
+
+    for (lvl = 0; lvl < RT_TIMER_WHEEL_LEVEL - 1; lvl++)
+    {
+        if (delta < ((rt_tick_t)1 << (RT_TIMER_WHEEL_BITS * (lvl + 1))))
+            break;
+    }
+    idx = (expires >> (RT_TIMER_WHEEL_BITS * lvl)) & RT_TIMER_WHEEL_MASK;
+
+    /* append to the tail, timers with the same timeout fire in start order */
+    rt_list_insert_before(&wheel->slot[lvl][idx], RT_TIMER_NODE(timer));
+    wheel->bitmap[lvl] |= 1UL << idx;
+
+    if (wheel->next_valid &&
+            (wheel->next_timer == RT_NULL ||
+             !RT_TICK_AFTER_EQ(timer->timeout_tick, wheel->next_timer->timeout_tick)))
+    {
+        wheel->next_timer = timer;
+    }
+}
+
+static void _rt_timer_wheel_cascade(struct rt_timer_wheel *wheel, int lvl, int idx)
+{
+    rt_list_t *head = &wheel->slot[lvl][idx];
+    rt_list_t list;
+
+    wheel->bitmap[lvl] &= ~(1UL << idx);
+
+    /* detach the whole slot first, parked timers may land in the same slot again */
+    list.next = head->next;
+    list.prev = head->prev;
+    list.next->prev = &list;
+    list.prev->next = &list;
+    rt_list_init(head);
+
+    while (!rt_list_isempty(&list))
+    {
+        struct rt_timer *t = rt_list_entry(list.next, struct rt_timer,
+                                           row[RT_TIMER_SKIP_LIST_LEVEL - 1]);
+
+        rt_list_remove(RT_TIMER_NODE(t));
+        _rt_timer_wheel_insert(wheel, t);
+    }
+}
+
+/*
+ * Move the wheel to tick "to". No level 0 timer may expire before "to",
+ * the upper level slots whose boundary is passed are cascaded.
+ */
+static void _rt_timer_wheel_forward(struct rt_timer_wheel *wheel, rt_tick_t to)
+{
+    rt_tick_t from = wheel->clk;
+    int lvl;
+
+    wheel->clk = to;
+
+    for (lvl = 1; lvl < RT_TIMER_WHEEL_LEVEL; lvl++)
+    {
+        int shift = RT_TIMER_WHEEL_BITS * lvl;
+        rt_tick_t base = from >> shift;
+        rt_tick_t passed = ((to >> shift) - base) & (RT_TICK_MAX >> shift);
+        rt_uint32_t bitmap = wheel->bitmap[lvl];
+
+        /* no boundary of this level is passed, neither of upper levels */
+        if (passed == 0)
+            break;
+
+        while (bitmap)
+        {
+            int idx = __rt_ffs((int)bitmap) - 1;
+            rt_tick_t dist = (idx - base) & RT_TIMER_WHEEL_MASK;
+
+            bitmap &= ~(1UL << idx);
+            if (dist == 0)
+                dist = RT_TIMER_WHEEL_SIZE;
+            if (passed >= dist)
+                _rt_timer_wheel_cascade(wheel, lvl, idx);
+        }
+    }
+}
+
+static struct rt_timer *_rt_timer_wheel_next(struct rt_timer_wheel *wheel)
+{
+    struct rt_timer *next = RT_NULL;
+    int lvl;
+
+    if (wheel->next_valid)
+        return wheel->next_timer;
+
+    for (lvl = 0; lvl < RT_TIMER_WHEEL_LEVEL; lvl++)
+    {
+        int shift = RT_TIMER_WHEEL_BITS * lvl;
+        int cur = (wheel->clk >> shift) & RT_TIMER_WHEEL_MASK;
+        rt_list_t *head, *node;
+
+        if (wheel->bitmap[lvl] == 0)
+            continue;
+
+        /* the current slot of an upper level has been cascaded already */
+        if (lvl != 0)
+            cur = (cur + 1) & RT_TIMER_WHEEL_MASK;
+        head = &wheel->slot[lvl][_rt_timer_wheel_find(wheel->bitmap[lvl], cur)];
+
+        for (node = head->next; node != head; node = node->next)
+        {
+            struct rt_timer *t = rt_list_entry(node, struct rt_timer,
+                                               row[RT_TIMER_SKIP_LIST_LEVEL - 1]);
+
+            if (next == RT_NULL || !RT_TICK_AFTER_EQ(t->timeout_tick, next->timeout_tick))
+                next = t;
+
+            /* all timers of a level 0 slot share the same timeout */
+            if (lvl == 0)
+                break;
+        }
+    }
+
+    wheel->next_timer = next;
+    wheel->next_valid = 1;
+
+    return next;
+}
+
+/* return the first expired timer and leave it in the wheel, RT_NULL if none */
+static struct rt_timer *_rt_timer_queue_expired(rt_timer_queue_t wheel, rt_tick_t current_tick)
+{
+    struct rt_timer *next;
+
+    while (RT_TICK_AFTER_EQ(current_tick, wheel->clk))
+    {
+        rt_list_t *head = &wheel->slot[0][wheel->clk & RT_TIMER_WHEEL_MASK];
+
+        if (!rt_list_isempty(head))
+            return rt_list_entry(head->next, struct rt_timer, row[RT_TIMER_SKIP_LIST_LEVEL - 1]);
+
+        next = _rt_timer_wheel_next(wheel);
+        if (next == RT_NULL || !RT_TICK_AFTER_EQ(current_tick, next->timeout_tick))
+        {
+            /* nothing is due, skip the idle ticks at once */
+            _rt_timer_wheel_forward(wheel, current_tick + 1);
+            break;
+        }
+
+        if (RT_TICK_AFTER_EQ(wheel->clk, next->timeout_tick))
+            _rt_timer_wheel_forward(wheel, wheel->clk + 1);
+        else
+            _rt_timer_wheel_forward(wheel, next->timeout_tick);
+    }
+
+    return RT_NULL;
+}
+
+rt_inline void _rt_timer_queue_insert(rt_timer_queue_t wheel, rt_timer_t timer)
+{
+    _rt_timer_wheel_insert(wheel, timer);
+}
+
+static rt_tick_t _rt_timer_queue_next_timeout(rt_timer_queue_t wheel)
+{
+    struct rt_timer *timer;
+    register rt_base_t level;
+    rt_tick_t timeout_tick = RT_TICK_MAX;
+
+    /* disable interrupt */
+    level = rt_hw_interrupt_disable();
+
+    timer = _rt_timer_wheel_next(wheel);
+    if (timer != RT_NULL)
+        timeout_tick = timer->timeout_tick;
+
+    /* enable interrupt */
+    rt_hw_interrupt_enable(level);
+
+    return timeout_tick;
+}
+
+static struct rt_timer *_rt_timer_queue_first(rt_timer_queue_t wheel)
+{
+    struct rt_timer *timer;
+    register rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    timer = _rt_timer_wheel_next(wheel);
+    rt_hw_interrupt_enable(level);
+
+    return timer;
+}
+
+/* clear the slot bit and drop the cached next timer if they refer to timer */
+static void _rt_timer_wheel_unlink(struct rt_timer_wheel *wheel, rt_timer_t timer, rt_list_t *head)
+{
+    rt_list_t *slot = &wheel->slot[0][0];
+
+    if (head >= slot && head < slot + RT_TIMER_WHEEL_LEVEL * RT_TIMER_WHEEL_SIZE)
+    {
+        int pos = head - slot;
+
+        wheel->bitmap[pos >> RT_TIMER_WHEEL_BITS] &= ~(1UL << (pos & RT_TIMER_WHEEL_MASK));
+    }
+
+    if (wheel->next_timer == timer)
+        wheel->next_valid = 0;
+}
+
+rt_inline void _rt_timer_remove(rt_timer_t timer)
+{
+    rt_list_t *node = RT_TIMER_NODE(timer);
+    rt_list_t *head = RT_NULL;
+
+    /* the only neighbour left may be the slot head which becomes empty */
+    if (node->next == node->prev)
+        head = node->next;
+
+    rt_list_remove(node);
+
+    _rt_timer_wheel_unlink(&timer_wheel, timer, head);
+#ifdef RT_USING_TIMER_SOFT
+    _rt_timer_wheel_unlink(&soft_timer_wheel, timer, head);
+#endif
+}
+
+#else
+
 /* the fist timer always in the last row */
 static rt_tick_t rt_timer_list_next_timeout(rt_list_t timer_list[])
 {
@@ -165,6 +501,88 @@ rt_inline void _rt_timer_remove(rt_timer_t timer)
     }
 }
 
+static void _rt_timer_queue_insert(rt_timer_queue_t timer_list, rt_timer_t timer)
+{
+    unsigned int row_lvl;
+    rt_list_t *row_head[RT_TIMER_SKIP_LIST_LEVEL];
+    unsigned int tst_nr;
+    static unsigned int random_nr;
+
+    row_head[0]  = &timer_list[0];
+    for (row_lvl = 0; row_lvl < RT_TIMER_SKIP_LIST_LEVEL; row_lvl++)
+    {
+        for (; row_head[row_lvl] != timer_list[row_lvl].prev;
+                row_head[row_lvl]  = row_head[row_lvl]->next)
+        {
+            struct rt_timer *t;
+            rt_list_t *p = row_head[row_lvl]->next;
+
+            /* fix up the entry pointer */
+            t = rt_list_entry(p, struct rt_timer, row[row_lvl]);
+
+            /* If we have two timers that timeout at the same time, it's
+             * preferred that the timer inserted early get called early.
+             * So insert the new timer to the end the the some-timeout timer
+             * list.
+             */
+            if ((t->timeout_tick - timer->timeout_tick) == 0)
+            {
+                continue;
+            }
+            else if ((t->timeout_tick - timer->timeout_tick) < RT_TICK_MAX / 2)
+            {
+                break;
+            }
+        }
+        if (row_lvl != RT_TIMER_SKIP_LIST_LEVEL - 1)
+            row_head[row_lvl + 1] = row_head[row_lvl] + 1;
+    }
+
+    /* Interestingly, this super simple timer insert counter works very very
+     * well on distributing the list height uniformly. By means of "very very
+     * well", I mean it beats the randomness of timer->timeout_tick very easily
+     * (actually, the timeout_tick is not random and easy to be attacked). */
+    random_nr++;
+    tst_nr = random_nr;
+
+    rt_list_insert_after(row_head[RT_TIMER_SKIP_LIST_LEVEL - 1],
+                         &(timer->row[RT_TIMER_SKIP_LIST_LEVEL - 1]));
+    for (row_lvl = 2; row_lvl <= RT_TIMER_SKIP_LIST_LEVEL; row_lvl++)
+    {
+        if (!(tst_nr & RT_TIMER_SKIP_LIST_MASK))
+            rt_list_insert_after(row_head[RT_TIMER_SKIP_LIST_LEVEL - row_lvl],
+                                 &(timer->row[RT_TIMER_SKIP_LIST_LEVEL - row_lvl]));
+        else
+            break;
+        /* Shift over the bits we have tested. Works well with 1 bit and 2
+         * bits. */
+        tst_nr >>= (RT_TIMER_SKIP_LIST_MASK + 1) >> 1;
+    }
+}
+
+/* return the first expired timer and leave it in the list, RT_NULL if none */
+rt_inline struct rt_timer *_rt_timer_queue_expired(rt_timer_queue_t timer_list, rt_tick_t current_tick)
+{
+    struct rt_timer *t;
+
+    t = rt_timer_list_next_timer(&timer_list[RT_TIMER_SKIP_LIST_LEVEL - 1]);
+
+    /*
+     * It supposes that the new tick shall less than the half duration of
+     * tick max.
+     */
+    if (t != RT_NULL && (current_tick - t->timeout_tick) < RT_TICK_MAX / 2)
+        return t;
+
+    return RT_NULL;
+}
+
+#define _rt_timer_queue_next_timeout(timer_list)    rt_timer_list_next_timeout(timer_list)
+#define _rt_timer_queue_first(timer_list)           \
+    rt_timer_list_next_timer(&(timer_list)[RT_TIMER_SKIP_LIST_LEVEL - 1])
+
+#endif /* RT_USING_TIMER_WHEEL */
+
 #if RT_DEBUG_TIMER
 static int rt_timer_count_height(struct rt_timer *timer)
 {
@@ -281,6 +699,7 @@ __ROM_USED rt_timer_t rt_timer_create(const char *name,
 {
     struct rt_timer *timer;
 
+#ifndef RT_USING_TIMER_WHEEL
     // Just for one list
     rt_list_t *list = &rt_timer_list[0];
     rt_timer_t timer_1 = rt_timer_list_next_timer(list);
@@ -294,6 +713,7 @@ __ROM_USED rt_timer_t rt_timer_create(const char *name,
         list = list->next;
         timer_1 = rt_timer_list_next_timer(list);
     }
+#endif /* RT_USING_TIMER_WHEEL */
 
 
     /* allocate a object */
@@ -351,12 +771,8 @@ RTM_EXPORT(rt_timer_delete);
  */
 __ROM_USED rt_err_t rt_timer_start(rt_timer_t timer)
 {
-    unsigned int row_lvl;
-    rt_list_t *timer_list;
+    rt_timer_queue_t timer_queue;
     register rt_base_t level;
-    rt_list_t *row_head[RT_TIMER_SKIP_LIST_LEVEL];
-    unsigned int tst_nr;
-    static unsigned int random_nr;
 
     /* timer check */
     RT_ASSERT(timer != RT_NULL);
@@ -382,65 +798,16 @@ __ROM_USED rt_err_t rt_timer_start(rt_timer_t timer)
     if (timer->parent.flag & RT_TIMER_FLAG_SOFT_TIMER)
     {
         /* insert timer to soft timer list */
-        timer_list = rt_soft_timer_list;
+        timer_queue = RT_SOFT_TIMER_QUEUE;
     }
     else
 #endif
     {
         /* insert timer to system timer list */
-        timer_list = rt_timer_list;
-    }
-
-    row_head[0]  = &timer_list[0];
-    for (row_lvl = 0; row_lvl < RT_TIMER_SKIP_LIST_LEVEL; row_lvl++)
-    {
-        for (; row_head[row_lvl] != timer_list[row_lvl].prev;
-                row_head[row_lvl]  = row_head[row_lvl]->next)
-        {
-            struct rt_timer *t;
-            rt_list_t *p = row_head[row_lvl]->next;
-
-            /* fix up the entry pointer */
-            t = rt_list_entry(p, struct rt_timer, row[row_lvl]);
-
-            /* If we have two timers that timeout at the same time, it's
-             * preferred that the timer inserted early get called early.
-             * So insert the new timer to the end the the some-timeout timer
-             * list.
-             */
-            if ((t->timeout_tick - timer->timeout_tick) == 0)
-            {
-                continue;
-            }
-            else if ((t->timeout_tick - timer->timeout_tick) < RT_TICK_MAX / 2)
-            {
-                break;
-            }
-        }
-        if (row_lvl != RT_TIMER_SKIP_LIST_LEVEL - 1)
-            row_head[row_lvl + 1] = row_head[row_lvl] + 1;
+        timer_queue = RT_HARD_TIMER_QUEUE;
     }
 
-    /* Interestingly, this super simple timer insert counter works very very
-     * well on distributing the list height uniformly. By means of "very very
-     * well", I mean it beats the randomness of timer->timeout_tick very easily
-     * (actually, the timeout_tick is not random and easy to be attacked). */
-    random_nr++;
-    tst_nr = random_nr;
-
-    rt_list_insert_after(row_head[RT_TIMER_SKIP_LIST_LEVEL - 1],
-                         &(timer->row[RT_TIMER_SKIP_LIST_LEVEL - 1]));
-    for (row_lvl = 2; row_lvl <= RT_TIMER_SKIP_LIST_LEVEL; row_lvl++)
-    {
-        if (!(tst_nr & RT_TIMER_SKIP_LIST_MASK))
-            rt_list_insert_after(row_head[RT_TIMER_SKIP_LIST_LEVEL - row_lvl],
-                                 &(timer->row[RT_TIMER_SKIP_LIST_LEVEL - row_lvl]));
-        else
-            break;
-        /* Shift over the bits we have tested. Works well with 1 bit and 2
-         * bits. */
-        tst_nr >>= (RT_TIMER_SKIP_LIST_MASK + 1) >> 1;
-    }
+    _rt_timer_queue_insert(timer_queue, timer);
 
     timer->parent.flag |= RT_TIMER_FLAG_ACTIVATED;
 
@@ -563,51 +930,40 @@ __ROM_USED void rt_timer_check(void)
     /* disable interrupt */
     level = rt_hw_interrupt_disable();
 
-    while (!rt_list_isempty(&rt_timer_list[RT_TIMER_SKIP_LIST_LEVEL - 1]))
+    while ((t = _rt_timer_queue_expired(RT_HARD_TIMER_QUEUE, current_tick)) != RT_NULL)
     {
-        t = rt_list_entry(rt_timer_list[RT_TIMER_SKIP_LIST_LEVEL - 1].next,
-                          struct rt_timer, row[RT_TIMER_SKIP_LIST_LEVEL - 1]);
+        RT_OBJECT_HOOK_CALL(rt_timer_enter_hook, (t));
 
-        /*
-         * It supposes that the new tick shall less than the half duration of
-         * tick max.
-         */
-        if ((current_tick - t->timeout_tick) < RT_TICK_MAX / 2)
+        /* remove timer from timer list firstly */
+        _rt_timer_remove(t);
+        if (!(t->parent.flag & RT_TIMER_FLAG_PERIODIC))
         {
-            RT_OBJECT_HOOK_CALL(rt_timer_enter_hook, (t));
-
-            /* remove timer from timer list firstly */
-            _rt_timer_remove(t);
-            if (!(t->parent.flag & RT_TIMER_FLAG_PERIODIC))
-            {
-                t->parent.flag &= ~RT_TIMER_FLAG_ACTIVATED;
-            }
-            /* add timer to temporary list  */
-            rt_list_insert_after(&list, &(t->row[RT_TIMER_SKIP_LIST_LEVEL - 1]));
-            /* call timeout function */
-            t->timeout_func(t->parameter);
+            t->parent.flag &= ~RT_TIMER_FLAG_ACTIVATED;
+        }
+        /* add timer to temporary list  */
+        rt_list_insert_after(&list, &(t->row[RT_TIMER_SKIP_LIST_LEVEL - 1]));
+        /* call timeout function */
+        t->timeout_func(t->parameter);
 
-            /* re-get tick */
-            current_tick = rt_tick_get();
+        /* re-get tick */
+        current_tick = rt_tick_get();
 
-            RT_OBJECT_HOOK_CALL(rt_timer_exit_hook, (t));
-            RT_DEBUG_LOG(RT_DEBUG_TIMER, ("current tick: %d\n", current_tick));
+        RT_OBJECT_HOOK_CALL(rt_timer_exit_hook, (t));
+        RT_DEBUG_LOG(RT_DEBUG_TIMER, ("current tick: %d\n", current_tick));
 
-            /* Check whether the timer object is detached or started again */
-            if (rt_list_isempty(&list))
-            {
-                continue;
-            }
-            rt_list_remove(&(t->row[RT_TIMER_SKIP_LIST_LEVEL - 1]));
-            if ((t->parent.flag & RT_TIMER_FLAG_PERIODIC) &&
-                    (t->parent.flag & RT_TIMER_FLAG_ACTIVATED))
-            {
-                /* start it */
-                t->parent.flag &= ~RT_TIMER_FLAG_ACTIVATED;
-                rt_timer_start(t);
-            }
+        /* Check whether the timer object is detached or started again */
+        if (rt_list_isempty(&list))
+        {
+            continue;
+        }
+        rt_list_remove(&(t->row[RT_TIMER_SKIP_LIST_LEVEL - 1]));
+        if ((t->parent.flag & RT_TIMER_FLAG_PERIODIC) &&
+                (t->parent.flag & RT_TIMER_FLAG_ACTIVATED))
+        {
+            /* start it */
+            t->parent.flag &= ~RT_TIMER_FLAG_ACTIVATED;
+            rt_timer_start(t);
         }
-        else break;
     }
 
     /* enable interrupt */
@@ -623,7 +979,7 @@ __ROM_USED void rt_timer_check(void)
  */
 __ROM_USED rt_tick_t rt_timer_next_timeout_tick(void)
 {
-    return rt_timer_list_next_timeout(rt_timer_list);
+    return _rt_timer_queue_next_timeout(RT_HARD_TIMER_QUEUE);
 }
 
 
@@ -631,14 +987,14 @@ __ROM_USED struct rt_timer *rt_timer_next_timer(void)
 {
     rt_timer_t next_timer;
 
-    next_timer = rt_timer_list_next_timer(&rt_timer_list[RT_TIMER_SKIP_LIST_LEVEL - 1]);
+    next_timer = _rt_timer_queue_first(RT_HARD_TIMER_QUEUE);
 
 #ifdef RT_USING_TIMER_SOFT
 
     if (next_timer
             && (0 == rt_strncmp(next_timer->parent.name, "timer", RT_NAME_MAX)))
     {
-        next_timer = rt_timer_list_next_timer(&rt_soft_timer_list[RT_TIMER_SKIP_LIST_LEVEL - 1]);
+        next_timer = _rt_timer_queue_first(RT_SOFT_TIMER_QUEUE);
     }
 #endif /* RT_USING_TIMER_SOFT */
 
@@ -651,7 +1007,7 @@ struct rt_timer *rt_timer_next_soft_timer(void)
 {
     rt_timer_t next_timer;
 
-    next_timer = rt_timer_list_next_timer(&rt_soft_timer_list[RT_TIMER_SKIP_LIST_LEVEL - 1]);
+    next_timer = _rt_timer_queue_first(RT_SOFT_TIMER_QUEUE);
 
     return next_timer;
 }
@@ -674,59 +1030,52 @@ __ROM_USED void rt_soft_timer_check(void)
     /* disable interrupt */
     level = rt_hw_interrupt_disable();
 
-    while (!rt_list_isempty(&rt_soft_timer_list[RT_TIMER_SKIP_LIST_LEVEL - 1]))
+    while (1)
     {
-        t = rt_list_entry(rt_soft_timer_list[RT_TIMER_SKIP_LIST_LEVEL - 1].next,
-                          struct rt_timer, row[RT_TIMER_SKIP_LIST_LEVEL - 1]);
-
         current_tick = rt_tick_get();
 
-        /*
-         * It supposes that the new tick shall less than the half duration of
-         * tick max.
-         */
-        if ((current_tick - t->timeout_tick) < RT_TICK_MAX / 2)
-        {
-            RT_OBJECT_HOOK_CALL(rt_timer_enter_hook, (t));
+        t = _rt_timer_queue_expired(RT_SOFT_TIMER_QUEUE, current_tick);
+        if (t == RT_NULL)
+            break; /* not check anymore */
 
-            /* remove timer from timer list firstly */
-            _rt_timer_remove(t);
-            if (!(t->parent.flag & RT_TIMER_FLAG_PERIODIC))
-            {
-                t->parent.flag &= ~RT_TIMER_FLAG_ACTIVATED;
-            }
-            /* add timer to temporary list  */
-            rt_list_insert_after(&list, &(t->row[RT_TIMER_SKIP_LIST_LEVEL - 1]));
+        RT_OBJECT_HOOK_CALL(rt_timer_enter_hook, (t));
 
-            soft_timer_status = RT_SOFT_TIMER_BUSY;
-            /* enable interrupt */
-            rt_hw_interrupt_enable(level);
+        /* remove timer from timer list firstly */
+        _rt_timer_remove(t);
+        if (!(t->parent.flag & RT_TIMER_FLAG_PERIODIC))
+        {
+            t->parent.flag &= ~RT_TIMER_FLAG_ACTIVATED;
+        }
+        /* add timer to temporary list  */
+        rt_list_insert_after(&list, &(t->row[RT_TIMER_SKIP_LIST_LEVEL - 1]));
 
-            /* call timeout function */
-            t->timeout_func(t->parameter);
+        soft_timer_status = RT_SOFT_TIMER_BUSY;
+        /* enable interrupt */
+        rt_hw_interrupt_enable(level);
 
-            RT_OBJECT_HOOK_CALL(rt_timer_exit_hook, (t));
-            RT_DEBUG_LOG(RT_DEBUG_TIMER, ("current tick: %d\n", current_tick));
+        /* call timeout function */
+        t->timeout_func(t->parameter);
 
-            /* disable interrupt */
-            level = rt_hw_interrupt_disable();
+        RT_OBJECT_HOOK_CALL(rt_timer_exit_hook, (t));
+        RT_DEBUG_LOG(RT_DEBUG_TIMER, ("current tick: %d\n", current_tick));
 
-            soft_timer_status = RT_SOFT_TIMER_IDLE;
-            /* Check whether the timer object is detached or started again */
-            if (rt_list_isempty(&list))
-            {
-                continue;
-            }
-            rt_list_remove(&(t->row[RT_TIMER_SKIP_LIST_LEVEL - 1]));
-            if ((t->parent.flag & RT_TIMER_FLAG_PERIODIC) &&
-                    (t->parent.flag & RT_TIMER_FLAG_ACTIVATED))
-            {
-                /* start it */
-                t->parent.flag &= ~RT_TIMER_FLAG_ACTIVATED;
-                rt_timer_start(t);
-            }
+        /* disable interrupt */
+        level = rt_hw_interrupt_disable();
+
+        soft_timer_status = RT_SOFT_TIMER_IDLE;
+        /* Check whether the timer object is detached or started again */
+        if (rt_list_isempty(&list))
+        {
+            continue;
+        }
+        rt_list_remove(&(t->row[RT_TIMER_SKIP_LIST_LEVEL - 1]));
+        if ((t->parent.flag & RT_TIMER_FLAG_PERIODIC) &&
+                (t->parent.flag & RT_TIMER_FLAG_ACTIVATED))
+        {
+            /* start it */
+            t->parent.flag &= ~RT_TIMER_FLAG_ACTIVATED;
+            rt_timer_start(t);
         }
-        else break; /* not check anymore */
     }
     /* enable interrupt */
     rt_hw_interrupt_enable(level);
@@ -742,7 +1091,7 @@ static void rt_thread_timer_entry(void *parameter)
     while (1)
     {
         /* get the next timeout tick */
-        next_timeout = rt_timer_list_next_timeout(rt_soft_timer_list);
+        next_timeout = _rt_timer_queue_next_timeout(RT_SOFT_TIMER_QUEUE);
         if (next_timeout == RT_TICK_MAX)
         {
             /* no software timer exist, suspend self. */
@@ -784,6 +1133,9 @@ __ROM_USED void rt_system_timer_init(void)
     {
         rt_list_init(rt_timer_list + i);
     }
+#ifdef RT_USING_TIMER_WHEEL
+    _rt_timer_wheel_init(&timer_wheel);
+#endif
 }
 
 /**
@@ -802,6 +1154,9 @@ __ROM_USED void rt_system_timer_thread_init(void)
     {
         rt_list_init(rt_soft_timer_list + i);
     }
+#ifdef RT_USING_TIMER_WHEEL
+    _rt_timer_wheel_init(&soft_timer_wheel);
+#endif
 
     /* start software timer thread */
     rt_thread_init(&timer_thread,
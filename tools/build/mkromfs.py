@@ -14,6 +14,24 @@ parser.add_argument('output', type=argparse.FileType('wb'), nargs='?', help='out
 parser.add_argument('--dump', action='store_true', help='dump the fs hierarchy')
 parser.add_argument('--binary', action='store_true', help='output binary file')
 parser.add_argument('--addr', default='0', help='set the base address of the binary file, default to 0, i.e. name and data field are relative offset.')
+parser.add_argument('--index', action='store_true', help='mark directories as sorted and add hash tables to the large ones, for faster lookup. Needs a romfs driver that knows ROMFS_DIRENT_SORTED/HASHED.')
+
+# dirent types and directory index flags, see dfs_romfs.h
+ROMFS_DIRENT_FILE = 0x00
+ROMFS_DIRENT_DIR = 0x01
+ROMFS_DIRENT_HASH = 0x02
+ROMFS_DIRENT_SORTED = 0x10
+ROMFS_DIRENT_HASHED = 0x20
+
+# directories with fewer entries are only binary searched
+HASH_MIN_ENTRIES = 8
+
+def name_hash(name):
+    '''FNV-1a of the UTF-8 name, must match romfs_name_hash() in dfs_romfs.c'''
+    h = 2166136261
+    for c in bytearray(name.encode('utf-8')):
+        h = ((h ^ c) * 16777619) & 0xffffffff
+    return h
 
 class File(object):
     def __init__(self, name):
@@ -59,6 +77,8 @@ class File(object):
 class Folder(object):
     bin_fmt = struct.Struct('IIII')
     bin_item = namedtuple('dirent', 'type, name, data, size')
+    # set by --index
+    index = False
 
     def __init__(self, name):
         self._name = name
@@ -111,6 +131,42 @@ class Folder(object):
             if isinstance(c, Folder):
                 c.sort()
 
+    @property
+    def hashed(self):
+        return self.index and self.entry_size >= HASH_MIN_ENTRIES
+
+    @property
+    def bin_type(self):
+        tp = ROMFS_DIRENT_DIR
+        if self.index and self.entry_size > 0:
+            tp |= ROMFS_DIRENT_SORTED
+        if self.hashed:
+            tp |= ROMFS_DIRENT_HASHED
+        return tp
+
+    @property
+    def c_type(self):
+        tp = 'ROMFS_DIRENT_DIR'
+        if self.index and self.entry_size > 0:
+            tp += ' | ROMFS_DIRENT_SORTED'
+        if self.hashed:
+            tp += ' | ROMFS_DIRENT_HASHED'
+        return tp
+
+    def hash_table(self):
+        '''Open addressing table of entry index + 1, at most half full.'''
+        assert self.entry_size < 0xffff, 'Too many entries in %s' % self._name
+        n = 1
+        while n < self.entry_size * 2:
+            n <<= 1
+        slots = [0] * n
+        for i, c in enumerate(self._children):
+            j = name_hash(c.name) & (n - 1)
+            while slots[j]:
+                j = (j + 1) & (n - 1)
+            slots[j] = i + 1
+        return slots
+
     def dump(self, indent=0):
         print('%s%s' % (' ' * indent, self._name))
         for c in self._children:
@@ -128,6 +184,7 @@ class Folder(object):
         dhead = 'static const struct romfs_dirent %s[] = {\n' % (prefix + self.c_name)
         dtail = '\n};'
         body_fmt = '    {{{type}, "{name}", (rt_uint8_t *){data}, sizeof({data})/sizeof({data}[0])}}'
+        body_fmt1= '    {{{type}, "{name}", (rt_uint8_t *){data}, {size}}}'
         body_fmt0= '    {{{type}, "{name}", RT_NULL, 0}}'
         # prefix of children
         cpf = prefix+self.c_name
@@ -138,17 +195,30 @@ class Folder(object):
             if isinstance(c, File):
                 tp = 'ROMFS_DIRENT_FILE'
             elif isinstance(c, Folder):
-                tp = 'ROMFS_DIRENT_DIR'
+                tp = c.c_type
             else:
                 assert False, 'Unkown instance:%s' % str(c)
             if entry_size == 0:
                 body_li.append(body_fmt0.format(type=tp, name = c.name))
+            elif isinstance(c, Folder) and c.hashed:
+                # the array also holds the hash dirent
+                body_li.append(body_fmt1.format(type=tp,
+                                            name=c.name,
+                                            data=cpf+c.c_name,
+                                            size=entry_size))
             else:
                 body_li.append(body_fmt.format(type=tp,
                                             name=c.name,
                                             data=cpf+c.c_name))
             payload_li.append(c.c_data(prefix=cpf))
 
+        if self.hashed:
+            slots = self.hash_table()
+            payload_li.append('static const rt_uint16_t %s_hash[] = {\n%s\n};' %
+                              (cpf, ','.join(str(i) for i in slots)))
+            body_li.append('    {ROMFS_DIRENT_HASH, RT_NULL, (rt_uint8_t *)%s_hash, %d}' %
+                           (cpf, len(slots)))
+
         # All the data we need is defined in payload so we should append the
         # dirent to it. It also meet the depth-first policy in this code.
         payload_li.append(dhead + ',\n'.join(body_li) + dtail)
@@ -178,13 +248,27 @@ class Folder(object):
         v_len = p_base
         # payload
         p_li = []
+        if self.hashed:
+            # the hash dirent follows the entries, then its table
+            slots = self.hash_table()
+            v_len += self.bin_fmt.size
+            h_li = [self.bin_fmt.pack(*self.bin_item(
+                                           type=ROMFS_DIRENT_HASH,
+                                           name=0,
+                                           data=v_len,
+                                           size=len(slots))),
+                    struct.pack('%dH' % len(slots), *slots)]
+            v_len += len(slots) * 2
+            if v_len % 4 != 0:
+                h_li.append(b'\0' * (4 - v_len % 4))
+                v_len += 4 - v_len % 4
+        else:
+            h_li = []
         for c in self._children:
             if isinstance(c, File):
-                # ROMFS_DIRENT_FILE
-                tp = 0
+                tp = ROMFS_DIRENT_FILE
             elif isinstance(c, Folder):
-                # ROMFS_DIRENT_DIR
-                tp = 1
+                tp = c.bin_type
             else:
                 assert False, 'Unkown instance:%s' % str(c)
 
@@ -208,7 +292,7 @@ class Folder(object):
 
             p_li.extend((name, data))
 
-        return bytes().join(d_li) + bytes().join(p_li)
+        return bytes().join(d_li) + bytes().join(h_li) + bytes().join(p_li)
 
 def get_c_data(tree):
     # Handle the root dirent specially.
@@ -219,12 +303,15 @@ def get_c_data(tree):
 {data}
 
 const struct romfs_dirent {name} = {{
-    ROMFS_DIRENT_DIR, "/", (rt_uint8_t *){rootdirent}, sizeof({rootdirent})/sizeof({rootdirent}[0])
+    {type}, "/", (rt_uint8_t *){rootdirent}, {size}
 }};
 '''
 
     return root_dirent_fmt.format(name='romfs_root',
+                                  type=tree.c_type,
                                   rootdirent=tree.c_name,
+                                  size=tree.entry_size if tree.hashed else
+                                       'sizeof(%s)/sizeof(%s[0])' % (tree.c_name, tree.c_name),
                                   data=tree.c_data())
 
 def get_bin_data(tree, base_addr):
@@ -234,7 +321,7 @@ def get_bin_data(tree, base_addr):
     v_len += len(name)
     data_addr = v_len
     # root entry
-    data = Folder.bin_fmt.pack(*Folder.bin_item(type=1,
+    data = Folder.bin_fmt.pack(*Folder.bin_item(type=tree.bin_type,
                                                 name=name_addr,
                                                 data=data_addr,
                                                 size=tree.entry_size))
@@ -244,6 +331,7 @@ if __name__ == '__main__':
     args = parser.parse_args()
 
     os.chdir(args.rootdir)
+    Folder.index = args.index
 
     tree = Folder('romfs_root')
     tree.walk()
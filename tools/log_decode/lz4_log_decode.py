@@ -0,0 +1,206 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+#
+# Decode logs compressed on the device, no lz4 package is needed.
+#
+#   python3 lz4_log_decode.py input [-o output]
+#
+# input may be
+#   - a file_logger file (metrics, HCI log), with or without FL_FLAG_LZ4
+#     records, the records are written to output one after another
+#   - the data received by BLE log with BLE_LOG_GET_FLAG_LZ4, a LZ4 frame,
+#     the result is decoded again if it's a file_logger file
+#
+# Every LZ4 block of both formats is independent, a block cut by the ring
+# or by a broken transfer is skipped and the following ones are decoded.
+
+import argparse
+import struct
+import sys
+
+LZ4_FRAME_MAGIC = 0x184D2204
+FL_FILE_HDR_MAGIC = 0x5354454D
+FL_PACKET_HDR_MAGIC = 0x4448
+FL_PACKET_LZ4_MAGIC = 0x5A4C
+FL_PACKET_TAIL_MAGIC = 0x4154
+
+
+def lz4_block_decompress(src, max_size=1 << 24):
+    """Decompress one LZ4 block, raise ValueError if it's corrupted."""
+    dst = bytearray()
+    pos = 0
+    end = len(src)
+    while pos < end:
+        token = src[pos]
+        pos += 1
+        literal = token >> 4
+        if literal == 15:
+            while True:
+                if pos >= end:
+                    raise ValueError('truncated literal length')
+                b = src[pos]
+                pos += 1
+                literal += b
+                if b != 255:
+                    break
+        if pos + literal > end:
+            raise ValueError('truncated literals')
+        dst += src[pos:pos + literal]
+        pos += literal
+        if pos == end:
+            break
+        if pos + 2 > end:
+            raise ValueError('truncated offset')
+        offset = src[pos] | (src[pos + 1] << 8)
+        pos += 2
+        if offset == 0 or offset > len(dst):
+            raise ValueError('bad offset')
+        match = (token & 15) + 4
+        if (token & 15) == 15:
+            while True:
+                if pos >= end:
+                    raise ValueError('truncated match length')
+                b = src[pos]
+                pos += 1
+                match += b
+                if b != 255:
+                    break
+        if len(dst) + match > max_size:
+            raise ValueError('output too large')
+        start = len(dst) - offset
+        if match <= offset:
+            dst += dst[start:start + match]
+        else:
+            for i in range(match):
+                dst.append(dst[start + i])
+    return bytes(dst)
+
+
+class Stat(object):
+    def __init__(self):
+        self.blocks = 0
+        self.bad_blocks = 0
+        self.packets = 0
+        self.records = 0
+        self.skipped = 0
+
+    def __str__(self):
+        return ('%d packets, %d LZ4 blocks (%d bad), %d records, %d bytes skipped' %
+                (self.packets, self.blocks, self.bad_blocks, self.records, self.skipped))
+
+
+def decode_frame(data, stat):
+    """LZ4 frame(s), independent blocks, a truncated tail is dropped."""
+    out = bytearray()
+    pos = 0
+    while pos + 7 <= len(data):
+        magic, flg, bd = struct.unpack_from('<IBB', data, pos)
+        if magic != LZ4_FRAME_MAGIC:
+            stat.skipped += len(data) - pos
+            break
+        pos += 6
+        block_checksum = flg & 0x10
+        if flg & 0x08:
+            pos += 8
+        if flg & 0x01:
+            pos += 4
+        pos += 1
+        while pos + 4 <= len(data):
+            size, = struct.unpack_from('<I', data, pos)
+            pos += 4
+            if size == 0:
+                if flg & 0x04:
+                    pos += 4
+                break
+            raw = size & 0x80000000
+            size &= 0x7FFFFFFF
+            block = data[pos:pos + size]
+            pos += size + (4 if block_checksum else 0)
+            if len(block) < size:
+                sys.stderr.write('frame truncated, %d bytes of the last block lost\n' % len(block))
+                stat.skipped += len(block)
+                break
+            stat.blocks += 1
+            if raw:
+                out += block
+                continue
+            try:
+                out += lz4_block_decompress(block)
+            except ValueError as e:
+                stat.bad_blocks += 1
+                sys.stderr.write('bad block at %d: %s\n' % (pos - size, e))
+    return bytes(out)
+
+
+def decode_file_logger(data, stat):
+    """file_logger ring, returns the records in write order."""
+    magic, wr_pos = struct.unpack_from('<Ii', data, 0)
+    if magic != FL_FILE_HDR_MAGIC:
+        raise ValueError('not a file_logger file')
+    ring = data[8:]
+    if 0 <= wr_pos < len(ring):
+        # the ring is full, the oldest data is at wr_pos
+        ring = ring[wr_pos:] + ring[:wr_pos]
+
+    records = []
+    pos = 0
+    while pos + 6 <= len(ring):
+        magic, length = struct.unpack_from('<HH', ring, pos)
+        tail = pos + 4 + length
+        if (magic not in (FL_PACKET_HDR_MAGIC, FL_PACKET_LZ4_MAGIC) or tail + 2 > len(ring) or
+                struct.unpack_from('<H', ring, tail)[0] != FL_PACKET_TAIL_MAGIC):
+            pos += 1
+            stat.skipped += 1
+            continue
+        payload = ring[pos + 4:tail]
+        pos = tail + 2
+        stat.packets += 1
+        if magic == FL_PACKET_HDR_MAGIC:
+            records.append(payload)
+            continue
+
+        stat.blocks += 1
+        org_size, = struct.unpack_from('<H', payload, 0)
+        try:
+            block = lz4_block_decompress(payload[2:], org_size)
+        except ValueError as e:
+            stat.bad_blocks += 1
+            sys.stderr.write('bad block: %s\n' % e)
+            continue
+        if len(block) != org_size:
+            stat.bad_blocks += 1
+            continue
+        rec = 0
+        while rec + 2 <= len(block):
+            length, = struct.unpack_from('<H', block, rec)
+            records.append(block[rec + 2:rec + 2 + length])
+            rec += 2 + length
+    stat.records += len(records)
+    return records
+
+
+def main():
+    parser = argparse.ArgumentParser(description='decode LZ4 compressed logs')
+    parser.add_argument('input')
+    parser.add_argument('-o', '--output', help='default: stdout')
+    args = parser.parse_args()
+
+    with open(args.input, 'rb') as f:
+        data = f.read()
+
+    stat = Stat()
+    if len(data) >= 4 and struct.unpack_from('<I', data)[0] == LZ4_FRAME_MAGIC:
+        data = decode_frame(data, stat)
+    if len(data) >= 8 and struct.unpack_from('<I', data)[0] == FL_FILE_HDR_MAGIC:
+        data = b''.join(decode_file_logger(data, stat))
+
+    if args.output:
+        with open(args.output, 'wb') as f:
+            f.write(data)
+    else:
+        sys.stdout.buffer.write(data)
+    sys.stderr.write('%s, %d bytes decoded\n' % (stat, len(data)))
+
+
+if __name__ == '__main__':
+    main()
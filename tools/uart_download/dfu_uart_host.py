@@ -0,0 +1,345 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+#
+# Host side of the uart DFU protocol in middleware/dfu_uart.
+#
+# Download an image:
+#   python3 dfu_uart_host.py COM5 1000000 app.bin 0x10060000 [--window 4] [--packet 2] [--no-end]
+#
+# Measure the effective throughput against a device model over a pty,
+# lockstep and windowed, without a board:
+#   python3 dfu_uart_host.py --loopback [--baud 3000000] [--size 262144]
+#
+# A device from version 2 (DFU_UART_USING_WINDOW) accepts several data
+# packets in flight, older devices are driven in lockstep.
+
+import argparse
+import os
+import queue
+import select
+import struct
+import sys
+import threading
+import time
+
+HEADER = struct.pack('<IH', 0x41554653, 0x5452)
+
+START_REQ = 1
+START_RSP = 2
+IMAGE_START_REQ = 3
+IMAGE_START_RSP = 4
+IMAGE_DATA_IND = 5
+IMAGE_DATA_CFM = 6
+IMAGE_END_REQ = 7
+IMAGE_END_RSP = 8
+END_REQ = 9
+END_RSP = 10
+IMAGE_START_EX_REQ = 11
+IMAGE_START_EX_RSP = 12
+IMAGE_DATA_ACK = 13
+
+ERROR_NO_ERROR = 0
+ERROR_INDEX_ERROR = 1
+
+# rounds resent in a row before giving up, with the wait doubled each time
+RETRIES = 5
+BACKOFF = 0.05
+
+
+def crc32mpeg2(data, crc=0xFFFFFFFF):
+    for b in data:
+        crc ^= b << 24
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x04C11DB7) if crc & 0x80000000 else (crc << 1)
+        crc &= 0xFFFFFFFF
+    return crc
+
+
+def frame(command, payload=b''):
+    return HEADER + struct.pack('<HH', command, len(payload)) + payload
+
+
+class Link(object):
+    """Frames over a byte stream, resynchronised on the header."""
+
+    def __init__(self, read, write):
+        self.read = read
+        self.write = write
+        self.buf = b''
+
+    def _fill(self, n):
+        while len(self.buf) < n:
+            data = self.read(max(n - len(self.buf), 1))
+            if not data:
+                raise IOError('link closed')
+            self.buf += data
+
+    def recv(self):
+        while True:
+            self._fill(len(HEADER) + 4)
+            pos = self.buf.find(HEADER)
+            if pos != 0:
+                self.buf = self.buf[pos:] if pos > 0 else self.buf[-(len(HEADER) - 1):]
+                continue
+            command, length = struct.unpack_from('<HH', self.buf, len(HEADER))
+            self._fill(len(HEADER) + 4 + length)
+            payload = self.buf[len(HEADER) + 4:len(HEADER) + 4 + length]
+            self.buf = self.buf[len(HEADER) + 4 + length:]
+            return command, payload
+
+    def send(self, command, payload=b''):
+        self.write(frame(command, payload))
+
+    def expect(self, command):
+        while True:
+            cmd, payload = self.recv()
+            if cmd == command:
+                return payload
+
+
+def backoff(retries):
+    """Wait before resending a round, the line settles down meanwhile."""
+    if retries >= RETRIES:
+        raise IOError('no progress after %d retries' % retries)
+    time.sleep(BACKOFF * (1 << retries))
+    return retries + 1
+
+
+def download(link, image, addr, packet_kb, window, end):
+    """Returns the seconds from image start to image end, and the window."""
+    link.send(START_REQ)
+    result, version = struct.unpack('<HH', link.expect(START_RSP)[:4])
+    crc = crc32mpeg2(image)
+    size = packet_kb * 1024
+    packets = [image[i:i + size] for i in range(0, len(image), size)]
+
+    windowed = version >= 2 and window > 1
+    # erasing is part of the cost, the lockstep device erases all at start
+    start = time.time()
+    if windowed:
+        link.send(IMAGE_START_EX_REQ, struct.pack('<IIIHH', len(image), addr, crc, packet_kb, window))
+        result, window = struct.unpack('<HH', link.expect(IMAGE_START_EX_RSP)[:4])
+    else:
+        link.send(IMAGE_START_REQ, struct.pack('<IIIHxx', len(image), addr, crc, packet_kb))
+        result, = struct.unpack('<H', link.expect(IMAGE_START_RSP)[:2])
+    if result != ERROR_NO_ERROR:
+        raise IOError('image start error %d' % result)
+
+    if windowed:
+        # packet indexes start from 1, acked is the next index to be written
+        acked = sent = 1
+        retries = 0
+        while acked <= len(packets):
+            while sent <= len(packets) and sent < acked + window:
+                link.send(IMAGE_DATA_IND, struct.pack('<H', sent) + packets[sent - 1])
+                sent += 1
+            try:
+                cmd, payload = link.recv()
+            except IOError:
+                # the ack or the index error got lost, go back to the last ack
+                retries = backoff(retries)
+                sent = acked
+                continue
+            if cmd != IMAGE_DATA_ACK:
+                continue
+            result, next_index = struct.unpack('<HH', payload[:4])
+            if result == ERROR_INDEX_ERROR:
+                retries = backoff(retries)
+                sent = next_index
+            elif result != ERROR_NO_ERROR:
+                raise IOError('data error %d at %d' % (result, next_index))
+            else:
+                retries = 0
+            acked = max(acked, next_index)
+    else:
+        for index, packet in enumerate(packets, 1):
+            link.send(IMAGE_DATA_IND, struct.pack('<H', index) + packet)
+            result, = struct.unpack('<H', link.expect(IMAGE_DATA_CFM)[:2])
+            if result != ERROR_NO_ERROR:
+                raise IOError('data error %d at %d' % (result, index))
+
+    link.send(IMAGE_END_REQ)
+    result, = struct.unpack('<H', link.expect(IMAGE_END_RSP)[:2])
+    elapsed = time.time() - start
+    if result != ERROR_NO_ERROR:
+        raise IOError('image end error %d' % result)
+    if end:
+        link.send(END_REQ)
+        link.expect(END_RSP)
+    return elapsed, window if windowed else 1
+
+
+class DeviceModel(threading.Thread):
+    """
+    Device side on a pty: the wire is paced at the baud rate and the flash
+    takes erase_ms per sector and program_ms per KB, on a writer thread in
+    windowed mode as on the target.
+    """
+
+    def __init__(self, fd, baud, window, sector=4096, erase_ms=25.0, program_ms=3.0):
+        threading.Thread.__init__(self)
+        self.daemon = True
+        self.fd = fd
+        self.byte_time = 10.0 / baud
+        self.window = window
+        self.sector = sector
+        self.erase_s = erase_ms / 1000.0
+        self.program_s = program_ms / 1000.0 / 1024
+        self.tx_lock = threading.Lock()
+        self.flash = {}
+        self.wire_free = 0.0
+
+    def _read(self, n):
+        return os.read(self.fd, n)
+
+    def _write(self, data):
+        with self.tx_lock:
+            time.sleep(len(data) * self.byte_time)
+            os.write(self.fd, data)
+
+    def _erase_to(self, end):
+        while self.erased_end < end:
+            time.sleep(self.erase_s)
+            self.erased_end += self.sector
+
+    def _program(self, addr, data):
+        self._erase_to(addr + len(data))
+        time.sleep(len(data) * self.program_s)
+        self.flash[addr] = data
+
+    def _writer(self):
+        while True:
+            try:
+                # a few sectors ahead of the data, as on the target
+                ahead = min(self.end, self.base + self.written + 4 * self.sector)
+                item = self.slots.get(timeout=0.001 if self.erased_end < ahead else None)
+            except queue.Empty:
+                self._erase_to(self.erased_end + 1)
+                continue
+            index, data = item
+            self._program(self.base + self.written, data)
+            self.written += len(data)
+            self.free.release()
+            self.link.send(IMAGE_DATA_ACK, struct.pack('<HH', 0, index + 1))
+
+    def run(self):
+        link = self.link = Link(self._read, self._write)
+        rx_index = 1
+        while True:
+            try:
+                command, payload = link.recv()
+            except (IOError, OSError):
+                # the host side is closed
+                return
+            # the bytes take their time on the wire
+            self.wire_free = max(self.wire_free, time.time()) + (len(payload) + 10) * self.byte_time
+            time.sleep(max(0.0, self.wire_free - time.time()))
+
+            if command == START_REQ:
+                link.send(START_RSP, struct.pack('<HH', 0, 2 if self.window > 1 else 1))
+            elif command in (IMAGE_START_REQ, IMAGE_START_EX_REQ):
+                length, self.base, crc, kb = struct.unpack_from('<IIIH', payload)
+                self.end = self.base + length
+                self.erased_end = self.base
+                self.written = 0
+                self.size = kb * 1024
+                rx_index = 1
+                if command == IMAGE_START_REQ:
+                    # erase all first, like the lockstep device
+                    self._erase_to(self.end)
+                    link.send(IMAGE_START_RSP, struct.pack('<H', 0))
+                else:
+                    window = min(struct.unpack_from('<H', payload, 14)[0], self.window)
+                    self.slots = queue.Queue()
+                    self.free = threading.Semaphore(window)
+                    threading.Thread(target=self._writer, daemon=True).start()
+                    link.send(IMAGE_START_EX_RSP, struct.pack('<HH', 0, window))
+            elif command == IMAGE_DATA_IND:
+                index, = struct.unpack_from('<H', payload)
+                if hasattr(self, 'slots'):
+                    self.free.acquire()
+                    if index != rx_index:
+                        self.free.release()
+                        continue
+                    rx_index += 1
+                    self.slots.put((index, payload[2:]))
+                else:
+                    self._program(self.base + self.written, payload[2:])
+                    self.written += len(payload) - 2
+                    link.send(IMAGE_DATA_CFM, struct.pack('<HH', 0, 0))
+            elif command == IMAGE_END_REQ:
+                if hasattr(self, 'slots'):
+                    while self.written < self.end - self.base:
+                        time.sleep(0.001)
+                    del self.slots
+                image = b''.join(self.flash[a] for a in sorted(self.flash))
+                self.flash = {}
+                link.send(IMAGE_END_RSP, struct.pack('<H', 0 if len(image) == self.end - self.base else 3))
+            elif command == END_REQ:
+                link.send(END_RSP, struct.pack('<H', 0))
+
+
+def read_timeout(fd, n, timeout):
+    if not select.select([fd], [], [], timeout)[0]:
+        raise IOError('timeout')
+    return os.read(fd, n)
+
+
+def loopback(args):
+    import tty
+    image = os.urandom(args.size)
+    print('%d bytes at %d baud, %d KB packets' % (len(image), args.loop_baud, args.packet))
+    wire = len(image) * 10.0 / args.loop_baud
+    for window in sorted(set([1, args.window])):
+        master, slave = os.openpty()
+        tty.setraw(master)
+        tty.setraw(slave)
+        DeviceModel(slave, args.loop_baud, window).start()
+        link = Link(lambda n: read_timeout(master, n, 5), lambda d: os.write(master, d))
+        elapsed, granted = download(link, image, 0x10060000, args.packet, window, True)
+        print('window %2d: %6.2f s, %7.1f KB/s, %3d%% of line rate' %
+              (granted, elapsed, len(image) / 1024.0 / elapsed, wire * 100 / elapsed))
+        os.close(master)
+        os.close(slave)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='uart DFU host')
+    parser.add_argument('port', nargs='?')
+    parser.add_argument('baud', nargs='?', type=int, default=1000000)
+    parser.add_argument('image', nargs='?')
+    parser.add_argument('addr', nargs='?', type=lambda x: int(x, 0), default=0x10060000)
+    parser.add_argument('--packet', type=int, default=2, help='packet size in KB')
+    parser.add_argument('--window', type=int, default=4, help='packets in flight')
+    parser.add_argument('--no-end', action='store_true', help='do not reboot into the image')
+    parser.add_argument('--loopback', action='store_true', help='measure against a device model on a pty')
+    parser.add_argument('--size', type=int, default=256 * 1024, help='loopback image size')
+    parser.add_argument('--baud', dest='loop_baud', type=int, default=3000000, help='loopback baud rate')
+    args = parser.parse_args()
+
+    if args.loopback:
+        loopback(args)
+        return
+
+    if not args.port or not args.image:
+        parser.error('port and image are needed')
+
+    import serial
+    port = serial.Serial(args.port, args.baud, timeout=5)
+    with open(args.image, 'rb') as f:
+        image = f.read()
+
+    def read(n):
+        data = port.read(n)
+        if not data:
+            raise IOError('timeout')
+        return data
+
+    elapsed, window = download(Link(read, port.write), image, args.addr, args.packet,
+                               args.window, not args.no_end)
+    print('%d bytes in %.2f s, %.1f KB/s, window %d' % (len(image), elapsed,
+                                                        len(image) / 1024.0 / elapsed, window))
+
+
+if __name__ == '__main__':
+    main()